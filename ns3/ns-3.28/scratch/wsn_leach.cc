@@ -12,6 +12,7 @@
 #include "ns3/wifi-module.h"
 #include "ns3/mobility-module.h"
 #include "ns3/leach-helper.h"
+#include "ns3/leach-fast-forward.h"
 #include "ns3/energy-module.h"
 #include "ns3/file-helper.h"
 #include "ns3/traced-value.h"
@@ -22,6 +23,8 @@
 #include <iostream>
 #include <fstream>
 #include <string>
+#include <limits>
+#include <cmath>
 
 using namespace ns3;
 
@@ -191,6 +194,42 @@ void TotalEnergy (double oldValue, double totalEnergy)
 }
 
 
+/* Duration of a LEACH round, RoutingProtocol::m_roundDuration. */
+static const double roundDuration = 3.0; /* seconds */
+
+/* Lifetime milestones of the fast-forward model. */
+static u_int32_t firstDeadRound = 0;
+static u_int32_t halfDeadRound = 0;
+
+/* Trace function for the end of a fast-forward round. */
+void FastForwardRound (uint32_t round, uint32_t alive, uint32_t clusterHeads)
+{
+    if(firstDeadRound == 0 && alive < (u_int32_t) nodeEnergySize)
+        firstDeadRound = round;
+    if(halfDeadRound == 0 && alive <= (u_int32_t) nodeEnergySize / 2)
+        halfDeadRound = round;
+
+    NS_LOG_INFO("Round " << round << ": alive nodes = " << alive << " cluster heads = " << clusterHeads);
+}
+
+/* Create the analytic model of the field: same points, energy and traffic. */
+Ptr<leach::FastForward> createFastForward(Points* p, u_int32_t nNodes,
+                                          uint32_t packetSize, double interval,
+                                          u_int32_t threads)
+{
+    Ptr<leach::FastForward> ff = CreateObject<leach::FastForward>();
+    ff->SetAttribute("PacketSize", UintegerValue(packetSize));
+    ff->SetAttribute("PacketsPerRound", UintegerValue(std::max(1.0, std::floor(roundDuration / interval))));
+    ff->SetAttribute("Threads", UintegerValue(threads));
+    ff->SetBaseStation(p->points[0][0], p->points[0][1]);
+    for(u_int32_t i = 0; i < nNodes; i++)
+        ff->AddNode(p->points[i + 1][0], p->points[i + 1][1], batteryValue);
+
+    ff->TraceConnectWithoutContext("RoundEnd", MakeCallback(&FastForwardRound));
+
+    return ff;
+}
+
 int main (int argc, char *argv[])
 {
     /**************************************************************************
@@ -207,6 +246,11 @@ int main (int argc, char *argv[])
     bool verbose = true;
     bool pcap = false;
     std::string file_path = "";
+    bool firstOrder = false;
+    bool fastForward = false;
+    bool validate = false;
+    u_int32_t threads = 1;
+    u_int32_t maxRounds = 0;
 
     /* Set comandline arguments and parse them. */
     CommandLine cmd;
@@ -219,14 +263,40 @@ int main (int argc, char *argv[])
     cmd.AddValue("maxPackets", "Maximum number of packets send per node", maxPackets);
     cmd.AddValue("interval", "Interval between sending packets. Unit: seconds", interval);
     cmd.AddValue("energy", "Energy available to a node", batteryValue);
+    cmd.AddValue("firstOrder", "Use the first order radio energy model instead of the wifi state model", firstOrder);
+    cmd.AddValue("fastForward", "Compute the lifetime round by round instead of simulating packets", fastForward);
+    cmd.AddValue("validate", "Run the packet level and the fast-forward model side by side", validate);
+    cmd.AddValue("threads", "Number of threads used by the fast-forward model", threads);
+    cmd.AddValue("rounds", "Maximum number of fast-forward rounds, 0 runs until all nodes are depleted", maxRounds);
     cmd.Parse (argc, argv);
 
     /* Get the points. */
     Points* p = createPoints(nNodes + 1);
     read_points(p, file_path);
+    nodeEnergySize = nNodes;
+
+    /* Only compute the rounds analytically, no network is created. */
+    if(fastForward)
+    {
+        if(verbose)
+            LogComponentEnable("wsn_leach", LOG_LEVEL_INFO);
+
+        Ptr<leach::FastForward> ff = createFastForward(p, nNodes, packetSize, interval, threads);
+        u_int32_t rounds = ff->Run(maxRounds > 0 ? maxRounds : std::numeric_limits<u_int32_t>::max());
+        deletePoints(p);
+
+        std::cout << "Rounds: " << rounds << std::endl;
+        std::cout << "First node depleted in round: " << firstDeadRound << std::endl;
+        std::cout << "Half of the nodes depleted in round: " << halfDeadRound << std::endl;
+        std::cout << "Total Depleted nodes: " << nNodes - ff->GetNAliveNodes() << "/" << nNodes << std::endl;
+        return 0;
+    }
+
+    /* The fast-forward model uses the first order radio model. */
+    if(validate)
+        firstOrder = true;
 
     /* Create objects for tracing the amount of energy in nodes. */
-    nodeEnergySize = nNodes;
     pNodeEnergy = new Ptr<NodeEnergy>[nodeEnergySize];
     for(int i = 0; i < nodeEnergySize; i++)
         pNodeEnergy[i] = CreateObject<NodeEnergy>();
@@ -327,9 +397,19 @@ int main (int argc, char *argv[])
         sources.Add(basicSourceHelper.Install(sensorNodes.Get(i)));
 
     /* device energy model */
-    WifiRadioEnergyModelHelper radioEnergyHelper;
-    radioEnergyHelper.SetDepletionCallback(MakeCallback(&NodeEnergyDepletion));
-    DeviceEnergyModelContainer deviceModels = radioEnergyHelper.Install (sensorDevices, sources);
+    DeviceEnergyModelContainer deviceModels;
+    if(firstOrder)
+    {
+        FirstOrderRadioEnergyModelHelper radioEnergyHelper;
+        radioEnergyHelper.SetDepletionCallback(MakeCallback(&NodeEnergyDepletion));
+        deviceModels = radioEnergyHelper.Install (sensorDevices, sources);
+    }
+    else
+    {
+        WifiRadioEnergyModelHelper radioEnergyHelper;
+        radioEnergyHelper.SetDepletionCallback(MakeCallback(&NodeEnergyDepletion));
+        deviceModels = radioEnergyHelper.Install (sensorDevices, sources);
+    }
 
 
     /**************************************************************************
@@ -338,6 +418,7 @@ int main (int argc, char *argv[])
 
     /* Enable LEACH */
     LeachHelper leach;
+    leach.SetBaseStation(baseStation.Get(0), Ipv4Address("10.1.1.1"));
 
     Ipv4ListRoutingHelper list;
     list.Add(leach, 100);
@@ -489,6 +570,32 @@ int main (int argc, char *argv[])
         i++;
     }
 
+    /* Compute the same number of rounds with the fast-forward model. The
+     * elections use different random numbers and the analytic model has no
+     * control, MAC or overhearing cost, so the difference shows how much of
+     * the energy goes to those. */
+    if(validate)
+    {
+        Ptr<leach::FastForward> ff = createFastForward(p, nNodes, packetSize, interval, threads);
+        ff->Run(std::ceil(simStopTime / roundDuration));
+
+        double totalPacket = 0;
+        double totalAnalytic = 0;
+        for(u_int32_t n = 0; n < nNodes; n++)
+        {
+            double packetLevel = deviceModels.Get(n)->GetTotalEnergyConsumption();
+            double analytic = ff->GetTotalEnergyConsumption(n);
+            totalPacket += packetLevel;
+            totalAnalytic += analytic;
+            std::cout << "Node " << n + 1 << " energy consumed: packet level = " << packetLevel
+                      << "J fast-forward = " << analytic << "J" << std::endl;
+        }
+
+        std::cout << "Total energy consumed: packet level = " << totalPacket
+                  << "J fast-forward = " << totalAnalytic << "J relative difference = "
+                  << (totalAnalytic - totalPacket) / totalPacket << std::endl;
+    }
+
     Simulator::Destroy();
 
     /* Clean up. */
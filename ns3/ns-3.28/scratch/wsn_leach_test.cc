@@ -283,6 +283,7 @@ int main (int argc, char *argv[])
 
     /* Enable LEACH */
     LeachHelper leach;
+    leach.SetBaseStation(baseStation.Get(0), Ipv4Address("10.1.1.1"));
 
     Ipv4ListRoutingHelper list;
     /* TODO cleanup */
@@ -28,7 +28,10 @@
 #include "attribute.h"
 #include "attribute-helper.h"
 #include "simple-ref-count.h"
+#include "ns3/core-config.h"
+#include <new>
 #include <typeinfo>
+#include <type_traits>
 
 /**
  * \file
@@ -153,6 +156,14 @@ public:
    * \return The object type as a string.
    */
   virtual std::string GetTypeid (void) const = 0;
+  /**
+   * Copy this implementation, with a reference count of one.
+   *
+   * \param [in] buffer Where to build the copy, or 0 to allocate it
+   *             on the heap.
+   * \return The copy.
+   */
+  virtual CallbackImplBase * Copy (void *buffer) const = 0;
 
 protected:
   /**
@@ -449,6 +460,10 @@ public:
   FunctorCallbackImpl (T const &functor)
     : m_functor (functor) {}
   virtual ~FunctorCallbackImpl () {}
+  /** \copydoc CallbackImplBase::Copy */
+  virtual CallbackImplBase * Copy (void *buffer) const {
+    return buffer == 0 ? new FunctorCallbackImpl<T,R,T1,T2,T3,T4,T5,T6,T7,T8,T9> (*this) : new (buffer) FunctorCallbackImpl<T,R,T1,T2,T3,T4,T5,T6,T7,T8,T9> (*this);
+  }
   /**
    * Functor with varying numbers of arguments
    * @{
@@ -596,6 +611,10 @@ public:
   MemPtrCallbackImpl (OBJ_PTR const&objPtr, MEM_PTR memPtr)
     : m_objPtr (objPtr), m_memPtr (memPtr) {}
   virtual ~MemPtrCallbackImpl () {}
+  /** \copydoc CallbackImplBase::Copy */
+  virtual CallbackImplBase * Copy (void *buffer) const {
+    return buffer == 0 ? new MemPtrCallbackImpl<OBJ_PTR,MEM_PTR,R,T1,T2,T3,T4,T5,T6,T7,T8,T9> (*this) : new (buffer) MemPtrCallbackImpl<OBJ_PTR,MEM_PTR,R,T1,T2,T3,T4,T5,T6,T7,T8,T9> (*this);
+  }
   /**
    * Functor with varying numbers of arguments
    * @{
@@ -745,6 +764,10 @@ public:
   BoundFunctorCallbackImpl (FUNCTOR functor, ARG a)
     : m_functor (functor), m_a (a) {}
   virtual ~BoundFunctorCallbackImpl () {}
+  /** \copydoc CallbackImplBase::Copy */
+  virtual CallbackImplBase * Copy (void *buffer) const {
+    return buffer == 0 ? new BoundFunctorCallbackImpl<T,R,TX,T1,T2,T3,T4,T5,T6,T7,T8> (*this) : new (buffer) BoundFunctorCallbackImpl<T,R,TX,T1,T2,T3,T4,T5,T6,T7,T8> (*this);
+  }
   /**
    * Functor with varying numbers of arguments
    * @{
@@ -880,6 +903,10 @@ public:
   TwoBoundFunctorCallbackImpl (FUNCTOR functor, ARG1 arg1, ARG2 arg2)
     : m_functor (functor), m_a1 (arg1), m_a2 (arg2) {}
   virtual ~TwoBoundFunctorCallbackImpl () {}
+  /** \copydoc CallbackImplBase::Copy */
+  virtual CallbackImplBase * Copy (void *buffer) const {
+    return buffer == 0 ? new TwoBoundFunctorCallbackImpl<T,R,TX1,TX2,T1,T2,T3,T4,T5,T6,T7> (*this) : new (buffer) TwoBoundFunctorCallbackImpl<T,R,TX1,TX2,T1,T2,T3,T4,T5,T6,T7> (*this);
+  }
   /**
    * Functor with varying numbers of arguments
    * @{
@@ -1003,6 +1030,10 @@ public:
   ThreeBoundFunctorCallbackImpl (FUNCTOR functor, ARG1 arg1, ARG2 arg2, ARG3 arg3)
     : m_functor (functor), m_a1 (arg1), m_a2 (arg2), m_a3 (arg3) {}
   virtual ~ThreeBoundFunctorCallbackImpl () {}
+  /** \copydoc CallbackImplBase::Copy */
+  virtual CallbackImplBase * Copy (void *buffer) const {
+    return buffer == 0 ? new ThreeBoundFunctorCallbackImpl<T,R,TX1,TX2,TX3,T1,T2,T3,T4,T5,T6> (*this) : new (buffer) ThreeBoundFunctorCallbackImpl<T,R,TX1,TX2,TX3,T1,T2,T3,T4,T5,T6> (*this);
+  }
   /**
    * Functor with varying numbers of arguments
    * @{
@@ -1096,6 +1127,125 @@ private:
   typename TypeTraits<TX3>::ReferencedType m_a3;  //!< third bound argument
 };
 
+#ifdef NS3_INLINE_CALLBACKS
+/**
+ * \ingroup callbackimpl
+ * Base class for Callback class.
+ * Provides pimpl abstraction, with inline storage for small pimpls.
+ */
+class CallbackBase {
+public:
+  CallbackBase () : m_impl (), m_peek (0) {}
+  /**
+   * Copy constructor: copies an inline implementation, shares a heap one.
+   * \param [in] o The CallbackBase to copy
+   */
+  CallbackBase (const CallbackBase &o) : m_impl (), m_peek (0) { DoCopy (o); }
+  /**
+   * Assignment
+   * \param [in] o The CallbackBase to copy
+   * \return This CallbackBase
+   */
+  CallbackBase & operator = (const CallbackBase &o) {
+    if (this != &o)
+      {
+        DoReset ();
+        DoCopy (o);
+      }
+    return *this;
+  }
+  ~CallbackBase () { DoReset (); }
+  /**
+   * \return The impl pointer.  An implementation stored inline is
+   *         moved to the heap first, so that this CallbackBase returns
+   *         the same pointer until it is changed.
+   */
+  Ptr<CallbackImplBase> GetImpl (void) const {
+    if (IsInline ())
+      {
+        CallbackImplBase *impl = m_peek->Copy (0);
+        m_peek->~CallbackImplBase ();
+        m_impl = Ptr<CallbackImplBase> (impl, false);
+        m_peek = impl;
+      }
+    return m_impl;
+  }
+  /**
+   * \return The impl pointer, valid as long as this CallbackBase is
+   *         neither changed nor destroyed.
+   */
+  CallbackImplBase * PeekImpl (void) const { return m_peek; }
+protected:
+  /**
+   * Construct from a pimpl
+   * \param [in] impl The CallbackImplBase Ptr
+   */
+  CallbackBase (Ptr<CallbackImplBase> impl) : m_impl (impl), m_peek (PeekPointer (impl)) {}
+  /**
+   * Store a copy of an implementation: inline if it fits, else on the heap.
+   * \param [in] impl The implementation
+   */
+  template <typename IMPL>
+  void DoStore (const IMPL &impl) {
+    DoStore (impl, std::integral_constant<bool, (sizeof (IMPL) <= sizeof (m_buffer)
+                                                 && alignof (IMPL) <= alignof (void *))> ());
+  }
+  /**
+   * Store a copy of an implementation inline.
+   * \param [in] impl The implementation
+   */
+  template <typename IMPL>
+  void DoStore (const IMPL &impl, std::true_type) {
+    m_peek = new (m_buffer) IMPL (impl);
+  }
+  /**
+   * Store a copy of an implementation on the heap.
+   * \param [in] impl The implementation
+   */
+  template <typename IMPL>
+  void DoStore (const IMPL &impl, std::false_type) {
+    m_impl = Ptr<CallbackImplBase> (new IMPL (impl), false);
+    m_peek = PeekPointer (m_impl);
+  }
+  /** Discard the implementation */
+  void DoReset (void) {
+    if (IsInline ())
+      {
+        m_peek->~CallbackImplBase ();
+      }
+    m_impl = 0;
+    m_peek = 0;
+  }
+  mutable Ptr<CallbackImplBase> m_impl; //!< the pimpl, if it is on the heap
+  mutable CallbackImplBase *m_peek;     //!< the pimpl, wherever it is
+private:
+  /** \return \c true if the implementation is stored in m_buffer */
+  bool IsInline (void) const { return m_peek != 0 && m_impl == 0; }
+  /**
+   * Copy the implementation of another CallbackBase, after DoReset().
+   * \param [in] o The CallbackBase to copy
+   */
+  void DoCopy (const CallbackBase &o) {
+    if (o.IsInline ())
+      {
+        m_peek = o.m_peek->Copy (m_buffer);
+      }
+    else
+      {
+        m_impl = o.m_impl;
+        m_peek = o.m_peek;
+      }
+  }
+  /**
+   * Inline storage for small implementations: a member function
+   * with its object, or a function with up to two pointer sized
+   * bound arguments.
+   */
+  void *m_buffer[5];
+};
+
+#else /* NS3_INLINE_CALLBACKS */
+
 /**
  * \ingroup callbackimpl
  * Base class for Callback class.
@@ -1106,15 +1256,34 @@ public:
   CallbackBase () : m_impl () {}
   /** \return The impl pointer */
   Ptr<CallbackImplBase> GetImpl (void) const { return m_impl; }
+  /**
+   * \return The impl pointer, valid as long as this CallbackBase is
+   *         neither changed nor destroyed.
+   */
+  CallbackImplBase * PeekImpl (void) const { return PeekPointer (m_impl); }
 protected:
   /**
    * Construct from a pimpl
    * \param [in] impl The CallbackImplBase Ptr
    */
   CallbackBase (Ptr<CallbackImplBase> impl) : m_impl (impl) {}
+  /**
+   * Store a copy of an implementation on the heap.
+   * \param [in] impl The implementation
+   */
+  template <typename IMPL>
+  void DoStore (const IMPL &impl) {
+    m_impl = Ptr<CallbackImplBase> (new IMPL (impl), false);
+  }
+  /** Discard the implementation */
+  void DoReset (void) {
+    m_impl = 0;
+  }
   Ptr<CallbackImplBase> m_impl;         //!< the pimpl
 };
 
+#endif /* NS3_INLINE_CALLBACKS */
+
 /**
  * \ingroup callback
  * \brief Callback template class
@@ -1157,6 +1326,13 @@ protected:
  *     member functions.
  *   - a reference list implementation to implement the Callback's
  *     value semantics.
+ *   - when ns-3 is configured with --enable-inline-callbacks, a small
+ *     buffer in the Callback itself which holds pimpls of member
+ *     function pointers and of function pointers with few bound
+ *     arguments, so that making them does not allocate; copying
+ *     such a Callback copies its pimpl.  Larger pimpls go on the heap
+ *     and are shared by copies.  The buffer makes each Callback 56
+ *     bytes instead of 8, so it is off by default.
  *
  * This code most notably departs from the alexandrescu 
  * implementation in that it does not use type lists to specify
@@ -1188,8 +1364,9 @@ public:
    */
   template <typename FUNCTOR>
   Callback (FUNCTOR const &functor, bool, bool) 
-    : CallbackBase (Create<FunctorCallbackImpl<FUNCTOR,R,T1,T2,T3,T4,T5,T6,T7,T8,T9> > (functor))
-  {}
+  {
+    DoStore (FunctorCallbackImpl<FUNCTOR,R,T1,T2,T3,T4,T5,T6,T7,T8,T9> (functor));
+  }
 
   /**
    * Construct a member function pointer call back.
@@ -1199,8 +1376,9 @@ public:
    */
   template <typename OBJ_PTR, typename MEM_PTR>
   Callback (OBJ_PTR const &objPtr, MEM_PTR memPtr)
-    : CallbackBase (Create<MemPtrCallbackImpl<OBJ_PTR,MEM_PTR,R,T1,T2,T3,T4,T5,T6,T7,T8,T9> > (objPtr, memPtr))
-  {}
+  {
+    DoStore (MemPtrCallbackImpl<OBJ_PTR,MEM_PTR,R,T1,T2,T3,T4,T5,T6,T7,T8,T9> (objPtr, memPtr));
+  }
 
   /**
    * Construct from a CallbackImpl pointer
@@ -1211,6 +1389,18 @@ public:
     : CallbackBase (impl)
   {}
 
+  /**
+   * Construct from a copy of a CallbackImpl, stored inline if it fits
+   *
+   * \param [in] impl The CallbackImpl
+   */
+  template <typename IMPL>
+  explicit Callback (IMPL const &impl,
+                     typename std::enable_if<std::is_base_of<CallbackImpl<R,T1,T2,T3,T4,T5,T6,T7,T8,T9>, IMPL>::value>::type * = 0)
+  {
+    DoStore (impl);
+  }
+
   /**
    * Bind the first arguments
    *
@@ -1272,7 +1462,7 @@ public:
   }
   /** Discard the implementation, set it to null */
   void Nullify (void) {
-    m_impl = 0;
+    DoReset ();
   }
 
   /**
@@ -1391,7 +1581,7 @@ public:
    * \return \c true if we are equal
    */
   bool IsEqual (const CallbackBase &other) const {
-    return m_impl->IsEqual (other.GetImpl ());
+    return PeekImpl ()->IsEqual (other.PeekImpl ());
   }
 
   /**
@@ -1401,7 +1591,7 @@ public:
    * \return \c true if other can be dynamic_cast to my type
    */
   bool CheckType (const CallbackBase & other) const {
-    return DoCheckType (other.GetImpl ());
+    return DoCheckType (other.PeekImpl ());
   }
   /**
    * Adopt the other's implementation, if type compatible
@@ -1410,12 +1600,12 @@ public:
    * \returns \c true if \p other was type-compatible and could be adopted.
    */
   bool Assign (const CallbackBase &other) {
-    return DoAssign (other.GetImpl ());
+    return DoAssign (other);
   }
 private:
   /** \return The pimpl pointer */
   CallbackImpl<R,T1,T2,T3,T4,T5,T6,T7,T8,T9> *DoPeekImpl (void) const {
-    return static_cast<CallbackImpl<R,T1,T2,T3,T4,T5,T6,T7,T8,T9> *> (PeekPointer (m_impl));
+    return static_cast<CallbackImpl<R,T1,T2,T3,T4,T5,T6,T7,T8,T9> *> (PeekImpl ());
   }
   /**
    * Check for compatible types
@@ -1423,9 +1613,9 @@ private:
    * \param [in] other Callback Ptr
    * \return \c true if other can be dynamic_cast to my type
    */
-  bool DoCheckType (Ptr<const CallbackImplBase> other) const {
+  bool DoCheckType (const CallbackImplBase *other) const {
     if (other != 0 &&
-        dynamic_cast<const CallbackImpl<R,T1,T2,T3,T4,T5,T6,T7,T8,T9> *> (PeekPointer (other)) != 0)
+        dynamic_cast<const CallbackImpl<R,T1,T2,T3,T4,T5,T6,T7,T8,T9> *> (other) != 0)
       {
         return true;
       }
@@ -1439,17 +1629,17 @@ private:
       }
   }
   /** \copydoc Assign */
-  bool DoAssign (Ptr<const CallbackImplBase> other) {
-    if (!DoCheckType (other))
+  bool DoAssign (const CallbackBase &other) {
+    if (!DoCheckType (other.PeekImpl ()))
       {
-        std::string othTid = other->GetTypeid ();
+        std::string othTid = other.PeekImpl ()->GetTypeid ();
         std::string myTid = CallbackImpl<R,T1,T2,T3,T4,T5,T6,T7,T8,T9>::DoGetTypeid ();
         NS_FATAL_ERROR_CONT ("Incompatible types. (feed to \"c++filt -t\" if needed)" << std::endl <<
                         "got=" << othTid << std::endl <<
                         "expected=" << myTid);
         return false;
       }
-    m_impl = const_cast<CallbackImplBase *> (PeekPointer (other));
+    CallbackBase::operator = (other);
     return true;
   }
 };
@@ -1684,64 +1874,55 @@ Callback<R,T1,T2,T3,T4,T5,T6,T7,T8,T9> MakeNullCallback (void) {
  */   
 template <typename R, typename TX, typename ARG>
 Callback<R> MakeBoundCallback (R (*fnPtr)(TX), ARG a1) {
-  Ptr<CallbackImpl<R,empty,empty,empty,empty,empty,empty,empty,empty,empty> > impl =
-    Create<BoundFunctorCallbackImpl<R (*)(TX),R,TX,empty,empty,empty,empty,empty,empty,empty,empty> >(fnPtr, a1);
+  BoundFunctorCallbackImpl<R (*)(TX),R,TX,empty,empty,empty,empty,empty,empty,empty,empty> impl (fnPtr, a1);
   return Callback<R> (impl);
 }
 template <typename R, typename TX, typename ARG, 
           typename T1>
 Callback<R,T1> MakeBoundCallback (R (*fnPtr)(TX,T1), ARG a1) {
-  Ptr<CallbackImpl<R,T1,empty,empty,empty,empty,empty,empty,empty,empty> > impl =
-    Create<BoundFunctorCallbackImpl<R (*)(TX,T1),R,TX,T1,empty,empty,empty,empty,empty,empty,empty> > (fnPtr, a1);
+  BoundFunctorCallbackImpl<R (*)(TX,T1),R,TX,T1,empty,empty,empty,empty,empty,empty,empty> impl (fnPtr, a1);
   return Callback<R,T1> (impl);
 }
 template <typename R, typename TX, typename ARG, 
           typename T1, typename T2>
 Callback<R,T1,T2> MakeBoundCallback (R (*fnPtr)(TX,T1,T2), ARG a1) {
-  Ptr<CallbackImpl<R,T1,T2,empty,empty,empty,empty,empty,empty,empty> > impl =
-    Create<BoundFunctorCallbackImpl<R (*)(TX,T1,T2),R,TX,T1,T2,empty,empty,empty,empty,empty,empty> > (fnPtr, a1);
+  BoundFunctorCallbackImpl<R (*)(TX,T1,T2),R,TX,T1,T2,empty,empty,empty,empty,empty,empty> impl (fnPtr, a1);
   return Callback<R,T1,T2> (impl);
 }
 template <typename R, typename TX, typename ARG,
           typename T1, typename T2,typename T3>
 Callback<R,T1,T2,T3> MakeBoundCallback (R (*fnPtr)(TX,T1,T2,T3), ARG a1) {
-  Ptr<CallbackImpl<R,T1,T2,T3,empty,empty,empty,empty,empty,empty> > impl =
-    Create<BoundFunctorCallbackImpl<R (*)(TX,T1,T2,T3),R,TX,T1,T2,T3,empty,empty,empty,empty,empty> > (fnPtr, a1);
+  BoundFunctorCallbackImpl<R (*)(TX,T1,T2,T3),R,TX,T1,T2,T3,empty,empty,empty,empty,empty> impl (fnPtr, a1);
   return Callback<R,T1,T2,T3> (impl);
 }
 template <typename R, typename TX, typename ARG,
           typename T1, typename T2,typename T3,typename T4>
 Callback<R,T1,T2,T3,T4> MakeBoundCallback (R (*fnPtr)(TX,T1,T2,T3,T4), ARG a1) {
-  Ptr<CallbackImpl<R,T1,T2,T3,T4,empty,empty,empty,empty,empty> > impl =
-    Create<BoundFunctorCallbackImpl<R (*)(TX,T1,T2,T3,T4),R,TX,T1,T2,T3,T4,empty,empty,empty,empty> > (fnPtr, a1);
+  BoundFunctorCallbackImpl<R (*)(TX,T1,T2,T3,T4),R,TX,T1,T2,T3,T4,empty,empty,empty,empty> impl (fnPtr, a1);
   return Callback<R,T1,T2,T3,T4> (impl);
 }
 template <typename R, typename TX, typename ARG,
           typename T1, typename T2,typename T3,typename T4,typename T5>
 Callback<R,T1,T2,T3,T4,T5> MakeBoundCallback (R (*fnPtr)(TX,T1,T2,T3,T4,T5), ARG a1) {
-  Ptr<CallbackImpl<R,T1,T2,T3,T4,T5,empty,empty,empty,empty> > impl =
-    Create<BoundFunctorCallbackImpl<R (*)(TX,T1,T2,T3,T4,T5),R,TX,T1,T2,T3,T4,T5,empty,empty,empty> > (fnPtr, a1);
+  BoundFunctorCallbackImpl<R (*)(TX,T1,T2,T3,T4,T5),R,TX,T1,T2,T3,T4,T5,empty,empty,empty> impl (fnPtr, a1);
   return Callback<R,T1,T2,T3,T4,T5> (impl);
 }
 template <typename R, typename TX, typename ARG,
           typename T1, typename T2,typename T3,typename T4,typename T5, typename T6>
 Callback<R,T1,T2,T3,T4,T5,T6> MakeBoundCallback (R (*fnPtr)(TX,T1,T2,T3,T4,T5,T6), ARG a1) {
-  Ptr<CallbackImpl<R,T1,T2,T3,T4,T5,T6,empty,empty,empty> > impl =
-    Create<BoundFunctorCallbackImpl<R (*)(TX,T1,T2,T3,T4,T5,T6),R,TX,T1,T2,T3,T4,T5,T6,empty,empty> > (fnPtr, a1);
+  BoundFunctorCallbackImpl<R (*)(TX,T1,T2,T3,T4,T5,T6),R,TX,T1,T2,T3,T4,T5,T6,empty,empty> impl (fnPtr, a1);
   return Callback<R,T1,T2,T3,T4,T5,T6> (impl);
 }
 template <typename R, typename TX, typename ARG,
           typename T1, typename T2,typename T3,typename T4,typename T5, typename T6, typename T7>
 Callback<R,T1,T2,T3,T4,T5,T6,T7> MakeBoundCallback (R (*fnPtr)(TX,T1,T2,T3,T4,T5,T6,T7), ARG a1) {
-  Ptr<CallbackImpl<R,T1,T2,T3,T4,T5,T6,T7,empty,empty> > impl =
-    Create<BoundFunctorCallbackImpl<R (*)(TX,T1,T2,T3,T4,T5,T6,T7),R,TX,T1,T2,T3,T4,T5,T6,T7,empty> > (fnPtr, a1);
+  BoundFunctorCallbackImpl<R (*)(TX,T1,T2,T3,T4,T5,T6,T7),R,TX,T1,T2,T3,T4,T5,T6,T7,empty> impl (fnPtr, a1);
   return Callback<R,T1,T2,T3,T4,T5,T6,T7> (impl);
 }
 template <typename R, typename TX, typename ARG,
           typename T1, typename T2,typename T3,typename T4,typename T5, typename T6, typename T7, typename T8>
 Callback<R,T1,T2,T3,T4,T5,T6,T7,T8> MakeBoundCallback (R (*fnPtr)(TX,T1,T2,T3,T4,T5,T6,T7,T8), ARG a1) {
-  Ptr<CallbackImpl<R,T1,T2,T3,T4,T5,T6,T7,T8,empty> > impl =
-    Create<BoundFunctorCallbackImpl<R (*)(TX,T1,T2,T3,T4,T5,T6,T7,T8),R,TX,T1,T2,T3,T4,T5,T6,T7,T8> > (fnPtr, a1);
+  BoundFunctorCallbackImpl<R (*)(TX,T1,T2,T3,T4,T5,T6,T7,T8),R,TX,T1,T2,T3,T4,T5,T6,T7,T8> impl (fnPtr, a1);
   return Callback<R,T1,T2,T3,T4,T5,T6,T7,T8> (impl);
 }
 /**@}*/
@@ -1757,57 +1938,49 @@ Callback<R,T1,T2,T3,T4,T5,T6,T7,T8> MakeBoundCallback (R (*fnPtr)(TX,T1,T2,T3,T4
  */
 template <typename R, typename TX1, typename TX2, typename ARG1, typename ARG2>
 Callback<R> MakeBoundCallback (R (*fnPtr)(TX1,TX2), ARG1 a1, ARG2 a2) {
-  Ptr<CallbackImpl<R,empty,empty,empty,empty,empty,empty,empty,empty,empty> > impl =
-    Create<TwoBoundFunctorCallbackImpl<R (*)(TX1,TX2),R,TX1,TX2,empty,empty,empty,empty,empty,empty,empty> >(fnPtr, a1, a2);
+  TwoBoundFunctorCallbackImpl<R (*)(TX1,TX2),R,TX1,TX2,empty,empty,empty,empty,empty,empty,empty> impl (fnPtr, a1, a2);
   return Callback<R> (impl);
 }
 template <typename R, typename TX1, typename TX2, typename ARG1, typename ARG2,
           typename T1>
 Callback<R,T1> MakeBoundCallback (R (*fnPtr)(TX1,TX2,T1), ARG1 a1, ARG2 a2) {
-  Ptr<CallbackImpl<R,T1,empty,empty,empty,empty,empty,empty,empty,empty> > impl =
-    Create<TwoBoundFunctorCallbackImpl<R (*)(TX1,TX2,T1),R,TX1,TX2,T1,empty,empty,empty,empty,empty,empty> > (fnPtr, a1, a2);
+  TwoBoundFunctorCallbackImpl<R (*)(TX1,TX2,T1),R,TX1,TX2,T1,empty,empty,empty,empty,empty,empty> impl (fnPtr, a1, a2);
   return Callback<R,T1> (impl);
 }
 template <typename R, typename TX1, typename TX2, typename ARG1, typename ARG2,
           typename T1, typename T2>
 Callback<R,T1,T2> MakeBoundCallback (R (*fnPtr)(TX1,TX2,T1,T2), ARG1 a1, ARG2 a2) {
-  Ptr<CallbackImpl<R,T1,T2,empty,empty,empty,empty,empty,empty,empty> > impl =
-    Create<TwoBoundFunctorCallbackImpl<R (*)(TX1,TX2,T1,T2),R,TX1,TX2,T1,T2,empty,empty,empty,empty,empty> > (fnPtr, a1, a2);
+  TwoBoundFunctorCallbackImpl<R (*)(TX1,TX2,T1,T2),R,TX1,TX2,T1,T2,empty,empty,empty,empty,empty> impl (fnPtr, a1, a2);
   return Callback<R,T1,T2> (impl);
 }
 template <typename R, typename TX1, typename TX2, typename ARG1, typename ARG2,
           typename T1, typename T2,typename T3>
 Callback<R,T1,T2,T3> MakeBoundCallback (R (*fnPtr)(TX1,TX2,T1,T2,T3), ARG1 a1, ARG2 a2) {
-  Ptr<CallbackImpl<R,T1,T2,T3,empty,empty,empty,empty,empty,empty> > impl =
-    Create<TwoBoundFunctorCallbackImpl<R (*)(TX1,TX2,T1,T2,T3),R,TX1,TX2,T1,T2,T3,empty,empty,empty,empty> > (fnPtr, a1, a2);
+  TwoBoundFunctorCallbackImpl<R (*)(TX1,TX2,T1,T2,T3),R,TX1,TX2,T1,T2,T3,empty,empty,empty,empty> impl (fnPtr, a1, a2);
   return Callback<R,T1,T2,T3> (impl);
 }
 template <typename R, typename TX1, typename TX2, typename ARG1, typename ARG2,
           typename T1, typename T2,typename T3,typename T4>
 Callback<R,T1,T2,T3,T4> MakeBoundCallback (R (*fnPtr)(TX1,TX2,T1,T2,T3,T4), ARG1 a1, ARG2 a2) {
-  Ptr<CallbackImpl<R,T1,T2,T3,T4,empty,empty,empty,empty,empty> > impl =
-    Create<TwoBoundFunctorCallbackImpl<R (*)(TX1,TX2,T1,T2,T3,T4),R,TX1,TX2,T1,T2,T3,T4,empty,empty,empty> > (fnPtr, a1, a2);
+  TwoBoundFunctorCallbackImpl<R (*)(TX1,TX2,T1,T2,T3,T4),R,TX1,TX2,T1,T2,T3,T4,empty,empty,empty> impl (fnPtr, a1, a2);
   return Callback<R,T1,T2,T3,T4> (impl);
 }
 template <typename R, typename TX1, typename TX2, typename ARG1, typename ARG2,
           typename T1, typename T2,typename T3,typename T4,typename T5>
 Callback<R,T1,T2,T3,T4,T5> MakeBoundCallback (R (*fnPtr)(TX1,TX2,T1,T2,T3,T4,T5), ARG1 a1, ARG2 a2) {
-  Ptr<CallbackImpl<R,T1,T2,T3,T4,T5,empty,empty,empty,empty> > impl =
-    Create<TwoBoundFunctorCallbackImpl<R (*)(TX1,TX2,T1,T2,T3,T4,T5),R,TX1,TX2,T1,T2,T3,T4,T5,empty,empty> > (fnPtr, a1, a2);
+  TwoBoundFunctorCallbackImpl<R (*)(TX1,TX2,T1,T2,T3,T4,T5),R,TX1,TX2,T1,T2,T3,T4,T5,empty,empty> impl (fnPtr, a1, a2);
   return Callback<R,T1,T2,T3,T4,T5> (impl);
 }
 template <typename R, typename TX1, typename TX2, typename ARG1, typename ARG2,
           typename T1, typename T2,typename T3,typename T4,typename T5, typename T6>
 Callback<R,T1,T2,T3,T4,T5,T6> MakeBoundCallback (R (*fnPtr)(TX1,TX2,T1,T2,T3,T4,T5,T6), ARG1 a1, ARG2 a2) {
-  Ptr<CallbackImpl<R,T1,T2,T3,T4,T5,T6,empty,empty,empty> > impl =
-    Create<TwoBoundFunctorCallbackImpl<R (*)(TX1,TX2,T1,T2,T3,T4,T5,T6),R,TX1,TX2,T1,T2,T3,T4,T5,T6,empty> > (fnPtr, a1, a2);
+  TwoBoundFunctorCallbackImpl<R (*)(TX1,TX2,T1,T2,T3,T4,T5,T6),R,TX1,TX2,T1,T2,T3,T4,T5,T6,empty> impl (fnPtr, a1, a2);
   return Callback<R,T1,T2,T3,T4,T5,T6> (impl);
 }
 template <typename R, typename TX1, typename TX2, typename ARG1, typename ARG2,
           typename T1, typename T2,typename T3,typename T4,typename T5, typename T6, typename T7>
 Callback<R,T1,T2,T3,T4,T5,T6,T7> MakeBoundCallback (R (*fnPtr)(TX1,TX2,T1,T2,T3,T4,T5,T6,T7), ARG1 a1, ARG2 a2) {
-  Ptr<CallbackImpl<R,T1,T2,T3,T4,T5,T6,T7,empty,empty> > impl =
-    Create<TwoBoundFunctorCallbackImpl<R (*)(TX1,TX2,T1,T2,T3,T4,T5,T6,T7),R,TX1,TX2,T1,T2,T3,T4,T5,T6,T7> > (fnPtr, a1, a2);
+  TwoBoundFunctorCallbackImpl<R (*)(TX1,TX2,T1,T2,T3,T4,T5,T6,T7),R,TX1,TX2,T1,T2,T3,T4,T5,T6,T7> impl (fnPtr, a1, a2);
   return Callback<R,T1,T2,T3,T4,T5,T6,T7> (impl);
 }
 /**@}*/
@@ -1824,50 +1997,43 @@ Callback<R,T1,T2,T3,T4,T5,T6,T7> MakeBoundCallback (R (*fnPtr)(TX1,TX2,T1,T2,T3,
  */
 template <typename R, typename TX1, typename TX2, typename TX3, typename ARG1, typename ARG2, typename ARG3>
 Callback<R> MakeBoundCallback (R (*fnPtr)(TX1,TX2,TX3), ARG1 a1, ARG2 a2, ARG3 a3) {
-  Ptr<CallbackImpl<R,empty,empty,empty,empty,empty,empty,empty,empty,empty> > impl =
-    Create<ThreeBoundFunctorCallbackImpl<R (*)(TX1,TX2,TX3),R,TX1,TX2,TX3,empty,empty,empty,empty,empty,empty> >(fnPtr, a1, a2, a3);
+  ThreeBoundFunctorCallbackImpl<R (*)(TX1,TX2,TX3),R,TX1,TX2,TX3,empty,empty,empty,empty,empty,empty> impl (fnPtr, a1, a2, a3);
   return Callback<R> (impl);
 }
 template <typename R, typename TX1, typename TX2, typename TX3, typename ARG1, typename ARG2, typename ARG3,
           typename T1>
 Callback<R,T1> MakeBoundCallback (R (*fnPtr)(TX1,TX2,TX3,T1), ARG1 a1, ARG2 a2, ARG3 a3) {
-  Ptr<CallbackImpl<R,T1,empty,empty,empty,empty,empty,empty,empty,empty> > impl =
-    Create<ThreeBoundFunctorCallbackImpl<R (*)(TX1,TX2,TX3,T1),R,TX1,TX2,TX3,T1,empty,empty,empty,empty,empty> > (fnPtr, a1, a2, a3);
+  ThreeBoundFunctorCallbackImpl<R (*)(TX1,TX2,TX3,T1),R,TX1,TX2,TX3,T1,empty,empty,empty,empty,empty> impl (fnPtr, a1, a2, a3);
   return Callback<R,T1> (impl);
 }
 template <typename R, typename TX1, typename TX2, typename TX3, typename ARG1, typename ARG2, typename ARG3,
           typename T1, typename T2>
 Callback<R,T1,T2> MakeBoundCallback (R (*fnPtr)(TX1,TX2,TX3,T1,T2), ARG1 a1, ARG2 a2, ARG3 a3) {
-  Ptr<CallbackImpl<R,T1,T2,empty,empty,empty,empty,empty,empty,empty> > impl =
-    Create<ThreeBoundFunctorCallbackImpl<R (*)(TX1,TX2,TX3,T1,T2),R,TX1,TX2,TX3,T1,T2,empty,empty,empty,empty> > (fnPtr, a1, a2, a3);
+  ThreeBoundFunctorCallbackImpl<R (*)(TX1,TX2,TX3,T1,T2),R,TX1,TX2,TX3,T1,T2,empty,empty,empty,empty> impl (fnPtr, a1, a2, a3);
   return Callback<R,T1,T2> (impl);
 }
 template <typename R, typename TX1, typename TX2, typename TX3, typename ARG1, typename ARG2, typename ARG3,
           typename T1, typename T2,typename T3>
 Callback<R,T1,T2,T3> MakeBoundCallback (R (*fnPtr)(TX1,TX2,TX3,T1,T2,T3), ARG1 a1, ARG2 a2, ARG3 a3) {
-  Ptr<CallbackImpl<R,T1,T2,T3,empty,empty,empty,empty,empty,empty> > impl =
-    Create<ThreeBoundFunctorCallbackImpl<R (*)(TX1,TX2,TX3,T1,T2,T3),R,TX1,TX2,TX3,T1,T2,T3,empty,empty,empty> > (fnPtr, a1, a2, a3);
+  ThreeBoundFunctorCallbackImpl<R (*)(TX1,TX2,TX3,T1,T2,T3),R,TX1,TX2,TX3,T1,T2,T3,empty,empty,empty> impl (fnPtr, a1, a2, a3);
   return Callback<R,T1,T2,T3> (impl);
 }
 template <typename R, typename TX1, typename TX2, typename TX3, typename ARG1, typename ARG2, typename ARG3,
           typename T1, typename T2,typename T3,typename T4>
 Callback<R,T1,T2,T3,T4> MakeBoundCallback (R (*fnPtr)(TX1,TX2,TX3,T1,T2,T3,T4), ARG1 a1, ARG2 a2, ARG3 a3) {
-  Ptr<CallbackImpl<R,T1,T2,T3,T4,empty,empty,empty,empty,empty> > impl =
-    Create<ThreeBoundFunctorCallbackImpl<R (*)(TX1,TX2,TX3,T1,T2,T3,T4),R,TX1,TX2,TX3,T1,T2,T3,T4,empty,empty> > (fnPtr, a1, a2, a3);
+  ThreeBoundFunctorCallbackImpl<R (*)(TX1,TX2,TX3,T1,T2,T3,T4),R,TX1,TX2,TX3,T1,T2,T3,T4,empty,empty> impl (fnPtr, a1, a2, a3);
   return Callback<R,T1,T2,T3,T4> (impl);
 }
 template <typename R, typename TX1, typename TX2, typename TX3, typename ARG1, typename ARG2, typename ARG3,
           typename T1, typename T2,typename T3,typename T4,typename T5>
 Callback<R,T1,T2,T3,T4,T5> MakeBoundCallback (R (*fnPtr)(TX1,TX2,TX3,T1,T2,T3,T4,T5), ARG1 a1, ARG2 a2, ARG3 a3) {
-  Ptr<CallbackImpl<R,T1,T2,T3,T4,T5,empty,empty,empty,empty> > impl =
-    Create<ThreeBoundFunctorCallbackImpl<R (*)(TX1,TX2,TX3,T1,T2,T3,T4,T5),R,TX1,TX2,TX3,T1,T2,T3,T4,T5,empty> > (fnPtr, a1, a2, a3);
+  ThreeBoundFunctorCallbackImpl<R (*)(TX1,TX2,TX3,T1,T2,T3,T4,T5),R,TX1,TX2,TX3,T1,T2,T3,T4,T5,empty> impl (fnPtr, a1, a2, a3);
   return Callback<R,T1,T2,T3,T4,T5> (impl);
 }
 template <typename R, typename TX1, typename TX2, typename TX3, typename ARG1, typename ARG2, typename ARG3,
           typename T1, typename T2,typename T3,typename T4,typename T5, typename T6>
 Callback<R,T1,T2,T3,T4,T5,T6> MakeBoundCallback (R (*fnPtr)(TX1,TX2,TX3,T1,T2,T3,T4,T5,T6), ARG1 a1, ARG2 a2, ARG3 a3) {
-  Ptr<CallbackImpl<R,T1,T2,T3,T4,T5,T6,empty,empty,empty> > impl =
-    Create<ThreeBoundFunctorCallbackImpl<R (*)(TX1,TX2,TX3,T1,T2,T3,T4,T5,T6),R,TX1,TX2,TX3,T1,T2,T3,T4,T5,T6> > (fnPtr, a1, a2, a3);
+  ThreeBoundFunctorCallbackImpl<R (*)(TX1,TX2,TX3,T1,T2,T3,T4,T5,T6),R,TX1,TX2,TX3,T1,T2,T3,T4,T5,T6> impl (fnPtr, a1, a2, a3);
   return Callback<R,T1,T2,T3,T4,T5,T6> (impl);
 }
 /**@}*/
@@ -26,6 +26,8 @@
 #include "pointer.h"
 #include "log.h"
 
+#include <algorithm>
+#include <map>
 #include <sstream>
 
 /**
@@ -167,6 +169,17 @@ public:
    * \returns \c true if the index matches the Config Path.
    */
   bool Matches (uint32_t i) const;
+  /**
+   * List the indices which match the Config Path, if they are all
+   * below a bound.
+   *
+   * \param [in] n The bound.
+   * \param [in,out] indices The list the matching indices are added to,
+   *                 in no particular order and maybe more than once.
+   * \returns \c false if the Config Path contains a wildcard, or
+   *          matches an index which is not below \p n.
+   */
+  bool GetIndices (uint32_t n, std::vector<uint32_t> *indices) const;
 private:
   /**
    * Convert a string to an \c uint32_t.
@@ -251,6 +264,61 @@ ArrayMatcher::Matches (uint32_t i) const
   return false;
 }
 
+bool
+ArrayMatcher::GetIndices (uint32_t n, std::vector<uint32_t> *indices) const
+{
+  NS_LOG_FUNCTION (this << n << indices);
+  if (m_element == "*")
+    {
+      return false;
+    }
+  // Parse the element as Matches() does.
+  std::string::size_type tmp;
+  tmp = m_element.find ("|");
+  if (tmp != std::string::npos)
+    {
+      std::string left = m_element.substr (0, tmp-0);
+      std::string right = m_element.substr (tmp+1, m_element.size () - (tmp + 1));
+      return ArrayMatcher (left).GetIndices (n, indices)
+        && ArrayMatcher (right).GetIndices (n, indices);
+    }
+  std::string::size_type leftBracket = m_element.find ("[");
+  std::string::size_type rightBracket = m_element.find ("]");
+  std::string::size_type dash = m_element.find ("-");
+  if (leftBracket == 0 && rightBracket == m_element.size () - 1 &&
+      dash > leftBracket && dash < rightBracket)
+    {
+      std::string lowerBound = m_element.substr (leftBracket + 1, dash - (leftBracket + 1));
+      std::string upperBound = m_element.substr (dash + 1, rightBracket - (dash + 1));
+      uint32_t min;
+      uint32_t max;
+      if (StringToUint32 (lowerBound, &min) && 
+          StringToUint32 (upperBound, &max) &&
+          min <= max)
+        {
+          if (max >= n)
+            {
+              return false;
+            }
+          for (uint32_t i = min; i <= max; i++)
+            {
+              indices->push_back (i);
+            }
+        }
+      return true;
+    }
+  uint32_t value;
+  if (StringToUint32 (m_element, &value))
+    {
+      if (value >= n)
+        {
+          return false;
+        }
+      indices->push_back (value);
+    }
+  return true;
+}
+
 bool
 ArrayMatcher::StringToUint32 (std::string str, uint32_t *value) const
 {
@@ -261,6 +329,103 @@ ArrayMatcher::StringToUint32 (std::string str, uint32_t *value) const
   return !iss.bad () && !iss.fail ();
 }
 
+/**
+ * \ingroup config-impl
+ * An attribute a Config path can go through: a pointer or a container.
+ */
+struct PathAttribute
+{
+  std::string name;  //!< The attribute name.
+  bool pointer;      //!< \c true for a pointer, \c false for a container.
+  /**
+   * The accessor ObjectBase::GetAttribute() uses for the name, or 0 if
+   * it cannot get the attribute.
+   */
+  Ptr<const AttributeAccessor> accessor;
+};
+
+/**
+ * \ingroup config-impl
+ * Find the attributes a Config path element can go through on an object.
+ *
+ * The attributes of each type and element are looked up once, rather
+ * than by walking the attributes of the type and its parents on every
+ * resolution.
+ *
+ * \param [in] tid The type of the object.
+ * \param [in] item The path element, an attribute name or \c "*".
+ * \returns The matching attributes of \p tid and of its parents.
+ */
+static const std::vector<PathAttribute> &
+GetPathAttributes (TypeId tid, const std::string &item)
+{
+  NS_LOG_FUNCTION (tid << item);
+  /**
+   * The attributes by type and element, with the number of attributes
+   * of the type and its parents when they were looked up.
+   */
+  typedef std::map<std::pair<uint16_t, std::string>,
+                   std::pair<uint32_t, std::vector<PathAttribute> > > Table;
+  static Table table;
+
+  uint32_t n = 0;
+  TypeId t;
+  TypeId next = tid;
+  do
+    {
+      t = next;
+      n += t.GetAttributeN ();
+      next = t.GetParent ();
+    } while (next != t);
+
+  std::pair<uint32_t, std::vector<PathAttribute> > &entry = table[std::make_pair (tid.GetUid (), item)];
+  if (entry.first == n)
+    {
+      return entry.second;
+    }
+  // New, or attributes were added since.
+  entry.first = n;
+  entry.second.clear ();
+  next = tid;
+  do
+    {
+      t = next;
+      for (uint32_t i = 0; i < t.GetAttributeN (); i++)
+        {
+          struct TypeId::AttributeInformation info = t.GetAttribute (i);
+          if (info.name != item && item != "*")
+            {
+              continue;
+            }
+          PathAttribute attribute;
+          attribute.name = info.name;
+          if (dynamic_cast<const PointerChecker *> (PeekPointer (info.checker)) != 0)
+            {
+              attribute.pointer = true;
+            }
+          else if (dynamic_cast<const ObjectPtrContainerChecker *> (PeekPointer (info.checker)) != 0)
+            {
+              attribute.pointer = false;
+            }
+          else
+            {
+              // this could be anything else and we don't know what to do with it.
+              // So, we just ignore it.
+              continue;
+            }
+          struct TypeId::AttributeInformation found;
+          if (tid.LookupAttributeByName (info.name, &found)
+              && (found.flags & TypeId::ATTR_GET) && found.accessor->HasGetter ())
+            {
+              attribute.accessor = found.accessor;
+            }
+          entry.second.push_back (attribute);
+        }
+      next = t.GetParent ();
+    } while (next != t);
+  return entry.second;
+}
+
 /**
  * \ingroup config-impl
  * Abstract class to parse Config paths into object references.
@@ -301,9 +466,10 @@ private:
    * Parse an index on the Config path.
    *
    * \param [in] path The remaining Config path.
-   * \param [in,out] vector The resulting list of matching objects.
+   * \param [in] root The object holding the container.
+   * \param [in] attribute The container attribute.
    */
-  void DoArrayResolve (std::string path, const ObjectPtrContainerValue &vector);
+  void DoArrayResolve (std::string path, Ptr<Object> root, const PathAttribute &attribute);
   /**
    * Handle one object found on the path.
    *
@@ -483,61 +649,42 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
   else 
     {
       // this is a normal attribute.
-      TypeId tid;
-      TypeId nextTid = root->GetInstanceTypeId ();
+      const std::vector<PathAttribute> &attributes =
+        GetPathAttributes (root->GetInstanceTypeId (), item);
       bool foundMatch = false;
-      
-      do
+      for (std::vector<PathAttribute>::const_iterator i = attributes.begin ();
+           i != attributes.end (); i++)
         {
-          tid = nextTid;
-          
-          for (uint32_t i = 0; i < tid.GetAttributeN(); i++)
+          if (i->pointer)
             {
-              struct TypeId::AttributeInformation info;
-              info = tid.GetAttribute(i);
-              if (info.name != item && item != "*")
-                {
-                  continue;
-                }
-              // attempt to cast to a pointer checker.
-              const PointerChecker *ptr = dynamic_cast<const PointerChecker *> (PeekPointer (info.checker));
-              if (ptr != 0)
+              NS_LOG_DEBUG ("GetAttribute(ptr)="<<i->name<<" on path="<<GetResolvedPath ());
+              PointerValue ptr;
+              if (i->accessor == 0 || !i->accessor->Get (PeekPointer (root), ptr))
                 {
-                  NS_LOG_DEBUG ("GetAttribute(ptr)="<<info.name<<" on path="<<GetResolvedPath ());
-                  PointerValue ptr;
-                  root->GetAttribute (info.name, ptr);
-                  Ptr<Object> object = ptr.Get<Object> ();
-                  if (object == 0)
-                    {
-                      NS_LOG_ERROR ("Requested object name=\""<<item<<
-                                    "\" exists on path=\""<<GetResolvedPath ()<<"\""
-                                    " but is null.");
-                      continue;
-                    }
-                  foundMatch = true;
-                  m_workStack.push_back (info.name);
-                  DoResolve (pathLeft, object);
-                  m_workStack.pop_back ();
+                  root->GetAttribute (i->name, ptr);
                 }
-              // attempt to cast to an object vector.
-              const ObjectPtrContainerChecker *vectorChecker = 
-                dynamic_cast<const ObjectPtrContainerChecker *> (PeekPointer (info.checker));
-              if (vectorChecker != 0)
+              Ptr<Object> object = ptr.Get<Object> ();
+              if (object == 0)
                 {
-                  NS_LOG_DEBUG ("GetAttribute(vector)="<<info.name<<" on path="<<GetResolvedPath () << pathLeft);
-                  foundMatch = true;
-                  ObjectPtrContainerValue vector;
-                  root->GetAttribute (info.name, vector);
-                  m_workStack.push_back (info.name);
-                  DoArrayResolve (pathLeft, vector);
-                  m_workStack.pop_back ();
+                  NS_LOG_ERROR ("Requested object name=\""<<item<<
+                                "\" exists on path=\""<<GetResolvedPath ()<<"\""
+                                " but is null.");
+                  continue;
                 }
-              // this could be anything else and we don't know what to do with it.
-              // So, we just ignore it.
+              foundMatch = true;
+              m_workStack.push_back (i->name);
+              DoResolve (pathLeft, object);
+              m_workStack.pop_back ();
             }
-
-          nextTid = tid.GetParent ();
-        } while (nextTid != tid);
+          else
+            {
+              NS_LOG_DEBUG ("GetAttribute(vector)="<<i->name<<" on path="<<GetResolvedPath () << pathLeft);
+              foundMatch = true;
+              m_workStack.push_back (i->name);
+              DoArrayResolve (pathLeft, root, *i);
+              m_workStack.pop_back ();
+            }
+        }
       
       if (!foundMatch)
         {
@@ -548,9 +695,9 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
 }
 
 void 
-Resolver::DoArrayResolve (std::string path, const ObjectPtrContainerValue &container)
+Resolver::DoArrayResolve (std::string path, Ptr<Object> root, const PathAttribute &attribute)
 {
-  NS_LOG_FUNCTION(this << path << &container);
+  NS_LOG_FUNCTION(this << path << root << attribute.name);
   NS_ASSERT (path != "");
   NS_ASSERT ((path.find ("/")) == 0);
   std::string::size_type next = path.find ("/", 1);
@@ -562,6 +709,50 @@ Resolver::DoArrayResolve (std::string path, const ObjectPtrContainerValue &conta
   std::string pathLeft = path.substr (next, path.size ()-next);
 
   ArrayMatcher matcher = ArrayMatcher (item);
+
+  //
+  // Without wildcard, get the matching indices straight from the container
+  // rather than copying all of it, as long as indices are positions, as in
+  // an ObjectVector.  The indices of an ObjectMap are keys, which may be
+  // sparse: go through all of it unless every index matched is below its
+  // size and is the key of the item at that position.
+  //
+  const ObjectPtrContainerAccessor *accessor =
+    dynamic_cast<const ObjectPtrContainerAccessor *> (PeekPointer (attribute.accessor));
+  uint32_t n;
+  std::vector<uint32_t> indices;
+  if (accessor != 0 && accessor->GetN (PeekPointer (root), &n)
+      && matcher.GetIndices (n, &indices))
+    {
+      std::sort (indices.begin (), indices.end ());
+      indices.erase (std::unique (indices.begin (), indices.end ()), indices.end ());
+      std::vector<Ptr<Object> > objects;
+      for (std::vector<uint32_t>::const_iterator i = indices.begin (); i != indices.end (); ++i)
+        {
+          uint32_t index;
+          Ptr<Object> object = accessor->Get (PeekPointer (root), *i, &index);
+          if (index != *i)
+            {
+              break;
+            }
+          objects.push_back (object);
+        }
+      if (objects.size () == indices.size ())
+        {
+          for (uint32_t i = 0; i < indices.size (); ++i)
+            {
+              std::ostringstream oss;
+              oss << indices[i];
+              m_workStack.push_back (oss.str ());
+              DoResolve (pathLeft, objects[i]);
+              m_workStack.pop_back ();
+            }
+          return;
+        }
+    }
+
+  ObjectPtrContainerValue container;
+  root->GetAttribute (attribute.name, container);
   ObjectPtrContainerValue::Iterator it;
   for (it = container.Begin (); it != container.End (); ++it)
     {
@@ -589,6 +780,14 @@ public:
   void ConnectWithoutContext (std::string path, const CallbackBase &cb);
   /** \copydoc Config::Connect() */
   void Connect (std::string path, const CallbackBase &cb);
+  /**
+   * Connect a batch of sinks, resolving each distinct root path once.
+   * \param [in] paths The paths to match trace sources.
+   * \param [in] cbs The callbacks to connect, one for each path.
+   * \param [in] context Whether the callbacks receive the context string.
+   */
+  void Connect (const std::vector<std::string> &paths,
+                const std::vector<CallbackBase> &cbs, bool context);
   /** \copydoc Config::DisconnectWithoutContext() */
   void DisconnectWithoutContext (std::string path, const CallbackBase &cb);
   /** \copydoc Config::Disconnect() */
@@ -674,6 +873,36 @@ ConfigImpl::Connect (std::string path, const CallbackBase &cb)
   MatchContainer container = LookupMatches (root);
   container.Connect (leaf, cb);
 }
+void
+ConfigImpl::Connect (const std::vector<std::string> &paths,
+                     const std::vector<CallbackBase> &cbs, bool context)
+{
+  NS_LOG_FUNCTION (this << paths.size () << cbs.size () << context);
+  NS_ASSERT_MSG (paths.size () == cbs.size (),
+                 "Config::Connect(): " << paths.size () << " paths for "
+                 << cbs.size () << " callbacks");
+
+  // Resolve each distinct root only once.
+  std::map<std::string, MatchContainer> containers;
+  for (uint32_t i = 0; i < paths.size (); i++)
+    {
+      std::string root, leaf;
+      ParsePath (paths[i], &root, &leaf);
+      std::map<std::string, MatchContainer>::iterator it = containers.find (root);
+      if (it == containers.end ())
+        {
+          it = containers.insert (std::make_pair (root, LookupMatches (root))).first;
+        }
+      if (context)
+        {
+          it->second.Connect (leaf, cbs[i]);
+        }
+      else
+        {
+          it->second.ConnectWithoutContext (leaf, cbs[i]);
+        }
+    }
+}
 void 
 ConfigImpl::Disconnect (std::string path, const CallbackBase &cb)
 {
@@ -845,6 +1074,20 @@ Connect (std::string path, const CallbackBase &cb)
   NS_LOG_FUNCTION (path << &cb);
   ConfigImpl::Get ()->Connect (path, cb);
 }
+void
+ConnectWithoutContext (const std::vector<std::string> &paths,
+                       const std::vector<CallbackBase> &cbs)
+{
+  NS_LOG_FUNCTION (paths.size () << cbs.size ());
+  ConfigImpl::Get ()->Connect (paths, cbs, false);
+}
+void
+Connect (const std::vector<std::string> &paths,
+         const std::vector<CallbackBase> &cbs)
+{
+  NS_LOG_FUNCTION (paths.size () << cbs.size ());
+  ConfigImpl::Get ()->Connect (paths, cbs, true);
+}
 void 
 Disconnect (std::string path, const CallbackBase &cb)
 {
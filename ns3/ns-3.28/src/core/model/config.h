@@ -139,6 +139,30 @@ void Connect (std::string path, const CallbackBase &cb);
  * This function undoes the work of Config::ConnectWithContext.
  */
 void Disconnect (std::string path, const CallbackBase &cb);
+/**
+ * \ingroup config
+ * \param [in] paths The paths to match trace sources.
+ * \param [in] cbs The callbacks to connect, one for each path.
+ *
+ * This function connects each callback as ConnectWithoutContext()
+ * would, but resolves the part of the paths up to the trace source
+ * name only once for all the paths sharing it, as when connecting
+ * several trace sources of the same objects.
+ */
+void ConnectWithoutContext (const std::vector<std::string> &paths,
+                            const std::vector<CallbackBase> &cbs);
+/**
+ * \ingroup config
+ * \param [in] paths The paths to match trace sources.
+ * \param [in] cbs The callbacks to connect, one for each path.
+ *
+ * This function connects each callback as Connect() would, but
+ * resolves the part of the paths up to the trace source name only
+ * once for all the paths sharing it, as when connecting several
+ * trace sources of the same objects.
+ */
+void Connect (const std::vector<std::string> &paths,
+              const std::vector<CallbackBase> &cbs);
 
 /**
  * \ingroup config
@@ -22,13 +22,17 @@
 #include "default-simulator-impl.h"
 #include "scheduler.h"
 #include "event-impl.h"
+#include "event-profiler.h"
 
 #include "ptr.h"
 #include "pointer.h"
+#include "double.h"
+#include "uinteger.h"
 #include "assert.h"
 #include "log.h"
 
 #include <cmath>
+#include <vector>
 
 
 /**
@@ -53,6 +57,26 @@ DefaultSimulatorImpl::GetTypeId (void)
     .SetParent<SimulatorImpl> ()
     .SetGroupName ("Core")
     .AddConstructor<DefaultSimulatorImpl> ()
+    .AddAttribute ("PurgeRatio",
+                   "Purge the cancelled events from the event queue when they "
+                   "make up more than this fraction of it. 1 disables purging.",
+                   DoubleValue (0.5),
+                   MakeDoubleAccessor (&DefaultSimulatorImpl::m_purgeRatio),
+                   MakeDoubleChecker<double> (0.0, 1.0))
+    .AddAttribute ("PurgeMinEvents",
+                   "Do not purge the event queue before it holds at least "
+                   "this many cancelled events.",
+                   UintegerValue (1024),
+                   MakeUintegerAccessor (&DefaultSimulatorImpl::m_purgeMinEvents),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("EventsWithContextCapacity",
+                   "Number of events scheduled from other threads which can "
+                   "wait in the lock free queue, rounded up to a power of two. "
+                   "Past that, they wait in a list protected by a mutex; "
+                   "0 always uses the list.",
+                   UintegerValue (1024),
+                   MakeUintegerAccessor (&DefaultSimulatorImpl::m_eventsWithContextCapacity),
+                   MakeUintegerChecker<uint32_t> ())
   ;
   return tid;
 }
@@ -71,13 +95,30 @@ DefaultSimulatorImpl::DefaultSimulatorImpl ()
   m_currentTs = 0;
   m_currentContext = Simulator::NO_CONTEXT;
   m_unscheduledEvents = 0;
+  m_cancelledEvents = 0;
+  m_purges = 0;
+  m_eventsWithContextCapacity = 0;
   m_eventsWithContextEmpty = true;
+  m_profiler = 0;
   m_main = SystemThread::Self();
 }
 
 DefaultSimulatorImpl::~DefaultSimulatorImpl ()
 {
   NS_LOG_FUNCTION (this);
+  delete m_profiler;
+}
+
+void
+DefaultSimulatorImpl::NotifyConstructionCompleted (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_eventsWithContextRing.SetCapacity (m_eventsWithContextCapacity);
+  if (EventProfiler::IsEnabled ())
+    {
+      m_profiler = new EventProfiler ();
+    }
+  SimulatorImpl::NotifyConstructionCompleted ();
 }
 
 void
@@ -108,6 +149,12 @@ DefaultSimulatorImpl::Destroy ()
           ev->Invoke ();
         }
     }
+  if (m_profiler != 0)
+    {
+      m_profiler->Dump ();
+      delete m_profiler;
+      m_profiler = 0;
+    }
 }
 
 void
@@ -141,12 +188,28 @@ DefaultSimulatorImpl::ProcessOneEvent (void)
 
   NS_ASSERT (next.key.m_ts >= m_currentTs);
   m_unscheduledEvents--;
+  if (next.impl->IsCancelled () && m_cancelledEvents > 0)
+    {
+      m_cancelledEvents--;
+    }
 
   NS_LOG_LOGIC ("handle " << next.key.m_ts);
   m_currentTs = next.key.m_ts;
   m_currentContext = next.key.m_context;
   m_currentUid = next.key.m_uid;
-  next.impl->Invoke ();
+  if (m_profiler == 0)
+    {
+      next.impl->Invoke ();
+    }
+  else
+    {
+      // Before the event runs, which may delete the object it calls.
+      const void *function = next.impl->GetFunction ();
+      uint64_t start = EventProfiler::GetWallClock ();
+      next.impl->Invoke ();
+      m_profiler->Record (function, next.impl, next.key.m_context,
+                          EventProfiler::GetWallClock () - start);
+    }
   next.impl->Unref ();
 
   ProcessEventsWithContext ();
@@ -161,33 +224,56 @@ DefaultSimulatorImpl::IsFinished (void) const
 void
 DefaultSimulatorImpl::ProcessEventsWithContext (void)
 {
-  if (m_eventsWithContextEmpty)
+  bool listEmpty = m_eventsWithContextEmpty.load (std::memory_order_acquire);
+  if (listEmpty && m_eventsWithContextRing.IsEmpty ())
     {
       return;
     }
 
-  // swap queues
+  // Take the list first: every event a thread put in the ring before
+  // one of its events in the list is then in the ring already.
   EventsWithContext eventsWithContext;
-  {
-    CriticalSection cs (m_eventsWithContextMutex);
-    m_eventsWithContext.swap(eventsWithContext);
-    m_eventsWithContextEmpty = true;
-  }
+  if (!listEmpty)
+    {
+      CriticalSection cs (m_eventsWithContextMutex);
+      m_eventsWithContext.swap (eventsWithContext);
+    }
+  EventWithContext event;
+  for (uint32_t i = 0; i < m_eventsWithContextRing.GetCapacity ()
+       && m_eventsWithContextRing.Pop (event); ++i)
+    {
+      InsertEventWithContext (event);
+    }
   while (!eventsWithContext.empty ())
     {
-       EventWithContext event = eventsWithContext.front ();
-       eventsWithContext.pop_front ();
-       Scheduler::Event ev;
-       ev.impl = event.event;
-       ev.key.m_ts = m_currentTs + event.timestamp;
-       ev.key.m_context = event.context;
-       ev.key.m_uid = m_uid;
-       m_uid++;
-       m_unscheduledEvents++;
-       m_events->Insert (ev);
+      InsertEventWithContext (eventsWithContext.front ());
+      eventsWithContext.pop_front ();
+    }
+  if (!listEmpty)
+    {
+      // Let threads use the ring again only once everything they put in
+      // the list is in the event queue.
+      CriticalSection cs (m_eventsWithContextMutex);
+      if (m_eventsWithContext.empty ())
+        {
+          m_eventsWithContextEmpty.store (true, std::memory_order_release);
+        }
     }
 }
 
+void
+DefaultSimulatorImpl::InsertEventWithContext (const EventWithContext &event)
+{
+  Scheduler::Event ev;
+  ev.impl = event.event;
+  ev.key.m_ts = m_currentTs + event.timestamp;
+  ev.key.m_context = event.context;
+  ev.key.m_uid = m_uid;
+  m_uid++;
+  m_unscheduledEvents++;
+  m_events->Insert (ev);
+}
+
 void
 DefaultSimulatorImpl::Run (void)
 {
@@ -269,10 +355,15 @@ DefaultSimulatorImpl::ScheduleWithContext (uint32_t context, Time const &delay,
       // Current time added in ProcessEventsWithContext()
       ev.timestamp = delay.GetTimeStep ();
       ev.event = event;
+      if (m_eventsWithContextEmpty.load (std::memory_order_acquire)
+          && m_eventsWithContextRing.Push (ev))
+        {
+          return;
+        }
       {
         CriticalSection cs (m_eventsWithContextMutex);
         m_eventsWithContext.push_back(ev);
-        m_eventsWithContextEmpty = false;
+        m_eventsWithContextEmpty.store (false, std::memory_order_release);
       }
     }
 }
@@ -363,9 +454,49 @@ DefaultSimulatorImpl::Cancel (const EventId &id)
   if (!IsExpired (id))
     {
       id.PeekEventImpl ()->Cancel ();
+      if (id.GetUid () == 2)
+        {
+          // destroy events are not in the event queue.
+          return;
+        }
+      m_cancelledEvents++;
+      if (m_cancelledEvents >= static_cast<int> (m_purgeMinEvents)
+          && m_cancelledEvents > m_purgeRatio * m_unscheduledEvents)
+        {
+          Purge ();
+        }
     }
 }
 
+void
+DefaultSimulatorImpl::Purge (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_LOG_LOGIC ("purge " << m_cancelledEvents << " cancelled out of "
+                << m_unscheduledEvents << " events");
+  std::vector<Scheduler::Event> live;
+  live.reserve (m_unscheduledEvents - m_cancelledEvents);
+  while (!m_events->IsEmpty ())
+    {
+      Scheduler::Event next = m_events->RemoveNext ();
+      if (next.impl->IsCancelled ())
+        {
+          next.impl->Unref ();
+          m_unscheduledEvents--;
+        }
+      else
+        {
+          live.push_back (next);
+        }
+    }
+  for (std::vector<Scheduler::Event>::const_iterator i = live.begin (); i != live.end (); ++i)
+    {
+      m_events->Insert (*i);
+    }
+  m_cancelledEvents = 0;
+  m_purges++;
+}
+
 bool
 DefaultSimulatorImpl::IsExpired (const EventId &id) const
 {
@@ -412,4 +543,22 @@ DefaultSimulatorImpl::GetContext (void) const
   return m_currentContext;
 }
 
+uint32_t
+DefaultSimulatorImpl::GetEventCount (void) const
+{
+  return m_unscheduledEvents;
+}
+
+uint32_t
+DefaultSimulatorImpl::GetCancelledEventCount (void) const
+{
+  return m_cancelledEvents;
+}
+
+uint32_t
+DefaultSimulatorImpl::GetPurgeCount (void) const
+{
+  return m_purges;
+}
+
 } // namespace ns3
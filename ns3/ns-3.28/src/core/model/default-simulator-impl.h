@@ -26,9 +26,11 @@
 #include "event-impl.h"
 #include "system-thread.h"
 #include "system-mutex.h"
+#include "mpsc-ring.h"
 
 #include "ptr.h"
 
+#include <atomic>
 #include <list>
 
 /**
@@ -39,6 +41,8 @@
 
 namespace ns3 {
 
+class EventProfiler;
+
 /**
  * \ingroup simulator
  *
@@ -78,13 +82,41 @@ public:
   virtual uint32_t GetSystemId (void) const; 
   virtual uint32_t GetContext (void) const;
 
+  /**
+   * Get the number of events in the event queue, including the events
+   * which were cancelled but not removed yet.
+   *
+   * \returns The number of queued events.
+   */
+  uint32_t GetEventCount (void) const;
+  /**
+   * Get the number of events in the event queue which were cancelled
+   * with Simulator::Cancel() and are waiting to be discarded.
+   *
+   * \returns The number of cancelled events.
+   */
+  uint32_t GetCancelledEventCount (void) const;
+  /**
+   * Get the number of times the cancelled events were purged from the
+   * event queue.
+   *
+   * \returns The number of purges.
+   */
+  uint32_t GetPurgeCount (void) const;
+
 private:
   virtual void DoDispose (void);
+  virtual void NotifyConstructionCompleted (void);
 
   /** Process the next event. */
   void ProcessOneEvent (void);
   /** Move events from a different context into the main event queue. */
   void ProcessEventsWithContext (void);
+  /**
+   * Remove the cancelled events from the event queue, to keep them
+   * from slowing down the scheduler.
+   */
+  void Purge (void);
  
   /** Wrap an event with its execution context. */
   struct EventWithContext {
@@ -95,15 +127,30 @@ private:
     /** The event implementation. */
     EventImpl *event;
   };
+  /**
+   * Insert an event from a different context in the event queue.
+   *
+   * \param [in] event The event, with its delay from now.
+   */
+  void InsertEventWithContext (const EventWithContext &event);
   /** Container type for the events from a different context. */
   typedef std::list<struct EventWithContext> EventsWithContext;
-  /** The container of events from a different context. */
+  /**
+   * Lock free queue of the events from a different context.  When it is
+   * full, events go to m_eventsWithContext instead, and keep doing so
+   * until that list has been drained, so that the events of each thread
+   * stay in order.
+   */
+  MpscRing<struct EventWithContext> m_eventsWithContextRing;
+  /** Number of cells of m_eventsWithContextRing. */
+  uint32_t m_eventsWithContextCapacity;
+  /** The overflow container of events from a different context. */
   EventsWithContext m_eventsWithContext;
   /**
-   * Flag \c true if all events with context have been moved to the
-   * primary event queue.
+   * Flag \c true if m_eventsWithContext is empty, so that other threads
+   * can use m_eventsWithContextRing.
    */
-  bool m_eventsWithContextEmpty;
+  std::atomic<bool> m_eventsWithContextEmpty;
   /** Mutex to control access to the list of events with context. */
   SystemMutex m_eventsWithContextMutex;
 
@@ -129,6 +176,20 @@ private:
    *  not counting the Destroy events; this is used for validation
    */
   int m_unscheduledEvents;
+  /** Number of cancelled events still in the event queue. */
+  int m_cancelledEvents;
+  /** Number of times the cancelled events were purged. */
+  uint32_t m_purges;
+  /** Fraction of cancelled events in the queue which triggers a purge. */
+  double m_purgeRatio;
+  /** Minimum number of cancelled events in the queue before a purge. */
+  uint32_t m_purgeMinEvents;
+
+  /**
+   * The event profiler, if the "EventProfiler" GlobalValue was true
+   * when the simulator was created, 0 otherwise.
+   */
+  EventProfiler *m_profiler;
 
   /** Main execution thread. */
   SystemThread::ThreadId m_main;
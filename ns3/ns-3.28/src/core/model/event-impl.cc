@@ -20,6 +20,9 @@
 
 #include "event-impl.h"
 #include "log.h"
+#include "memory-accounting.h"
+#include <new>
+#include <atomic>
 
 /**
  * \file
@@ -31,6 +34,314 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("EventImpl");
 
+namespace {
+
+/** Granularity of the event pool size classes, in bytes. */
+const std::size_t EVENT_POOL_ALIGN = 16;
+/** Number of event pool size classes. */
+const std::size_t EVENT_POOL_CLASSES = EventImpl::MAX_POOLED_SIZE / EVENT_POOL_ALIGN;
+
+struct EventPool;
+
+/**
+ * Header of a block, before the storage of the event.  Its size is
+ * EVENT_POOL_ALIGN, so the event stays aligned.
+ */
+struct EventBlock
+{
+  EventPool *owner;    /**< Pool of the thread which allocated the block, or 0 if oversized. */
+  uint32_t sizeClass;  /**< Size class of the block. */
+  bool accounted;      /**< Whether the event is counted in MemoryAccounting. */
+};
+
+static_assert (sizeof (EventBlock) <= EVENT_POOL_ALIGN, "EventBlock does not fit its header");
+
+/** A free block, linked through the first word of its event storage. */
+struct FreeEvent
+{
+  FreeEvent *next; /**< Next free block. */
+};
+
+/** The free lists of one thread. */
+struct EventPool
+{
+  FreeEvent *free[EVENT_POOL_CLASSES];   /**< Free blocks, per size class. */
+  uint32_t nFree[EVENT_POOL_CLASSES];    /**< Length of each free list. */
+  /** Blocks freed by other threads, or &g_closedEventPool once the thread exited. */
+  std::atomic<FreeEvent *> remote;
+  /** Blocks of the pool, plus one while its thread runs. */
+  std::atomic<uint64_t> refs;
+};
+
+/** Marks the remote list of a pool whose thread exited. */
+FreeEvent g_closedEventPool;
+
+/** Pool of the calling thread, created on first use. */
+thread_local EventPool *g_eventPool = 0;
+/** Whether the pool of the calling thread was already released. */
+thread_local bool g_eventPoolExited = false;
+/** Pool statistics of the calling thread. */
+thread_local EventImpl::PoolStats g_eventPoolStats;
+
+/**
+ * \param [in] size Size of an event, in bytes.
+ * \returns The size class of the event.
+ */
+inline uint32_t
+EventPoolClass (std::size_t size)
+{
+  return (size - 1) / EVENT_POOL_ALIGN;
+}
+
+/**
+ * \param [in] event The storage of an event.
+ * \returns The header of its block.
+ */
+inline EventBlock *
+GetEventBlock (void *event)
+{
+  return reinterpret_cast<EventBlock *> (static_cast<char *> (event) - EVENT_POOL_ALIGN);
+}
+
+/**
+ * Drop references to a pool, and delete it with the last one.
+ *
+ * \param [in] pool The pool.
+ * \param [in] refs The number of references to drop.
+ */
+void
+ReleaseEventPool (EventPool *pool, uint64_t refs)
+{
+  if (pool->refs.fetch_sub (refs, std::memory_order_acq_rel) == refs)
+    {
+      delete pool;
+    }
+}
+
+/**
+ * Return a free block to the system.
+ *
+ * \param [in] event The storage of the event.
+ */
+void
+DeleteEventBlock (FreeEvent *event)
+{
+  EventBlock *block = GetEventBlock (event);
+  EventPool *owner = block->owner;
+  ::operator delete (block);
+  ReleaseEventPool (owner, 1);
+}
+
+/**
+ * Put a free block on a free list of the pool of the calling thread, or
+ * return it to the system if that list is full.
+ *
+ * \param [in] pool The pool of the calling thread.
+ * \param [in] event The storage of the event.
+ */
+void
+PushFreeEvent (EventPool *pool, FreeEvent *event)
+{
+  uint32_t sizeClass = GetEventBlock (event)->sizeClass;
+  if (pool->nFree[sizeClass] >= EventImpl::MAX_FREE_EVENTS)
+    {
+      g_eventPoolStats.released++;
+      DeleteEventBlock (event);
+      return;
+    }
+  event->next = pool->free[sizeClass];
+  pool->free[sizeClass] = event;
+  pool->nFree[sizeClass]++;
+}
+
+/**
+ * Hand a free block back to the pool which allocated it, from another
+ * thread.  The block is returned to the system if that thread exited.
+ *
+ * \param [in] owner The pool of the block.
+ * \param [in] event The storage of the event.
+ */
+void
+PushRemoteEvent (EventPool *owner, FreeEvent *event)
+{
+  FreeEvent *head = owner->remote.load (std::memory_order_relaxed);
+  do
+    {
+      if (head == &g_closedEventPool)
+        {
+          DeleteEventBlock (event);
+          return;
+        }
+      event->next = head;
+    }
+  while (!owner->remote.compare_exchange_weak (head, event,
+                                               std::memory_order_release,
+                                               std::memory_order_relaxed));
+}
+
+/**
+ * Move the blocks handed back by other threads to the free lists.
+ *
+ * \param [in] pool The pool of the calling thread.
+ */
+void
+ReclaimRemoteEvents (EventPool *pool)
+{
+  FreeEvent *event = pool->remote.exchange (0, std::memory_order_acquire);
+  while (event != 0)
+    {
+      FreeEvent *next = event->next;
+      PushFreeEvent (pool, event);
+      event = next;
+    }
+}
+
+/** Releases the pool of a thread when the thread exits. */
+struct EventPoolGuard
+{
+  /** Return every free block to the system and close the remote list. */
+  ~EventPoolGuard ()
+  {
+    EventPool *pool = g_eventPool;
+    g_eventPool = 0;
+    g_eventPoolExited = true;
+    FreeEvent *event = pool->remote.exchange (&g_closedEventPool, std::memory_order_acquire);
+    while (event != 0)
+      {
+        FreeEvent *next = event->next;
+        DeleteEventBlock (event);
+        event = next;
+      }
+    for (std::size_t i = 0; i < EVENT_POOL_CLASSES; ++i)
+      {
+        event = pool->free[i];
+        while (event != 0)
+          {
+            FreeEvent *next = event->next;
+            DeleteEventBlock (event);
+            event = next;
+          }
+      }
+    ReleaseEventPool (pool, 1);
+  }
+};
+
+/** Registered with the first pool of each thread. */
+thread_local EventPoolGuard g_eventPoolGuard;
+
+/**
+ * \returns The pool of the calling thread.
+ */
+inline EventPool *
+GetEventPool (void)
+{
+  EventPool *pool = g_eventPool;
+  if (pool == 0)
+    {
+      pool = new EventPool ();
+      pool->remote.store (0);
+      pool->refs.store (1);
+      g_eventPool = pool;
+      if (!g_eventPoolExited)
+        {
+          // Odr-use the guard so that its destructor runs at thread exit.
+          (void) &g_eventPoolGuard;
+        }
+    }
+  return pool;
+}
+
+/**
+ * \returns The index of the events in MemoryAccounting.
+ */
+uint32_t
+GetAccountingIndex (void)
+{
+  static uint32_t index = MemoryAccounting::Register ("ns3::EventImpl");
+  return index;
+}
+
+} // unnamed namespace
+
+void *
+EventImpl::operator new (std::size_t size)
+{
+  g_eventPoolStats.allocations++;
+  bool accounted = MemoryAccounting::IsEnabled ();
+  if (accounted)
+    {
+      MemoryAccounting::Allocate (GetAccountingIndex (), size);
+    }
+  if (size > MAX_POOLED_SIZE)
+    {
+      g_eventPoolStats.oversized++;
+      EventBlock *block = static_cast<EventBlock *> (::operator new (EVENT_POOL_ALIGN + size));
+      block->owner = 0;
+      block->sizeClass = EVENT_POOL_CLASSES;
+      block->accounted = accounted;
+      return reinterpret_cast<char *> (block) + EVENT_POOL_ALIGN;
+    }
+  EventPool *pool = GetEventPool ();
+  uint32_t sizeClass = EventPoolClass (size);
+  if (pool->free[sizeClass] == 0
+      && pool->remote.load (std::memory_order_relaxed) != 0)
+    {
+      ReclaimRemoteEvents (pool);
+    }
+  FreeEvent *event = pool->free[sizeClass];
+  if (event != 0)
+    {
+      g_eventPoolStats.hits++;
+      pool->free[sizeClass] = event->next;
+      pool->nFree[sizeClass]--;
+      GetEventBlock (event)->accounted = accounted;
+      return event;
+    }
+  g_eventPoolStats.refills++;
+  pool->refs.fetch_add (1, std::memory_order_relaxed);
+  EventBlock *block = static_cast<EventBlock *>
+    (::operator new (EVENT_POOL_ALIGN + (sizeClass + 1) * EVENT_POOL_ALIGN));
+  block->owner = pool;
+  block->sizeClass = sizeClass;
+  block->accounted = accounted;
+  return reinterpret_cast<char *> (block) + EVENT_POOL_ALIGN;
+}
+
+void
+EventImpl::operator delete (void *p, std::size_t size)
+{
+  if (p == 0)
+    {
+      return;
+    }
+  if (GetEventBlock (p)->accounted)
+    {
+      MemoryAccounting::Deallocate (GetAccountingIndex (), size);
+    }
+  if (size > MAX_POOLED_SIZE)
+    {
+      ::operator delete (GetEventBlock (p));
+      return;
+    }
+  FreeEvent *event = static_cast<FreeEvent *> (p);
+  EventPool *owner = GetEventBlock (p)->owner;
+  if (owner == g_eventPool)
+    {
+      PushFreeEvent (owner, event);
+    }
+  else
+    {
+      g_eventPoolStats.remote++;
+      PushRemoteEvent (owner, event);
+    }
+}
+
+EventImpl::PoolStats
+EventImpl::GetPoolStats (void)
+{
+  return g_eventPoolStats;
+}
+
 EventImpl::~EventImpl ()
 {
   NS_LOG_FUNCTION (this);
@@ -66,4 +377,10 @@ EventImpl::IsCancelled (void)
   return m_cancel;
 }
 
+const void *
+EventImpl::GetFunction (void) const
+{
+  return 0;
+}
+
 } // namespace ns3
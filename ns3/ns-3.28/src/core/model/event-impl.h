@@ -21,6 +21,7 @@
 #define EVENT_IMPL_H
 
 #include <stdint.h>
+#include <cstddef>
 #include "simple-ref-count.h"
 
 /**
@@ -65,6 +66,56 @@ public:
    * Checked by the simulation engine before calling Invoke().
    */
   bool IsCancelled (void);
+  /**
+   * \returns The address of the function this event calls, or 0 if it
+   *          is not known.  EventProfiler names events after it.
+   */
+  virtual const void * GetFunction (void) const;
+
+  /**
+   * Allocate the storage of an event.
+   *
+   * Events are small and short lived, so their storage is recycled
+   * through per-thread free lists, one per 16 byte size class, each
+   * holding at most MAX_FREE_EVENTS blocks.  Every block records the
+   * pool of the thread which allocated it: an event freed by another
+   * thread is handed back to that pool, and the blocks of a thread are
+   * returned to the system when it exits.  Events larger than
+   * MAX_POOLED_SIZE bytes use the global operator new, behind the same
+   * block header.
+   *
+   * \param [in] size The size of the event, in bytes.
+   * \returns Storage for the event.
+   */
+  static void * operator new (std::size_t size);
+  /**
+   * Release the storage of an event to the free list of its size class,
+   * or to the system if that list is full.
+   *
+   * \param [in] p The storage to release.
+   * \param [in] size The size of the event, in bytes.
+   */
+  static void operator delete (void *p, std::size_t size);
+
+  /** Allocation statistics of the event pool of the calling thread. */
+  struct PoolStats
+  {
+    uint64_t allocations; /**< Number of events allocated. */
+    uint64_t hits;        /**< Allocations served from a free list. */
+    uint64_t oversized;   /**< Allocations too large to be pooled. */
+    uint64_t refills;     /**< Blocks taken from the system. */
+    uint64_t released;    /**< Blocks returned to the system from a full free list. */
+    uint64_t remote;      /**< Events freed by a thread other than their allocator. */
+  };
+  /**
+   * \returns The event pool statistics of the calling thread.
+   */
+  static PoolStats GetPoolStats (void);
+
+  /** Events up to this size, in bytes, are pooled. */
+  static const std::size_t MAX_POOLED_SIZE = 256;
+  /** Maximum number of free blocks kept per size class and thread. */
+  static const uint32_t MAX_FREE_EVENTS = 1024;
 
 protected:
   /**
@@ -0,0 +1,384 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "event-profiler.h"
+#include "event-impl.h"
+#include "simulator.h"
+#include "global-value.h"
+#include "boolean.h"
+#include "string.h"
+#include "log.h"
+#include "ns3/core-config.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cxxabi.h>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#ifdef HAVE_DLFCN_H
+#include <dlfcn.h>
+#endif
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::EventProfiler implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("EventProfiler");
+
+/**
+ * \ingroup simulator
+ * Whether the simulator profiles the events it runs.
+ *
+ * This is accessible as "--EventProfiler" from CommandLine.
+ */
+static GlobalValue g_eventProfiler ("EventProfiler",
+                                    "Measure the wall clock time spent in each "
+                                    "type of event and report it at Simulator::Destroy",
+                                    BooleanValue (false),
+                                    MakeBooleanChecker ());
+/**
+ * \ingroup simulator
+ * The file the EventProfiler writes its entries to.
+ *
+ * This is accessible as "--EventProfilerFile" from CommandLine.
+ */
+static GlobalValue g_eventProfilerFile ("EventProfilerFile",
+                                        "The JSON file the event profile is written to, "
+                                        "or empty for none",
+                                        StringValue ("event-profile.json"),
+                                        MakeStringChecker ());
+
+namespace {
+
+/**
+ * \param [in] name A mangled name.
+ * \returns The demangled name, or \p name if it is not mangled.
+ */
+std::string
+Demangle (std::string name)
+{
+  int status;
+  char *demangled = abi::__cxa_demangle (name.c_str (), NULL, NULL, &status);
+  if (status == 0 && demangled != 0)
+    {
+      name = demangled;
+    }
+  std::free (demangled);
+  return name;
+}
+
+/**
+ * Name a function after its symbol.
+ *
+ * \param [in] function The address of the function.
+ * \returns The demangled name of the symbol at that address, or an
+ *          empty string if the dynamic linker does not know it.
+ */
+std::string
+GetFunctionName (const void *function)
+{
+#ifdef HAVE_DLFCN_H
+  Dl_info info;
+  if (function != 0 && dladdr (function, &info) != 0
+      && info.dli_sname != 0 && info.dli_saddr == function)
+    {
+      return Demangle (info.dli_sname);
+    }
+#endif
+  return "";
+}
+
+/**
+ * Name an event type.
+ *
+ * Events made by MakeEvent() are local classes of that function
+ * template: keep its template arguments, which identify the function
+ * called, and drop the rest.
+ *
+ * \param [in] type The type of the event.
+ * \returns The name of the type.
+ */
+std::string
+GetEventName (const std::type_info *type)
+{
+  std::string name = Demangle (type->name ());
+
+  std::string::size_type start = name.find ("ns3::MakeEvent<");
+  if (start == std::string::npos)
+    {
+      return name;
+    }
+  start += std::string ("ns3::MakeEvent<").size ();
+  int depth = 1;
+  for (std::string::size_type i = start; i < name.size (); ++i)
+    {
+      if (name[i] == '<')
+        {
+          depth++;
+        }
+      else if (name[i] == '>' && --depth == 0)
+        {
+          return name.substr (start, i - start);
+        }
+    }
+  return name;
+}
+
+/**
+ * \param [in] context A context.
+ * \returns The context as printed in the report.
+ */
+std::string
+GetContextName (uint32_t context)
+{
+  if (context == Simulator::NO_CONTEXT)
+    {
+      return "-";
+    }
+  std::ostringstream oss;
+  oss << context;
+  return oss.str ();
+}
+
+/** Order entries by decreasing total time. */
+struct Slower
+{
+  /**
+   * \param [in] a An entry.
+   * \param [in] b Another entry.
+   * \returns \c true if \p a took more time than \p b.
+   */
+  bool operator () (const EventProfiler::Entry &a, const EventProfiler::Entry &b) const
+  {
+    if (a.ns != b.ns)
+      {
+        return a.ns > b.ns;
+      }
+    if (a.name != b.name)
+      {
+        return a.name < b.name;
+      }
+    return a.context < b.context;
+  }
+};
+
+} // unnamed namespace
+
+EventProfiler::EventProfiler ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+bool
+EventProfiler::IsEnabled (void)
+{
+  BooleanValue enabled;
+  g_eventProfiler.GetValue (enabled);
+  return enabled.Get ();
+}
+
+uint64_t
+EventProfiler::GetWallClock (void)
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>
+           (std::chrono::steady_clock::now ().time_since_epoch ()).count ();
+}
+
+void
+EventProfiler::Record (const void *function, const EventImpl *event, uint32_t context, uint64_t ns)
+{
+  Key key = { function, &typeid (*event), context };
+  Stats &stats = m_stats[key];
+  stats.count++;
+  stats.ns += ns;
+}
+
+std::vector<EventProfiler::Entry>
+EventProfiler::GetEntries (void) const
+{
+  // Several type_infos may stand for one type across libraries, and
+  // MakeEvent() names may collapse: merge entries by name.
+  std::map<std::pair<const void *, const std::type_info *>, std::string> names;
+  std::map<std::pair<std::string, uint32_t>, Stats> merged;
+  for (std::unordered_map<Key, Stats, KeyHash>::const_iterator i = m_stats.begin ();
+       i != m_stats.end (); ++i)
+    {
+      std::pair<const void *, const std::type_info *> id (i->first.function, i->first.type);
+      std::map<std::pair<const void *, const std::type_info *>, std::string>::iterator n = names.find (id);
+      if (n == names.end ())
+        {
+          std::string name = GetFunctionName (i->first.function);
+          if (name.empty ())
+            {
+              // Unknown symbol: fall back to the type of the event, and
+              // keep apart the functions of the same signature.
+              std::ostringstream oss;
+              oss << GetEventName (i->first.type);
+              if (i->first.function != 0)
+                {
+                  oss << " at " << i->first.function;
+                }
+              name = oss.str ();
+            }
+          n = names.insert (std::make_pair (id, name)).first;
+        }
+      Stats &stats = merged[std::make_pair (n->second, i->first.context)];
+      stats.count += i->second.count;
+      stats.ns += i->second.ns;
+    }
+  std::vector<Entry> entries;
+  for (std::map<std::pair<std::string, uint32_t>, Stats>::const_iterator i = merged.begin ();
+       i != merged.end (); ++i)
+    {
+      Entry entry = { i->first.first, i->first.second, i->second.count, i->second.ns };
+      entries.push_back (entry);
+    }
+  std::sort (entries.begin (), entries.end (), Slower ());
+  return entries;
+}
+
+void
+EventProfiler::Report (std::ostream &os) const
+{
+  std::vector<Entry> entries = GetEntries ();
+  std::map<std::string, Entry> types;
+  std::map<uint32_t, Entry> contexts;
+  uint64_t total = 0;
+  uint64_t count = 0;
+  for (std::vector<Entry>::const_iterator i = entries.begin (); i != entries.end (); ++i)
+    {
+      Entry &type = types[i->name];
+      type.name = i->name;
+      type.count += i->count;
+      type.ns += i->ns;
+      Entry &context = contexts[i->context];
+      context.context = i->context;
+      context.count += i->count;
+      context.ns += i->ns;
+      total += i->ns;
+      count += i->count;
+    }
+  std::vector<Entry> byType;
+  for (std::map<std::string, Entry>::const_iterator i = types.begin (); i != types.end (); ++i)
+    {
+      byType.push_back (i->second);
+    }
+  std::sort (byType.begin (), byType.end (), Slower ());
+  std::vector<Entry> byContext;
+  for (std::map<uint32_t, Entry>::const_iterator i = contexts.begin (); i != contexts.end (); ++i)
+    {
+      byContext.push_back (i->second);
+    }
+  std::sort (byContext.begin (), byContext.end (), Slower ());
+
+  std::ios::fmtflags flags = os.flags ();
+  std::streamsize precision = os.precision ();
+  os << "Event profile: " << count << " events, "
+     << std::fixed << std::setprecision (3) << total / 1e6 << " ms" << std::endl;
+  os << std::right << std::setw (7) << "%"
+     << std::setw (14) << "ms"
+     << std::setw (12) << "events"
+     << std::setw (10) << "ns/event"
+     << "  type" << std::endl;
+  for (std::vector<Entry>::const_iterator i = byType.begin (); i != byType.end (); ++i)
+    {
+      os << std::setw (7) << std::setprecision (2) << (total ? 100.0 * i->ns / total : 0.0)
+         << std::setw (14) << std::setprecision (3) << i->ns / 1e6
+         << std::setw (12) << i->count
+         << std::setw (10) << i->ns / i->count
+         << "  " << i->name << std::endl;
+    }
+  os << std::setw (7) << "%"
+     << std::setw (14) << "ms"
+     << std::setw (12) << "events"
+     << std::setw (10) << "ns/event"
+     << "  context (top 10)" << std::endl;
+  for (uint32_t i = 0; i < byContext.size () && i < 10; ++i)
+    {
+      const Entry &e = byContext[i];
+      os << std::setw (7) << std::setprecision (2) << (total ? 100.0 * e.ns / total : 0.0)
+         << std::setw (14) << std::setprecision (3) << e.ns / 1e6
+         << std::setw (12) << e.count
+         << std::setw (10) << e.ns / e.count
+         << "  " << GetContextName (e.context) << std::endl;
+    }
+  os.flags (flags);
+  os.precision (precision);
+}
+
+void
+EventProfiler::Write (std::ostream &os) const
+{
+  std::vector<Entry> entries = GetEntries ();
+  os << "{" << std::endl;
+  os << " \"simulator_name\" : \"ns-3\"," << std::endl;
+  os << " \"events\" : [";
+  for (std::vector<Entry>::const_iterator i = entries.begin (); i != entries.end (); ++i)
+    {
+      os << (i == entries.begin () ? "" : ",") << std::endl;
+      os << "  { \"type\" : \"";
+      for (std::string::const_iterator c = i->name.begin (); c != i->name.end (); ++c)
+        {
+          if (*c == '"' || *c == '\\')
+            {
+              os << '\\';
+            }
+          os << *c;
+        }
+      os << "\", \"context\" : ";
+      if (i->context == Simulator::NO_CONTEXT)
+        {
+          os << "null";
+        }
+      else
+        {
+          os << i->context;
+        }
+      os << ", \"count\" : " << i->count
+         << ", \"wall_ns\" : " << i->ns << " }";
+    }
+  os << std::endl << " ]" << std::endl;
+  os << "}" << std::endl;
+}
+
+void
+EventProfiler::Dump (void) const
+{
+  NS_LOG_FUNCTION (this);
+  Report (std::clog);
+  StringValue file;
+  g_eventProfilerFile.GetValue (file);
+  if (file.Get () == "")
+    {
+      return;
+    }
+  std::ofstream os (file.Get ().c_str ());
+  if (!os.is_open ())
+    {
+      NS_LOG_UNCOND ("EventProfiler: cannot open " << file.Get ());
+      return;
+    }
+  Write (os);
+}
+
+} // namespace ns3
@@ -0,0 +1,154 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef EVENT_PROFILER_H
+#define EVENT_PROFILER_H
+
+#include <stdint.h>
+#include <iostream>
+#include <string>
+#include <typeinfo>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::EventProfiler declaration.
+ */
+
+namespace ns3 {
+
+class EventImpl;
+
+/**
+ * \ingroup simulator
+ * \brief Wall clock time spent in each kind of event.
+ *
+ * When the "EventProfiler" GlobalValue is true, DefaultSimulatorImpl
+ * times every event it runs and adds the time to the type of the event
+ * and its context, usually the node id.  The events made by MakeEvent(),
+ * as by Simulator::Schedule(), are grouped by the function they call,
+ * named after its symbol when the dynamic linker knows it, as for the
+ * functions of the ns-3 libraries, and else after the type of the
+ * event, which holds the signature of the function, and its address.
+ * Other events are named after their type.
+ *
+ * Simulator::Destroy() prints a report to std::clog, sorted by total
+ * time, and writes every (type, context) entry as JSON to the file
+ * named by the "EventProfilerFile" GlobalValue.
+ */
+class EventProfiler
+{
+public:
+  /** The statistics of one type of event in one context. */
+  struct Entry
+  {
+    std::string name;   /**< The demangled type of the event. */
+    uint32_t context;   /**< The context, or Simulator::NO_CONTEXT. */
+    uint64_t count;     /**< The number of events run. */
+    uint64_t ns;        /**< The wall clock time spent in them, in ns. */
+  };
+
+  /** Constructor. */
+  EventProfiler ();
+
+  /**
+   * \returns \c true if the simulator should profile events, as set by
+   *          the "EventProfiler" GlobalValue.
+   */
+  static bool IsEnabled (void);
+  /**
+   * \returns A monotonic wall clock time, in ns.
+   */
+  static uint64_t GetWallClock (void);
+
+  /**
+   * Account for one event.
+   *
+   * \param [in] function The function it called, from
+   *            EventImpl::GetFunction() before it ran.
+   * \param [in] event The event.
+   * \param [in] context The context it ran in.
+   * \param [in] ns The wall clock time it took, in ns.
+   */
+  void Record (const void *function, const EventImpl *event, uint32_t context, uint64_t ns);
+  /**
+   * \returns Every (type, context) entry, by decreasing total time.
+   */
+  std::vector<Entry> GetEntries (void) const;
+  /**
+   * Print the time spent in each type of event, summed over contexts,
+   * followed by the contexts which took the most time.
+   *
+   * \param [in] os The output stream.
+   */
+  void Report (std::ostream &os) const;
+  /**
+   * Write every entry as JSON.
+   *
+   * \param [in] os The output stream.
+   */
+  void Write (std::ostream &os) const;
+  /**
+   * Print the report to std::clog and write the entries to the file
+   * named by the "EventProfilerFile" GlobalValue.
+   */
+  void Dump (void) const;
+
+private:
+  /** The key of the entries. */
+  struct Key
+  {
+    const void *function;        /**< The function called, or 0 if unknown. */
+    const std::type_info *type;  /**< The type of the event. */
+    uint32_t context;            /**< The context. */
+    /**
+     * \param [in] o Another key.
+     * \returns \c true if both keys are equal.
+     */
+    bool operator == (const Key &o) const
+    {
+      return function == o.function && type == o.type && context == o.context;
+    }
+  };
+  /** Hash of a Key. */
+  struct KeyHash
+  {
+    /**
+     * \param [in] k The key.
+     * \returns The hash of the key.
+     */
+    size_t operator () (const Key &k) const
+    {
+      return std::hash<const void *> () (k.function) ^ std::hash<const void *> () (k.type)
+             ^ (size_t (k.context) * 0x9e3779b97f4a7c15ULL);
+    }
+  };
+  /** The statistics of an entry, before its type is demangled. */
+  struct Stats
+  {
+    uint64_t count;  /**< The number of events run. */
+    uint64_t ns;     /**< The wall clock time spent in them, in ns. */
+  };
+
+  /** The statistics of each (type, context). */
+  std::unordered_map<Key, Stats, KeyHash> m_stats;
+};
+
+} // namespace ns3
+
+#endif /* EVENT_PROFILER_H */
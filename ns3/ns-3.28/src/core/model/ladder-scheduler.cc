@@ -0,0 +1,396 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ladder-scheduler.h"
+#include "event-impl.h"
+#include "assert.h"
+#include "log.h"
+#include <algorithm>
+#include <limits>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * ns3::LadderScheduler class implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LadderScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED (LadderScheduler);
+
+namespace {
+
+/** Buckets with at most this many events are sorted into the bottom. */
+const uint32_t LADDER_THRESHOLD = 50;
+/** Maximum number of rungs. */
+const uint32_t LADDER_MAX_RUNGS = 8;
+/** Maximum number of buckets in a rung. */
+const uint32_t LADDER_MAX_BUCKETS = 4096;
+/** A bottom with more events than this is spilled to a new rung. */
+const uint32_t LADDER_MAX_BOTTOM = 1024;
+
+/**
+ * \param [in] ts A timestamp.
+ * \returns The timestamp right after ts, saturating at the largest one.
+ */
+uint64_t
+NextTs (uint64_t ts)
+{
+  return ts == std::numeric_limits<uint64_t>::max () ? ts : ts + 1;
+}
+
+} // unnamed namespace
+
+TypeId
+LadderScheduler::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::LadderScheduler")
+    .SetParent<Scheduler> ()
+    .SetGroupName ("Core")
+    .AddConstructor<LadderScheduler> ()
+  ;
+  return tid;
+}
+
+LadderScheduler::LadderScheduler ()
+  : m_topMin (0),
+    m_topMax (0),
+    m_topStart (0),
+    m_rungs (LADDER_MAX_RUNGS),
+    m_nRungs (0),
+    m_bottomHead (0),
+    m_count (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+LadderScheduler::~LadderScheduler ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+uint64_t
+LadderScheduler::Rung::BucketStart (uint32_t i) const
+{
+  return i < nBuckets ? start + i * width : end;
+}
+
+uint64_t
+LadderScheduler::Rung::BucketEnd (uint32_t i) const
+{
+  return i + 1 < nBuckets ? start + (i + 1) * width : end;
+}
+
+uint32_t
+LadderScheduler::Rung::BucketIndex (uint64_t ts) const
+{
+  // The last bucket also holds everything up to the end of the rung.
+  uint64_t i = (ts - start) / width;
+  return i < nBuckets ? static_cast<uint32_t> (i) : nBuckets - 1;
+}
+
+uint64_t
+LadderScheduler::BottomEnd (void) const
+{
+  if (m_nRungs == 0)
+    {
+      return m_topStart;
+    }
+  const Rung &rung = m_rungs[m_nRungs - 1];
+  return rung.BucketStart (rung.current);
+}
+
+void
+LadderScheduler::Insert (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+  uint64_t ts = ev.key.m_ts;
+  if (m_count == 0)
+    {
+      m_nRungs = 0;
+      m_bottom.clear ();
+      m_bottomHead = 0;
+      m_bottom.push_back (ev);
+      m_topStart = NextTs (ts);
+      m_count = 1;
+      return;
+    }
+  m_count++;
+  if (ts >= m_topStart)
+    {
+      if (m_top.empty ())
+        {
+          m_topMin = ts;
+          m_topMax = ts;
+        }
+      else
+        {
+          m_topMin = std::min (m_topMin, ts);
+          m_topMax = std::max (m_topMax, ts);
+        }
+      m_top.push_back (ev);
+      return;
+    }
+  if (ts < BottomEnd ())
+    {
+      InsertBottom (ev);
+      return;
+    }
+  // The rungs cover consecutive intervals, the finest one first.
+  for (uint32_t i = m_nRungs; i-- > 0; )
+    {
+      Rung &rung = m_rungs[i];
+      if (ts < rung.end)
+        {
+          rung.buckets[rung.BucketIndex (ts)].push_back (ev);
+          rung.count++;
+          return;
+        }
+    }
+  NS_ASSERT_MSG (false, "Event " << ts << " does not belong to any tier");
+}
+
+bool
+LadderScheduler::IsEmpty (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_count == 0;
+}
+
+Scheduler::Event
+LadderScheduler::PeekNext (void) const
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (m_count > 0);
+  return m_bottom[m_bottomHead];
+}
+
+Scheduler::Event
+LadderScheduler::RemoveNext (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (m_count > 0);
+  Event ev = m_bottom[m_bottomHead];
+  m_bottomHead++;
+  m_count--;
+  if (m_bottomHead == m_bottom.size ())
+    {
+      m_bottom.clear ();
+      m_bottomHead = 0;
+      Refill ();
+    }
+  NS_LOG_DEBUG ("remove " << ev.impl << " at " << ev.key.m_ts);
+  return ev;
+}
+
+void
+LadderScheduler::Remove (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+  NS_ASSERT (m_count > 0);
+  uint64_t ts = ev.key.m_ts;
+  if (ts < BottomEnd ())
+    {
+      Bucket::iterator i = std::lower_bound (m_bottom.begin () + m_bottomHead,
+                                             m_bottom.end (), ev);
+      NS_ASSERT (i != m_bottom.end () && i->impl == ev.impl);
+      if (i == m_bottom.begin () + m_bottomHead)
+        {
+          m_bottomHead++;
+        }
+      else
+        {
+          m_bottom.erase (i);
+        }
+    }
+  else
+    {
+      Bucket *bucket = &m_top;
+      Rung *rung = 0;
+      if (ts < m_topStart)
+        {
+          for (uint32_t i = m_nRungs; i-- > 0; )
+            {
+              if (ts < m_rungs[i].end)
+                {
+                  rung = &m_rungs[i];
+                  bucket = &rung->buckets[rung->BucketIndex (ts)];
+                  break;
+                }
+            }
+        }
+      Bucket::iterator i = bucket->begin ();
+      while (i != bucket->end () && i->key.m_uid != ev.key.m_uid)
+        {
+          ++i;
+        }
+      NS_ASSERT (i != bucket->end () && i->impl == ev.impl);
+      // Buckets are not sorted, so the order does not need to be kept.
+      *i = bucket->back ();
+      bucket->pop_back ();
+      if (rung != 0)
+        {
+          rung->count--;
+        }
+    }
+  m_count--;
+  if (m_bottomHead == m_bottom.size ())
+    {
+      m_bottom.clear ();
+      m_bottomHead = 0;
+      Refill ();
+    }
+}
+
+void
+LadderScheduler::InsertBottom (const Event &ev)
+{
+  Bucket::iterator i = std::upper_bound (m_bottom.begin () + m_bottomHead,
+                                         m_bottom.end (), ev);
+  if (i == m_bottom.begin () + m_bottomHead && m_bottomHead > 0)
+    {
+      // New earliest event: reuse the slot of the last one removed.
+      m_bottomHead--;
+      m_bottom[m_bottomHead] = ev;
+    }
+  else
+    {
+      m_bottom.insert (i, ev);
+    }
+  uint32_t size = m_bottom.size () - m_bottomHead;
+  if (size > LADDER_MAX_BOTTOM && m_nRungs < LADDER_MAX_RUNGS
+      && m_bottom[m_bottomHead].key.m_ts != m_bottom.back ().key.m_ts)
+    {
+      // Too many events were inserted before the end of the bottom, for
+      // instance far before the first event ever inserted: bucket them.
+      NS_LOG_DEBUG ("spill " << size << " events from the bottom");
+      m_bottom.erase (m_bottom.begin (), m_bottom.begin () + m_bottomHead);
+      m_bottomHead = 0;
+      uint64_t min = m_bottom.front ().key.m_ts;
+      uint64_t max = m_bottom.back ().key.m_ts;
+      AddRung (m_bottom, min, max, BottomEnd ());
+      Refill ();
+    }
+}
+
+void
+LadderScheduler::BucketToBottom (Bucket &bucket)
+{
+  NS_ASSERT (m_bottom.empty ());
+  // Swap rather than copy so that both vectors keep their storage.
+  m_bottom.swap (bucket);
+  m_bottomHead = 0;
+  // Bursts at one timestamp are usually inserted in uid order already.
+  if (!std::is_sorted (m_bottom.begin (), m_bottom.end ()))
+    {
+      std::sort (m_bottom.begin (), m_bottom.end ());
+    }
+}
+
+void
+LadderScheduler::AddRung (Bucket &bucket, uint64_t min, uint64_t max, uint64_t end)
+{
+  NS_ASSERT (m_nRungs < LADDER_MAX_RUNGS);
+  Rung &rung = m_rungs[m_nRungs];
+  m_nRungs++;
+  uint32_t nBuckets = std::min<uint32_t> (bucket.size (), LADDER_MAX_BUCKETS);
+  rung.start = min;
+  rung.width = (max - min) / nBuckets + 1;
+  rung.end = end;
+  rung.current = 0;
+  rung.nBuckets = nBuckets;
+  rung.count = bucket.size ();
+  if (rung.buckets.size () < nBuckets)
+    {
+      rung.buckets.resize (nBuckets);
+    }
+  for (Bucket::const_iterator i = bucket.begin (); i != bucket.end (); ++i)
+    {
+      rung.buckets[rung.BucketIndex (i->key.m_ts)].push_back (*i);
+    }
+  bucket.clear ();
+  NS_LOG_DEBUG ("rung " << m_nRungs - 1 << ": " << rung.count << " events in "
+                        << nBuckets << " buckets of " << rung.width);
+}
+
+void
+LadderScheduler::TopToLadder (void)
+{
+  NS_ASSERT (m_nRungs == 0 && !m_top.empty ());
+  if (m_top.size () <= LADDER_THRESHOLD || m_topMin == m_topMax)
+    {
+      m_topStart = NextTs (m_topMax);
+      BucketToBottom (m_top);
+      return;
+    }
+  // Rung 0 ends where the new top starts; its last bucket ends past m_topMax.
+  uint32_t nBuckets = std::min<uint32_t> (m_top.size (), LADDER_MAX_BUCKETS);
+  uint64_t width = (m_topMax - m_topMin) / nBuckets + 1;
+  m_topStart = m_topMin + nBuckets * width;
+  AddRung (m_top, m_topMin, m_topMax, m_topStart);
+}
+
+void
+LadderScheduler::Refill (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (m_bottom.empty ());
+  while (m_count > 0)
+    {
+      if (m_nRungs == 0)
+        {
+          TopToLadder ();
+          if (!m_bottom.empty ())
+            {
+              return;
+            }
+          continue;
+        }
+      Rung &rung = m_rungs[m_nRungs - 1];
+      while (rung.current < rung.nBuckets && rung.buckets[rung.current].empty ())
+        {
+          rung.current++;
+        }
+      if (rung.current == rung.nBuckets)
+        {
+          NS_ASSERT (rung.count == 0);
+          m_nRungs--;
+          continue;
+        }
+      Bucket &bucket = rung.buckets[rung.current];
+      uint64_t end = rung.BucketEnd (rung.current);
+      rung.current++;
+      rung.count -= bucket.size ();
+      uint64_t min = bucket.front ().key.m_ts;
+      uint64_t max = min;
+      for (Bucket::const_iterator i = bucket.begin (); i != bucket.end (); ++i)
+        {
+          min = std::min (min, i->key.m_ts);
+          max = std::max (max, i->key.m_ts);
+        }
+      if (bucket.size () <= LADDER_THRESHOLD || min == max
+          || m_nRungs == LADDER_MAX_RUNGS)
+        {
+          BucketToBottom (bucket);
+          return;
+        }
+      AddRung (bucket, min, max, end);
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,165 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LADDER_SCHEDULER_H
+#define LADDER_SCHEDULER_H
+
+#include "scheduler.h"
+#include <stdint.h>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * ns3::LadderScheduler class declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup scheduler
+ * \brief a ladder queue event scheduler
+ *
+ * This event scheduler implements the Ladder Queue of
+ * "Ladder Queue: An O(1) Priority Queue Structure for Large-Scale
+ * Discrete Event Simulation" by W. T. Tang, R. S. M. Goh and
+ * I. L.-J. Thng (ACM TOMACS, 2005).  Events are kept in three tiers:
+ *
+ * - Top: an unsorted vector of far future events;
+ * - Ladder: rungs of buckets, each rung splitting one bucket of the
+ *   rung above it into finer buckets;
+ * - Bottom: a sorted vector holding the earliest events.
+ *
+ * Events only get sorted once they reach the bottom, in small batches,
+ * which gives O(1) amortized insert and remove.  Unlike the original
+ * structure, buckets are std::vector rather than linked lists, and the
+ * bucket vectors of a rung are kept when the rung empties so that their
+ * storage is reused.  A bucket whose events all share one timestamp
+ * (bursts at a round or slot boundary) is moved to the bottom in one
+ * pass without being split further.  If events keep being inserted
+ * before the end of the bottom, the bottom is spilled back to a new rung
+ * once it grows past a fixed size, to keep the sorted inserts cheap.
+ */
+class LadderScheduler : public Scheduler
+{
+public:
+  /**
+   *  Register this type.
+   *  \return The object TypeId.
+   */
+  static TypeId GetTypeId (void);
+
+  /** Constructor. */
+  LadderScheduler ();
+  /** Destructor. */
+  virtual ~LadderScheduler ();
+
+  // Inherited
+  virtual void Insert (const Scheduler::Event &ev);
+  virtual bool IsEmpty (void) const;
+  virtual Scheduler::Event PeekNext (void) const;
+  virtual Scheduler::Event RemoveNext (void);
+  virtual void Remove (const Scheduler::Event &ev);
+
+private:
+  /** Bucket type: an unsorted vector of Events. */
+  typedef std::vector<Scheduler::Event> Bucket;
+
+  /** One rung of the ladder. */
+  struct Rung
+  {
+    uint64_t start;              /**< Timestamp of the start of bucket 0. */
+    uint64_t width;              /**< Duration of a bucket. */
+    uint64_t end;                /**< Timestamp of the end of the rung. */
+    uint32_t current;            /**< Index of the first bucket not yet dequeued. */
+    uint32_t nBuckets;           /**< Number of buckets in use. */
+    uint32_t count;              /**< Number of events in the rung. */
+    std::vector<Bucket> buckets; /**< The buckets, possibly more than nBuckets. */
+    /**
+     * \param [in] i A bucket index.
+     * \returns The timestamp of the start of the bucket.
+     */
+    uint64_t BucketStart (uint32_t i) const;
+    /**
+     * \param [in] i A bucket index.
+     * \returns The timestamp of the end of the bucket.
+     */
+    uint64_t BucketEnd (uint32_t i) const;
+    /**
+     * \param [in] ts A timestamp within the rung.
+     * \returns The index of the bucket holding ts.
+     */
+    uint32_t BucketIndex (uint64_t ts) const;
+  };
+
+  /**
+   * Keep the bottom non empty while there are events, so that PeekNext
+   * does not have to modify the queue.
+   */
+  void Refill (void);
+  /**
+   * Move the events of the top to a new first rung.
+   */
+  void TopToLadder (void);
+  /**
+   * Start a new rung and move the events of a bucket into it.
+   *
+   * \param [in,out] bucket The events to move, emptied on return.
+   * \param [in] min The smallest timestamp in bucket.
+   * \param [in] max The largest timestamp in bucket.
+   * \param [in] end The timestamp of the end of the new rung.
+   */
+  void AddRung (Bucket &bucket, uint64_t min, uint64_t max, uint64_t end);
+  /**
+   * Move the events of a bucket to the empty bottom and sort them.
+   *
+   * \param [in,out] bucket The events to move, emptied on return.
+   */
+  void BucketToBottom (Bucket &bucket);
+  /**
+   * Insert an event in the sorted bottom.
+   *
+   * \param [in] ev The event to insert.
+   */
+  void InsertBottom (const Scheduler::Event &ev);
+  /**
+   * \returns The timestamp below which events belong to the bottom.
+   */
+  uint64_t BottomEnd (void) const;
+
+  /** Unsorted far future events. */
+  Bucket m_top;
+  /** Smallest timestamp in the top. */
+  uint64_t m_topMin;
+  /** Largest timestamp in the top. */
+  uint64_t m_topMax;
+  /** Events at or after this timestamp go to the top. */
+  uint64_t m_topStart;
+  /** The rungs; only the first m_nRungs are in use. */
+  std::vector<Rung> m_rungs;
+  /** Number of rungs in use. */
+  uint32_t m_nRungs;
+  /** Earliest events, sorted from m_bottomHead on. */
+  Bucket m_bottom;
+  /** Index of the first event of the bottom still in the queue. */
+  uint32_t m_bottomHead;
+  /** Number of events in the queue. */
+  uint32_t m_count;
+};
+
+} // namespace ns3
+
+#endif /* LADDER_SCHEDULER_H */
@@ -0,0 +1,616 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "log-buffer.h"
+#include "nstime.h"
+#include "simulator.h"
+#include "fatal-error.h"
+#include "ns3/core-config.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifdef HAVE_STDLIB_H
+#include <cstdlib>
+#endif
+
+/**
+ * \file
+ * \ingroup logging
+ * ns3::LogBuffer implementation.
+ */
+
+namespace ns3 {
+
+// The buffer cannot log: it uses the standard library threads rather
+// than SystemThread, SystemMutex and SystemCondition, which do.
+
+bool LogBuffer::g_enabled = false;
+
+namespace {
+
+/** The kinds of records. */
+enum Kind
+{
+  NAME,      //!< Defines the name of a component or function id.
+  MESSAGE,   //!< A message of NS_LOG().
+  FUNCTION   //!< A message of NS_LOG_FUNCTION().
+};
+
+/** The prefixes of a record. */
+enum Prefix
+{
+  PREFIX_FUNC = 1,   //!< LOG_PREFIX_FUNC
+  PREFIX_TIME = 2,   //!< LOG_PREFIX_TIME
+  PREFIX_NODE = 4,   //!< LOG_PREFIX_NODE
+  PREFIX_LEVEL = 8   //!< LOG_PREFIX_LEVEL
+};
+
+/** The header of a record, followed by \c size bytes of text. */
+struct Record
+{
+  uint32_t size;       //!< Size of the text.
+  uint8_t kind;        //!< Kind of the record.
+  uint8_t prefixes;    //!< Prefixes enabled for the component.
+  uint8_t unit;        //!< Time::Unit of the time, Time::LAST if none.
+  uint8_t reserved;    //!< Zero.
+  uint32_t component;  //!< Name id of the component, or the id a NAME defines.
+  uint32_t function;   //!< Name id of the function.
+  uint32_t context;    //!< Context of the message.
+  uint32_t level;      //!< LogLevel of the message.
+  int64_t time;        //!< Time of the message, in time steps.
+};
+
+/** The start of a file. */
+const char MAGIC[8] = { 'n', 's', '3', 'l', 'o', 'g', '0', '1' };
+
+/** Stream buffer appending to a string, which keeps its capacity. */
+class TextBuffer : public std::streambuf
+{
+public:
+  std::string text;  //!< The text written so far.
+
+protected:
+  virtual int_type overflow (int_type c)
+  {
+    if (c != traits_type::eof ())
+      {
+        text.push_back (traits_type::to_char_type (c));
+      }
+    return traits_type::not_eof (c);
+  }
+  virtual std::streamsize xsputn (const char *s, std::streamsize n)
+  {
+    text.append (s, n);
+    return n;
+  }
+};
+
+/** A message being formatted. */
+struct Pending
+{
+  Pending () : os (&buffer) {}
+  Record record;          //!< The header of the message.
+  const char *component;  //!< The name of the component.
+  const char *function;   //!< The name of the function.
+  TextBuffer buffer;      //!< The text of the message.
+  std::ostream os;        //!< The stream writing to the text.
+};
+
+/** The messages being formatted by a thread. */
+struct Stack
+{
+  Stack () : depth (0) {}
+  ~Stack ()
+  {
+    for (std::vector<Pending *>::iterator i = pending.begin (); i != pending.end (); ++i)
+      {
+        delete *i;
+      }
+  }
+  /** The messages, kept for reuse; more than one if a message logs. */
+  std::vector<Pending *> pending;
+  /** The number of messages being formatted. */
+  uint32_t depth;
+};
+
+/**
+ * \returns The messages being formatted by the calling thread.
+ */
+Stack &
+GetStack (void)
+{
+  static thread_local Stack stack;
+  return stack;
+}
+
+/** The ring buffer, drained to a file by a background thread. */
+struct Sink
+{
+  std::ofstream file;         //!< The file, only used by the writer.
+  std::vector<char> ring;     //!< The ring buffer.
+  uint64_t mask;              //!< The size of the ring, minus one.
+  uint64_t head;              //!< Total bytes written to the ring.
+  uint64_t tail;              //!< Total bytes written to the file.
+  bool flush;                 //!< Set to wake the writer up.
+  bool exit;                  //!< Set to stop the writer.
+  std::map<const char *, uint32_t> names;  //!< Id of the names recorded.
+  std::mutex mutex;           //!< Protects the fields above, but the file.
+  std::condition_variable ready;  //!< Wakes the writer up.
+  std::condition_variable space;  //!< Signals the ring was drained.
+  std::thread writer;         //!< The background thread.
+};
+
+/** The sink, while enabled. */
+Sink *g_sink = 0;
+/** The simulation clock. */
+LogBuffer::Clock g_clock = 0;
+
+/** First node id kept. */
+std::atomic<uint32_t> g_firstNode (0);
+/** Last node id kept. */
+std::atomic<uint32_t> g_lastNode (std::numeric_limits<uint32_t>::max ());
+/** Start of the time window, in time steps. */
+std::atomic<int64_t> g_start (std::numeric_limits<int64_t>::min ());
+/** End of the time window, in time steps, excluded. */
+std::atomic<int64_t> g_stop (std::numeric_limits<int64_t>::max ());
+
+/**
+ * \param [in] context The context of a message.
+ * \param [in] stamped Whether the message has a time.
+ * \param [in] time Its time, in time steps.
+ * \returns \c true if the filters keep the message.
+ */
+bool
+IsKept (uint32_t context, bool stamped, int64_t time)
+{
+  if (context != Simulator::NO_CONTEXT
+      && (context < g_firstNode.load (std::memory_order_relaxed)
+          || context > g_lastNode.load (std::memory_order_relaxed)))
+    {
+      return false;
+    }
+  return !stamped
+         || (time >= g_start.load (std::memory_order_relaxed)
+             && time < g_stop.load (std::memory_order_relaxed));
+}
+
+/**
+ * Copy bytes to the ring, which has room for them.
+ *
+ * \param [in] sink The sink.
+ * \param [in] data The bytes.
+ * \param [in] size The number of bytes.
+ */
+void
+Copy (Sink *sink, const void *data, uint64_t size)
+{
+  uint64_t start = sink->head & sink->mask;
+  uint64_t first = std::min (size, sink->mask + 1 - start);
+  std::memcpy (&sink->ring[start], data, first);
+  std::memcpy (&sink->ring[0], static_cast<const char *> (data) + first, size - first);
+  sink->head += size;
+}
+
+/**
+ * Queue a record and the NAME records of the names it uses first.
+ *
+ * \param [in] sink The sink.
+ * \param [in] record The record, whose name ids are set here.
+ * \param [in] component The name of the component.
+ * \param [in] function The name of the function.
+ * \param [in] text The text of the record.
+ */
+void
+Push (Sink *sink, Record &record, const char *component, const char *function,
+      const std::string &text)
+{
+  const char *names[2] = { component, function };
+  uint64_t capacity = sink->mask + 1;
+  std::unique_lock<std::mutex> lock (sink->mutex);
+  uint64_t need;
+  while (true)
+    {
+      need = sizeof (Record) + record.size;
+      for (uint32_t i = 0; i < 2; ++i)
+        {
+          if (sink->names.find (names[i]) == sink->names.end ())
+            {
+              need += sizeof (Record) + std::strlen (names[i]);
+            }
+        }
+      if (capacity - (sink->head - sink->tail) >= need)
+        {
+          break;
+        }
+      sink->flush = true;
+      sink->ready.notify_one ();
+      sink->space.wait (lock);
+    }
+  uint32_t *ids[2] = { &record.component, &record.function };
+  for (uint32_t i = 0; i < 2; ++i)
+    {
+      std::map<const char *, uint32_t>::iterator name = sink->names.find (names[i]);
+      if (name == sink->names.end ())
+        {
+          Record define;
+          std::memset (&define, 0, sizeof (define));
+          define.kind = NAME;
+          define.size = std::strlen (names[i]);
+          define.component = sink->names.size ();
+          name = sink->names.insert (std::make_pair (names[i], define.component)).first;
+          Copy (sink, &define, sizeof (define));
+          Copy (sink, names[i], define.size);
+        }
+      *ids[i] = name->second;
+    }
+  Copy (sink, &record, sizeof (record));
+  Copy (sink, text.data (), record.size);
+  if (sink->head - sink->tail > capacity / 2)
+    {
+      sink->ready.notify_one ();
+    }
+}
+
+/**
+ * The writer thread: drain the ring to the file until told to exit.
+ *
+ * \param [in] sink The sink.
+ */
+void
+Drain (Sink *sink)
+{
+  std::unique_lock<std::mutex> lock (sink->mutex);
+  uint64_t half = (sink->mask + 1) / 2;
+  while (true)
+    {
+      sink->ready.wait_for (lock, std::chrono::milliseconds (100),
+                            [sink, half] { return sink->flush || sink->exit
+                                                  || sink->head - sink->tail > half; });
+      sink->flush = false;
+      bool exit = sink->exit;
+      uint64_t head = sink->head;
+      uint64_t tail = sink->tail;
+      lock.unlock ();
+      // Producers only write past head: the bytes up to it are ours.
+      while (tail != head)
+        {
+          uint64_t start = tail & sink->mask;
+          uint64_t size = std::min (head - tail, sink->mask + 1 - start);
+          sink->file.write (&sink->ring[start], size);
+          tail += size;
+        }
+      sink->file.flush ();
+      lock.lock ();
+      sink->tail = head;
+      sink->space.notify_all ();
+      if (exit && sink->head == sink->tail)
+        {
+          return;
+        }
+    }
+}
+
+/**
+ * Start a record.
+ *
+ * \param [in] kind The kind of record.
+ * \param [in] component The log component.
+ * \param [in] level The level of the message.
+ * \param [in] function The function logging.
+ * \returns The stream to write the message to, or 0.
+ */
+std::ostream *
+Start (enum Kind kind, const LogComponent &component, enum LogLevel level,
+       const char *function)
+{
+  int64_t time = 0;
+  uint32_t context = Simulator::NO_CONTEXT;
+  LogBuffer::Clock clock = g_clock;
+  if (clock != 0)
+    {
+      clock (time, context);
+    }
+  if (!IsKept (context, clock != 0, time))
+    {
+      return 0;
+    }
+  Stack &stack = GetStack ();
+  if (stack.depth == stack.pending.size ())
+    {
+      stack.pending.push_back (new Pending);
+    }
+  Pending *pending = stack.pending[stack.depth++];
+  pending->component = component.Name ();
+  pending->function = function;
+  Record &record = pending->record;
+  record.kind = kind;
+  record.prefixes = (component.IsEnabled (LOG_PREFIX_FUNC) ? PREFIX_FUNC : 0)
+    | (component.IsEnabled (LOG_PREFIX_TIME) ? PREFIX_TIME : 0)
+    | (component.IsEnabled (LOG_PREFIX_NODE) ? PREFIX_NODE : 0)
+    | (component.IsEnabled (LOG_PREFIX_LEVEL) ? PREFIX_LEVEL : 0);
+  record.unit = clock != 0 ? Time::GetResolution () : Time::LAST;
+  record.reserved = 0;
+  record.context = context;
+  record.level = level;
+  record.time = time;
+  pending->buffer.text.clear ();
+  pending->os.clear ();
+  pending->os.flags (std::ios::dec | std::ios::skipws);
+  pending->os.precision (6);
+  pending->os.fill (' ');
+  return &pending->os;
+}
+
+/**
+ * Print the time of a record as the LogTimePrinter does.
+ *
+ * \param [in] os The output stream.
+ * \param [in] time The time, in time steps of \p unit.
+ * \param [in] unit The resolution when the record was logged.
+ */
+void
+PrintTime (std::ostream &os, int64_t time, enum Time::Unit unit)
+{
+  std::ios_base::fmtflags ff = os.flags ();
+  std::streamsize oldPrecision = os.precision ();
+  int precision;
+  switch (unit)
+    {
+    case Time::NS: precision = 9; break;
+    case Time::PS: precision = 12; break;
+    case Time::FS: precision = 15; break;
+    case Time::US: precision = 6; break;
+    default: precision = 5; break;
+    }
+  os << std::fixed << std::setprecision (precision)
+     << Time::FromInteger (time, unit).As (Time::S);
+  os << std::setprecision (oldPrecision);
+  os.flags (ff);
+}
+
+/**
+ * Read the environment and write the pending records at exit.
+ */
+class LogBufferInitializer
+{
+public:
+  LogBufferInitializer ()
+  {
+#ifdef HAVE_GETENV
+    char *envVar = getenv ("NS_LOG_BUFFER");
+    if (envVar != 0 && std::strlen (envVar) != 0)
+      {
+        LogBuffer::Enable (envVar);
+      }
+#endif
+  }
+  ~LogBufferInitializer ()
+  {
+    LogBuffer::Disable ();
+  }
+};
+
+/** Enable the buffer from the environment. */
+LogBufferInitializer g_logBufferInitializer;
+
+} // unnamed namespace
+
+void
+LogBuffer::Enable (const std::string &filename, uint32_t capacity)
+{
+  Disable ();
+  Sink *sink = new Sink;
+  sink->file.open (filename.c_str (), std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!sink->file.is_open ())
+    {
+      delete sink;
+      NS_FATAL_ERROR ("LogBuffer: cannot open " << filename);
+    }
+  sink->file.write (MAGIC, sizeof (MAGIC));
+  uint64_t size = 4096;
+  while (size < capacity)
+    {
+      size *= 2;
+    }
+  sink->ring.resize (size);
+  sink->mask = size - 1;
+  sink->head = 0;
+  sink->tail = 0;
+  sink->flush = false;
+  sink->exit = false;
+  sink->writer = std::thread (&Drain, sink);
+  g_sink = sink;
+  g_enabled = true;
+}
+
+void
+LogBuffer::Disable (void)
+{
+  Sink *sink = g_sink;
+  if (sink == 0)
+    {
+      return;
+    }
+  g_enabled = false;
+  g_sink = 0;
+  {
+    std::unique_lock<std::mutex> lock (sink->mutex);
+    sink->exit = true;
+    sink->ready.notify_one ();
+  }
+  sink->writer.join ();
+  sink->file.close ();
+  delete sink;
+}
+
+void
+LogBuffer::Flush (void)
+{
+  Sink *sink = g_sink;
+  if (sink == 0)
+    {
+      return;
+    }
+  std::unique_lock<std::mutex> lock (sink->mutex);
+  uint64_t head = sink->head;
+  while (sink->tail < head)
+    {
+      sink->flush = true;
+      sink->ready.notify_one ();
+      sink->space.wait (lock);
+    }
+}
+
+void
+LogBuffer::SetNodeFilter (uint32_t first, uint32_t last)
+{
+  g_firstNode = first;
+  g_lastNode = last;
+}
+
+void
+LogBuffer::SetTimeFilter (const Time &start, const Time &stop)
+{
+  g_start = start.GetTimeStep ();
+  g_stop = stop.GetTimeStep ();
+}
+
+void
+LogBuffer::ResetFilters (void)
+{
+  g_firstNode = 0;
+  g_lastNode = std::numeric_limits<uint32_t>::max ();
+  g_start = std::numeric_limits<int64_t>::min ();
+  g_stop = std::numeric_limits<int64_t>::max ();
+}
+
+void
+LogBuffer::SetClock (Clock clock)
+{
+  g_clock = clock;
+}
+
+std::ostream *
+LogBuffer::Begin (const LogComponent &component, enum LogLevel level, const char *function)
+{
+  return Start (MESSAGE, component, level, function);
+}
+
+std::ostream *
+LogBuffer::BeginFunction (const LogComponent &component, const char *function)
+{
+  return Start (FUNCTION, component, LOG_FUNCTION, function);
+}
+
+void
+LogBuffer::End (void)
+{
+  Stack &stack = GetStack ();
+  Pending *pending = stack.pending[--stack.depth];
+  Sink *sink = g_sink;
+  if (sink == 0)
+    {
+      return;
+    }
+  // Leave room for the names: a record must fit in the ring.
+  uint64_t room = (sink->mask + 1) / 2 - sizeof (Record);
+  if (pending->buffer.text.size () > room)
+    {
+      pending->buffer.text.resize (room);
+    }
+  pending->record.size = pending->buffer.text.size ();
+  Push (sink, pending->record, pending->component, pending->function,
+        pending->buffer.text);
+}
+
+bool
+LogBuffer::Format (std::istream &is, std::ostream &os)
+{
+  char magic[sizeof (MAGIC)];
+  if (!is.read (magic, sizeof (magic)) || std::memcmp (magic, MAGIC, sizeof (MAGIC)) != 0)
+    {
+      return false;
+    }
+  std::map<uint32_t, std::string> names;
+  std::string text;
+  Record record;
+  while (is.read (reinterpret_cast<char *> (&record), sizeof (record)))
+    {
+      text.resize (record.size);
+      if (record.size != 0 && !is.read (&text[0], record.size))
+        {
+          return false;
+        }
+      if (record.kind == NAME)
+        {
+          names[record.component] = text;
+          continue;
+        }
+      bool stamped = record.unit != Time::LAST;
+      enum Time::Unit unit = static_cast<enum Time::Unit> (record.unit);
+      int64_t time = stamped ? Time::FromInteger (record.time, unit).GetTimeStep () : 0;
+      if (!IsKept (record.context, stamped, time))
+        {
+          continue;
+        }
+      if (stamped && (record.prefixes & PREFIX_TIME))
+        {
+          PrintTime (os, record.time, unit);
+          os << " ";
+        }
+      if (stamped && (record.prefixes & PREFIX_NODE))
+        {
+          if (record.context == Simulator::NO_CONTEXT)
+            {
+              os << "-1";
+            }
+          else
+            {
+              os << record.context;
+            }
+          os << " ";
+        }
+      if (record.kind == FUNCTION)
+        {
+          os << names[record.component] << ":" << names[record.function]
+             << "(" << text << ")" << std::endl;
+          continue;
+        }
+      if (record.prefixes & PREFIX_FUNC)
+        {
+          os << names[record.component] << ":" << names[record.function] << "(): ";
+        }
+      if (record.prefixes & PREFIX_LEVEL)
+        {
+          os << "[" << LogComponent::GetLevelLabel (static_cast<enum LogLevel> (record.level))
+             << "] ";
+        }
+      os << text << std::endl;
+    }
+  return is.eof ();
+}
+
+} // namespace ns3
@@ -0,0 +1,174 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef NS3_LOG_BUFFER_H
+#define NS3_LOG_BUFFER_H
+
+#include "log.h"
+
+#include <stdint.h>
+#include <iostream>
+#include <string>
+
+/**
+ * \file
+ * \ingroup logging
+ * ns3::LogBuffer declaration.
+ */
+
+namespace ns3 {
+
+class Time;
+
+/**
+ * \ingroup logging
+ * \brief Asynchronous binary sink for the NS_LOG macros.
+ *
+ * Once enabled, the logging macros no longer write to \c std::clog:
+ * each message is formatted, without any prefix, into a per-thread
+ * buffer and queued as a compact binary record holding the simulation
+ * time, the context (usually the node id), the component, the function,
+ * the level and the prefixes enabled for the component.  A background
+ * thread drains the queue, a ring buffer, to a file, and
+ * LogBuffer::Format() turns the file back into the text the macros
+ * would have printed.  The \c log-format utility does so offline.
+ *
+ * The file-local NS_LOG_APPEND_CONTEXT is not evaluated for buffered
+ * messages: the time and node prefixes, which the record always
+ * carries, stand in for it.  NS_LOG_UNCOND still writes to \c std::clog.
+ *
+ * The buffer is enabled by Enable(), or by setting the \c NS_LOG_BUFFER
+ * environment variable to the name of the file:
+ * \code
+ *   $ NS_LOG_BUFFER=run.log NS_LOG='LeachRoutingProtocol=info|prefix_all' ./waf --run ...
+ *   $ ./waf --run "log-format --file=run.log --firstNode=3 --lastNode=3"
+ * \endcode
+ *
+ * Messages can be filtered by node and time window, at any time during
+ * the simulation, with SetNodeFilter() and SetTimeFilter(): a filtered
+ * out message is not even formatted.  The same filters select the
+ * records printed by Format().
+ */
+class LogBuffer
+{
+public:
+  /**
+   * Send the log messages to a file.
+   *
+   * \param [in] filename The file to write the records to.
+   * \param [in] capacity The size of the ring buffer, in bytes.
+   */
+  static void Enable (const std::string &filename, uint32_t capacity = 1 << 20);
+  /**
+   * Write the pending records, close the file and log to \c std::clog
+   * again.
+   *
+   * This must not be called while other threads log.
+   */
+  static void Disable (void);
+  /**
+   * \returns \c true if the log messages go to the buffer.
+   */
+  static bool IsEnabled (void)
+  {
+    return g_enabled;
+  }
+  /**
+   * Wait until the records queued so far are written to the file.
+   */
+  static void Flush (void);
+
+  /**
+   * Keep only the messages of a range of nodes.
+   *
+   * Messages logged without context, such as from the main program,
+   * are always kept.
+   *
+   * \param [in] first The first node id kept.
+   * \param [in] last The last node id kept.
+   */
+  static void SetNodeFilter (uint32_t first, uint32_t last);
+  /**
+   * Keep only the messages logged in a time window.
+   *
+   * \param [in] start The start of the window.
+   * \param [in] stop The end of the window, excluded.
+   */
+  static void SetTimeFilter (const Time &start, const Time &stop);
+  /** Keep the messages of all nodes, at all times. */
+  static void ResetFilters (void);
+
+  /**
+   * Print the records of a file as the logging macros would have.
+   *
+   * \param [in] is The content of the file.
+   * \param [in] os The output stream.
+   * \returns \c false if \p is does not hold log records.
+   */
+  static bool Format (std::istream &is, std::ostream &os);
+
+  /**
+   * Function signature for stamping a message with the simulation
+   * time and context.
+   *
+   * \param [out] time The current simulation time, in time steps.
+   * \param [out] context The current context.
+   */
+  typedef void (*Clock)(int64_t &time, uint32_t &context);
+  /**
+   * Set the Clock stamping the messages, set by the simulator once it
+   * exists, like the LogTimePrinter.
+   *
+   * \param [in] clock The Clock, or 0 when there is no simulator.
+   */
+  static void SetClock (Clock clock);
+
+  /**
+   * \internal
+   * Start a message of the NS_LOG() macros.
+   *
+   * \param [in] component The log component.
+   * \param [in] level The level of the message.
+   * \param [in] function The function logging.
+   * \returns The stream to write the message to, to be followed by
+   *          End(), or 0 if the message is filtered out.
+   */
+  static std::ostream * Begin (const LogComponent &component, enum LogLevel level,
+                               const char *function);
+  /**
+   * \internal
+   * Start a message of the NS_LOG_FUNCTION() macros.
+   *
+   * \param [in] component The log component.
+   * \param [in] function The function logging.
+   * \returns The stream to write the parameters to, to be followed by
+   *          End(), or 0 if the message is filtered out.
+   */
+  static std::ostream * BeginFunction (const LogComponent &component, const char *function);
+  /**
+   * \internal
+   * Queue the message started by the last Begin() or BeginFunction().
+   */
+  static void End (void);
+
+private:
+  /** Set while the log messages go to the buffer. */
+  static bool g_enabled;
+};
+
+} // namespace ns3
+
+#endif /* NS3_LOG_BUFFER_H */
@@ -107,6 +107,8 @@
  *       std::clog << "[node " << var->GetObject<Node> ()->GetId () << "] ";
  *     }
  * \endcode
+ *
+ * It is not evaluated when the ns3::LogBuffer is enabled.
  */
 #define NS_LOG_APPEND_CONTEXT
 #endif /* NS_LOG_APPEND_CONTEXT */
@@ -155,12 +157,25 @@
     {                                                           \
       if (g_log.IsEnabled (level))                              \
         {                                                       \
-          NS_LOG_APPEND_TIME_PREFIX;                            \
-          NS_LOG_APPEND_NODE_PREFIX;                            \
-          NS_LOG_APPEND_CONTEXT;                                \
-          NS_LOG_APPEND_FUNC_PREFIX;                            \
-          NS_LOG_APPEND_LEVEL_PREFIX (level);                   \
-          std::clog << msg << std::endl;                        \
+          if (ns3::LogBuffer::IsEnabled ())                     \
+            {                                                   \
+              std::ostream *ns3LogStream =                      \
+                ns3::LogBuffer::Begin (g_log, level, __FUNCTION__); \
+              if (ns3LogStream != 0)                            \
+                {                                               \
+                  *ns3LogStream << msg;                         \
+                  ns3::LogBuffer::End ();                       \
+                }                                               \
+            }                                                   \
+          else                                                  \
+            {                                                   \
+              NS_LOG_APPEND_TIME_PREFIX;                        \
+              NS_LOG_APPEND_NODE_PREFIX;                        \
+              NS_LOG_APPEND_CONTEXT;                            \
+              NS_LOG_APPEND_FUNC_PREFIX;                        \
+              NS_LOG_APPEND_LEVEL_PREFIX (level);               \
+              std::clog << msg << std::endl;                    \
+            }                                                   \
         }                                                       \
     }                                                           \
   while (false)
@@ -179,11 +194,21 @@
     {                                                           \
       if (g_log.IsEnabled (ns3::LOG_FUNCTION))                  \
         {                                                       \
-          NS_LOG_APPEND_TIME_PREFIX;                            \
-          NS_LOG_APPEND_NODE_PREFIX;                            \
-          NS_LOG_APPEND_CONTEXT;                                \
-          std::clog << g_log.Name () << ":"                     \
-                    << __FUNCTION__ << "()" << std::endl;       \
+          if (ns3::LogBuffer::IsEnabled ())                     \
+            {                                                   \
+              if (ns3::LogBuffer::BeginFunction (g_log, __FUNCTION__) != 0) \
+                {                                               \
+                  ns3::LogBuffer::End ();                       \
+                }                                               \
+            }                                                   \
+          else                                                  \
+            {                                                   \
+              NS_LOG_APPEND_TIME_PREFIX;                        \
+              NS_LOG_APPEND_NODE_PREFIX;                        \
+              NS_LOG_APPEND_CONTEXT;                            \
+              std::clog << g_log.Name () << ":"                 \
+                        << __FUNCTION__ << "()" << std::endl;   \
+            }                                                   \
         }                                                       \
     }                                                           \
   while (false)
@@ -216,13 +241,26 @@
     {                                                           \
       if (g_log.IsEnabled (ns3::LOG_FUNCTION))                  \
         {                                                       \
-          NS_LOG_APPEND_TIME_PREFIX;                            \
-          NS_LOG_APPEND_NODE_PREFIX;                            \
-          NS_LOG_APPEND_CONTEXT;                                \
-          std::clog << g_log.Name () << ":"                     \
-                    << __FUNCTION__ << "(";                     \
-          ns3::ParameterLogger (std::clog) << parameters;       \
-          std::clog << ")" << std::endl;                        \
+          if (ns3::LogBuffer::IsEnabled ())                     \
+            {                                                   \
+              std::ostream *ns3LogStream =                      \
+                ns3::LogBuffer::BeginFunction (g_log, __FUNCTION__); \
+              if (ns3LogStream != 0)                            \
+                {                                               \
+                  ns3::ParameterLogger (*ns3LogStream) << parameters; \
+                  ns3::LogBuffer::End ();                       \
+                }                                               \
+            }                                                   \
+          else                                                  \
+            {                                                   \
+              NS_LOG_APPEND_TIME_PREFIX;                        \
+              NS_LOG_APPEND_NODE_PREFIX;                        \
+              NS_LOG_APPEND_CONTEXT;                            \
+              std::clog << g_log.Name () << ":"                 \
+                        << __FUNCTION__ << "(";                 \
+              ns3::ParameterLogger (std::clog) << parameters;   \
+              std::clog << ")" << std::endl;                    \
+            }                                                   \
         }                                                       \
     }                                                           \
   while (false)
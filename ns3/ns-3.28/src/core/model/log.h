@@ -78,6 +78,9 @@
  *   NS_LOG_FUNCTION (this << arg1 << args);
  * \endcode
  * Use NS_LOG_FUNCTION_NOARGS() only in static functions with no arguments.
+ *
+ * On large simulations, ns3::LogBuffer sends the messages to a file
+ * from a background thread, in binary, rather than to \c std::clog.
  */
 /** @{ */
 
@@ -515,4 +518,6 @@ ParameterLogger::operator<< <const char *>(const char * param);
 
 /**@}*/  // \ingroup logging
 
+#include "log-buffer.h"
+
 #endif /* NS3_LOG_H */
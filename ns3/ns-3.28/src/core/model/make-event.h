@@ -317,8 +317,75 @@ EventImpl * MakeEvent (void (*f)(U1,U2,U3,U4,U5,U6), T1 a1, T2 a2, T3 a3, T4 a4,
 #include "event-impl.h"
 #include "type-traits.h"
 
+#include <stdint.h>
+#include <cstddef>
+#include <cstring>
+
 namespace ns3 {
 
+/**
+ * \ingroup makeeventfnptr
+ * \param [in] function A function pointer.
+ * \returns The address of the function.
+ */
+template <typename F>
+const void * GetFunctionAddress (F function)
+{
+  // Function pointers do not convert to object pointers in ISO C++.
+  const void *address = 0;
+  if (sizeof (function) == sizeof (address))
+    {
+      std::memcpy (&address, &function, sizeof (address));
+    }
+  return address;
+}
+
+/**
+ * \ingroup makeeventmemptr
+ * \param [in] function A pointer to member function.
+ * \param [in] obj The object it is called on.
+ * \returns The address of the function called, with virtual functions
+ *          resolved through the vtable of \p obj, or 0 if the pointer
+ *          to member does not follow the Itanium C++ ABI.
+ */
+template <typename MEM, typename T>
+const void * GetMemberFunctionAddress (MEM function, const T &obj)
+{
+#if defined (__GNUC__) && !defined (_WIN32)
+  // The address of a non-virtual function, or 1 + the offset of a
+  // virtual one in the vtable, then the adjustment of this.  On ARM the
+  // adjustment is doubled and its low bit marks the virtual functions.
+  struct
+  {
+    uintptr_t ptr;
+    ptrdiff_t adj;
+  } rep;
+  if (sizeof (function) != sizeof (rep))
+    {
+      return 0;
+    }
+  std::memcpy (&rep, &function, sizeof (rep));
+#if defined (__arm__) || defined (__aarch64__)
+  bool isVirtual = (rep.adj & 1) != 0;
+  ptrdiff_t adj = rep.adj >> 1;
+  uintptr_t offset = rep.ptr;
+#else
+  bool isVirtual = (rep.ptr & 1) != 0;
+  ptrdiff_t adj = rep.adj;
+  uintptr_t offset = rep.ptr - 1;
+#endif
+  if (!isVirtual)
+    {
+      return reinterpret_cast<const void *> (rep.ptr);
+    }
+  const char *self = reinterpret_cast<const char *> (&obj) + adj;
+  const char *vtable = *reinterpret_cast<const char * const *> (self);
+  return *reinterpret_cast<const void * const *> (vtable + offset);
+#else
+  return 0;
+#endif
+}
+
 /**
  * \ingroup makeeventmemptr
  * Helper for the MakeEvent functions which take a class method.
@@ -375,6 +442,10 @@ private:
     {
       (EventMemberImplObjTraits<OBJ>::GetReference (m_obj).*m_function)();
     }
+    virtual const void * GetFunction (void) const
+    {
+      return GetMemberFunctionAddress (m_function, EventMemberImplObjTraits<OBJ>::GetReference (m_obj));
+    }
     OBJ m_obj;
     MEM m_function;
   } *ev = new EventMemberImpl0 (obj, mem_ptr);
@@ -405,6 +476,10 @@ private:
     {
       (EventMemberImplObjTraits<OBJ>::GetReference (m_obj).*m_function)(m_a1);
     }
+    virtual const void * GetFunction (void) const
+    {
+      return GetMemberFunctionAddress (m_function, EventMemberImplObjTraits<OBJ>::GetReference (m_obj));
+    }
     OBJ m_obj;
     MEM m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
@@ -436,6 +511,10 @@ private:
     {
       (EventMemberImplObjTraits<OBJ>::GetReference (m_obj).*m_function)(m_a1, m_a2);
     }
+    virtual const void * GetFunction (void) const
+    {
+      return GetMemberFunctionAddress (m_function, EventMemberImplObjTraits<OBJ>::GetReference (m_obj));
+    }
     OBJ m_obj;
     MEM m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
@@ -469,6 +548,10 @@ private:
     {
       (EventMemberImplObjTraits<OBJ>::GetReference (m_obj).*m_function)(m_a1, m_a2, m_a3);
     }
+    virtual const void * GetFunction (void) const
+    {
+      return GetMemberFunctionAddress (m_function, EventMemberImplObjTraits<OBJ>::GetReference (m_obj));
+    }
     OBJ m_obj;
     MEM m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
@@ -504,6 +587,10 @@ private:
     {
       (EventMemberImplObjTraits<OBJ>::GetReference (m_obj).*m_function)(m_a1, m_a2, m_a3, m_a4);
     }
+    virtual const void * GetFunction (void) const
+    {
+      return GetMemberFunctionAddress (m_function, EventMemberImplObjTraits<OBJ>::GetReference (m_obj));
+    }
     OBJ m_obj;
     MEM m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
@@ -542,6 +629,10 @@ private:
     {
       (EventMemberImplObjTraits<OBJ>::GetReference (m_obj).*m_function)(m_a1, m_a2, m_a3, m_a4, m_a5);
     }
+    virtual const void * GetFunction (void) const
+    {
+      return GetMemberFunctionAddress (m_function, EventMemberImplObjTraits<OBJ>::GetReference (m_obj));
+    }
     OBJ m_obj;
     MEM m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
@@ -582,6 +673,10 @@ private:
     {
       (EventMemberImplObjTraits<OBJ>::GetReference (m_obj).*m_function)(m_a1, m_a2, m_a3, m_a4, m_a5, m_a6);
     }
+    virtual const void * GetFunction (void) const
+    {
+      return GetMemberFunctionAddress (m_function, EventMemberImplObjTraits<OBJ>::GetReference (m_obj));
+    }
     OBJ m_obj;
     MEM m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
@@ -617,6 +712,10 @@ private:
     {
       (*m_function)(m_a1);
     }
+    virtual const void * GetFunction (void) const
+    {
+      return GetFunctionAddress (m_function);
+    }
     F m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
   } *ev = new EventFunctionImpl1 (f, a1);
@@ -647,6 +746,10 @@ private:
     {
       (*m_function)(m_a1, m_a2);
     }
+    virtual const void * GetFunction (void) const
+    {
+      return GetFunctionAddress (m_function);
+    }
     F m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
     typename TypeTraits<T2>::ReferencedType m_a2;
@@ -680,6 +783,10 @@ private:
     {
       (*m_function)(m_a1, m_a2, m_a3);
     }
+    virtual const void * GetFunction (void) const
+    {
+      return GetFunctionAddress (m_function);
+    }
     F m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
     typename TypeTraits<T2>::ReferencedType m_a2;
@@ -715,6 +822,10 @@ private:
     {
       (*m_function)(m_a1, m_a2, m_a3, m_a4);
     }
+    virtual const void * GetFunction (void) const
+    {
+      return GetFunctionAddress (m_function);
+    }
     F m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
     typename TypeTraits<T2>::ReferencedType m_a2;
@@ -752,6 +863,10 @@ private:
     {
       (*m_function)(m_a1, m_a2, m_a3, m_a4, m_a5);
     }
+    virtual const void * GetFunction (void) const
+    {
+      return GetFunctionAddress (m_function);
+    }
     F m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
     typename TypeTraits<T2>::ReferencedType m_a2;
@@ -791,6 +906,10 @@ private:
     {
       (*m_function)(m_a1, m_a2, m_a3, m_a4, m_a5, m_a6);
     }
+    virtual const void * GetFunction (void) const
+    {
+      return GetFunctionAddress (m_function);
+    }
     F m_function;
     typename TypeTraits<T1>::ReferencedType m_a1;
     typename TypeTraits<T2>::ReferencedType m_a2;
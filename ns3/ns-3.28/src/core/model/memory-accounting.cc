@@ -0,0 +1,304 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "memory-accounting.h"
+#include "global-value.h"
+#include "boolean.h"
+#include "log.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <iomanip>
+#include <map>
+#include <new>
+
+/**
+ * \file
+ * \ingroup object
+ * ns3::MemoryAccounting implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("MemoryAccounting");
+
+/**
+ * \ingroup object
+ * Whether to count the live instances and memory of each type.
+ *
+ * This is accessible as "--MemoryAccounting" from CommandLine.
+ */
+static GlobalValue g_memoryAccounting ("MemoryAccounting",
+                                       "Count the live instances and memory of each "
+                                       "type and report them at Simulator::Destroy",
+                                       BooleanValue (false),
+                                       MakeBooleanChecker ());
+
+bool MemoryAccounting::m_enabled = false;
+
+namespace {
+
+/**
+ * Size of the header before the storage allocated by
+ * MemoryAccounting::New(), so the instance stays aligned.
+ */
+const std::size_t NEW_HEADER_SIZE = alignof (std::max_align_t);
+
+/** The usages of the types, and their indices. */
+struct UsageTable
+{
+  std::vector<MemoryAccounting::Usage> usages;  /**< The usages, by index. */
+  std::vector<uint32_t> uids;                   /**< The index + 1 of each TypeId uid, or 0. */
+  std::map<std::string, uint32_t> names;        /**< The index of each name. */
+};
+
+/**
+ * The table is never deleted: the Objects held by static variables are
+ * released after the static variables of this file are destroyed.
+ *
+ * \returns The table of the usages.
+ */
+UsageTable &
+GetTable (void)
+{
+  static UsageTable *table = new UsageTable ();
+  return *table;
+}
+
+/**
+ * \param [in] tid The TypeId of an Object.
+ * \returns Its size, or 0 if it was not registered.
+ */
+std::size_t
+GetObjectSize (TypeId tid)
+{
+  std::size_t size = tid.GetSize ();
+  return size == std::size_t (-1) ? 0 : size;
+}
+
+/**
+ * \param [in] a A usage.
+ * \param [in] b Another usage.
+ * \returns \c true if \p a comes before \p b in a report.
+ */
+bool
+ComparePeakBytes (const MemoryAccounting::Usage &a, const MemoryAccounting::Usage &b)
+{
+  if (a.peakBytes != b.peakBytes)
+    {
+      return a.peakBytes > b.peakBytes;
+    }
+  return a.name < b.name;
+}
+
+/**
+ * Count an instance.
+ *
+ * \param [in] index The index of its type.
+ * \param [in] bytes Its size.
+ */
+void
+DoAllocate (uint32_t index, std::size_t bytes)
+{
+  MemoryAccounting::Usage &usage = GetTable ().usages[index];
+  usage.live++;
+  usage.created++;
+  usage.bytes += bytes;
+  usage.peak = std::max (usage.peak, usage.live);
+  usage.peakBytes = std::max (usage.peakBytes, usage.bytes);
+}
+
+/**
+ * Release an instance, unless none is live.
+ *
+ * \param [in] index The index of its type.
+ * \param [in] bytes Its size.
+ */
+void
+DoDeallocate (uint32_t index, std::size_t bytes)
+{
+  MemoryAccounting::Usage &usage = GetTable ().usages[index];
+  if (usage.live == 0)
+    {
+      return;
+    }
+  usage.live--;
+  usage.bytes -= std::min<uint64_t> (usage.bytes, bytes);
+}
+
+} // unnamed namespace
+
+void
+MemoryAccounting::Enable (bool enable)
+{
+  NS_LOG_FUNCTION (enable);
+  m_enabled = enable;
+}
+
+void
+MemoryAccounting::Initialize (void)
+{
+  BooleanValue enable;
+  g_memoryAccounting.GetValue (enable);
+  if (enable.Get ())
+    {
+      m_enabled = true;
+    }
+}
+
+uint32_t
+MemoryAccounting::Register (std::string name)
+{
+  UsageTable &table = GetTable ();
+  std::map<std::string, uint32_t>::const_iterator it = table.names.find (name);
+  if (it != table.names.end ())
+    {
+      return it->second;
+    }
+  Usage usage = {name, 0, 0, 0, 0, 0};
+  uint32_t index = table.usages.size ();
+  table.usages.push_back (usage);
+  table.names[name] = index;
+  return index;
+}
+
+uint32_t
+MemoryAccounting::GetIndex (TypeId tid)
+{
+  UsageTable &table = GetTable ();
+  uint16_t uid = tid.GetUid ();
+  if (uid >= table.uids.size ())
+    {
+      table.uids.resize (uid + 1, 0);
+    }
+  if (table.uids[uid] == 0)
+    {
+      table.uids[uid] = Register (tid.GetName ()) + 1;
+    }
+  return table.uids[uid] - 1;
+}
+
+void
+MemoryAccounting::Allocate (uint32_t index, std::size_t bytes)
+{
+  DoAllocate (index, bytes);
+}
+
+void
+MemoryAccounting::Deallocate (uint32_t index, std::size_t bytes)
+{
+  DoDeallocate (index, bytes);
+}
+
+void *
+MemoryAccounting::New (uint32_t index, std::size_t bytes)
+{
+  char *block = static_cast<char *> (::operator new (NEW_HEADER_SIZE + bytes));
+  bool *accounted = reinterpret_cast<bool *> (block);
+  *accounted = m_enabled;
+  if (*accounted)
+    {
+      DoAllocate (index, bytes);
+    }
+  return block + NEW_HEADER_SIZE;
+}
+
+void
+MemoryAccounting::Delete (void *p, uint32_t index, std::size_t bytes)
+{
+  if (p == 0)
+    {
+      return;
+    }
+  char *block = static_cast<char *> (p) - NEW_HEADER_SIZE;
+  if (*reinterpret_cast<bool *> (block))
+    {
+      DoDeallocate (index, bytes);
+    }
+  ::operator delete (block);
+}
+
+void
+MemoryAccounting::Allocate (TypeId tid)
+{
+  DoAllocate (GetIndex (tid), GetObjectSize (tid));
+}
+
+void
+MemoryAccounting::Deallocate (TypeId tid)
+{
+  DoDeallocate (GetIndex (tid), GetObjectSize (tid));
+}
+
+MemoryAccounting::Usage
+MemoryAccounting::GetUsage (TypeId tid)
+{
+  return GetTable ().usages[GetIndex (tid)];
+}
+
+MemoryAccounting::Usage
+MemoryAccounting::GetUsage (std::string name)
+{
+  UsageTable &table = GetTable ();
+  std::map<std::string, uint32_t>::const_iterator it = table.names.find (name);
+  if (it == table.names.end ())
+    {
+      Usage usage = {name, 0, 0, 0, 0, 0};
+      return usage;
+    }
+  return table.usages[it->second];
+}
+
+std::vector<MemoryAccounting::Usage>
+MemoryAccounting::GetUsages (void)
+{
+  std::vector<Usage> usages;
+  const UsageTable &table = GetTable ();
+  for (std::vector<Usage>::const_iterator i = table.usages.begin (); i != table.usages.end (); ++i)
+    {
+      if (i->created > 0)
+        {
+          usages.push_back (*i);
+        }
+    }
+  std::sort (usages.begin (), usages.end (), &ComparePeakBytes);
+  return usages;
+}
+
+void
+MemoryAccounting::Print (std::ostream &os)
+{
+  std::vector<Usage> usages = GetUsages ();
+  uint64_t bytes = 0;
+  os << std::left << std::setw (48) << "Type"
+     << std::right << std::setw (12) << "Live"
+     << std::setw (12) << "Peak"
+     << std::setw (14) << "Bytes"
+     << std::setw (14) << "Peak bytes" << std::endl;
+  for (std::vector<Usage>::const_iterator i = usages.begin (); i != usages.end (); ++i)
+    {
+      os << std::left << std::setw (48) << i->name
+         << std::right << std::setw (12) << i->live
+         << std::setw (12) << i->peak
+         << std::setw (14) << i->bytes
+         << std::setw (14) << i->peakBytes << std::endl;
+      bytes += i->bytes;
+    }
+  os << std::left << std::setw (72) << "Total"
+     << std::right << std::setw (14) << bytes << std::endl;
+}
+
+} // namespace ns3
@@ -0,0 +1,193 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MEMORY_ACCOUNTING_H
+#define MEMORY_ACCOUNTING_H
+
+#include <stdint.h>
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "type-id.h"
+
+/**
+ * \file
+ * \ingroup object
+ * ns3::MemoryAccounting declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup object
+ * \brief Live instances and memory of each type.
+ *
+ * When the "MemoryAccounting" GlobalValue is true, or after Enable(),
+ * every Object created through CreateObject() or an ObjectFactory is
+ * counted under its TypeId, with the size registered by
+ * NS_OBJECT_ENSURE_REGISTERED(), until it is deleted.  The Packets, the
+ * data of their Buffers, the EventImpls, the WifiRemoteStations and
+ * their states, and the IPv4 and IPv6 routing table entries are counted
+ * under their class names, with their allocated size.  Other types can
+ * Register() a name and report their instances with Allocate() and
+ * Deallocate(), or allocate them with New() and Delete() from their
+ * operator new and operator delete.
+ *
+ * The GlobalValue is read when the simulator is created, so the
+ * instances created before are not counted.  Each instance remembers
+ * whether it was counted, and only a counted instance is released, even
+ * after the accounting is stopped.  Simulator::Destroy() prints the
+ * usage of every type to std::clog, before the destroy events run.
+ */
+class MemoryAccounting
+{
+public:
+  /** The usage of one type. */
+  struct Usage
+  {
+    std::string name;    /**< The name of the type. */
+    uint64_t live;       /**< The number of live instances. */
+    uint64_t peak;       /**< The peak number of live instances. */
+    uint64_t bytes;      /**< The bytes of the live instances. */
+    uint64_t peakBytes;  /**< The peak bytes of the live instances. */
+    uint64_t created;    /**< The number of instances counted so far. */
+  };
+
+  /**
+   * \returns \c true if the instances are counted.
+   */
+  static bool IsEnabled (void);
+  /**
+   * Start or stop counting the instances.
+   *
+   * The usages are kept when the accounting is stopped, and the
+   * instances counted are still released when they are deleted.
+   *
+   * \param [in] enable Whether to count the instances.
+   */
+  static void Enable (bool enable);
+  /**
+   * Start counting the instances if the "MemoryAccounting" GlobalValue
+   * is true.
+   */
+  static void Initialize (void);
+
+  /**
+   * Register a type which is not an Object.
+   *
+   * \param [in] name The name of the type.
+   * \returns The index of the type, for Allocate() and Deallocate().
+   */
+  static uint32_t Register (std::string name);
+  /**
+   * \param [in] tid The TypeId of an Object.
+   * \returns The index of the type, for Allocate() and Deallocate().
+   */
+  static uint32_t GetIndex (TypeId tid);
+
+  /**
+   * Count a new instance, whether enabled or not.
+   *
+   * The caller checks IsEnabled() first, and remembers that the
+   * instance was counted.
+   *
+   * \param [in] index The index of its type.
+   * \param [in] bytes Its size.
+   */
+  static void Allocate (uint32_t index, std::size_t bytes);
+  /**
+   * Release a counted instance, whether enabled or not.  The count of
+   * live instances does not go below zero.
+   *
+   * \param [in] index The index of its type.
+   * \param [in] bytes Its size.
+   */
+  static void Deallocate (uint32_t index, std::size_t bytes);
+  /**
+   * Allocate the storage of an instance, and count it if enabled.
+   *
+   * A header before the storage records whether the instance was
+   * counted, so that Delete() releases only the counted instances.
+   *
+   * \param [in] index The index of its type.
+   * \param [in] bytes Its size.
+   * \returns Storage for the instance.
+   */
+  static void * New (uint32_t index, std::size_t bytes);
+  /**
+   * Release the storage of an instance allocated by New(), and release
+   * the instance if it was counted.
+   *
+   * \param [in] p The storage of the instance, or 0.
+   * \param [in] index The index of its type.
+   * \param [in] bytes Its size.
+   */
+  static void Delete (void *p, uint32_t index, std::size_t bytes);
+  /**
+   * Count a new Object, whether enabled or not.
+   *
+   * \param [in] tid Its TypeId.
+   */
+  static void Allocate (TypeId tid);
+  /**
+   * Release a counted Object, whether enabled or not.
+   *
+   * \param [in] tid Its TypeId.
+   */
+  static void Deallocate (TypeId tid);
+
+  /**
+   * \param [in] tid The TypeId of an Object.
+   * \returns The usage of the type.
+   */
+  static Usage GetUsage (TypeId tid);
+  /**
+   * \param [in] name The name of a type.
+   * \returns The usage of the type, all zero if it is not known.
+   */
+  static Usage GetUsage (std::string name);
+  /**
+   * \returns The usage of every type counted, by decreasing peak bytes.
+   */
+  static std::vector<Usage> GetUsages (void);
+  /**
+   * Print the usage of every type counted, by decreasing peak bytes.
+   *
+   * \param [in] os The output stream.
+   */
+  static void Print (std::ostream &os);
+
+private:
+  /** Whether the instances are counted. */
+  static bool m_enabled;
+};
+
+} // namespace ns3
+
+
+namespace ns3 {
+
+inline bool
+MemoryAccounting::IsEnabled (void)
+{
+  return m_enabled;
+}
+
+} // namespace ns3
+
+#endif /* MEMORY_ACCOUNTING_H */
@@ -0,0 +1,251 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MPSC_RING_H
+#define MPSC_RING_H
+
+#include "assert.h"
+#include <stdint.h>
+#include <atomic>
+#include <thread>
+
+/**
+ * \file
+ * \ingroup thread
+ * ns3::MpscRing declaration and template implementation.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup thread
+ * \brief A bounded lock free queue with many producers and one consumer.
+ *
+ * This is the bounded queue of D. Vyukov: each cell carries a sequence
+ * number which tells whether it is free for the producer claiming that
+ * position or holds an item for the consumer.  Producers claim a
+ * position with one compare and swap on the tail, then write the item
+ * and publish it by bumping the sequence number of the cell; the single
+ * consumer reads cells in order without any atomic read-modify-write.
+ *
+ * Push() fails when the ring is full, so that the caller can fall back
+ * to some unbounded, slower path.  Pop() waits for items whose position
+ * was claimed but which are not published yet: a position is claimed
+ * right before the item is written, so this only spins for a few
+ * instructions, unless the producer thread is preempted in between.
+ * Items of one producer are thus always popped in the order they were
+ * pushed.
+ *
+ * \tparam T \deduced The type of the items, which must be copyable.
+ */
+template <typename T>
+class MpscRing
+{
+public:
+  /** Constructor: the ring has no capacity until SetCapacity(). */
+  MpscRing ();
+  /** Destructor. */
+  ~MpscRing ();
+
+  /**
+   * Allocate the cells of the ring.
+   *
+   * This must be called while there is no producer and the ring is empty.
+   *
+   * \param [in] capacity The number of cells, rounded up to a power of
+   *             two; 0 makes Push() always fail.
+   */
+  void SetCapacity (uint32_t capacity);
+  /** \returns The number of cells. */
+  uint32_t GetCapacity (void) const;
+  /**
+   * Enqueue an item, from any thread.
+   *
+   * \param [in] item The item.
+   * \returns \c false if the ring is full.
+   */
+  bool Push (const T &item);
+  /**
+   * Dequeue the first item, from the consumer thread only.
+   *
+   * \param [out] item The item.
+   * \returns \c false if no position was claimed by a producer.
+   */
+  bool Pop (T &item);
+  /**
+   * \returns \c true if no position was claimed by a producer.  Only
+   *          meaningful in the consumer thread.
+   */
+  bool IsEmpty (void) const;
+
+private:
+  /** A position in the ring. */
+  struct Cell
+  {
+    /**
+     * The position this cell is free for, or that position + 1 once
+     * its item is published.
+     */
+    std::atomic<uint64_t> seq;
+    /** The item. */
+    T item;
+  };
+
+  /** Copy constructor: not implemented. */
+  MpscRing (const MpscRing &);
+  /**
+   * Assignment: not implemented.
+   * \returns This ring.
+   */
+  MpscRing & operator = (const MpscRing &);
+
+  /** The cells. */
+  Cell *m_cells;
+  /** Number of cells - 1. */
+  uint64_t m_mask;
+  /** Keep the tail, written by producers, off the consumer cache line. */
+  char m_pad[64];
+  /** Next position to claim. */
+  std::atomic<uint64_t> m_tail;
+  /** Next position to read. */
+  uint64_t m_head;
+};
+
+} // namespace ns3
+
+
+/********************************************************************
+ *  Implementation of the templates declared above.
+ ********************************************************************/
+
+namespace ns3 {
+
+template <typename T>
+MpscRing<T>::MpscRing ()
+  : m_cells (0),
+    m_mask (0),
+    m_tail (0),
+    m_head (0)
+{
+}
+
+template <typename T>
+MpscRing<T>::~MpscRing ()
+{
+  delete [] m_cells;
+}
+
+template <typename T>
+void
+MpscRing<T>::SetCapacity (uint32_t capacity)
+{
+  NS_ASSERT (IsEmpty ());
+  delete [] m_cells;
+  m_cells = 0;
+  m_mask = 0;
+  m_tail.store (0);
+  m_head = 0;
+  if (capacity == 0)
+    {
+      return;
+    }
+  uint64_t size = 1;
+  while (size < capacity)
+    {
+      size <<= 1;
+    }
+  m_cells = new Cell[size];
+  m_mask = size - 1;
+  for (uint64_t i = 0; i < size; ++i)
+    {
+      m_cells[i].seq.store (i, std::memory_order_relaxed);
+    }
+}
+
+template <typename T>
+uint32_t
+MpscRing<T>::GetCapacity (void) const
+{
+  return m_cells == 0 ? 0 : m_mask + 1;
+}
+
+template <typename T>
+bool
+MpscRing<T>::Push (const T &item)
+{
+  if (m_cells == 0)
+    {
+      return false;
+    }
+  uint64_t pos = m_tail.load (std::memory_order_relaxed);
+  Cell *cell;
+  while (true)
+    {
+      cell = &m_cells[pos & m_mask];
+      uint64_t seq = cell->seq.load (std::memory_order_acquire);
+      int64_t diff = static_cast<int64_t> (seq - pos);
+      if (diff == 0)
+        {
+          if (m_tail.compare_exchange_weak (pos, pos + 1, std::memory_order_relaxed))
+            {
+              break;
+            }
+        }
+      else if (diff < 0)
+        {
+          // The cell still holds the item of the previous lap.
+          return false;
+        }
+      else
+        {
+          pos = m_tail.load (std::memory_order_relaxed);
+        }
+    }
+  cell->item = item;
+  cell->seq.store (pos + 1, std::memory_order_release);
+  return true;
+}
+
+template <typename T>
+bool
+MpscRing<T>::Pop (T &item)
+{
+  if (IsEmpty ())
+    {
+      return false;
+    }
+  Cell *cell = &m_cells[m_head & m_mask];
+  while (cell->seq.load (std::memory_order_acquire) != m_head + 1)
+    {
+      // Claimed, but the producer did not publish the item yet.
+      std::this_thread::yield ();
+    }
+  item = cell->item;
+  cell->seq.store (m_head + m_mask + 1, std::memory_order_release);
+  m_head++;
+  return true;
+}
+
+template <typename T>
+bool
+MpscRing<T>::IsEmpty (void) const
+{
+  return m_tail.load (std::memory_order_acquire) == m_head;
+}
+
+} // namespace ns3
+
+#endif /* MPSC_RING_H */
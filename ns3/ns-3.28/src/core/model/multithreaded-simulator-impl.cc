@@ -0,0 +1,826 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "multithreaded-simulator-impl.h"
+#include "simulator.h"
+#include "scheduler.h"
+#include "event-impl.h"
+#include "memory-accounting.h"
+#include "timer-wheel.h"
+
+#include "ptr.h"
+#include "uinteger.h"
+#include "assert.h"
+#include "fatal-error.h"
+#include "log.h"
+
+#include <algorithm>
+#include <limits>
+#include <thread>
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::MultithreadedSimulatorImpl implementation.
+ */
+
+namespace ns3 {
+
+// Note:  Logging in this file is largely avoided due to the
+// number of calls that are made to these functions and the possibility
+// of causing recursions leading to stack overflow
+NS_LOG_COMPONENT_DEFINE ("MultithreadedSimulatorImpl");
+
+NS_OBJECT_ENSURE_REGISTERED (MultithreadedSimulatorImpl);
+
+thread_local MultithreadedSimulatorImpl::Partition *MultithreadedSimulatorImpl::g_current = 0;
+const uint32_t MultithreadedSimulatorImpl::NO_PARTITION;
+const uint32_t MultithreadedSimulatorImpl::PARTITION_BITS;
+const uint32_t MultithreadedSimulatorImpl::MAX_PARTITIONS;
+const uint32_t MultithreadedSimulatorImpl::MAX_UID;
+
+TypeId
+MultithreadedSimulatorImpl::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MultithreadedSimulatorImpl")
+    .SetParent<SimulatorImpl> ()
+    .SetGroupName ("Core")
+    .AddConstructor<MultithreadedSimulatorImpl> ()
+    .AddAttribute ("Lookahead",
+                   "Smallest delay of an event scheduled for a context of "
+                   "another partition, which sets the duration of a round.",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&MultithreadedSimulatorImpl::m_lookahead),
+                   MakeTimeChecker (Seconds (0)))
+    .AddAttribute ("Threads",
+                   "Number of threads running partitions, "
+                   "0 for one per processor.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&MultithreadedSimulatorImpl::m_nThreads),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("Partitions",
+                   "Number of partitions before SetPartition adds any, "
+                   "0 for one per thread.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&MultithreadedSimulatorImpl::m_nPartitions),
+                   MakeUintegerChecker<uint32_t> (0, MAX_PARTITIONS))
+  ;
+  return tid;
+}
+
+MultithreadedSimulatorImpl::MultithreadedSimulatorImpl ()
+  : m_global (0),
+    m_repartition (false),
+    m_nThreads (0),
+    m_nPartitions (0),
+    m_nextActive (0),
+    m_roundEnd (0),
+    m_round (0),
+    m_firstRound (0),
+    m_busy (0),
+    m_exit (false),
+    m_parallel (false),
+    m_rounds (0),
+    m_stop (false),
+    m_stopTs (std::numeric_limits<uint64_t>::max ())
+{
+  NS_LOG_FUNCTION (this);
+  m_schedulerFactory.SetTypeId ("ns3::MapScheduler");
+  m_main = SystemThread::Self ();
+}
+
+MultithreadedSimulatorImpl::~MultithreadedSimulatorImpl ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+MultithreadedSimulatorImpl::NotifyConstructionCompleted (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_nThreads == 0)
+    {
+      m_nThreads = std::max (1U, std::thread::hardware_concurrency ());
+    }
+  m_global = new Partition ();
+  m_global->id = 0;
+  m_global->events = m_schedulerFactory.Create<Scheduler> ();
+  m_global->currentTs = 0;
+  m_global->currentUid = 0;
+  m_global->currentContext = Simulator::NO_CONTEXT;
+  m_global->uid = 1;
+  m_global->unscheduledEvents = 0;
+  AddPartitions (m_nPartitions == 0 ? std::min (m_nThreads, MAX_PARTITIONS) : m_nPartitions);
+  SimulatorImpl::NotifyConstructionCompleted ();
+}
+
+void
+MultithreadedSimulatorImpl::AddPartitions (uint32_t n)
+{
+  NS_ASSERT_MSG (n <= MAX_PARTITIONS, "At most " << MAX_PARTITIONS << " partitions");
+  while (m_partitions.size () < n)
+    {
+      Partition *partition = new Partition ();
+      partition->id = m_partitions.size () + 1;
+      partition->events = m_schedulerFactory.Create<Scheduler> ();
+      partition->currentTs = m_global->currentTs;
+      partition->currentUid = 0;
+      partition->currentContext = Simulator::NO_CONTEXT;
+      partition->uid = 1;
+      partition->unscheduledEvents = 0;
+      m_partitions.push_back (partition);
+      // The default partition of the contexts changed.
+      m_repartition = true;
+    }
+}
+
+void
+MultithreadedSimulatorImpl::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  Deliver ();
+  m_partitions.push_back (m_global);
+  for (std::vector<Partition *>::iterator i = m_partitions.begin (); i != m_partitions.end (); ++i)
+    {
+      Partition *partition = *i;
+      while (!partition->events->IsEmpty ())
+        {
+          Scheduler::Event next = partition->events->RemoveNext ();
+          next.impl->Unref ();
+        }
+      delete partition;
+    }
+  m_partitions.clear ();
+  m_global = 0;
+  SimulatorImpl::DoDispose ();
+}
+
+void
+MultithreadedSimulatorImpl::Destroy ()
+{
+  NS_LOG_FUNCTION (this);
+  while (!m_destroyEvents.empty ())
+    {
+      Ptr<EventImpl> ev = m_destroyEvents.front ().PeekEventImpl ();
+      m_destroyEvents.pop_front ();
+      NS_LOG_LOGIC ("handle destroy " << ev);
+      if (!ev->IsCancelled ())
+        {
+          ev->Invoke ();
+        }
+    }
+}
+
+void
+MultithreadedSimulatorImpl::SetScheduler (ObjectFactory schedulerFactory)
+{
+  NS_LOG_FUNCTION (this << schedulerFactory);
+  NS_ASSERT (!m_parallel);
+  m_schedulerFactory = schedulerFactory;
+  m_partitions.push_back (m_global);
+  for (std::vector<Partition *>::iterator i = m_partitions.begin (); i != m_partitions.end (); ++i)
+    {
+      Ptr<Scheduler> scheduler = schedulerFactory.Create<Scheduler> ();
+      while (!(*i)->events->IsEmpty ())
+        {
+          scheduler->Insert ((*i)->events->RemoveNext ());
+        }
+      (*i)->events = scheduler;
+    }
+  m_partitions.pop_back ();
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetSystemId (void) const
+{
+  return 0;
+}
+
+void
+MultithreadedSimulatorImpl::SetPartition (uint32_t context, uint32_t partition)
+{
+  NS_LOG_FUNCTION (this << context << partition);
+  NS_ASSERT_MSG (!m_parallel && SystemThread::Equals (m_main),
+                 "Partitions can only change while the simulation is not running");
+  NS_ASSERT (context != Simulator::NO_CONTEXT);
+  AddPartitions (partition + 1);
+  if (m_contextPartition.size () <= context)
+    {
+      m_contextPartition.resize (context + 1, NO_PARTITION);
+    }
+  m_contextPartition[context] = partition;
+  m_repartition = true;
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetPartition (uint32_t context) const
+{
+  if (context == Simulator::NO_CONTEXT)
+    {
+      return NO_PARTITION;
+    }
+  return FindPartition (context)->id - 1;
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetNPartitions (void) const
+{
+  return m_partitions.size ();
+}
+
+uint64_t
+MultithreadedSimulatorImpl::GetRounds (void) const
+{
+  return m_rounds;
+}
+
+MultithreadedSimulatorImpl::Partition *
+MultithreadedSimulatorImpl::FindPartition (uint32_t context) const
+{
+  if (context == Simulator::NO_CONTEXT)
+    {
+      return m_global;
+    }
+  if (context < m_contextPartition.size () && m_contextPartition[context] != NO_PARTITION)
+    {
+      return m_partitions[m_contextPartition[context]];
+    }
+  return m_partitions[context % m_partitions.size ()];
+}
+
+MultithreadedSimulatorImpl::Partition *
+MultithreadedSimulatorImpl::GetCurrent (void) const
+{
+  if (g_current != 0)
+    {
+      return g_current;
+    }
+  if (SystemThread::Equals (m_main))
+    {
+      return m_global;
+    }
+  return 0;
+}
+
+uint32_t
+MultithreadedSimulatorImpl::Insert (Partition *partition, Scheduler::Event ev)
+{
+  // The partition id in the low bits keeps uids unique across
+  // partitions, so that events can move between them.
+  if (partition->uid >= MAX_UID)
+    {
+      NS_FATAL_ERROR ("More than " << MAX_UID - 1 << " events scheduled in partition " <<
+                      partition->id << ": the event uids would wrap");
+    }
+  ev.key.m_uid = (partition->uid << PARTITION_BITS) | partition->id;
+  partition->uid++;
+  partition->unscheduledEvents++;
+  partition->events->Insert (ev);
+  return ev.key.m_uid;
+}
+
+void
+MultithreadedSimulatorImpl::Repartition (void)
+{
+  NS_LOG_FUNCTION (this);
+  std::vector<Scheduler::Event> moved;
+  for (std::vector<Partition *>::iterator i = m_partitions.begin (); i != m_partitions.end (); ++i)
+    {
+      Partition *partition = *i;
+      std::vector<Scheduler::Event> kept;
+      while (!partition->events->IsEmpty ())
+        {
+          Scheduler::Event ev = partition->events->RemoveNext ();
+          if (FindPartition (ev.key.m_context) == partition)
+            {
+              kept.push_back (ev);
+            }
+          else
+            {
+              moved.push_back (ev);
+              partition->unscheduledEvents--;
+            }
+        }
+      for (std::vector<Scheduler::Event>::const_iterator j = kept.begin (); j != kept.end (); ++j)
+        {
+          partition->events->Insert (*j);
+        }
+    }
+  // Moved events keep their uid, so that their EventIds stay valid, and
+  // the uids of their new partition keep growing past theirs.
+  for (std::vector<Scheduler::Event>::const_iterator i = moved.begin (); i != moved.end (); ++i)
+    {
+      Partition *partition = FindPartition (i->key.m_context);
+      partition->unscheduledEvents++;
+      partition->uid = std::max (partition->uid, (i->key.m_uid >> PARTITION_BITS) + 1);
+      NS_ASSERT (partition->uid <= MAX_UID);
+      partition->events->Insert (*i);
+    }
+  m_repartition = false;
+}
+
+void
+MultithreadedSimulatorImpl::Deliver (void)
+{
+  for (std::vector<Partition *>::iterator i = m_partitions.begin (); i != m_partitions.end (); ++i)
+    {
+      std::vector<Outgoing> &outgoing = (*i)->outgoing;
+      for (std::vector<Outgoing>::const_iterator j = outgoing.begin (); j != outgoing.end (); ++j)
+        {
+          if (j->ev.key.m_ts < j->partition->currentTs)
+            {
+              NS_FATAL_ERROR ("Event for context " << j->ev.key.m_context << " at " <<
+                              j->ev.key.m_ts << " is in the past of its partition, at " <<
+                              j->partition->currentTs << ": the Lookahead is too large");
+            }
+          Insert (j->partition, j->ev);
+        }
+      outgoing.clear ();
+    }
+  std::vector<Scheduler::Event> foreign;
+  {
+    CriticalSection cs (m_mutex);
+    m_foreign.swap (foreign);
+  }
+  for (std::vector<Scheduler::Event>::iterator i = foreign.begin (); i != foreign.end (); ++i)
+    {
+      // Current time added here, as in DefaultSimulatorImpl.
+      Partition *partition = FindPartition (i->key.m_context);
+      i->key.m_ts += partition->currentTs;
+      Insert (partition, *i);
+    }
+}
+
+void
+MultithreadedSimulatorImpl::RunPartition (Partition *partition)
+{
+  g_current = partition;
+  while (!partition->events->IsEmpty ())
+    {
+      Scheduler::Event next = partition->events->PeekNext ();
+      if (next.key.m_ts >= m_roundEnd)
+        {
+          break;
+        }
+      partition->events->RemoveNext ();
+      NS_ASSERT (next.key.m_ts >= partition->currentTs);
+      partition->unscheduledEvents--;
+      partition->currentTs = next.key.m_ts;
+      partition->currentContext = next.key.m_context;
+      partition->currentUid = next.key.m_uid;
+      next.impl->Invoke ();
+      next.impl->Unref ();
+    }
+  g_current = 0;
+}
+
+void
+MultithreadedSimulatorImpl::RunPartitionAt (Partition *partition, uint64_t ts)
+{
+  while (!partition->events->IsEmpty ()
+         && partition->events->PeekNext ().key.m_ts == ts)
+    {
+      Scheduler::Event next = partition->events->RemoveNext ();
+      partition->unscheduledEvents--;
+      partition->currentTs = next.key.m_ts;
+      partition->currentContext = next.key.m_context;
+      partition->currentUid = next.key.m_uid;
+      next.impl->Invoke ();
+      next.impl->Unref ();
+    }
+}
+
+void
+MultithreadedSimulatorImpl::RunPartitions (void)
+{
+  uint32_t i;
+  while ((i = m_nextActive.fetch_add (1, std::memory_order_relaxed)) < m_active.size ())
+    {
+      RunPartition (m_active[i]);
+    }
+}
+
+void
+MultithreadedSimulatorImpl::Work (void)
+{
+  uint64_t seen = m_firstRound;
+  while (true)
+    {
+      {
+        std::unique_lock<std::mutex> lock (m_roundMutex);
+        while (m_round == seen && !m_exit)
+          {
+            m_roundStart.wait (lock);
+          }
+        if (m_round == seen)
+          {
+            return;
+          }
+        seen = m_round;
+      }
+      RunPartitions ();
+      std::lock_guard<std::mutex> lock (m_roundMutex);
+      if (--m_busy == 0)
+        {
+          m_roundDone.notify_one ();
+        }
+    }
+}
+
+std::vector<Callback<void, Ptr<const MultithreadedSimulatorImpl> > > &
+MultithreadedSimulatorImpl::GetParallelChecks (void)
+{
+  static std::vector<Callback<void, Ptr<const MultithreadedSimulatorImpl> > > checks;
+  return checks;
+}
+
+void
+MultithreadedSimulatorImpl::AddParallelCheck (Callback<void, Ptr<const MultithreadedSimulatorImpl> > check)
+{
+  GetParallelChecks ().push_back (check);
+}
+
+void
+MultithreadedSimulatorImpl::CheckParallel (void) const
+{
+  NS_LOG_FUNCTION (this);
+  if (MemoryAccounting::IsEnabled ())
+    {
+      NS_FATAL_ERROR ("The memory accounting cannot count the objects of partitions "
+                      "run in parallel: use one thread or disable it");
+    }
+  if (TimerWheel::IsEnabled ())
+    {
+      NS_FATAL_ERROR ("The timer wheel cannot run the Timers of partitions "
+                      "run in parallel: use one thread or disable it");
+    }
+  std::vector<Callback<void, Ptr<const MultithreadedSimulatorImpl> > > &checks = GetParallelChecks ();
+  for (std::vector<Callback<void, Ptr<const MultithreadedSimulatorImpl> > >::iterator i = checks.begin ();
+       i != checks.end (); ++i)
+    {
+      (*i)(this);
+    }
+}
+
+bool
+MultithreadedSimulatorImpl::IsFinished (void) const
+{
+  if (m_stop || !m_global->events->IsEmpty ())
+    {
+      return m_stop;
+    }
+  for (std::vector<Partition *>::const_iterator i = m_partitions.begin (); i != m_partitions.end (); ++i)
+    {
+      if (!(*i)->events->IsEmpty () || !(*i)->outgoing.empty ())
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+void
+MultithreadedSimulatorImpl::Run (void)
+{
+  NS_LOG_FUNCTION (this);
+  // Set the current threadId as the main threadId
+  m_main = SystemThread::Self ();
+  m_stop = false;
+  if (m_repartition)
+    {
+      Repartition ();
+    }
+  uint64_t lookahead = std::max<int64_t> (m_lookahead.GetTimeStep (), 1);
+
+  m_firstRound = m_round;
+  m_exit = false;
+  if (std::min<uint32_t> (m_nThreads, m_partitions.size ()) > 1)
+    {
+      CheckParallel ();
+    }
+  for (uint32_t i = 1; i < std::min<uint32_t> (m_nThreads, m_partitions.size ()); ++i)
+    {
+      m_workers.push_back (Create<SystemThread> (MakeCallback (&MultithreadedSimulatorImpl::Work, this)));
+      m_workers.back ()->Start ();
+    }
+
+  uint64_t last = m_global->currentTs;
+  while (true)
+    {
+      Deliver ();
+      if (m_repartition)
+        {
+          // A global event changed the partitions.
+          Repartition ();
+          if (!m_workers.empty ())
+            {
+              CheckParallel ();
+            }
+        }
+      if (m_stop)
+        {
+          break;
+        }
+      uint64_t next = std::numeric_limits<uint64_t>::max ();
+      for (std::vector<Partition *>::const_iterator i = m_partitions.begin (); i != m_partitions.end (); ++i)
+        {
+          if (!(*i)->events->IsEmpty ())
+            {
+              next = std::min (next, (*i)->events->PeekNext ().key.m_ts);
+            }
+        }
+      uint64_t global = std::numeric_limits<uint64_t>::max ();
+      if (!m_global->events->IsEmpty ())
+        {
+          global = m_global->events->PeekNext ().key.m_ts;
+        }
+      uint64_t start = std::min (next, global);
+      if (start == std::numeric_limits<uint64_t>::max ())
+        {
+          break;
+        }
+      uint64_t stopTs = m_stopTs.load ();
+      if (start > stopTs)
+        {
+          last = stopTs;
+          m_stopTs = std::numeric_limits<uint64_t>::max ();
+          break;
+        }
+      last = start;
+      m_global->currentTs = start;
+      if (global == start)
+        {
+          // Global events run alone, before the partitions at the same time.
+          RunPartitionAt (m_global, start);
+          continue;
+        }
+
+      m_roundEnd = start + std::min (lookahead, std::numeric_limits<uint64_t>::max () - start);
+      m_roundEnd = std::min (m_roundEnd, global);
+      if (stopTs < m_roundEnd)
+        {
+          m_roundEnd = stopTs + 1;
+        }
+      m_active.clear ();
+      for (std::vector<Partition *>::const_iterator i = m_partitions.begin (); i != m_partitions.end (); ++i)
+        {
+          if (!(*i)->events->IsEmpty () && (*i)->events->PeekNext ().key.m_ts < m_roundEnd)
+            {
+              m_active.push_back (*i);
+            }
+        }
+      m_parallel = true;
+      m_nextActive.store (0, std::memory_order_relaxed);
+      if (m_active.size () > 1 && !m_workers.empty ())
+        {
+          {
+            std::lock_guard<std::mutex> lock (m_roundMutex);
+            m_busy = m_workers.size ();
+            m_round++;
+          }
+          m_roundStart.notify_all ();
+          RunPartitions ();
+          std::unique_lock<std::mutex> lock (m_roundMutex);
+          while (m_busy != 0)
+            {
+              m_roundDone.wait (lock);
+            }
+        }
+      else
+        {
+          RunPartitions ();
+        }
+      m_parallel = false;
+      m_rounds++;
+    }
+
+  {
+    std::lock_guard<std::mutex> lock (m_roundMutex);
+    m_exit = true;
+  }
+  m_roundStart.notify_all ();
+  for (std::vector<Ptr<SystemThread> >::iterator i = m_workers.begin (); i != m_workers.end (); ++i)
+    {
+      (*i)->Join ();
+    }
+  m_workers.clear ();
+
+  for (std::vector<Partition *>::const_iterator i = m_partitions.begin (); i != m_partitions.end (); ++i)
+    {
+      last = std::max (last, (*i)->currentTs);
+    }
+  m_global->currentTs = last;
+}
+
+void
+MultithreadedSimulatorImpl::Stop (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_stop = true;
+}
+
+void
+MultithreadedSimulatorImpl::Stop (const Time &delay)
+{
+  NS_LOG_FUNCTION (this << delay.GetTimeStep ());
+  Partition *current = GetCurrent ();
+  NS_ASSERT_MSG (current != 0, "Simulator::Stop Thread-unsafe invocation!");
+  uint64_t ts = current->currentTs + delay.GetTimeStep ();
+  uint64_t stopTs = m_stopTs.load ();
+  while (ts < stopTs && !m_stopTs.compare_exchange_weak (stopTs, ts))
+    {
+    }
+}
+
+EventId
+MultithreadedSimulatorImpl::Schedule (const Time &delay, EventImpl *event)
+{
+  Partition *current = GetCurrent ();
+  NS_ASSERT_MSG (current != 0, "Simulator::Schedule Thread-unsafe invocation!");
+
+  Time tAbsolute = delay + TimeStep (current->currentTs);
+  NS_ASSERT (tAbsolute.IsPositive ());
+  NS_ASSERT (tAbsolute >= TimeStep (current->currentTs));
+  Scheduler::Event ev;
+  ev.impl = event;
+  ev.key.m_ts = (uint64_t) tAbsolute.GetTimeStep ();
+  ev.key.m_context = current->currentContext;
+  uint32_t uid = Insert (current, ev);
+  return EventId (event, ev.key.m_ts, ev.key.m_context, uid);
+}
+
+void
+MultithreadedSimulatorImpl::ScheduleWithContext (uint32_t context, const Time &delay, EventImpl *event)
+{
+  Partition *current = GetCurrent ();
+  Scheduler::Event ev;
+  ev.impl = event;
+  ev.key.m_context = context;
+  if (current == 0)
+    {
+      // Current time added in Deliver()
+      ev.key.m_ts = delay.GetTimeStep ();
+      CriticalSection cs (m_mutex);
+      m_foreign.push_back (ev);
+      return;
+    }
+  ev.key.m_ts = current->currentTs + delay.GetTimeStep ();
+  Partition *partition = FindPartition (context);
+  if (partition == current || !m_parallel)
+    {
+      Insert (partition, ev);
+    }
+  else
+    {
+      Outgoing outgoing;
+      outgoing.partition = partition;
+      outgoing.ev = ev;
+      current->outgoing.push_back (outgoing);
+    }
+}
+
+EventId
+MultithreadedSimulatorImpl::ScheduleNow (EventImpl *event)
+{
+  return Schedule (Time (0), event);
+}
+
+EventId
+MultithreadedSimulatorImpl::ScheduleDestroy (EventImpl *event)
+{
+  Partition *current = GetCurrent ();
+  uint64_t ts = current != 0 ? current->currentTs : m_global->currentTs;
+  EventId id (Ptr<EventImpl> (event, false), ts, 0xffffffff, 2);
+  CriticalSection cs (m_mutex);
+  m_destroyEvents.push_back (id);
+  return id;
+}
+
+Time
+MultithreadedSimulatorImpl::Now (void) const
+{
+  // Do not add function logging here, to avoid stack overflow
+  Partition *current = GetCurrent ();
+  return TimeStep (current != 0 ? current->currentTs : m_global->currentTs);
+}
+
+Time
+MultithreadedSimulatorImpl::GetDelayLeft (const EventId &id) const
+{
+  if (IsExpired (id))
+    {
+      return TimeStep (0);
+    }
+  else
+    {
+      return TimeStep (id.GetTs ()) - Now ();
+    }
+}
+
+void
+MultithreadedSimulatorImpl::Remove (const EventId &id)
+{
+  if (id.GetUid () == 2)
+    {
+      // destroy events.
+      CriticalSection cs (m_mutex);
+      for (DestroyEvents::iterator i = m_destroyEvents.begin (); i != m_destroyEvents.end (); i++)
+        {
+          if (*i == id)
+            {
+              m_destroyEvents.erase (i);
+              break;
+            }
+        }
+      return;
+    }
+  if (IsExpired (id))
+    {
+      return;
+    }
+  if (m_repartition)
+    {
+      Repartition ();
+    }
+  Partition *partition = FindPartition (id.GetContext ());
+  NS_ASSERT_MSG (!m_parallel || partition == GetCurrent (),
+                 "Simulator::Remove of an event of another partition");
+  Scheduler::Event event;
+  event.impl = id.PeekEventImpl ();
+  event.key.m_ts = id.GetTs ();
+  event.key.m_context = id.GetContext ();
+  event.key.m_uid = id.GetUid ();
+  partition->events->Remove (event);
+  event.impl->Cancel ();
+  // whenever we remove an event from the event list, we have to unref it.
+  event.impl->Unref ();
+
+  partition->unscheduledEvents--;
+}
+
+void
+MultithreadedSimulatorImpl::Cancel (const EventId &id)
+{
+  if (!IsExpired (id))
+    {
+      id.PeekEventImpl ()->Cancel ();
+    }
+}
+
+bool
+MultithreadedSimulatorImpl::IsExpired (const EventId &id) const
+{
+  if (id.GetUid () == 2)
+    {
+      if (id.PeekEventImpl () == 0 ||
+          id.PeekEventImpl ()->IsCancelled ())
+        {
+          return true;
+        }
+      // destroy events.
+      CriticalSection cs (const_cast<SystemMutex &> (m_mutex));
+      for (DestroyEvents::const_iterator i = m_destroyEvents.begin (); i != m_destroyEvents.end (); i++)
+        {
+          if (*i == id)
+            {
+              return false;
+            }
+        }
+      return true;
+    }
+  if (id.PeekEventImpl () == 0 || id.PeekEventImpl ()->IsCancelled ())
+    {
+      return true;
+    }
+  const Partition *partition = FindPartition (id.GetContext ());
+  return id.GetTs () < partition->currentTs ||
+         (id.GetTs () == partition->currentTs && id.GetUid () <= partition->currentUid);
+}
+
+Time
+MultithreadedSimulatorImpl::GetMaximumSimulationTime (void) const
+{
+  return TimeStep (0x7fffffffffffffffLL);
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetContext (void) const
+{
+  Partition *current = GetCurrent ();
+  return current != 0 ? current->currentContext : Simulator::NO_CONTEXT;
+}
+
+} // namespace ns3
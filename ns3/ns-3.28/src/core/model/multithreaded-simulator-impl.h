@@ -0,0 +1,317 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MULTITHREADED_SIMULATOR_IMPL_H
+#define MULTITHREADED_SIMULATOR_IMPL_H
+
+#include "simulator-impl.h"
+#include "scheduler.h"
+#include "event-impl.h"
+#include "object-factory.h"
+#include "system-thread.h"
+#include "system-mutex.h"
+#include "nstime.h"
+#include "ptr.h"
+#include "callback.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <list>
+#include <mutex>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::MultithreadedSimulatorImpl declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup simulator
+ *
+ * \brief A conservative parallel simulator using threads of one process.
+ *
+ * Events are split into partitions, or logical processes, by their
+ * context: partition p holds the events of the contexts (usually node
+ * ids) assigned to it with SetPartition(), and by default of every
+ * context c with c modulo the number of partitions equal to p.  Each
+ * partition has its own event queue and clock.
+ *
+ * The simulation advances in rounds.  A round starts at the earliest
+ * timestamp T of all partitions and covers the window [T, T + Lookahead):
+ * the "Threads" worker threads then run the events of that window of
+ * all partitions in parallel.  This is safe as long as an event never
+ * schedules an event in another partition with a delay smaller than
+ * the "Lookahead" attribute, for instance because partitions are
+ * spatial regions of a wireless channel and the lookahead is the
+ * shortest propagation delay between two regions.  Events for another
+ * partition are kept in the partition which scheduled them until the
+ * end of the round, then inserted in order of partition, which keeps
+ * the results independent of the number of threads and of their
+ * timing.  An event which would arrive in the past of its partition
+ * aborts the simulation: the lookahead is too large for the model.
+ *
+ * Events without context (Simulator::NO_CONTEXT), such as events
+ * scheduled from the main program with Simulator::Schedule(), go to a
+ * global partition run by the main thread while the other partitions
+ * wait, so they can safely touch any node: a round never goes past the
+ * next global event.
+ *
+ * The models run in parallel must not share mutable state between
+ * partitions, other than through the simulator itself.  The event
+ * allocations, the Packet uids and the free lists of the Packet buffers
+ * and byte tags are safe to use from several partitions, but the
+ * reference counts of ns3::Ptr and the Packet copies, which share their
+ * buffers, are not: models which hand packets or objects to the nodes of
+ * another partition, such as channels, cannot run in parallel.  When
+ * more than one thread would run partitions, Run() aborts with a fatal
+ * error if a check added with AddParallelCheck() fails, for instance
+ * because a channel connects nodes of different partitions, or if the
+ * memory accounting or the timer wheel is enabled, as both are shared
+ * by every partition.  With one thread, the partitions run in turn and
+ * any model works.
+ *
+ * Simulator::Stop(const Time &) takes effect at the end of the round
+ * which reaches the stop time: every event at the stop time runs.
+ */
+class MultithreadedSimulatorImpl : public SimulatorImpl
+{
+public:
+  /**
+   *  Register this type.
+   *  \return The object TypeId.
+   */
+  static TypeId GetTypeId (void);
+
+  /** Constructor. */
+  MultithreadedSimulatorImpl ();
+  /** Destructor. */
+  ~MultithreadedSimulatorImpl ();
+
+  // Inherited
+  virtual void Destroy ();
+  virtual bool IsFinished (void) const;
+  virtual void Stop (void);
+  virtual void Stop (const Time &delay);
+  virtual EventId Schedule (const Time &delay, EventImpl *event);
+  virtual void ScheduleWithContext (uint32_t context, const Time &delay, EventImpl *event);
+  virtual EventId ScheduleNow (EventImpl *event);
+  virtual EventId ScheduleDestroy (EventImpl *event);
+  virtual void Remove (const EventId &id);
+  virtual void Cancel (const EventId &id);
+  virtual bool IsExpired (const EventId &id) const;
+  virtual void Run (void);
+  virtual Time Now (void) const;
+  virtual Time GetDelayLeft (const EventId &id) const;
+  virtual Time GetMaximumSimulationTime (void) const;
+  virtual void SetScheduler (ObjectFactory schedulerFactory);
+  virtual uint32_t GetSystemId (void) const;
+  virtual uint32_t GetContext (void) const;
+
+  /**
+   * Assign a context to a partition.
+   *
+   * This can only be called from the main thread, outside of Run() or
+   * from an event without context.  The events already scheduled for
+   * the context move to the partition before the next round.
+   *
+   * \param [in] context The context, usually a node id.
+   * \param [in] partition The partition, which is created if needed.
+   */
+  void SetPartition (uint32_t context, uint32_t partition);
+  /**
+   * \param [in] context A context.
+   * \returns The partition running the events of the context.
+   */
+  uint32_t GetPartition (uint32_t context) const;
+  /**
+   * \returns The number of partitions, not counting the global one.
+   */
+  uint32_t GetNPartitions (void) const;
+  /**
+   * \returns The number of rounds run so far.
+   */
+  uint64_t GetRounds (void) const;
+
+  /**
+   * Add a check of the models run before the partitions run in parallel,
+   * which calls NS_FATAL_ERROR if the models would share mutable state
+   * between partitions.
+   *
+   * \param [in] check The check, given this simulator.
+   */
+  static void AddParallelCheck (Callback<void, Ptr<const MultithreadedSimulatorImpl> > check);
+
+private:
+  virtual void DoDispose (void);
+  virtual void NotifyConstructionCompleted (void);
+
+  struct Partition;
+  /** An event for another partition, kept until the end of the round. */
+  struct Outgoing
+  {
+    Partition *partition;  /**< The destination partition. */
+    Scheduler::Event ev;   /**< The event, without uid. */
+  };
+
+  /** A logical process. */
+  struct Partition
+  {
+    uint32_t id;                    /**< Index in m_partitions + 1, 0 for the global one. */
+    Ptr<Scheduler> events;          /**< The event queue. */
+    uint64_t currentTs;             /**< Timestamp of the current event. */
+    uint32_t currentUid;            /**< Unique id of the current event. */
+    uint32_t currentContext;        /**< Context of the current event. */
+    uint32_t uid;                   /**< Next event unique id, without the partition id, below MAX_UID. */
+    int unscheduledEvents;          /**< Number of events in the queue. */
+    std::vector<Outgoing> outgoing; /**< Events for other partitions. */
+  };
+
+  /** Worker thread body: run partitions until Run() returns. */
+  void Work (void);
+  /** Run the partitions of the current round, from any thread. */
+  void RunPartitions (void);
+  /**
+   * Run the events of one partition up to the end of the round.
+   *
+   * \param [in] partition The partition.
+   */
+  void RunPartition (Partition *partition);
+  /**
+   * Run the events of a partition at one timestamp, in the main thread.
+   *
+   * \param [in] partition The partition.
+   * \param [in] ts The timestamp.
+   */
+  void RunPartitionAt (Partition *partition, uint64_t ts);
+  /**
+   * Insert an event in a partition.
+   *
+   * \param [in] partition The partition.
+   * \param [in] ev The event, whose uid is set here.
+   * \returns The uid of the event.
+   */
+  uint32_t Insert (Partition *partition, Scheduler::Event ev);
+  /** Insert the events for other partitions and from other threads. */
+  void Deliver (void);
+  /** Move the events of each context to its partition. */
+  void Repartition (void);
+  /**
+   * Create the partitions missing up to a number.
+   *
+   * \param [in] n The number of partitions.
+   */
+  void AddPartitions (uint32_t n);
+  /**
+   * \returns The partition of the calling thread, or 0 for a thread
+   *          which is not running the simulation.
+   */
+  Partition * GetCurrent (void) const;
+  /**
+   * \param [in] context A context.
+   * \returns The partition of the context.
+   */
+  Partition * FindPartition (uint32_t context) const;
+  /** Abort if the models cannot run in parallel. */
+  void CheckParallel (void) const;
+  /**
+   * \returns The checks added with AddParallelCheck().
+   */
+  static std::vector<Callback<void, Ptr<const MultithreadedSimulatorImpl> > > & GetParallelChecks (void);
+
+  /** The partitions, with the global one last. */
+  std::vector<Partition *> m_partitions;
+  /** The global partition, for events without context. */
+  Partition *m_global;
+  /** Explicit partition of each context, or NO_PARTITION. */
+  std::vector<uint32_t> m_contextPartition;
+  /** Set when contexts changed partition since the last Run(). */
+  bool m_repartition;
+  /** Factory of the event queues. */
+  ObjectFactory m_schedulerFactory;
+
+  /** Smallest delay of events scheduled for another partition. */
+  Time m_lookahead;
+  /** Number of threads running partitions, 0 for one per core. */
+  uint32_t m_nThreads;
+  /** Initial number of partitions, 0 for one per thread. */
+  uint32_t m_nPartitions;
+
+  /** Threads running partitions besides the main one. */
+  std::vector<Ptr<SystemThread> > m_workers;
+  /** Partitions with events in the current round. */
+  std::vector<Partition *> m_active;
+  /** Next entry of m_active to run. */
+  std::atomic<uint32_t> m_nextActive;
+  /** End of the current round, excluded. */
+  uint64_t m_roundEnd;
+  /** Mutex protecting m_round, m_busy and m_exit. */
+  std::mutex m_roundMutex;
+  /** Signaled when a round starts or the workers must exit. */
+  std::condition_variable m_roundStart;
+  /** Signaled when the last worker finishes a round. */
+  std::condition_variable m_roundDone;
+  /** Round number, which workers wait on. */
+  uint64_t m_round;
+  /** Round number when the workers were started. */
+  uint64_t m_firstRound;
+  /** Number of workers still running the current round. */
+  uint32_t m_busy;
+  /** Set to release the workers at the end of Run(). */
+  bool m_exit;
+  /** Set while the partitions run in parallel. */
+  bool m_parallel;
+  /** Number of rounds run. */
+  uint64_t m_rounds;
+
+  /** Flag calling for the end of the simulation. */
+  std::atomic<bool> m_stop;
+  /** Timestamp at which the simulation stops. */
+  std::atomic<uint64_t> m_stopTs;
+
+  /** Container type for the events to run at Simulator::Destroy() */
+  typedef std::list<EventId> DestroyEvents;
+  /** The container of events to run at Destroy. */
+  DestroyEvents m_destroyEvents;
+  /**
+   * Events scheduled by threads which do not run the simulation, with
+   * their delay as timestamp.
+   */
+  std::vector<Scheduler::Event> m_foreign;
+  /** Mutex protecting m_foreign and m_destroyEvents. */
+  SystemMutex m_mutex;
+
+  /** Main execution thread. */
+  SystemThread::ThreadId m_main;
+
+  /** The partition run by the calling thread. */
+  static thread_local Partition *g_current;
+
+  /** Marks a context without explicit partition. */
+  static const uint32_t NO_PARTITION = 0xffffffff;
+  /** Low bits of event uids holding the partition id. */
+  static const uint32_t PARTITION_BITS = 6;
+  /** Largest number of partitions. */
+  static const uint32_t MAX_PARTITIONS = (1 << PARTITION_BITS) - 1;
+  /** Largest number of events scheduled in one partition, plus one. */
+  static const uint32_t MAX_UID = 1U << (32 - PARTITION_BITS);
+};
+
+} // namespace ns3
+
+#endif /* MULTITHREADED_SIMULATOR_IMPL_H */
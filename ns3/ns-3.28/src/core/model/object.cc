@@ -25,6 +25,7 @@
 #include "attribute.h"
 #include "log.h"
 #include "string.h"
+#include "memory-accounting.h"
 #include <vector>
 #include <sstream>
 #include <cstdlib>
@@ -46,6 +47,31 @@ NS_LOG_COMPONENT_DEFINE ("Object");
 
 NS_OBJECT_ENSURE_REGISTERED (Object);
 
+/**
+ * \ingroup object
+ * An open addressing hash table of the Objects aggregated together,
+ * indexed by the uid of their TypeId and of its parents, with linear
+ * probing.
+ *
+ * This uses the same trick as Object::Aggregates to allocate the
+ * slots with the table.
+ */
+struct Object::Lookup
+{
+  /** The number of slots, a power of two, minus one. */
+  uint32_t mask;
+  /** An entry of the table. */
+  struct Slot
+  {
+    /** The TypeId uid, or 0 for an empty slot. */
+    uint16_t uid;
+    /** The Object with this TypeId, or 0 if several have it. */
+    Object *object;
+  };
+  /** The slots. */
+  struct Slot slots[1];
+};
+
 Object::AggregateIterator::AggregateIterator ()
   : m_object (0),
     m_current (0)
@@ -97,17 +123,23 @@ Object::Object ()
   : m_tid (Object::GetTypeId ()),
     m_disposed (false),
     m_initialized (false),
+    m_accounted (false),
     m_aggregates ((struct Aggregates *) std::malloc (sizeof (struct Aggregates))),
     m_getObjectCount (0)
 {
   NS_LOG_FUNCTION (this);
   m_aggregates->n = 1;
+  m_aggregates->lookup = 0;
   m_aggregates->buffer[0] = this;
 }
 Object::~Object () 
 {
   // remove this object from the aggregate list
   NS_LOG_FUNCTION (this);
+  if (m_accounted)
+    {
+      MemoryAccounting::Deallocate (m_tid);
+    }
   uint32_t n = m_aggregates->n;
   for (uint32_t i = 0; i < n; i++)
     {
@@ -120,6 +152,10 @@ Object::~Object ()
           m_aggregates->n--;
         }
     }
+  // the remaining objects are being deleted too: fall back to
+  // the linear search in DoGetObject rather than rebuild the lookup
+  std::free (m_aggregates->lookup);
+  m_aggregates->lookup = 0;
   // finally, if all objects have been removed from the list,
   // delete the aggregate list
   if (m_aggregates->n == 0)
@@ -132,11 +168,18 @@ Object::Object (const Object &o)
   : m_tid (o.m_tid),
     m_disposed (false),
     m_initialized (false),
+    m_accounted (false),
     m_aggregates ((struct Aggregates *) std::malloc (sizeof (struct Aggregates))),
     m_getObjectCount (0)
 {
   m_aggregates->n = 1;
+  m_aggregates->lookup = 0;
   m_aggregates->buffer[0] = this;
+  if (MemoryAccounting::IsEnabled ())
+    {
+      MemoryAccounting::Allocate (m_tid);
+      m_accounted = true;
+    }
 }
 void
 Object::Construct (const AttributeConstructionList &attributes)
@@ -151,6 +194,27 @@ Object::DoGetObject (TypeId tid) const
   NS_LOG_FUNCTION (this << tid);
   NS_ASSERT (CheckLoose ());
 
+  struct Lookup *lookup = m_aggregates->lookup;
+  if (lookup != 0)
+    {
+      uint16_t uid = tid.GetUid ();
+      uint32_t i = uid & lookup->mask;
+      while (lookup->slots[i].uid != uid)
+        {
+          if (lookup->slots[i].uid == 0)
+            {
+              return 0;
+            }
+          i = (i + 1) & lookup->mask;
+        }
+      if (lookup->slots[i].object != 0)
+        {
+          return lookup->slots[i].object;
+        }
+      // Several objects have this TypeId: search them in the
+      // most-recently-used order below, as without the lookup.
+    }
+
   uint32_t n = m_aggregates->n;
   TypeId objectTid = Object::GetTypeId ();
   for (uint32_t i = 0; i < n; i++)
@@ -248,6 +312,62 @@ Object::UpdateSortedArray (struct Aggregates *aggregates, uint32_t j) const
       j--;
     }
 }
+void
+Object::BuildLookup (struct Aggregates *aggregates)
+{
+  NS_LOG_FUNCTION (aggregates);
+  std::free (aggregates->lookup);
+
+  // Each object matches its TypeId and parents, up to ns3::Object,
+  // as in DoGetObject.
+  TypeId objectTid = Object::GetTypeId ();
+  std::vector<std::pair<uint16_t, Object *> > entries;
+  for (uint32_t i = 0; i < aggregates->n; i++)
+    {
+      Object *current = aggregates->buffer[i];
+      TypeId cur = current->GetInstanceTypeId ();
+      entries.push_back (std::make_pair (cur.GetUid (), current));
+      while (cur != objectTid && cur.GetParent () != cur)
+        {
+          cur = cur.GetParent ();
+          entries.push_back (std::make_pair (cur.GetUid (), current));
+        }
+    }
+
+  // At most half full, to keep the probe sequences short.
+  uint32_t size = 1;
+  while (size < 2 * entries.size ())
+    {
+      size <<= 1;
+    }
+  struct Lookup *lookup =
+    (struct Lookup *)std::malloc (sizeof (struct Lookup) + (size - 1) * sizeof (struct Lookup::Slot));
+  lookup->mask = size - 1;
+  for (uint32_t i = 0; i < size; i++)
+    {
+      lookup->slots[i].uid = 0;
+      lookup->slots[i].object = 0;
+    }
+  for (std::vector<std::pair<uint16_t, Object *> >::const_iterator j = entries.begin ();
+       j != entries.end (); ++j)
+    {
+      uint32_t i = j->first & lookup->mask;
+      while (lookup->slots[i].uid != 0 && lookup->slots[i].uid != j->first)
+        {
+          i = (i + 1) & lookup->mask;
+        }
+      if (lookup->slots[i].uid == 0)
+        {
+          lookup->slots[i].uid = j->first;
+          lookup->slots[i].object = j->second;
+        }
+      else
+        {
+          lookup->slots[i].object = 0;
+        }
+    }
+  aggregates->lookup = lookup;
+}
 void 
 Object::AggregateObject (Ptr<Object> o)
 {
@@ -263,6 +383,7 @@ Object::AggregateObject (Ptr<Object> o)
   struct Aggregates *aggregates = 
     (struct Aggregates *)std::malloc (sizeof(struct Aggregates)+(total-1)*sizeof(Object*));
   aggregates->n = total;
+  aggregates->lookup = 0;
 
   // copy our buffer to the new buffer
   std::memcpy (&aggregates->buffer[0], 
@@ -283,6 +404,7 @@ Object::AggregateObject (Ptr<Object> o)
         }
       UpdateSortedArray (aggregates, m_aggregates->n + i);
     }
+  BuildLookup (aggregates);
 
   // keep track of the old aggregate buffers for the iteration
   // of NotifyNewAggregates
@@ -314,7 +436,9 @@ Object::AggregateObject (Ptr<Object> o)
     }
 
   // Now that we are done with them, we can free our old aggregate buffers
+  std::free (a->lookup);
   std::free (a);
+  std::free (b->lookup);
   std::free (b);
 }
 /**
@@ -339,7 +463,20 @@ Object::SetTypeId (TypeId tid)
 {
   NS_LOG_FUNCTION (this << tid);
   NS_ASSERT (Check ());
+  if (m_accounted)
+    {
+      MemoryAccounting::Deallocate (m_tid);
+    }
   m_tid = tid;
+  m_accounted = MemoryAccounting::IsEnabled ();
+  if (m_accounted)
+    {
+      MemoryAccounting::Allocate (m_tid);
+    }
+  if (m_aggregates->lookup != 0)
+    {
+      BuildLookup (m_aggregates);
+    }
 }
 
 void
@@ -320,6 +320,13 @@ private:
   friend class AggregateIterator;
   friend struct ObjectDeleter;
 
+  /**
+   * The Objects aggregated together, by TypeId and parent TypeIds.
+   *
+   * Defined in object.cc.
+   */
+  struct Lookup;
+
   /**
    * The list of Objects aggregated to this one.
    *
@@ -335,6 +342,11 @@ private:
   struct Aggregates {
     /** The number of entries in \c buffer. */
     uint32_t n;
+    /**
+     * The Objects by TypeId, built when Objects are aggregated,
+     * or 0 for an Object on its own.
+     */
+    struct Lookup *lookup;
     /** The array of Objects. */
     Object *buffer[1];
   };
@@ -393,6 +405,14 @@ private:
    * \param [in] i The most recently used entry in the list.
    */
   void UpdateSortedArray (struct Aggregates *aggregates, uint32_t i) const;
+  /**
+   * Build the table of a list of aggregated Objects by TypeId, which
+   * makes GetObject() a hash table lookup rather than a walk of the
+   * TypeId parents of each Object.
+   *
+   * \param [in,out] aggregates The list of aggregated Objects.
+   */
+  static void BuildLookup (struct Aggregates *aggregates);
   /**
    * Attempt to delete this Object.
    *
@@ -416,6 +436,11 @@ private:
    * \c false otherwise
    */
   bool m_initialized;
+  /**
+   * Set to \c true when this Object is counted by MemoryAccounting
+   * under m_tid, \c false otherwise.
+   */
+  bool m_accounted;
   /**
    * A pointer to an array of 'aggregates'.
    *
@@ -459,11 +484,15 @@ Ptr<T>
 Object::GetObject () const
 {
   // This is an optimization: if the cast works (which is likely),
-  // things will be pretty fast.
-  T *result = dynamic_cast<T *> (m_aggregates->buffer[0]);
-  if (result != 0)
+  // things will be pretty fast.  Once Objects are aggregated, the
+  // lookup by TypeId is faster than a failed cast.
+  if (m_aggregates->lookup == 0)
     {
-      return Ptr<T> (result);
+      T *result = dynamic_cast<T *> (m_aggregates->buffer[0]);
+      if (result != 0)
+        {
+          return Ptr<T> (result);
+        }
     }
   // if the cast does not work, we try to do a full type check.
   Ptr<Object> found = DoGetObject (T::GetTypeId ());
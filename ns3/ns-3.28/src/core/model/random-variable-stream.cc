@@ -34,6 +34,7 @@
 #include "rng-stream.h"
 #include "rng-seed-manager.h"
 #include "unused.h"
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 
@@ -47,6 +48,13 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("RandomVariableStream");
 
+/**
+ * \ingroup randomvariable
+ * The number of uniform randoms GetValues() draws from the RngStream
+ * at a time.
+ */
+static const std::size_t g_uniformBatch = 64;
+
 NS_OBJECT_ENSURE_REGISTERED (RandomVariableStream);
 
 TypeId 
@@ -138,6 +146,16 @@ RandomVariableStream::Peek(void) const
   return m_rng;
 }
 
+void
+RandomVariableStream::GetValues (double *values, std::size_t n)
+{
+  NS_LOG_FUNCTION (this << values << n);
+  for (std::size_t i = 0; i < n; ++i)
+    {
+      values[i] = GetValue ();
+    }
+}
+
 NS_OBJECT_ENSURE_REGISTERED(UniformRandomVariable);
 
 TypeId 
@@ -188,6 +206,22 @@ UniformRandomVariable::GetValue (double min, double max)
     }
   return v;
 }
+void
+UniformRandomVariable::GetValues (double min, double max, double *values, std::size_t n)
+{
+  NS_LOG_FUNCTION (this << min << max << values << n);
+  Peek ()->RandU01 (values, n);
+  bool antithetic = IsAntithetic ();
+  for (std::size_t i = 0; i < n; ++i)
+    {
+      double v = min + values[i] * (max - min);
+      if (antithetic)
+        {
+          v = min + (max - v);
+        }
+      values[i] = v;
+    }
+}
 uint32_t 
 UniformRandomVariable::GetInteger (uint32_t min, uint32_t max)
 {
@@ -208,6 +242,12 @@ UniformRandomVariable::GetInteger (void)
   NS_LOG_FUNCTION (this);
   return (uint32_t)GetValue (m_min, m_max + 1);
 }
+void
+UniformRandomVariable::GetValues (double *values, std::size_t n)
+{
+  NS_LOG_FUNCTION (this << values << n);
+  GetValues (m_min, m_max, values, n);
+}
 
 NS_OBJECT_ENSURE_REGISTERED(ConstantRandomVariable);
 
@@ -439,6 +479,34 @@ ExponentialRandomVariable::GetValue (void)
   NS_LOG_FUNCTION (this);
   return GetValue (m_mean, m_bound);
 }
+void
+ExponentialRandomVariable::GetValues (double *values, std::size_t n)
+{
+  NS_LOG_FUNCTION (this << values << n);
+  double u[g_uniformBatch];
+  bool antithetic = IsAntithetic ();
+  std::size_t j = 0;
+  while (j < n)
+    {
+      // Each value takes at least one uniform: draw no more than the
+      // values left, so that the stream ends where GetValue() leaves it.
+      std::size_t m = std::min (n - j, g_uniformBatch);
+      Peek ()->RandU01 (u, m);
+      for (std::size_t i = 0; i < m; ++i)
+        {
+          double v = u[i];
+          if (antithetic)
+            {
+              v = (1 - v);
+            }
+          double r = -m_mean*std::log (v);
+          if (m_bound == 0 || r <= m_bound)
+            {
+              values[j++] = r;
+            }
+        }
+    }
+}
 uint32_t 
 ExponentialRandomVariable::GetInteger (void)
 {
@@ -772,6 +840,65 @@ NormalRandomVariable::GetValue (void)
   NS_LOG_FUNCTION (this);
   return GetValue (m_mean, m_variance, m_bound);
 }
+void
+NormalRandomVariable::GetValues (double *values, std::size_t n)
+{
+  NS_LOG_FUNCTION (this << values << n);
+  double u[g_uniformBatch];
+  bool antithetic = IsAntithetic ();
+  double sd = std::sqrt (m_variance);
+  std::size_t j = 0;
+  while (j < n)
+    {
+      if (m_nextValid)
+        { // use previously generated
+          m_nextValid = false;
+          values[j++] = m_next;
+          continue;
+        }
+      // Each pair of uniforms gives at most two values: draw no more
+      // pairs than needed for the values left, so that the stream ends
+      // where GetValue() leaves it.
+      std::size_t m = std::min ((n - j + 1) / 2, g_uniformBatch / 2);
+      Peek ()->RandU01 (u, 2 * m);
+      for (std::size_t i = 0; i < m; ++i)
+        {
+          // Same as GetValue (double, double, double)
+          double u1 = u[2 * i];
+          double u2 = u[2 * i + 1];
+          if (antithetic)
+            {
+              u1 = (1 - u1);
+              u2 = (1 - u2);
+            }
+          double v1 = 2 * u1 - 1;
+          double v2 = 2 * u2 - 1;
+          double w = v1 * v1 + v2 * v2;
+          if (w <= 1.0)
+            {
+              double y = std::sqrt ((-2 * std::log (w)) / w);
+              m_next = m_mean + v2 * y * sd;
+              m_nextValid = std::fabs (m_next - m_mean) <= m_bound;
+              double x1 = m_mean + v1 * y * sd;
+              if (std::fabs (x1 - m_mean) <= m_bound)
+                {
+                  values[j++] = x1;
+                }
+              else if (m_nextValid)
+                {
+                  m_nextValid = false;
+                  values[j++] = m_next;
+                }
+              // the second value is the next one, unless this was the last
+              if (m_nextValid && j < n)
+                {
+                  m_nextValid = false;
+                  values[j++] = m_next;
+                }
+            }
+        }
+    }
+}
 uint32_t 
 NormalRandomVariable::GetInteger (void)
 {
@@ -892,6 +1019,42 @@ LogNormalRandomVariable::GetValue (void)
   NS_LOG_FUNCTION (this);
   return GetValue (m_mu, m_sigma);
 }
+void
+LogNormalRandomVariable::GetValues (double *values, std::size_t n)
+{
+  NS_LOG_FUNCTION (this << values << n);
+  double u[g_uniformBatch];
+  bool antithetic = IsAntithetic ();
+  std::size_t j = 0;
+  while (j < n)
+    {
+      // Each value takes at least one pair of uniforms: draw no more
+      // pairs than the values left, so that the stream ends where
+      // GetValue() leaves it.
+      std::size_t m = std::min (n - j, g_uniformBatch / 2);
+      Peek ()->RandU01 (u, 2 * m);
+      for (std::size_t i = 0; i < m; ++i)
+        {
+          // Same as GetValue (double, double)
+          double u1 = u[2 * i];
+          double u2 = u[2 * i + 1];
+          if (antithetic)
+            {
+              u1 = (1 - u1);
+              u2 = (1 - u2);
+            }
+          double v1 = -1 + 2 * u1;
+          double v2 = -1 + 2 * u2;
+          double r2 = v1 * v1 + v2 * v2;
+          if (r2 > 1.0 || r2 == 0)
+            {
+              continue;
+            }
+          double normal = v1 * std::sqrt (-2.0 * std::log (r2) / r2);
+          values[j++] = std::exp (m_sigma * normal + m_mu);
+        }
+    }
+}
 uint32_t 
 LogNormalRandomVariable::GetInteger (void)
 {
@@ -30,6 +30,7 @@
 #include "object.h"
 #include "attribute-helper.h"
 #include <stdint.h>
+#include <cstddef>
 
 /**
  * \file
@@ -149,6 +150,20 @@ public:
    */
   virtual uint32_t GetInteger (void) = 0;
 
+  /**
+   * \brief Get the next random values as doubles drawn from the distribution.
+   *
+   * The values are those \p n calls to GetValue(void) would return,
+   * in the same order, and the stream is left in the same state.
+   * The uniform, exponential, normal and log-normal distributions draw
+   * the uniform randoms they need in bulk from the RngStream, rather
+   * than one call at a time.
+   *
+   * \param [out] values The array to write the values to.
+   * \param [in] n The number of values.
+   */
+  virtual void GetValues (double *values, std::size_t n);
+
 protected:
   /**
    * \brief Get the pointer to the underlying RngStream.
@@ -281,6 +296,20 @@ public:
    */
   uint32_t GetInteger (uint32_t min, uint32_t max);
 
+  /**
+   * \brief Get the next random values, as doubles in the specified range
+   * \f$[min, max)\f$.
+   *
+   * The values are those \p n calls to GetValue(double,double) would
+   * return.
+   *
+   * \param [in] min Low end of the range (included).
+   * \param [in] max High end of the range (excluded).
+   * \param [out] values The array to write the values to.
+   * \param [in] n The number of values.
+   */
+  void GetValues (double min, double max, double *values, std::size_t n);
+
   // Inherited from RandomVariableStream
   /**
    * \brief Get the next random value as a double drawn from the distribution.
@@ -294,6 +323,7 @@ public:
    * \note The upper limit is included in the output range.
    */
   virtual uint32_t GetInteger (void);
+  virtual void GetValues (double *values, std::size_t n);
   
 private:
   /** The lower bound on values that can be returned by this RNG stream. */
@@ -586,6 +616,7 @@ public:
   // Inherited from RandomVariableStream
   virtual double GetValue (void);
   virtual uint32_t GetInteger (void);
+  virtual void GetValues (double *values, std::size_t n);
 
 private:
   /** The mean value of the unbounded exponential distribution. */
@@ -1234,6 +1265,9 @@ public:
    */
   virtual uint32_t GetInteger (void);
 
+  // Inherited from RandomVariableStream
+  virtual void GetValues (double *values, std::size_t n);
+
 private:
   /** The mean value for the normal distribution returned by this RNG stream. */
   double m_mean;
@@ -1464,6 +1498,9 @@ public:
    */
   virtual uint32_t GetInteger (void);
 
+  // Inherited from RandomVariableStream
+  virtual void GetValues (double *values, std::size_t n);
+
 private:
   /** The mu value for the log-normal distribution returned by this RNG stream. */
   double m_mu;
@@ -21,6 +21,7 @@
 #define RNGSTREAM_H
 #include <string>
 #include <stdint.h>
+#include <cstddef>
 
 /**
  * \file
@@ -70,6 +71,23 @@ public:
    * \returns The next random.
    */
   double RandU01 (void);
+  /**
+   * Generate the next random numbers for this stream, the same as
+   * \p n calls to RandU01(void) would.
+   *
+   * The state of the generator stays in registers for the whole loop.
+   * The randoms are generated one after the other: they could also be
+   * generated in interleaved lanes, each advancing its own copy of the
+   * state by the k-th powers of the transition matrices, which gives
+   * the same sequence.  But the entries of these powers are full size,
+   * so each lane step takes nine exact products modulo m per component
+   * instead of two small ones, which costs more than it saves without
+   * vector 64-bit modular products.
+   *
+   * \param [out] values The array to write the randoms to.
+   * \param [in] n The number of randoms.
+   */
+  void RandU01 (double *values, std::size_t n);
 
 private:
   /**
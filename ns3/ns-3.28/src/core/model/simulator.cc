@@ -24,6 +24,8 @@
 #include "map-scheduler.h"
 #include "event-impl.h"
 #include "des-metrics.h"
+#include "memory-accounting.h"
+#include "timer-wheel.h"
 
 #include "ptr.h"
 #include "string.h"
@@ -132,6 +134,20 @@ NodePrinter (std::ostream &os)
     }
 }
 
+/**
+ * \ingroup logging
+ * Default LogBuffer::Clock implementation.
+ *
+ * \param [out] time The current simulation time, in time steps.
+ * \param [out] context The current context.
+ */
+static void
+LogClock (int64_t &time, uint32_t &context)
+{
+  time = Simulator::Now ().GetTimeStep ();
+  context = Simulator::GetContext ();
+}
+
 /**
  * \ingroup simulator
  * \brief Get the static SimulatorImpl instance.
@@ -157,6 +173,7 @@ static SimulatorImpl * GetImpl (void)
    */
   if (*pimpl == 0)
     {
+      MemoryAccounting::Initialize ();
       {
         ObjectFactory factory;
         StringValue s;
@@ -182,6 +199,7 @@ static SimulatorImpl * GetImpl (void)
 //
       LogSetTimePrinter (&TimePrinter);
       LogSetNodePrinter (&NodePrinter);
+      LogBuffer::SetClock (&LogClock);
     }
   return *pimpl;
 }
@@ -191,6 +209,7 @@ Simulator::Destroy (void)
 {
   NS_LOG_FUNCTION_NOARGS ();
 
+  TimerWheel::Reset ();
   SimulatorImpl **pimpl = PeekImpl (); 
   if (*pimpl == 0)
     {
@@ -201,8 +220,13 @@ Simulator::Destroy (void)
    * legal), Simulator::GetImpl will trigger again an infinite recursion until
    * the stack explodes.
    */
+  if (MemoryAccounting::IsEnabled ())
+    {
+      MemoryAccounting::Print (std::clog);
+    }
   LogSetTimePrinter (0);
   LogSetNodePrinter (0);
+  LogBuffer::SetClock (0);
   (*pimpl)->Destroy ();
   (*pimpl)->Unref ();
   *pimpl = 0;
@@ -419,6 +443,7 @@ Simulator::SetImplementation (Ptr<SimulatorImpl> impl)
 //
   LogSetTimePrinter (&TimePrinter);
   LogSetNodePrinter (&NodePrinter);
+  LogBuffer::SetClock (&LogClock);
 }
 
 Ptr<SimulatorImpl>
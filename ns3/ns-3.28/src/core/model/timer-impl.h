@@ -131,6 +131,11 @@ public:
   virtual EventId Schedule (const Time &delay) = 0;
   /** Invoke the expire function. */
   virtual void Invoke (void) = 0;
+  /**
+   * \returns A copy of this implementation, with the same function and
+   *          arguments.
+   */
+  virtual TimerImpl * Copy (void) const = 0;
 };
 
 } // namespace ns3
@@ -270,6 +275,10 @@ MakeTimerImpl (IntToType<0>, FN fn)
       : m_fn (fn)
     {
     }
+    virtual TimerImpl * Copy (void) const
+    {
+      return new FnTimerImplZero (*this);
+    }
     virtual EventId Schedule (const Time &delay)
     {
       return Simulator::Schedule (delay, m_fn);
@@ -305,6 +314,10 @@ MakeTimerImpl (IntToType<1>, FN fn)
     {
       m_a1 = a1;
     }
+    virtual TimerImpl * Copy (void) const
+    {
+      return new FnTimerImplOne (*this);
+    }
     virtual EventId Schedule (const Time &delay)
     {
       return Simulator::Schedule (delay, m_fn, m_a1);
@@ -345,6 +358,10 @@ MakeTimerImpl (IntToType<2>, FN fn)
       m_a1 = a1;
       m_a2 = a2;
     }
+    virtual TimerImpl * Copy (void) const
+    {
+      return new FnTimerImplTwo (*this);
+    }
     virtual EventId Schedule (const Time &delay)
     {
       return Simulator::Schedule (delay, m_fn, m_a1, m_a2);
@@ -390,6 +407,10 @@ MakeTimerImpl (IntToType<3>, FN fn)
       m_a2 = a2;
       m_a3 = a3;
     }
+    virtual TimerImpl * Copy (void) const
+    {
+      return new FnTimerImplThree (*this);
+    }
     virtual EventId Schedule (const Time &delay)
     {
       return Simulator::Schedule (delay, m_fn, m_a1, m_a2, m_a3);
@@ -440,6 +461,10 @@ MakeTimerImpl (IntToType<4>, FN fn)
       m_a3 = a3;
       m_a4 = a4;
     }
+    virtual TimerImpl * Copy (void) const
+    {
+      return new FnTimerImplFour (*this);
+    }
     virtual EventId Schedule (const Time &delay)
     {
       return Simulator::Schedule (delay, m_fn, m_a1, m_a2, m_a3, m_a4);
@@ -495,6 +520,10 @@ MakeTimerImpl (IntToType<5>, FN fn)
       m_a4 = a4;
       m_a5 = a5;
     }
+    virtual TimerImpl * Copy (void) const
+    {
+      return new FnTimerImplFive (*this);
+    }
     virtual EventId Schedule (const Time &delay)
     {
       return Simulator::Schedule (delay, m_fn, m_a1, m_a2, m_a3, m_a4, m_a5);
@@ -555,6 +584,10 @@ MakeTimerImpl (IntToType<6>, FN fn)
       m_a5 = a5;
       m_a6 = a6;
     }
+    virtual TimerImpl * Copy (void) const
+    {
+      return new FnTimerImplSix (*this);
+    }
     virtual EventId Schedule (const Time &delay)
     {
       return Simulator::Schedule (delay, m_fn, m_a1, m_a2, m_a3, m_a4, m_a5, m_a6);
@@ -645,6 +678,10 @@ MakeTimerImpl (IntToType<0>, MEM_PTR memPtr, OBJ_PTR objPtr)
         m_objPtr (objPtr)
     {
     }
+    virtual TimerImpl * Copy (void) const
+    {
+      return new MemFnTimerImplZero (*this);
+    }
     virtual EventId Schedule (const Time &delay)
     {
       return Simulator::Schedule (delay, m_memPtr, m_objPtr);
@@ -682,6 +719,10 @@ MakeTimerImpl (IntToType<1>, MEM_PTR memPtr, OBJ_PTR objPtr)
     {
       m_a1 = a1;
     }
+    virtual TimerImpl * Copy (void) const
+    {
+      return new MemFnTimerImplOne (*this);
+    }
     virtual EventId Schedule (const Time &delay)
     {
       return Simulator::Schedule (delay, m_memPtr, m_objPtr, m_a1);
@@ -724,6 +765,10 @@ MakeTimerImpl (IntToType<2>, MEM_PTR memPtr, OBJ_PTR objPtr)
       m_a1 = a1;
       m_a2 = a2;
     }
+    virtual TimerImpl * Copy (void) const
+    {
+      return new MemFnTimerImplTwo (*this);
+    }
     virtual EventId Schedule (const Time &delay)
     {
       return Simulator::Schedule (delay, m_memPtr, m_objPtr, m_a1, m_a2);
@@ -771,6 +816,10 @@ MakeTimerImpl (IntToType<3>, MEM_PTR memPtr, OBJ_PTR objPtr)
       m_a2 = a2;
       m_a3 = a3;
     }
+    virtual TimerImpl * Copy (void) const
+    {
+      return new MemFnTimerImplThree (*this);
+    }
     virtual EventId Schedule (const Time &delay)
     {
       return Simulator::Schedule (delay, m_memPtr, m_objPtr, m_a1, m_a2, m_a3);
@@ -823,6 +872,10 @@ MakeTimerImpl (IntToType<4>, MEM_PTR memPtr, OBJ_PTR objPtr)
       m_a3 = a3;
       m_a4 = a4;
     }
+    virtual TimerImpl * Copy (void) const
+    {
+      return new MemFnTimerImplFour (*this);
+    }
     virtual EventId Schedule (const Time &delay)
     {
       return Simulator::Schedule (delay, m_memPtr, m_objPtr, m_a1, m_a2, m_a3, m_a4);
@@ -880,6 +933,10 @@ MakeTimerImpl (IntToType<5>, MEM_PTR memPtr, OBJ_PTR objPtr)
       m_a4 = a4;
       m_a5 = a5;
     }
+    virtual TimerImpl * Copy (void) const
+    {
+      return new MemFnTimerImplFive (*this);
+    }
     virtual EventId Schedule (const Time &delay)
     {
       return Simulator::Schedule (delay, m_memPtr, m_objPtr, m_a1, m_a2, m_a3, m_a4, m_a5);
@@ -942,6 +999,10 @@ MakeTimerImpl (IntToType<6>, MEM_PTR memPtr, OBJ_PTR objPtr)
       m_a5 = a5;
       m_a6 = a6;
     }
+    virtual TimerImpl * Copy (void) const
+    {
+      return new MemFnTimerImplSix (*this);
+    }
     virtual EventId Schedule (const Time &delay)
     {
       return Simulator::Schedule (delay, m_memPtr, m_objPtr, m_a1, m_a2, m_a3, m_a4, m_a5, m_a6);
@@ -0,0 +1,379 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "timer-wheel.h"
+#include "timer.h"
+#include "simulator.h"
+#include "simulation-singleton.h"
+#include "global-value.h"
+#include "boolean.h"
+#include "assert.h"
+#include "log.h"
+#include <algorithm>
+
+/**
+ * \file
+ * \ingroup timer
+ * ns3::TimerWheel implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TimerWheel");
+
+/**
+ * \ingroup timer
+ * Whether Timers use the TimerWheel.
+ *
+ * This is accessible as "--TimerWheel" from CommandLine.
+ */
+static GlobalValue g_timerWheel ("TimerWheel",
+                                 "Expire ns3::Timer through a timer wheel instead "
+                                 "of one simulator event per Timer",
+                                 BooleanValue (false),
+                                 MakeBooleanChecker ());
+/**
+ * \ingroup timer
+ * The duration of a level 0 slot of the TimerWheel.
+ *
+ * This is accessible as "--TimerWheelResolution" from CommandLine.
+ */
+static GlobalValue g_timerWheelResolution ("TimerWheelResolution",
+                                           "Duration of a slot of the timer wheel",
+                                           TimeValue (MilliSeconds (1)),
+                                           MakeTimeChecker (TimeStep (1)));
+
+int TimerWheel::m_enabled = -1;
+
+namespace {
+
+/**
+ * \param [in] bits A non zero bit set.
+ * \returns The index of the lowest bit set.
+ */
+uint32_t
+LowestBit (uint64_t bits)
+{
+  uint32_t i = 0;
+  while ((bits & 1) == 0)
+    {
+      bits >>= 1;
+      i++;
+    }
+  return i;
+}
+
+} // unnamed namespace
+
+TimerWheel::TimerWheel ()
+  : m_cursor (0),
+    m_seq (0),
+    m_nTimers (0),
+    m_eventTs (0),
+    m_expiring (false)
+{
+  NS_LOG_FUNCTION (this);
+  TimeValue resolution;
+  g_timerWheelResolution.GetValue (resolution);
+  m_resolution = resolution.Get ().GetTimeStep ();
+  for (uint32_t l = 0; l < LEVELS; ++l)
+    {
+      m_occupied[l] = 0;
+    }
+}
+
+TimerWheel::~TimerWheel ()
+{
+  NS_LOG_FUNCTION (this);
+  for (std::vector<Entry>::iterator i = m_entries.begin (); i != m_entries.end (); ++i)
+    {
+      if (i->timer != 0)
+        {
+          i->timer->m_wheelId = NO_ENTRY;
+        }
+    }
+}
+
+void
+TimerWheel::Reset (void)
+{
+  m_enabled = -1;
+}
+
+void
+TimerWheel::ReadEnabled (void)
+{
+  BooleanValue enabled;
+  g_timerWheel.GetValue (enabled);
+  m_enabled = enabled.Get () ? 1 : 0;
+}
+
+TimerWheel *
+TimerWheel::Get (void)
+{
+  return SimulationSingleton<TimerWheel>::Get ();
+}
+
+uint64_t
+TimerWheel::Arm (Timer *timer, const Time &delay)
+{
+  NS_LOG_FUNCTION (this << timer << delay);
+  NS_ASSERT (delay.IsPositive ());
+  uint64_t now = Simulator::Now ().GetTimeStep ();
+  if (m_nTimers == 0)
+    {
+      // Nothing can expire before now: restart the wheel from here.
+      m_cursor = now / m_resolution;
+    }
+  uint32_t id;
+  if (m_free.empty ())
+    {
+      id = m_entries.size ();
+      m_entries.push_back (Entry ());
+      m_entries[id].generation = 0;
+    }
+  else
+    {
+      id = m_free.back ();
+      m_free.pop_back ();
+    }
+  Entry &entry = m_entries[id];
+  entry.timer = timer;
+  entry.ts = now + delay.GetTimeStep ();
+  entry.seq = m_seq++;
+  m_nTimers++;
+  Place (id);
+  Reschedule ();
+  return (uint64_t (entry.generation) << 32) | id;
+}
+
+void
+TimerWheel::Cancel (uint64_t id)
+{
+  NS_LOG_FUNCTION (this << id);
+  if (!IsArmed (id))
+    {
+      return;
+    }
+  uint32_t index = id & 0xffffffff;
+  Unlink (index);
+  Free (index);
+  // The wheel event may now be early: it then finds nothing to expire
+  // and moves on, which is cheaper than removing it.
+}
+
+bool
+TimerWheel::IsArmed (uint64_t id) const
+{
+  uint32_t index = id & 0xffffffff;
+  return index < m_entries.size ()
+         && m_entries[index].timer != 0
+         && m_entries[index].generation == (id >> 32);
+}
+
+Time
+TimerWheel::GetExpiration (uint64_t id) const
+{
+  NS_ASSERT (IsArmed (id));
+  return TimeStep (m_entries[id & 0xffffffff].ts);
+}
+
+void
+TimerWheel::Free (uint32_t index)
+{
+  m_entries[index].timer = 0;
+  m_entries[index].generation++;
+  m_free.push_back (index);
+  m_nTimers--;
+}
+
+uint32_t
+TimerWheel::GetNTimers (void) const
+{
+  return m_nTimers;
+}
+
+bool
+TimerWheel::Later::operator () (uint32_t a, uint32_t b) const
+{
+  const Entry &ea = wheel->m_entries[a];
+  const Entry &eb = wheel->m_entries[b];
+  return ea.ts > eb.ts || (ea.ts == eb.ts && ea.seq > eb.seq);
+}
+
+void
+TimerWheel::Place (uint32_t id)
+{
+  Entry &entry = m_entries[id];
+  uint64_t tick = entry.ts / m_resolution;
+  if (tick <= m_cursor)
+    {
+      Later later = { this };
+      m_due.insert (std::upper_bound (m_due.begin (), m_due.end (), id, later), id);
+      entry.level = LEVEL_DUE;
+      return;
+    }
+  // Level l holds the ticks which only differ from the cursor in their
+  // level l digit, so every level expires before the next one.
+  for (uint32_t l = 0; l < LEVELS; ++l)
+    {
+      uint32_t shift = SLOT_BITS * (l + 1);
+      if ((tick >> shift) == (m_cursor >> shift))
+        {
+          uint32_t slot = (tick >> (SLOT_BITS * l)) & (SLOTS - 1);
+          entry.level = l;
+          entry.index = m_slots[l][slot].size ();
+          m_slots[l][slot].push_back (id);
+          m_occupied[l] |= uint64_t (1) << slot;
+          return;
+        }
+    }
+  entry.level = LEVEL_OVERFLOW;
+  entry.index = m_overflow.size ();
+  m_overflow.push_back (id);
+}
+
+void
+TimerWheel::Unlink (uint32_t id)
+{
+  Entry &entry = m_entries[id];
+  std::vector<uint32_t> *slot;
+  if (entry.level == LEVEL_DUE)
+    {
+      m_due.erase (std::find (m_due.begin (), m_due.end (), id));
+      return;
+    }
+  else if (entry.level == LEVEL_OVERFLOW)
+    {
+      slot = &m_overflow;
+    }
+  else
+    {
+      uint32_t s = (entry.ts / m_resolution >> (SLOT_BITS * entry.level)) & (SLOTS - 1);
+      slot = &m_slots[entry.level][s];
+      if (slot->size () == 1)
+        {
+          m_occupied[entry.level] &= ~(uint64_t (1) << s);
+        }
+    }
+  // Slots are not sorted: move the last entry in the hole.
+  uint32_t last = slot->back ();
+  (*slot)[entry.index] = last;
+  m_entries[last].index = entry.index;
+  slot->pop_back ();
+}
+
+bool
+TimerWheel::Advance (void)
+{
+  NS_ASSERT (m_due.empty ());
+  while (m_nTimers > 0)
+    {
+      if (m_occupied[0] != 0)
+        {
+          uint32_t slot = LowestBit (m_occupied[0]);
+          m_occupied[0] &= ~(uint64_t (1) << slot);
+          m_cursor = (m_cursor & ~uint64_t (SLOTS - 1)) | slot;
+          m_due.swap (m_slots[0][slot]);
+          for (std::vector<uint32_t>::const_iterator i = m_due.begin (); i != m_due.end (); ++i)
+            {
+              m_entries[*i].level = LEVEL_DUE;
+            }
+          Later later = { this };
+          std::sort (m_due.begin (), m_due.end (), later);
+          return true;
+        }
+      // Move the cursor to the first non empty slot of the lowest
+      // non empty level, and spread that slot over the levels below.
+      std::vector<uint32_t> entries;
+      uint32_t l = 1;
+      while (l < LEVELS && m_occupied[l] == 0)
+        {
+          l++;
+        }
+      if (l < LEVELS)
+        {
+          uint32_t slot = LowestBit (m_occupied[l]);
+          m_occupied[l] &= ~(uint64_t (1) << slot);
+          uint32_t shift = SLOT_BITS * (l + 1);
+          m_cursor = ((m_cursor >> shift) << shift) | (uint64_t (slot) << (SLOT_BITS * l));
+          entries.swap (m_slots[l][slot]);
+        }
+      else
+        {
+          uint64_t first = m_entries[m_overflow.front ()].ts;
+          for (std::vector<uint32_t>::const_iterator i = m_overflow.begin (); i != m_overflow.end (); ++i)
+            {
+              first = std::min (first, m_entries[*i].ts);
+            }
+          m_cursor = first / m_resolution;
+          entries.swap (m_overflow);
+        }
+      for (std::vector<uint32_t>::const_iterator i = entries.begin (); i != entries.end (); ++i)
+        {
+          Place (*i);
+        }
+      if (!m_due.empty ())
+        {
+          return true;
+        }
+    }
+  return false;
+}
+
+void
+TimerWheel::Reschedule (void)
+{
+  if (m_expiring)
+    {
+      return;
+    }
+  if (m_due.empty () && !Advance ())
+    {
+      return;
+    }
+  uint64_t ts = m_entries[m_due.back ()].ts;
+  if (m_event.IsRunning ())
+    {
+      if (m_eventTs <= ts)
+        {
+          return;
+        }
+      Simulator::Remove (m_event);
+    }
+  m_eventTs = ts;
+  m_event = Simulator::Schedule (TimeStep (ts) - Simulator::Now (), &TimerWheel::Expire, this);
+}
+
+void
+TimerWheel::Expire (void)
+{
+  NS_LOG_FUNCTION (this);
+  uint64_t now = Simulator::Now ().GetTimeStep ();
+  m_expiring = true;
+  while (!m_due.empty () && m_entries[m_due.back ()].ts == now)
+    {
+      uint32_t id = m_due.back ();
+      m_due.pop_back ();
+      Timer *timer = m_entries[id].timer;
+      Free (id);
+      timer->Expire ();
+    }
+  m_expiring = false;
+  Reschedule ();
+}
+
+} // namespace ns3
@@ -0,0 +1,233 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include "nstime.h"
+#include "event-id.h"
+#include <stdint.h>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup timer
+ * ns3::TimerWheel declaration.
+ */
+
+namespace ns3 {
+
+class Timer;
+
+/**
+ * \ingroup timer
+ * \brief Hierarchical timing wheel holding the expirations of Timers.
+ *
+ * When the "TimerWheel" GlobalValue is true, Timer::Schedule() arms an
+ * entry in the wheel of the current simulation instead of scheduling
+ * an event, and Timer::Cancel() disarms it.  Both are O(1) and leave
+ * nothing behind in the main event queue, which only ever holds one
+ * event for the whole wheel: the next expiration.
+ *
+ * The wheel has four levels of 64 slots.  A level 0 slot spans
+ * "TimerWheelResolution", and a slot of each next level spans the
+ * whole level below it; later expirations wait in an overflow list.
+ * Slots are only ever used to find the next due slot: its entries are
+ * then sorted by expiration time, and every Timer expires at the exact
+ * time it would have expired with a simulator event.  Timers expiring
+ * at the same time expire in the order they were scheduled, but
+ * relative to other events at the same time they expire in the order
+ * of the single wheel event.
+ *
+ * There is one wheel per simulation, created on first use and deleted
+ * by Simulator::Destroy().
+ */
+class TimerWheel
+{
+public:
+  /** Constructor. */
+  TimerWheel ();
+  /** Destructor: disarms every Timer still in the wheel. */
+  ~TimerWheel ();
+
+  /**
+   * The "TimerWheel" GlobalValue is read on the first call of each
+   * simulation, so that Timer::Schedule() does not read it every time.
+   *
+   * \returns \c true if Timers should use the wheel.
+   */
+  static bool IsEnabled (void);
+  /**
+   * Read the "TimerWheel" GlobalValue again on the next call of
+   * IsEnabled().  Called by Simulator::Destroy().
+   */
+  static void Reset (void);
+  /**
+   * \returns The wheel of the current simulation.
+   */
+  static TimerWheel * Get (void);
+
+  /**
+   * Arm a Timer.
+   *
+   * \param [in] timer The Timer to expire.
+   * \param [in] delay The delay after which it expires.
+   * \returns The identifier of the entry.
+   */
+  uint64_t Arm (Timer *timer, const Time &delay);
+  /**
+   * Disarm a Timer.  Nothing happens if the entry already expired or
+   * was cancelled, even if it was armed again since.
+   *
+   * \param [in] id The identifier returned by Arm().
+   */
+  void Cancel (uint64_t id);
+  /**
+   * \param [in] id The identifier returned by Arm().
+   * \returns \c true if the entry is still armed.
+   */
+  bool IsArmed (uint64_t id) const;
+  /**
+   * \param [in] id The identifier returned by Arm().
+   * \returns The time at which the entry expires.
+   */
+  Time GetExpiration (uint64_t id) const;
+  /**
+   * \returns The number of armed Timers.
+   */
+  uint32_t GetNTimers (void) const;
+
+  /** Identifier of no entry. */
+  static const uint64_t NO_ENTRY = 0xffffffffffffffffULL;
+
+private:
+  /** An armed Timer. */
+  struct Entry
+  {
+    Timer *timer;        /**< The Timer, or 0 if the entry is free. */
+    uint32_t generation; /**< Incremented when the entry is freed, to detect stale identifiers. */
+    uint64_t ts;     /**< The expiration timestamp. */
+    uint64_t seq;    /**< Arm order, to break ties between timestamps. */
+    uint32_t level;  /**< Where the entry is: a level, LEVEL_DUE or LEVEL_OVERFLOW. */
+    uint32_t index;  /**< Index of the entry in its slot. */
+  };
+
+  /**
+   * Put an entry in the due list, the overflow list or the slot of the
+   * lowest level which holds its timestamp.
+   *
+   * \param [in] id The entry.
+   */
+  void Place (uint32_t id);
+  /**
+   * Remove an entry from its slot, overflow or due list.
+   *
+   * \param [in] id The entry.
+   */
+  void Unlink (uint32_t id);
+  /**
+   * Move the cursor to the next non empty slot and load its entries in
+   * the due list.
+   *
+   * \returns \c false if the wheel is empty.
+   */
+  bool Advance (void);
+  /**
+   * Free an entry.
+   *
+   * \param [in] index The entry.
+   */
+  void Free (uint32_t index);
+  /** Keep the wheel event scheduled at the first expiration. */
+  void Reschedule (void);
+  /** Expire the Timers due now. */
+  void Expire (void);
+  /** Order entries by timestamp then arm order, latest first. */
+  struct Later
+  {
+    /** The wheel holding the entries. */
+    const TimerWheel *wheel;
+    /**
+     * \param [in] a The first entry.
+     * \param [in] b The second entry.
+     * \returns \c true if a expires after b.
+     */
+    bool operator () (uint32_t a, uint32_t b) const;
+  };
+
+  /** Number of levels. */
+  static const uint32_t LEVELS = 4;
+  /** log2 of the number of slots of a level. */
+  static const uint32_t SLOT_BITS = 6;
+  /** Number of slots of a level. */
+  static const uint32_t SLOTS = 1 << SLOT_BITS;
+  /** Entry level: in the due list. */
+  static const uint32_t LEVEL_DUE = LEVELS;
+  /** Entry level: in the overflow list. */
+  static const uint32_t LEVEL_OVERFLOW = LEVELS + 1;
+
+  /** All entries, armed or free. */
+  std::vector<Entry> m_entries;
+  /** Free entries. */
+  std::vector<uint32_t> m_free;
+  /** The slots. */
+  std::vector<uint32_t> m_slots[LEVELS][SLOTS];
+  /** One bit per non empty slot. */
+  uint64_t m_occupied[LEVELS];
+  /** Entries past the last level. */
+  std::vector<uint32_t> m_overflow;
+  /** Entries up to the cursor, sorted with the first to expire last. */
+  std::vector<uint32_t> m_due;
+  /** Slot duration, in time steps. */
+  uint64_t m_resolution;
+  /** The current slot. */
+  uint64_t m_cursor;
+  /** Next arm order. */
+  uint64_t m_seq;
+  /** Number of armed Timers. */
+  uint32_t m_nTimers;
+  /** The wheel event. */
+  EventId m_event;
+  /** Timestamp of the wheel event. */
+  uint64_t m_eventTs;
+  /** Set while expiring Timers, to defer rescheduling. */
+  bool m_expiring;
+
+  /** Read the "TimerWheel" GlobalValue. */
+  static void ReadEnabled (void);
+
+  /** Whether Timers use the wheel: 1, 0, or -1 until it is read. */
+  static int m_enabled;
+};
+
+} // namespace ns3
+
+
+namespace ns3 {
+
+inline bool
+TimerWheel::IsEnabled (void)
+{
+  if (m_enabled < 0)
+    {
+      ReadEnabled ();
+    }
+  return m_enabled == 1;
+}
+
+} // namespace ns3
+
+#endif /* TIMER_WHEEL_H */
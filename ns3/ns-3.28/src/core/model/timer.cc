@@ -18,6 +18,7 @@
  * Author: Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
  */
 #include "timer.h"
+#include "timer-wheel.h"
 #include "simulator.h"
 #include "simulation-singleton.h"
 #include "log.h"
@@ -36,6 +37,7 @@ Timer::Timer ()
   : m_flags (CHECK_ON_DESTROY),
     m_delay (FemtoSeconds (0)),
     m_event (),
+    m_wheelId (TimerWheel::NO_ENTRY),
     m_impl (0)
 {
   NS_LOG_FUNCTION (this);
@@ -45,28 +47,62 @@ Timer::Timer (enum DestroyPolicy destroyPolicy)
   : m_flags (destroyPolicy),
     m_delay (FemtoSeconds (0)),
     m_event (),
+    m_wheelId (TimerWheel::NO_ENTRY),
     m_impl (0)
 {
   NS_LOG_FUNCTION (this << destroyPolicy);
 }
 
+Timer::Timer (const Timer &o)
+  : m_flags (o.m_flags),
+    m_delay (o.m_delay),
+    m_event (o.m_event),
+    m_wheelId (TimerWheel::NO_ENTRY),
+    m_impl (o.m_impl == 0 ? 0 : o.m_impl->Copy ()),
+    m_delayLeft (o.m_delayLeft)
+{
+  NS_LOG_FUNCTION (this << &o);
+}
+
+Timer &
+Timer::operator = (const Timer &o)
+{
+  NS_LOG_FUNCTION (this << &o);
+  if (this == &o)
+    {
+      return *this;
+    }
+  if (m_wheelId != TimerWheel::NO_ENTRY)
+    {
+      TimerWheel::Get ()->Cancel (m_wheelId);
+      m_wheelId = TimerWheel::NO_ENTRY;
+    }
+  m_flags = o.m_flags;
+  m_delay = o.m_delay;
+  m_event = o.m_event;
+  delete m_impl;
+  m_impl = o.m_impl == 0 ? 0 : o.m_impl->Copy ();
+  m_delayLeft = o.m_delayLeft;
+  return *this;
+}
+
 Timer::~Timer ()
 {
   NS_LOG_FUNCTION (this);
   if (m_flags & CHECK_ON_DESTROY)
     {
-      if (m_event.IsRunning ())
+      if (m_event.IsRunning () || m_wheelId != TimerWheel::NO_ENTRY)
         {
           NS_FATAL_ERROR ("Event is still running while destroying.");
         }
     }
   else if (m_flags & CANCEL_ON_DESTROY)
     {
-      m_event.Cancel ();
+      Cancel ();
     }
   else if (m_flags & REMOVE_ON_DESTROY)
     {
-      Simulator::Remove (m_event);
+      Remove ();
     }
   delete m_impl;
 }
@@ -90,6 +126,10 @@ Timer::GetDelayLeft (void) const
   switch (GetState ())
     {
     case Timer::RUNNING:
+      if (m_wheelId != TimerWheel::NO_ENTRY)
+        {
+          return TimerWheel::Get ()->GetExpiration (m_wheelId) - Simulator::Now ();
+        }
       return Simulator::GetDelayLeft (m_event);
       break;
     case Timer::EXPIRED:
@@ -109,25 +149,35 @@ void
 Timer::Cancel (void)
 {
   NS_LOG_FUNCTION (this);
+  if (m_wheelId != TimerWheel::NO_ENTRY)
+    {
+      TimerWheel::Get ()->Cancel (m_wheelId);
+      m_wheelId = TimerWheel::NO_ENTRY;
+    }
   Simulator::Cancel (m_event);
 }
 void
 Timer::Remove (void)
 {
   NS_LOG_FUNCTION (this);
+  if (m_wheelId != TimerWheel::NO_ENTRY)
+    {
+      TimerWheel::Get ()->Cancel (m_wheelId);
+      m_wheelId = TimerWheel::NO_ENTRY;
+    }
   Simulator::Remove (m_event);
 }
 bool
 Timer::IsExpired (void) const
 {
   NS_LOG_FUNCTION (this);
-  return !IsSuspended () && m_event.IsExpired ();
+  return !IsSuspended () && m_wheelId == TimerWheel::NO_ENTRY && m_event.IsExpired ();
 }
 bool
 Timer::IsRunning (void) const
 {
   NS_LOG_FUNCTION (this);
-  return !IsSuspended () && m_event.IsRunning ();
+  return !IsSuspended () && (m_wheelId != TimerWheel::NO_ENTRY || m_event.IsRunning ());
 }
 bool
 Timer::IsSuspended (void) const
@@ -166,11 +216,11 @@ Timer::Schedule (Time delay)
 {
   NS_LOG_FUNCTION (this << delay);
   NS_ASSERT (m_impl != 0);
-  if (m_event.IsRunning ())
+  if (m_event.IsRunning () || m_wheelId != TimerWheel::NO_ENTRY)
     {
       NS_FATAL_ERROR ("Event is still running while re-scheduling.");
     }
-  m_event = m_impl->Schedule (delay);
+  DoSchedule (delay);
 }
 
 void
@@ -178,8 +228,8 @@ Timer::Suspend (void)
 {
   NS_LOG_FUNCTION (this);
   NS_ASSERT (IsRunning ());
-  m_delayLeft = Simulator::GetDelayLeft (m_event);
-  Simulator::Remove (m_event);
+  m_delayLeft = GetDelayLeft ();
+  Remove ();
   m_flags |= TIMER_SUSPENDED;
 }
 
@@ -188,10 +238,31 @@ Timer::Resume (void)
 {
   NS_LOG_FUNCTION (this);
   NS_ASSERT (m_flags & TIMER_SUSPENDED);
-  m_event = m_impl->Schedule (m_delayLeft);
+  DoSchedule (m_delayLeft);
   m_flags &= ~TIMER_SUSPENDED;
 }
 
+void
+Timer::DoSchedule (const Time &delay)
+{
+  if (TimerWheel::IsEnabled ())
+    {
+      m_wheelId = TimerWheel::Get ()->Arm (this, delay);
+    }
+  else
+    {
+      m_event = m_impl->Schedule (delay);
+    }
+}
+
+void
+Timer::Expire (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_wheelId = TimerWheel::NO_ENTRY;
+  m_impl->Invoke ();
+}
+
 
 } // namespace ns3
 
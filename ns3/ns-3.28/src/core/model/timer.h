@@ -68,6 +68,9 @@ class TimerImpl;
  * management policies. These policies are specified at construction time
  * and cannot be changed after.
  *
+ * When the "TimerWheel" GlobalValue is true, the Timer is expired by
+ * the TimerWheel of the simulation instead of by its own event.
+ *
  * \see Watchdog for a simpler interface for a watchdog timer.
  */
 class Timer
@@ -112,6 +115,23 @@ public:
    * to use for destroy events
    */
   Timer (enum DestroyPolicy destroyPolicy);
+  /**
+   * Copy constructor.  The copy gets its own copy of the function and
+   * arguments, and does not take over the TimerWheel entry of \p o:
+   * only \p o is expired or cancelled through it.
+   *
+   * \param [in] o The Timer to copy.
+   */
+  Timer (const Timer &o);
+  /**
+   * Assignment.  A TimerWheel entry of this Timer is cancelled, the
+   * function and arguments of \p o are copied, and the TimerWheel entry
+   * of \p o is not taken over.
+   *
+   * \param [in] o The Timer to copy.
+   * \returns This Timer.
+   */
+  Timer & operator = (const Timer &o);
   ~Timer ();
 
   /**
@@ -263,6 +283,17 @@ public:
   void Resume (void);
 
 private:
+  friend class TimerWheel;
+
+  /**
+   * Schedule the expiration, through the TimerWheel if enabled.
+   *
+   * \param [in] delay The delay to expire after.
+   */
+  void DoSchedule (const Time &delay);
+  /** Expire from the TimerWheel. */
+  void Expire (void);
+
   /** Internal bit marking the suspended state. */
   enum InternalSuspended
   {
@@ -283,6 +314,8 @@ private:
   Time m_delay;
   /** The future event scheduled to expire the timer. */
   EventId m_event;
+  /** The TimerWheel entry of the timer, or TimerWheel::NO_ENTRY. */
+  uint64_t m_wheelId;
   /**
    * The timer implementation, which contains the bound callback
    * function and arguments.
@@ -21,7 +21,9 @@
 #ifndef TRACED_CALLBACK_H
 #define TRACED_CALLBACK_H
 
-#include <list>
+#include <stdint.h>
+#include <utility>
+#include <vector>
 #include "callback.h"
 
 /**
@@ -46,6 +48,19 @@ namespace ns3 {
  * calling one of the \c operator() forms with the appropriate
  * number of arguments.
  *
+ * The chain is a small vector which holds its first Callback inline
+ * and allocates room for the others only when they are connected, so
+ * that a TracedCallback without any Callback only costs a test when
+ * invoked, and one with a single Callback does not allocate.  Code
+ * which builds arguments only for the sake of the trace should test
+ * IsEmpty() first.
+ *
+ * A Callback may connect and disconnect Callbacks, itself included,
+ * while the chain invokes it.  The Callbacks it connects are invoked
+ * by the same invocation, after the others.  The Callbacks it
+ * disconnects are not invoked any more, and are removed from the
+ * chain when the outermost invocation returns.
+ *
  * \tparam T1 \explicit Type of the first argument to the functor.
  * \tparam T2 \explicit Type of the second argument to the functor.
  * \tparam T3 \explicit Type of the third argument to the functor.
@@ -64,6 +79,21 @@ class TracedCallback
 public:
   /** Constructor. */
   TracedCallback ();
+  /**
+   * Copy constructor.
+   *
+   * \param [in] o The TracedCallback to copy.
+   */
+  TracedCallback (const TracedCallback &o);
+  /**
+   * Assignment.
+   *
+   * \param [in] o The TracedCallback to copy.
+   * \returns This TracedCallback.
+   */
+  TracedCallback & operator = (const TracedCallback &o);
+  /** Destructor. */
+  ~TracedCallback ();
   /**
    * Append a Callback to the chain (without a context).
    *
@@ -93,6 +123,14 @@ public:
    * \param [in] path Context path which was used to connect the Callback.
    */
   void Disconnect (const CallbackBase & callback, std::string path);
+  /**
+   * \returns \c true if no Callback is connected, so that invoking
+   *          this TracedCallback does nothing.
+   */
+  bool IsEmpty (void) const
+  {
+    return m_first.IsNull () && m_others == 0;
+  }
   /**
    * \name Functors taking various numbers of arguments.
    *
@@ -222,21 +260,49 @@ public:
 
   
 private:
+  /** The type of the Callbacks in the chain. */
+  typedef Callback<void,T1,T2,T3,T4,T5,T6,T7,T8> ChainCallback;
+  /** Container type for the Callbacks after the first one. */
+  typedef std::vector<ChainCallback> CallbackList;
+
   /**
-   * Container type for holding the chain of Callbacks.
+   * Append a Callback to the chain.
    *
-   * \tparam T1 \deduced Type of the first argument to the functor.
-   * \tparam T2 \deduced Type of the second argument to the functor.
-   * \tparam T3 \deduced Type of the third argument to the functor.
-   * \tparam T4 \deduced Type of the fourth argument to the functor.
-   * \tparam T5 \deduced Type of the fifth argument to the functor.
-   * \tparam T6 \deduced Type of the sixth argument to the functor.
-   * \tparam T7 \deduced Type of the seventh argument to the functor.
-   * \tparam T8 \deduced Type of the eighth argument to the functor.
+   * \param [in] callback The Callback.
    */
-  typedef std::list<Callback<void,T1,T2,T3,T4,T5,T6,T7,T8> > CallbackList;
-  /** The chain of Callbacks. */
-  CallbackList m_callbackList;
+  void Append (const ChainCallback &callback);
+  /**
+   * Get the first Callback of the chain which is not disconnected,
+   * starting at a position.
+   *
+   * \param [in,out] i The position: 0 for the first Callback, i for
+   *             the i-th other one.  Set to the position of the
+   *             Callback found.
+   * \param [out] callback A copy of the Callback found, which stays
+   *             valid if it is disconnected while it is invoked.
+   * \returns \c true if a Callback was found.
+   */
+  bool GetCallback (uint32_t &i, ChainCallback &callback) const;
+  /** Start an invocation of the chain. */
+  void BeginInvoke (void) const;
+  /**
+   * End an invocation of the chain, and remove the Callbacks
+   * disconnected during the outermost one.
+   */
+  void EndInvoke (void) const;
+  /** Remove the disconnected Callbacks from the chain. */
+  void Compact (void) const;
+
+  // The members are mutable so that the Callbacks disconnected during
+  // an invocation can be removed when the const operator() returns.
+  /** The first Callback of the chain, or null. */
+  mutable ChainCallback m_first;
+  /** The other Callbacks of the chain, or 0 if there are none. */
+  mutable CallbackList *m_others;
+  /** The number of invocations of the chain in progress. */
+  mutable uint32_t m_invoking;
+  /** Whether a Callback was disconnected during an invocation. */
+  mutable bool m_disconnected;
 };
 
 } // namespace ns3
@@ -253,22 +319,67 @@ template<typename T1, typename T2,
          typename T5, typename T6,
          typename T7, typename T8>
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::TracedCallback ()
-  : m_callbackList () 
+  : m_first (),
+    m_others (0),
+    m_invoking (0),
+    m_disconnected (false)
 {
 }
-template<typename T1, typename T2,
+template<typename T1, typename T2, 
+         typename T3, typename T4,
+         typename T5, typename T6,
+         typename T7, typename T8>
+TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::TracedCallback (const TracedCallback &o)
+  : m_first (),
+    m_others (0),
+    m_invoking (0),
+    m_disconnected (false)
+{
+  uint32_t i = 0;
+  ChainCallback callback;
+  while (o.GetCallback (i, callback))
+    {
+      Append (callback);
+      i++;
+    }
+}
+template<typename T1, typename T2, 
+         typename T3, typename T4,
+         typename T5, typename T6,
+         typename T7, typename T8>
+TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8> &
+TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator = (const TracedCallback &o)
+{
+  if (this != &o)
+    {
+      TracedCallback copy (o);
+      std::swap (m_first, copy.m_first);
+      std::swap (m_others, copy.m_others);
+    }
+  return *this;
+}
+template<typename T1, typename T2, 
+         typename T3, typename T4,
+         typename T5, typename T6,
+         typename T7, typename T8>
+TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::~TracedCallback ()
+{
+  delete m_others;
+  m_others = 0;
+}
+template<typename T1, typename T2, 
          typename T3, typename T4,
          typename T5, typename T6,
          typename T7, typename T8>
 void
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::ConnectWithoutContext (const CallbackBase & callback)
 {
-  Callback<void,T1,T2,T3,T4,T5,T6,T7,T8> cb;
+  ChainCallback cb;
   if (!cb.Assign (callback))
     NS_FATAL_ERROR_NO_MSG();
-  m_callbackList.push_back (cb);
+  Append (cb);
 }
-template<typename T1, typename T2,
+template<typename T1, typename T2, 
          typename T3, typename T4,
          typename T5, typename T6,
          typename T7, typename T8>
@@ -278,8 +389,8 @@ TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::Connect (const CallbackBase & callback,
   Callback<void,std::string,T1,T2,T3,T4,T5,T6,T7,T8> cb;
   if (!cb.Assign (callback))
     NS_FATAL_ERROR ("when connecting to " << path);
-  Callback<void,T1,T2,T3,T4,T5,T6,T7,T8> realCb = cb.Bind (path);
-  m_callbackList.push_back (realCb);
+  ChainCallback realCb = cb.Bind (path);
+  Append (realCb);
 }
 template<typename T1, typename T2, 
          typename T3, typename T4,
@@ -288,18 +399,29 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::DisconnectWithoutContext (const CallbackBase & callback)
 {
-  for (typename CallbackList::iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); /* empty */)
+  // Only null the Callbacks here, as the chain may be being invoked.
+  if (!m_first.IsNull () && m_first.IsEqual (callback))
     {
-      if ((*i).IsEqual (callback))
-        {
-          i = m_callbackList.erase (i);
-        }
-      else
+      m_first.Nullify ();
+    }
+  if (m_others != 0)
+    {
+      for (typename CallbackList::iterator i = m_others->begin (); i != m_others->end (); i++)
         {
-          i++;
+          if (!(*i).IsNull () && (*i).IsEqual (callback))
+            {
+              (*i).Nullify ();
+            }
         }
     }
+  if (m_invoking == 0)
+    {
+      Compact ();
+    }
+  else
+    {
+      m_disconnected = true;
+    }
 }
 template<typename T1, typename T2, 
          typename T3, typename T4,
@@ -311,9 +433,112 @@ TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::Disconnect (const CallbackBase & callba
   Callback<void,std::string,T1,T2,T3,T4,T5,T6,T7,T8> cb;
   if (!cb.Assign (callback))
     NS_FATAL_ERROR ("when disconnecting from " << path);
-  Callback<void,T1,T2,T3,T4,T5,T6,T7,T8> realCb = cb.Bind (path);
+  ChainCallback realCb = cb.Bind (path);
   DisconnectWithoutContext (realCb);
 }
+template<typename T1, typename T2, 
+         typename T3, typename T4,
+         typename T5, typename T6,
+         typename T7, typename T8>
+void
+TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::Append (const ChainCallback &callback)
+{
+  // During an invocation the first slot may only be empty because its
+  // Callback was disconnected: keep the order by appending instead.
+  if (m_first.IsNull () && m_others == 0 && m_invoking == 0)
+    {
+      m_first = callback;
+      return;
+    }
+  if (m_others == 0)
+    {
+      m_others = new CallbackList ();
+    }
+  m_others->push_back (callback);
+}
+template<typename T1, typename T2, 
+         typename T3, typename T4,
+         typename T5, typename T6,
+         typename T7, typename T8>
+bool
+TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::GetCallback (uint32_t &i, ChainCallback &callback) const
+{
+  for (;; i++)
+    {
+      const ChainCallback *cb;
+      if (i == 0)
+        {
+          cb = &m_first;
+        }
+      else if (m_others != 0 && i <= m_others->size ())
+        {
+          cb = &(*m_others)[i - 1];
+        }
+      else
+        {
+          return false;
+        }
+      if (!cb->IsNull ())
+        {
+          callback = *cb;
+          return true;
+        }
+    }
+}
+template<typename T1, typename T2, 
+         typename T3, typename T4,
+         typename T5, typename T6,
+         typename T7, typename T8>
+void
+TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::BeginInvoke (void) const
+{
+  m_invoking++;
+}
+template<typename T1, typename T2, 
+         typename T3, typename T4,
+         typename T5, typename T6,
+         typename T7, typename T8>
+void
+TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::EndInvoke (void) const
+{
+  m_invoking--;
+  if (m_invoking == 0 && m_disconnected)
+    {
+      Compact ();
+    }
+}
+template<typename T1, typename T2, 
+         typename T3, typename T4,
+         typename T5, typename T6,
+         typename T7, typename T8>
+void
+TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::Compact (void) const
+{
+  m_disconnected = false;
+  if (m_others == 0)
+    {
+      return;
+    }
+  typename CallbackList::iterator j = m_others->begin ();
+  for (typename CallbackList::iterator i = m_others->begin (); i != m_others->end (); i++)
+    {
+      if (!(*i).IsNull ())
+        {
+          *j++ = *i;
+        }
+    }
+  m_others->erase (j, m_others->end ());
+  if (m_first.IsNull () && !m_others->empty ())
+    {
+      m_first = m_others->front ();
+      m_others->erase (m_others->begin ());
+    }
+  if (m_others->empty ())
+    {
+      delete m_others;
+      m_others = 0;
+    }
+}
 template<typename T1, typename T2, 
          typename T3, typename T4,
          typename T5, typename T6,
@@ -321,11 +546,17 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (void) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (IsEmpty ())
+    {
+      return;
+    }
+  BeginInvoke ();
+  ChainCallback callback;
+  for (uint32_t i = 0; GetCallback (i, callback); i++)
     {
-      (*i)();
+      callback ();
     }
+  EndInvoke ();
 }
 template<typename T1, typename T2, 
          typename T3, typename T4,
@@ -334,11 +565,17 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (IsEmpty ())
+    {
+      return;
+    }
+  BeginInvoke ();
+  ChainCallback callback;
+  for (uint32_t i = 0; GetCallback (i, callback); i++)
     {
-      (*i)(a1);
+      callback (a1);
     }
+  EndInvoke ();
 }
 template<typename T1, typename T2, 
          typename T3, typename T4,
@@ -347,11 +584,17 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (IsEmpty ())
+    {
+      return;
+    }
+  BeginInvoke ();
+  ChainCallback callback;
+  for (uint32_t i = 0; GetCallback (i, callback); i++)
     {
-      (*i)(a1, a2);
+      callback (a1, a2);
     }
+  EndInvoke ();
 }
 template<typename T1, typename T2, 
          typename T3, typename T4,
@@ -360,11 +603,17 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2, T3 a3) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (IsEmpty ())
     {
-      (*i)(a1, a2, a3);
+      return;
     }
+  BeginInvoke ();
+  ChainCallback callback;
+  for (uint32_t i = 0; GetCallback (i, callback); i++)
+    {
+      callback (a1, a2, a3);
+    }
+  EndInvoke ();
 }
 template<typename T1, typename T2, 
          typename T3, typename T4,
@@ -373,11 +622,17 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2, T3 a3, T4 a4) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (IsEmpty ())
+    {
+      return;
+    }
+  BeginInvoke ();
+  ChainCallback callback;
+  for (uint32_t i = 0; GetCallback (i, callback); i++)
     {
-      (*i)(a1, a2, a3, a4);
+      callback (a1, a2, a3, a4);
     }
+  EndInvoke ();
 }
 template<typename T1, typename T2, 
          typename T3, typename T4,
@@ -386,11 +641,17 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (IsEmpty ())
     {
-      (*i)(a1, a2, a3, a4, a5);
+      return;
     }
+  BeginInvoke ();
+  ChainCallback callback;
+  for (uint32_t i = 0; GetCallback (i, callback); i++)
+    {
+      callback (a1, a2, a3, a4, a5);
+    }
+  EndInvoke ();
 }
 template<typename T1, typename T2, 
          typename T3, typename T4,
@@ -399,11 +660,17 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5, T6 a6) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (IsEmpty ())
+    {
+      return;
+    }
+  BeginInvoke ();
+  ChainCallback callback;
+  for (uint32_t i = 0; GetCallback (i, callback); i++)
     {
-      (*i)(a1, a2, a3, a4, a5, a6);
+      callback (a1, a2, a3, a4, a5, a6);
     }
+  EndInvoke ();
 }
 template<typename T1, typename T2, 
          typename T3, typename T4,
@@ -412,11 +679,17 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5, T6 a6, T7 a7) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (IsEmpty ())
     {
-      (*i)(a1, a2, a3, a4, a5, a6, a7);
+      return;
     }
+  BeginInvoke ();
+  ChainCallback callback;
+  for (uint32_t i = 0; GetCallback (i, callback); i++)
+    {
+      callback (a1, a2, a3, a4, a5, a6, a7);
+    }
+  EndInvoke ();
 }
 template<typename T1, typename T2, 
          typename T3, typename T4,
@@ -425,11 +698,17 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5, T6 a6, T7 a7, T8 a8) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (IsEmpty ())
+    {
+      return;
+    }
+  BeginInvoke ();
+  ChainCallback callback;
+  for (uint32_t i = 0; GetCallback (i, callback); i++)
     {
-      (*i)(a1, a2, a3, a4, a5, a6, a7, a8);
+      callback (a1, a2, a3, a4, a5, a6, a7, a8);
     }
+  EndInvoke ();
 }
 
 } // namespace ns3
@@ -205,7 +205,11 @@ public:
    * \param [in] v The new value.
    */
   void Set (const T &v) {
-    if (m_v != v)
+    if (m_cb.IsEmpty ())
+      {
+        m_v = v;
+      }
+    else if (m_v != v)
       {
         m_cb (m_v, v);
         m_v = v;
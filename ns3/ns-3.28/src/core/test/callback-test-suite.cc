@@ -18,7 +18,12 @@
 
 #include "ns3/test.h"
 #include "ns3/callback.h"
+#include "ns3/ptr.h"
+#include "ns3/simple-ref-count.h"
+#include "ns3/core-config.h"
 #include <stdint.h>
+#include <sstream>
+#include <string>
 
 using namespace ns3;
 
@@ -557,6 +562,101 @@ NullifyCallbackTestCase::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ (target1.IsNull (), true, "Nullified Callback reports not IsNull()");
 }
 
+// ===========================================================================
+// Test copies of Callbacks, whether their pimpl is stored inline or not
+// ===========================================================================
+class CopyCallbackTestTarget : public SimpleRefCount<CopyCallbackTestTarget>
+{
+public:
+  CopyCallbackTestTarget () : m_sum (0) {}
+  void Add (int a) { m_sum += a; }
+  int m_sum;
+};
+
+static std::string gCopyCallbackTest;
+
+void CopyCallbackTarget (std::string a, std::string b, int c)
+{
+  std::ostringstream oss;
+  oss << a << b << c;
+  gCopyCallbackTest = oss.str ();
+}
+
+class CopyCallbackTestCase : public TestCase
+{
+public:
+  CopyCallbackTestCase ();
+  virtual ~CopyCallbackTestCase () {}
+
+private:
+  virtual void DoRun (void);
+};
+
+CopyCallbackTestCase::CopyCallbackTestCase ()
+  : TestCase ("Check copies of small and large Callbacks")
+{
+}
+
+void
+CopyCallbackTestCase::DoRun (void)
+{
+  Ptr<CopyCallbackTestTarget> target = Create<CopyCallbackTestTarget> ();
+  Callback<void, int> *original = new Callback<void, int> (MakeCallback (&CopyCallbackTestTarget::Add, target));
+  NS_TEST_ASSERT_MSG_EQ (target->GetReferenceCount (), 2, "Callback does not hold its object");
+  Callback<void, int> copy = *original;
+#ifdef NS3_INLINE_CALLBACKS
+  // An inline pimpl is copied, with its object.
+  NS_TEST_ASSERT_MSG_EQ (target->GetReferenceCount (), 3, "Copy does not hold its object");
+#else
+  NS_TEST_ASSERT_MSG_EQ (target->GetReferenceCount (), 2, "Copy does not share the pimpl");
+  NS_TEST_ASSERT_MSG_EQ (sizeof (copy), sizeof (void *), "Callback is larger than its pimpl pointer");
+#endif
+  NS_TEST_ASSERT_MSG_EQ (copy.IsEqual (*original), true, "Copy differs from its original");
+  delete original;
+  copy (3);
+  copy (4);
+  NS_TEST_ASSERT_MSG_EQ (target->m_sum, 7, "Copy did not fire after its original was deleted");
+
+  Callback<void, int> assigned;
+  NS_TEST_ASSERT_MSG_EQ (assigned.IsNull (), true, "Default Callback is not null");
+  assigned = copy;
+  assigned = assigned;
+  assigned (1);
+  NS_TEST_ASSERT_MSG_EQ (target->m_sum, 8, "Assigned Callback did not fire");
+#ifdef NS3_INLINE_CALLBACKS
+  NS_TEST_ASSERT_MSG_EQ (target->GetReferenceCount (), 3, "Wrong reference count after assignment");
+#else
+  NS_TEST_ASSERT_MSG_EQ (target->GetReferenceCount (), 2, "Wrong reference count after assignment");
+#endif
+
+  CallbackValue value (assigned);
+  Callback<void, int> fromValue;
+  NS_TEST_ASSERT_MSG_EQ (value.GetAccessor (fromValue), true, "Callback not assigned from CallbackValue");
+  fromValue (2);
+  NS_TEST_ASSERT_MSG_EQ (target->m_sum, 10, "Callback from CallbackValue did not fire");
+  NS_TEST_ASSERT_MSG_EQ (fromValue.GetImpl ()->IsEqual (copy.GetImpl ()), true,
+                         "Heap copies of equal Callbacks differ");
+  Ptr<CallbackImplBase> impl = copy.GetImpl ();
+  NS_TEST_ASSERT_MSG_EQ (copy.GetImpl (), impl, "GetImpl returned another pimpl");
+  NS_TEST_ASSERT_MSG_EQ (copy.PeekImpl (), PeekPointer (impl), "PeekImpl differs from GetImpl");
+  copy (1);
+  NS_TEST_ASSERT_MSG_EQ (target->m_sum, 11, "Callback did not fire after GetImpl");
+  impl = 0;
+
+  copy.Nullify ();
+  assigned.Nullify ();
+  fromValue.Nullify ();
+  NS_TEST_ASSERT_MSG_EQ (target->GetReferenceCount (), 2, "Nullified Callbacks still hold their object");
+
+  // Too large to be stored inline: copies share the bound arguments.
+  Callback<void, int> large = MakeBoundCallback (&CopyCallbackTarget, std::string ("abcdefghijklmnopqrstuvwxyz"),
+                                                 std::string ("0123456789"));
+  Callback<void, int> largeCopy = large;
+  large = MakeNullCallback<void, int> ();
+  largeCopy (42);
+  NS_TEST_ASSERT_MSG_EQ (gCopyCallbackTest, "abcdefghijklmnopqrstuvwxyz012345678942", "Large Callback did not fire");
+}
+
 // ===========================================================================
 // Make sure that various MakeCallback template functions compile and execute.
 // Doesn't check an results of the execution.
@@ -704,6 +804,7 @@ CallbackTestSuite::CallbackTestSuite ()
   AddTestCase (new MakeCallbackTestCase, TestCase::QUICK);
   AddTestCase (new MakeBoundCallbackTestCase, TestCase::QUICK);
   AddTestCase (new NullifyCallbackTestCase, TestCase::QUICK);
+  AddTestCase (new CopyCallbackTestCase, TestCase::QUICK);
   AddTestCase (new MakeCallbackTemplatesTestCase, TestCase::QUICK);
 }
 
@@ -27,11 +27,13 @@
 #include "ns3/singleton.h"
 #include "ns3/object.h"
 #include "ns3/object-vector.h"
+#include "ns3/object-map.h"
 #include "ns3/names.h"
 #include "ns3/pointer.h"
 #include "ns3/log.h"
 
 
+#include <map>
 #include <sstream>
 
 /**
@@ -75,6 +77,12 @@ public:
    * \param b test object b
    */
   void AddNodeB (Ptr<ConfigTestObject> b);
+  /**
+   * Add a node to the map
+   * \param key the key of the node
+   * \param node the test object
+   */
+  void AddNodeMap (uint32_t key, Ptr<ConfigTestObject> node);
 
   /**
    * Set node A function
@@ -101,6 +109,7 @@ public:
 private:
   std::vector<Ptr<ConfigTestObject> > m_nodesA; //!< NodesA attribute target.
   std::vector<Ptr<ConfigTestObject> > m_nodesB; //!< NodesB attribute target.
+  std::map<uint32_t, Ptr<ConfigTestObject> > m_nodesMap; //!< NodesMap attribute target.
   Ptr<ConfigTestObject> m_nodeA;  //!< NodeA attribute target.
   Ptr<ConfigTestObject> m_nodeB;  //!< NodeB attribute target.
   int8_t m_a;                     //!< A attribute target.
@@ -121,6 +130,10 @@ ConfigTestObject::GetTypeId (void)
                    ObjectVectorValue (),
                    MakeObjectVectorAccessor (&ConfigTestObject::m_nodesB),
                    MakeObjectVectorChecker<ConfigTestObject> ())
+    .AddAttribute ("NodesMap", "",
+                   ObjectMapValue (),
+                   MakeObjectMapAccessor (&ConfigTestObject::m_nodesMap),
+                   MakeObjectMapChecker<ConfigTestObject> ())
     .AddAttribute ("NodeA", "",
                    PointerValue (),
                    MakePointerAccessor (&ConfigTestObject::m_nodeA),
@@ -172,6 +185,12 @@ ConfigTestObject::AddNodeB (Ptr<ConfigTestObject> b)
   m_nodesB.push_back (b);
 }
 
+void 
+ConfigTestObject::AddNodeMap (uint32_t key, Ptr<ConfigTestObject> node)
+{
+  m_nodesMap[key] = node;
+}
+
 int8_t 
 ConfigTestObject::GetA (void) const
 {
@@ -604,6 +623,140 @@ ObjectVectorConfigTestCase::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ (iv.Get (), -16, "Object Attribute \"A\" not set as expected");
 }
 
+/**
+ * \ingroup config-tests
+ * Test for the resolution of explicit indices into vectors of objects,
+ * and for connecting a batch of trace sources.
+ */
+class ObjectVectorIndexConfigTestCase : public TestCase
+{
+public:
+  /** Constructor. */
+  ObjectVectorIndexConfigTestCase ();
+  /** Destructor. */
+  virtual ~ObjectVectorIndexConfigTestCase () {}
+
+  /**
+   * Trace callback with context path.
+   * \param path The context path.
+   * \param oldValue The old value.
+   * \param newValue The new value.
+   */
+  void Trace (std::string path, int16_t oldValue, int16_t newValue);
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Check the objects matched by a Config path.
+   * \param path The Config path.
+   * \param indices The expected indices of the matched objects, in order.
+   */
+  void CheckMatches (std::string path, std::string indices);
+
+  std::vector<Ptr<ConfigTestObject> > m_objects;  //!< The objects of the vector.
+  std::vector<std::string> m_paths;              //!< The traced context paths.
+};
+
+ObjectVectorIndexConfigTestCase::ObjectVectorIndexConfigTestCase ()
+  : TestCase ("Check resolution of explicit indices into vectors and maps of Object")
+{
+}
+
+void
+ObjectVectorIndexConfigTestCase::Trace (std::string path, int16_t oldValue, int16_t newValue)
+{
+  m_paths.push_back (path);
+}
+
+void
+ObjectVectorIndexConfigTestCase::CheckMatches (std::string path, std::string indices)
+{
+  Config::MatchContainer matches = Config::LookupMatches (path);
+  std::ostringstream oss;
+  for (uint32_t i = 0; i < matches.GetN (); i++)
+    {
+      for (uint32_t j = 0; j < m_objects.size (); j++)
+        {
+          if (matches.Get (i) == m_objects[j])
+            {
+              oss << (i ? " " : "") << j;
+            }
+        }
+    }
+  NS_TEST_ASSERT_MSG_EQ (oss.str (), indices, "Unexpected objects matched by " << path);
+}
+
+void
+ObjectVectorIndexConfigTestCase::DoRun (void)
+{
+  Ptr<ConfigTestObject> root = CreateObject<ConfigTestObject> ();
+  Config::RegisterRootNamespaceObject (root);
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      m_objects.push_back (CreateObject<ConfigTestObject> ());
+      root->AddNodeA (m_objects[i]);
+    }
+
+  //
+  // Explicit indices, ranges and their combinations select the objects
+  // in index order, once each.
+  //
+  CheckMatches ("/NodesA/2", "2");
+  CheckMatches ("/NodesA/[1-2]|0", "0 1 2");
+  CheckMatches ("/NodesA/3|1|1", "1 3");
+  CheckMatches ("/NodesA/[2-9]", "2 3");
+  CheckMatches ("/NodesA/7", "");
+  CheckMatches ("/NodesA/*", "0 1 2 3");
+
+  Config::MatchContainer matches = Config::LookupMatches ("/NodesA/1|3");
+  NS_TEST_ASSERT_MSG_EQ (matches.GetMatchedPath (1), "/NodesA/3/", "Unexpected matched path");
+
+  //
+  // The indices of a map are its keys, not positions.
+  //
+  root->AddNodeMap (5, m_objects[1]);
+  root->AddNodeMap (10, m_objects[2]);
+  CheckMatches ("/NodesMap/5", "1");
+  CheckMatches ("/NodesMap/10", "2");
+  CheckMatches ("/NodesMap/10|5", "1 2");
+  CheckMatches ("/NodesMap/[0-7]", "1");
+  CheckMatches ("/NodesMap/0", "");
+  CheckMatches ("/NodesMap/1", "");
+  CheckMatches ("/NodesMap/[0-1]", "");
+  matches = Config::LookupMatches ("/NodesMap/10");
+  NS_TEST_ASSERT_MSG_EQ (matches.GetMatchedPath (0), "/NodesMap/10/", "Unexpected matched path");
+
+  //
+  // Connect a batch of trace sources sharing root paths.
+  //
+  std::vector<std::string> paths;
+  std::vector<CallbackBase> cbs;
+  paths.push_back ("/NodesA/0/Source");
+  paths.push_back ("/NodesA/[2-3]/Source");
+  paths.push_back ("/NodesA/0/Source");
+  for (uint32_t i = 0; i < paths.size (); i++)
+    {
+      cbs.push_back (MakeCallback (&ObjectVectorIndexConfigTestCase::Trace, this));
+    }
+  Config::Connect (paths, cbs);
+
+  for (uint32_t i = 0; i < m_objects.size (); i++)
+    {
+      m_objects[i]->SetAttribute ("Source", IntegerValue (i));
+    }
+  NS_TEST_ASSERT_MSG_EQ (m_paths.size (), 4, "Unexpected number of trace calls");
+  if (m_paths.size () == 4)
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_paths[0], "/NodesA/0/Source", "Unexpected context");
+      NS_TEST_ASSERT_MSG_EQ (m_paths[1], "/NodesA/0/Source", "Unexpected context");
+      NS_TEST_ASSERT_MSG_EQ (m_paths[2], "/NodesA/2/Source", "Unexpected context");
+      NS_TEST_ASSERT_MSG_EQ (m_paths[3], "/NodesA/3/Source", "Unexpected context");
+    }
+
+  Config::UnregisterRootNamespaceObject (root);
+  m_objects.clear ();
+}
+
 /**
  * \ingroup config-tests
  * Test for the ability to trace configure with vectors of objects.
@@ -838,6 +991,7 @@ ConfigTestSuite::ConfigTestSuite ()
   AddTestCase (new RootNamespaceConfigTestCase);
   AddTestCase (new UnderRootNamespaceConfigTestCase);
   AddTestCase (new ObjectVectorConfigTestCase);
+  AddTestCase (new ObjectVectorIndexConfigTestCase);
   AddTestCase (new SearchAttributesOfParentObjectsTestCase);
 }
 
@@ -0,0 +1,203 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/nstime.h"
+#include "ns3/test.h"
+
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LogTestSuite");
+
+/**
+ * Log a few messages from a node, at all levels.
+ *
+ * \param [in] value A value to log.
+ */
+static void
+LogMessages (uint32_t value)
+{
+  NS_LOG_FUNCTION (value << "arg");
+  NS_LOG_FUNCTION_NOARGS ();
+  NS_LOG_INFO ("value " << value);
+  NS_LOG_DEBUG ("hex " << std::hex << value << std::dec << " then " << 1.5);
+  NS_LOG_LOGIC ("dec " << value);
+  NS_LOG_WARN ("");
+}
+
+/**
+ * Call LogMessages() from the main program, then from some nodes,
+ * once a second.
+ *
+ * \param [in] nodes The number of nodes.
+ */
+static void
+ScheduleMessages (uint32_t nodes)
+{
+  LogMessages (1000);
+  for (uint32_t i = 0; i < nodes; ++i)
+    {
+      Simulator::ScheduleWithContext (i, Seconds (i) + NanoSeconds (i), &LogMessages, i);
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+class LogBufferFormatTestCase : public TestCase
+{
+public:
+  LogBufferFormatTestCase ();
+  virtual ~LogBufferFormatTestCase () {}
+
+private:
+  virtual void DoRun (void);
+};
+
+LogBufferFormatTestCase::LogBufferFormatTestCase ()
+  : TestCase ("Check the LogBuffer output is the text output")
+{
+}
+
+void
+LogBufferFormatTestCase::DoRun (void)
+{
+#ifdef NS3_LOG_ENABLE
+  LogComponentEnable ("LogTestSuite", LogLevel (LOG_LEVEL_ALL | LOG_PREFIX_ALL));
+  Simulator::Destroy ();
+
+  std::ostringstream text;
+  std::streambuf *clog = std::clog.rdbuf (text.rdbuf ());
+  ScheduleMessages (4);
+  std::clog.rdbuf (clog);
+
+  std::string file = CreateTempDirFilename ("log-buffer.log");
+  LogBuffer::Enable (file, 0);
+  NS_TEST_ASSERT_MSG_EQ (LogBuffer::IsEnabled (), true, "LogBuffer not enabled");
+  std::ostringstream unexpected;
+  clog = std::clog.rdbuf (unexpected.rdbuf ());
+  ScheduleMessages (4);
+  std::clog.rdbuf (clog);
+  LogBuffer::Disable ();
+  NS_TEST_ASSERT_MSG_EQ (LogBuffer::IsEnabled (), false, "LogBuffer not disabled");
+  NS_TEST_ASSERT_MSG_EQ (unexpected.str (), "", "LogBuffer wrote to std::clog");
+
+  LogComponentDisable ("LogTestSuite", LOG_LEVEL_ALL);
+
+  std::ifstream is (file.c_str (), std::ios::in | std::ios::binary);
+  std::ostringstream formatted;
+  NS_TEST_ASSERT_MSG_EQ (LogBuffer::Format (is, formatted), true, "Could not read the records");
+  NS_TEST_ASSERT_MSG_EQ (formatted.str (), text.str (), "Formatted records differ from the text");
+#endif /* NS3_LOG_ENABLE */
+}
+
+class LogBufferFilterTestCase : public TestCase
+{
+public:
+  LogBufferFilterTestCase ();
+  virtual ~LogBufferFilterTestCase () {}
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \param [in] file A file written by the LogBuffer.
+   * \returns The number of lines of each of the 10 nodes, followed by
+   *          the lines without node and those without time.
+   */
+  std::vector<uint32_t> CountLines (std::string file);
+};
+
+LogBufferFilterTestCase::LogBufferFilterTestCase ()
+  : TestCase ("Check the LogBuffer node and time filters")
+{
+}
+
+std::vector<uint32_t>
+LogBufferFilterTestCase::CountLines (std::string file)
+{
+  std::ifstream is (file.c_str (), std::ios::in | std::ios::binary);
+  std::ostringstream os;
+  LogBuffer::Format (is, os);
+  std::istringstream lines (os.str ());
+  std::vector<uint32_t> count (12);
+  std::string line;
+  while (std::getline (lines, line))
+    {
+      if (line[0] != '+')
+        {
+          count[11]++;
+          continue;
+        }
+      std::istringstream words (line);
+      std::string time;
+      int32_t node;
+      words >> time >> node;
+      count[node < 0 ? 10 : node]++;
+    }
+  return count;
+}
+
+void
+LogBufferFilterTestCase::DoRun (void)
+{
+#ifdef NS3_LOG_ENABLE
+  LogComponentEnable ("LogTestSuite", LogLevel (LOG_LEVEL_INFO | LOG_PREFIX_TIME | LOG_PREFIX_NODE));
+  Simulator::Destroy ();
+  std::string file = CreateTempDirFilename ("log-buffer.log");
+  LogBuffer::Enable (file);
+  LogBuffer::SetNodeFilter (2, 7);
+  ScheduleMessages (10);
+  LogBuffer::Disable ();
+  LogBuffer::ResetFilters ();
+  LogComponentDisable ("LogTestSuite", LOG_LEVEL_ALL);
+
+  // LOG_LEVEL_INFO prints the INFO, DEBUG and WARN lines of each call.
+  std::vector<uint32_t> count = CountLines (file);
+  for (uint32_t i = 0; i < 10; ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (count[i], ((i >= 2 && i <= 7) ? 3 : 0), "Wrong lines for node " << i);
+    }
+  NS_TEST_ASSERT_MSG_EQ (count[11], 3, "Wrong lines without time");
+
+  LogBuffer::SetTimeFilter (Seconds (3), Seconds (5));
+  count = CountLines (file);
+  LogBuffer::ResetFilters ();
+  for (uint32_t i = 0; i < 10; ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (count[i], ((i == 3 || i == 4) ? 3 : 0), "Wrong lines for node " << i);
+    }
+  NS_TEST_ASSERT_MSG_EQ (count[11], 3, "Wrong lines without time");
+#endif /* NS3_LOG_ENABLE */
+}
+
+class LogTestSuite : public TestSuite
+{
+public:
+  LogTestSuite ();
+};
+
+LogTestSuite::LogTestSuite ()
+  : TestSuite ("log", UNIT)
+{
+  AddTestCase (new LogBufferFormatTestCase, TestCase::QUICK);
+  AddTestCase (new LogBufferFilterTestCase, TestCase::QUICK);
+}
+
+static LogTestSuite logTestSuite;
@@ -21,6 +21,8 @@
 #include "ns3/test.h"
 #include "ns3/object.h"
 #include "ns3/object-factory.h"
+#include "ns3/memory-accounting.h"
+#include "ns3/make-event.h"
 #include "ns3/assert.h"
 
 /**
@@ -398,6 +400,69 @@ AggregateObjectTestCase::DoRun (void)
   NS_TEST_ASSERT_MSG_NE (baseA, 0, "Unable to GetObject on released object");
 }
 
+/**
+ * \ingroup object-tests
+ * Test GetObject() finds the aggregated Objects by their TypeId and
+ * parent TypeIds.
+ */
+class GetObjectTestCase : public TestCase
+{
+public:
+  /** Constructor. */
+  GetObjectTestCase ();
+  /** Destructor. */
+  virtual ~GetObjectTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+GetObjectTestCase::GetObjectTestCase ()
+  : TestCase ("Check GetObject by TypeId on aggregates")
+{
+}
+
+GetObjectTestCase::~GetObjectTestCase ()
+{
+}
+
+void
+GetObjectTestCase::DoRun (void)
+{
+  //
+  // An aggregate where BaseB is provided twice, by a BaseB and by a
+  // DerivedB.  Aggregating them in the other order is an error.
+  //
+  Ptr<BaseB> baseB = CreateObject<BaseB> ();
+  Ptr<DerivedB> derivedB = CreateObject<DerivedB> ();
+  baseB->AggregateObject (derivedB);
+
+  NS_TEST_ASSERT_MSG_EQ (baseB->GetObject<DerivedB> (), derivedB, "GetObject (through baseB) for DerivedB returns wrong Object");
+  NS_TEST_ASSERT_MSG_EQ (derivedB->GetObject<DerivedB> (), derivedB, "GetObject (through derivedB) for DerivedB returns wrong Object");
+  Ptr<BaseB> found = derivedB->GetObject<BaseB> (BaseB::GetTypeId ());
+  NS_TEST_ASSERT_MSG_EQ ((found == baseB || found == derivedB), true, "GetObject for BaseB returns another Object");
+  NS_TEST_ASSERT_MSG_EQ (baseB->GetObject<BaseA> (), 0, "Unexpectedly found a BaseA through baseB");
+  NS_TEST_ASSERT_MSG_EQ (baseB->GetObject<Object> (ObjectBase::GetTypeId ()), 0, "Unexpectedly found an ObjectBase through baseB");
+
+  //
+  // Aggregating another aggregate makes its Objects, and their
+  // parents, found through all the Objects.
+  //
+  Ptr<BaseA> baseA = CreateObject<BaseA> ();
+  Ptr<DerivedA> derivedA = CreateObject<DerivedA> ();
+  baseA->AggregateObject (derivedA);
+  derivedB->AggregateObject (baseA);
+
+  NS_TEST_ASSERT_MSG_EQ (baseB->GetObject<DerivedA> (), derivedA, "GetObject (through baseB) for DerivedA returns wrong Object");
+  NS_TEST_ASSERT_MSG_EQ (derivedA->GetObject<DerivedB> (), derivedB, "GetObject (through derivedA) for DerivedB returns wrong Object");
+  Ptr<BaseA> foundA = baseB->GetObject<BaseA> ();
+  NS_TEST_ASSERT_MSG_EQ ((foundA == baseA || foundA == derivedA), true, "GetObject (through baseB) for BaseA returns another Object");
+  NS_TEST_ASSERT_MSG_NE (baseA->GetObject<BaseB> (), 0, "Cannot GetObject (through baseA) for BaseB");
+  NS_TEST_ASSERT_MSG_NE (baseA->GetObject<Object> (), 0, "Cannot GetObject (through baseA) for Object");
+
+  baseB->Dispose ();
+}
+
 /**
  * \ingroup object-tests
  * Test an Object factory can create Objects
@@ -473,6 +538,141 @@ ObjectFactoryTestCase::DoRun (void)
   NS_TEST_ASSERT_MSG_NE (a->GetObject<DerivedA> (), 0, "Unexpectedly able to work around C++ type system");
 }
 
+/**
+ * \ingroup object-tests
+ * Test MemoryAccounting counts the live Objects of each TypeId
+ */
+class MemoryAccountingTestCase : public TestCase
+{
+public:
+  /** Constructor. */
+  MemoryAccountingTestCase ();
+  /** Destructor. */
+  virtual ~MemoryAccountingTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /** Do nothing, for the events of the test. */
+  static void NoOp (void);
+};
+
+MemoryAccountingTestCase::MemoryAccountingTestCase ()
+  : TestCase ("Check MemoryAccounting functionality")
+{
+}
+
+MemoryAccountingTestCase::~MemoryAccountingTestCase ()
+{
+}
+
+void
+MemoryAccountingTestCase::NoOp (void)
+{
+}
+
+void
+MemoryAccountingTestCase::DoRun (void)
+{
+  bool enabled = MemoryAccounting::IsEnabled ();
+  MemoryAccounting::Enable (true);
+  MemoryAccounting::Usage before = MemoryAccounting::GetUsage (DerivedA::GetTypeId ());
+
+  //
+  // Objects made by CreateObject, an ObjectFactory and CopyObject are
+  // counted under their TypeId, with their size.
+  //
+  Ptr<DerivedA> a = CreateObject<DerivedA> ();
+  Ptr<DerivedA> b = CreateObject<DerivedA> ();
+  ObjectFactory factory;
+  factory.SetTypeId (DerivedA::GetTypeId ());
+  Ptr<Object> c = factory.Create ();
+  Ptr<DerivedA> d = CopyObject (a);
+  MemoryAccounting::Usage usage = MemoryAccounting::GetUsage (DerivedA::GetTypeId ());
+  NS_TEST_ASSERT_MSG_EQ (usage.name, "ObjectTest:DerivedA", "Wrong name");
+  NS_TEST_ASSERT_MSG_EQ (usage.live, before.live + 4, "The Objects were not counted");
+  NS_TEST_ASSERT_MSG_EQ (usage.bytes, before.bytes + 4 * sizeof (DerivedA), "Wrong size");
+  NS_TEST_ASSERT_MSG_EQ (usage.created, before.created + 4, "Wrong number of Objects created");
+
+  //
+  // The peak stays when the Objects are released.
+  //
+  a = 0;
+  b = 0;
+  usage = MemoryAccounting::GetUsage (DerivedA::GetTypeId ());
+  NS_TEST_ASSERT_MSG_EQ (usage.live, before.live + 2, "The Objects were not released");
+  NS_TEST_ASSERT_MSG_EQ ((usage.peak >= before.live + 4), true, "Wrong peak");
+
+  //
+  // The Objects counted are released after the accounting is stopped, and
+  // the Objects created meanwhile are not counted.
+  //
+  MemoryAccounting::Enable (false);
+  Ptr<DerivedA> e = CreateObject<DerivedA> ();
+  c = 0;
+  d = 0;
+  usage = MemoryAccounting::GetUsage (DerivedA::GetTypeId ());
+  NS_TEST_ASSERT_MSG_EQ (usage.live, before.live, "The Objects were not released");
+  MemoryAccounting::Enable (true);
+  e = 0;
+  usage = MemoryAccounting::GetUsage (DerivedA::GetTypeId ());
+  NS_TEST_ASSERT_MSG_EQ (usage.live, before.live, "An Object not counted was released");
+
+  //
+  // The same holds for the other types, such as the events.
+  //
+  MemoryAccounting::Usage events = MemoryAccounting::GetUsage ("ns3::EventImpl");
+  MemoryAccounting::Enable (false);
+  EventImpl *event = MakeEvent (&MemoryAccountingTestCase::NoOp);
+  MemoryAccounting::Enable (true);
+  event->Unref ();
+  usage = MemoryAccounting::GetUsage ("ns3::EventImpl");
+  NS_TEST_ASSERT_MSG_EQ (usage.live, events.live, "An EventImpl not counted was released");
+  event = MakeEvent (&MemoryAccountingTestCase::NoOp);
+  MemoryAccounting::Enable (false);
+  event->Unref ();
+  usage = MemoryAccounting::GetUsage ("ns3::EventImpl");
+  NS_TEST_ASSERT_MSG_EQ (usage.live, events.live, "The EventImpl was not released");
+  NS_TEST_ASSERT_MSG_EQ (usage.created, events.created + 1, "Wrong number of EventImpls created");
+  MemoryAccounting::Enable (true);
+
+  //
+  // Other types are counted by name.
+  //
+  uint32_t index = MemoryAccounting::Register ("ObjectTest:Other");
+  NS_TEST_ASSERT_MSG_EQ (MemoryAccounting::Register ("ObjectTest:Other"), index, "Registered twice");
+  MemoryAccounting::Allocate (index, 100);
+  MemoryAccounting::Allocate (index, 50);
+  MemoryAccounting::Deallocate (index, 100);
+  usage = MemoryAccounting::GetUsage ("ObjectTest:Other");
+  NS_TEST_ASSERT_MSG_EQ (usage.live, 1, "Wrong live count");
+  NS_TEST_ASSERT_MSG_EQ (usage.peak, 2, "Wrong peak count");
+  NS_TEST_ASSERT_MSG_EQ (usage.bytes, 50, "Wrong bytes");
+  NS_TEST_ASSERT_MSG_EQ (usage.peakBytes, 150, "Wrong peak bytes");
+  MemoryAccounting::Deallocate (index, 50);
+  MemoryAccounting::Deallocate (index, 50);
+  NS_TEST_ASSERT_MSG_EQ (MemoryAccounting::GetUsage ("ObjectTest:Other").live, 0, "Released more than counted");
+
+  //
+  // The instances allocated by New() remember whether they were counted.
+  //
+  MemoryAccounting::Enable (false);
+  void *p = MemoryAccounting::New (index, 20);
+  MemoryAccounting::Enable (true);
+  void *q = MemoryAccounting::New (index, 30);
+  usage = MemoryAccounting::GetUsage ("ObjectTest:Other");
+  NS_TEST_ASSERT_MSG_EQ (usage.live, 1, "Wrong live count");
+  NS_TEST_ASSERT_MSG_EQ (usage.bytes, 30, "Wrong bytes");
+  MemoryAccounting::Delete (p, index, 20);
+  NS_TEST_ASSERT_MSG_EQ (MemoryAccounting::GetUsage ("ObjectTest:Other").live, 1, "An instance not counted was released");
+  MemoryAccounting::Enable (false);
+  MemoryAccounting::Delete (q, index, 30);
+  NS_TEST_ASSERT_MSG_EQ (MemoryAccounting::GetUsage ("ObjectTest:Other").live, 0, "The instance was not released");
+  MemoryAccounting::Enable (true);
+  NS_TEST_ASSERT_MSG_EQ (MemoryAccounting::GetUsage ("ObjectTest:Unknown").created, 0, "Unknown type counted");
+
+  MemoryAccounting::Enable (enabled);
+}
+
 /**
  * \ingroup object-tests
  * The Test Suite that glues the Test Cases together.
@@ -489,7 +689,9 @@ ObjectTestSuite::ObjectTestSuite ()
 {
   AddTestCase (new CreateObjectTestCase);
   AddTestCase (new AggregateObjectTestCase);
+  AddTestCase (new GetObjectTestCase);
   AddTestCase (new ObjectFactoryTestCase);
+  AddTestCase (new MemoryAccountingTestCase);
 }
 
 /**
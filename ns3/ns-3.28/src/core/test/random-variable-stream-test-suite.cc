@@ -28,6 +28,7 @@
 #include <ctime>
 #include <fstream>
 #include <cmath>
+#include <vector>
 
 #include "ns3/boolean.h"
 #include "ns3/double.h"
@@ -37,6 +38,7 @@
 #include "ns3/log.h"
 #include "ns3/rng-seed-manager.h"
 #include "ns3/random-variable-stream.h"
+#include "ns3/object-factory.h"
 
 using namespace ns3;
 
@@ -2878,6 +2880,96 @@ RandomVariableStreamEmpiricalAntitheticTestCase::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ_TOL (valueMean, expectedMean, TOLERANCE, "Wrong mean value."); 
 }
 
+// ===========================================================================
+// Test case for values drawn in bulk with GetValues
+// ===========================================================================
+class RandomVariableStreamGetValuesTestCase : public TestCase
+{
+public:
+  RandomVariableStreamGetValuesTestCase ();
+  virtual ~RandomVariableStreamGetValuesTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Check GetValues() returns what GetValue() does, and leaves the
+   * stream where GetValue() does, for batches of several sizes.
+   * \param factory The factory of the random variable.
+   */
+  void Check (ObjectFactory factory);
+};
+
+RandomVariableStreamGetValuesTestCase::RandomVariableStreamGetValuesTestCase ()
+  : TestCase ("GetValues draws the same values as GetValue")
+{
+}
+
+RandomVariableStreamGetValuesTestCase::~RandomVariableStreamGetValuesTestCase ()
+{
+}
+
+void
+RandomVariableStreamGetValuesTestCase::Check (ObjectFactory factory)
+{
+  Ptr<RandomVariableStream> scalar = factory.Create<RandomVariableStream> ();
+  Ptr<RandomVariableStream> bulk = factory.Create<RandomVariableStream> ();
+  scalar->SetStream (17);
+  bulk->SetStream (17);
+  std::string name = factory.GetTypeId ().GetName ();
+
+  uint32_t sizes [] = { 1, 2, 3, 31, 64, 65, 200 };
+  for (uint32_t k = 0; k < sizeof (sizes) / sizeof (sizes[0]); ++k)
+    {
+      std::vector<double> values (sizes[k]);
+      bulk->GetValues (&values[0], sizes[k]);
+      for (uint32_t i = 0; i < sizes[k]; ++i)
+        {
+          double value = scalar->GetValue ();
+          NS_TEST_ASSERT_MSG_EQ (values[i], value, name << ": value " << i << " of " << sizes[k] << " differs");
+        }
+    }
+  double value = scalar->GetValue ();
+  NS_TEST_ASSERT_MSG_EQ (bulk->GetValue (), value, name << ": stream left in another state");
+}
+
+void
+RandomVariableStreamGetValuesTestCase::DoRun (void)
+{
+  SetTestSuiteSeed ();
+
+  for (uint32_t antithetic = 0; antithetic < 2; ++antithetic)
+    {
+      ObjectFactory factory;
+      factory.SetTypeId ("ns3::UniformRandomVariable");
+      factory.Set ("Antithetic", BooleanValue (antithetic));
+      factory.Set ("Min", DoubleValue (2));
+      factory.Set ("Max", DoubleValue (5));
+      Check (factory);
+
+      // With a bound, some uniforms are rejected.
+      factory = ObjectFactory ("ns3::ExponentialRandomVariable");
+      factory.Set ("Antithetic", BooleanValue (antithetic));
+      factory.Set ("Bound", DoubleValue (1.5));
+      Check (factory);
+
+      // The bound rejects either value of a pair, or both.
+      factory = ObjectFactory ("ns3::NormalRandomVariable");
+      factory.Set ("Antithetic", BooleanValue (antithetic));
+      factory.Set ("Bound", DoubleValue (1.0));
+      Check (factory);
+
+      factory = ObjectFactory ("ns3::LogNormalRandomVariable");
+      factory.Set ("Antithetic", BooleanValue (antithetic));
+      Check (factory);
+
+      // Calls GetValue() in turn.
+      factory = ObjectFactory ("ns3::ParetoRandomVariable");
+      factory.Set ("Antithetic", BooleanValue (antithetic));
+      Check (factory);
+    }
+}
+
 class RandomVariableStreamTestSuite : public TestSuite
 {
 public:
@@ -2922,6 +3014,7 @@ RandomVariableStreamTestSuite::RandomVariableStreamTestSuite ()
   AddTestCase (new RandomVariableStreamDeterministicTestCase, TestCase::QUICK);
   AddTestCase (new RandomVariableStreamEmpiricalTestCase, TestCase::QUICK);
   AddTestCase (new RandomVariableStreamEmpiricalAntitheticTestCase, TestCase::QUICK);
+  AddTestCase (new RandomVariableStreamGetValuesTestCase, TestCase::QUICK);
 }
 
 static RandomVariableStreamTestSuite randomVariableStreamTestSuite;
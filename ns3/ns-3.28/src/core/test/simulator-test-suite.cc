@@ -23,6 +23,19 @@
 #include "ns3/heap-scheduler.h"
 #include "ns3/map-scheduler.h"
 #include "ns3/calendar-scheduler.h"
+#include "ns3/ladder-scheduler.h"
+#include "ns3/event-impl.h"
+#include "ns3/default-simulator-impl.h"
+#include "ns3/uinteger.h"
+#include "ns3/boolean.h"
+#include "ns3/string.h"
+#include "ns3/global-value.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/core-config.h"
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <vector>
 
 using namespace ns3;
 
@@ -459,6 +472,316 @@ SimulatorTemplateTestCase::DoRun (void)
   Simulator::Destroy ();
 }
 
+class SimulatorEventPoolTestCase : public TestCase
+{
+public:
+  SimulatorEventPoolTestCase ();
+  virtual void DoRun (void);
+  void foo0 (void)
+  {
+  }
+  void foo3 (int, double, uint64_t)
+  {
+  }
+};
+
+SimulatorEventPoolTestCase::SimulatorEventPoolTestCase ()
+  : TestCase ("Check that freed events are reused by the event pool")
+{
+}
+
+void
+SimulatorEventPoolTestCase::DoRun (void)
+{
+  // Warm the pool, then every later event of the same size must be a hit.
+  Simulator::Schedule (Seconds (1), &SimulatorEventPoolTestCase::foo0, this);
+  Simulator::Schedule (Seconds (1), &SimulatorEventPoolTestCase::foo3, this, 0, 0.0, 0);
+  Simulator::Run ();
+
+  EventImpl::PoolStats before = EventImpl::GetPoolStats ();
+  for (int i = 0; i < 100; ++i)
+    {
+      Simulator::Schedule (Seconds (i), &SimulatorEventPoolTestCase::foo0, this);
+      Simulator::Run ();
+      EventId id = Simulator::Schedule (Seconds (i), &SimulatorEventPoolTestCase::foo3, this, i, 0.0, 0);
+      Simulator::Cancel (id);
+      Simulator::Run ();
+    }
+  EventImpl::PoolStats after = EventImpl::GetPoolStats ();
+  NS_TEST_EXPECT_MSG_EQ (after.allocations - before.allocations, 200, "Wrong number of allocations");
+  NS_TEST_EXPECT_MSG_EQ (after.hits - before.hits, 200, "Freed events were not reused");
+  NS_TEST_EXPECT_MSG_EQ (after.refills, before.refills, "Pool grew while events were recycled");
+  Simulator::Destroy ();
+}
+
+class SimulatorPurgeTestCase : public TestCase
+{
+public:
+  SimulatorPurgeTestCase ();
+  virtual void DoRun (void);
+  void Event (uint32_t i);
+  uint32_t m_runs;
+  uint32_t m_last;
+  bool m_inOrder;
+};
+
+SimulatorPurgeTestCase::SimulatorPurgeTestCase ()
+  : TestCase ("Check that cancelled events are purged from the event queue")
+{
+}
+
+void
+SimulatorPurgeTestCase::Event (uint32_t i)
+{
+  if (i % 4 != 0 || (m_runs > 0 && i <= m_last))
+    {
+      m_inOrder = false;
+    }
+  m_last = i;
+  m_runs++;
+}
+
+void
+SimulatorPurgeTestCase::DoRun (void)
+{
+  Ptr<DefaultSimulatorImpl> impl = DynamicCast<DefaultSimulatorImpl> (Simulator::GetImplementation ());
+  if (impl == 0)
+    {
+      return;
+    }
+  impl->SetAttribute ("PurgeMinEvents", UintegerValue (100));
+  m_runs = 0;
+  m_last = 0;
+  m_inOrder = true;
+  std::vector<EventId> ids;
+  for (uint32_t i = 0; i < 1000; ++i)
+    {
+      ids.push_back (Simulator::Schedule (MicroSeconds (i), &SimulatorPurgeTestCase::Event, this, i));
+    }
+  NS_TEST_EXPECT_MSG_EQ (impl->GetEventCount (), 1000, "Wrong number of queued events");
+  uint32_t purges = impl->GetPurgeCount ();
+  // Cancel 3 out of 4 events; the queue is purged once half of it is dead.
+  for (uint32_t i = 0; i < 1000; ++i)
+    {
+      if (i % 4 != 0)
+        {
+          ids[i].Cancel ();
+        }
+    }
+  NS_TEST_EXPECT_MSG_EQ (impl->GetPurgeCount (), purges + 1, "Event queue was not purged once");
+  NS_TEST_EXPECT_MSG_EQ (impl->GetEventCount (), 499,
+                         "Wrong number of queued events after the purge");
+  NS_TEST_EXPECT_MSG_EQ (impl->GetCancelledEventCount (), 249, "Wrong number of cancelled events");
+  NS_TEST_EXPECT_MSG_EQ (ids[1].IsExpired (), true, "Purged event is not expired");
+  NS_TEST_EXPECT_MSG_EQ (ids[4].IsExpired (), false, "Live event is expired");
+  Simulator::Run ();
+  NS_TEST_EXPECT_MSG_EQ (m_runs, 250, "Wrong number of events run");
+  NS_TEST_EXPECT_MSG_EQ (m_inOrder, true, "Events run out of order or cancelled events run");
+  NS_TEST_EXPECT_MSG_EQ (impl->GetEventCount (), 0, "Events left in the queue");
+  NS_TEST_EXPECT_MSG_EQ (impl->GetCancelledEventCount (), 0, "Cancelled events left in the queue");
+  Simulator::Destroy ();
+}
+
+class SimulatorProfilerTestCase : public TestCase
+{
+public:
+  SimulatorProfilerTestCase ();
+  virtual void DoRun (void);
+  void Fast (void);
+  void Slow (uint32_t n);
+  uint32_t m_sum;
+};
+
+SimulatorProfilerTestCase::SimulatorProfilerTestCase ()
+  : TestCase ("Check the event profiler report")
+{
+}
+
+void
+SimulatorProfilerTestCase::Fast (void)
+{
+}
+
+void
+SimulatorProfilerTestCase::Slow (uint32_t n)
+{
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      m_sum += i * i;
+    }
+}
+
+void
+SimulatorProfilerTestCase::DoRun (void)
+{
+  if (DynamicCast<DefaultSimulatorImpl> (Simulator::GetImplementation ()) == 0)
+    {
+      return;
+    }
+  Simulator::Destroy ();
+  std::string file = CreateTempDirFilename ("event-profile.json");
+  GlobalValue::Bind ("EventProfiler", BooleanValue (true));
+  GlobalValue::Bind ("EventProfilerFile", StringValue (file));
+  m_sum = 0;
+  for (uint32_t i = 0; i < 10; ++i)
+    {
+      Simulator::ScheduleWithContext (7, MicroSeconds (i), &SimulatorProfilerTestCase::Slow, this, 100000);
+    }
+  for (uint32_t i = 0; i < 30; ++i)
+    {
+      Simulator::Schedule (MicroSeconds (i), &SimulatorProfilerTestCase::Fast, this);
+    }
+  Simulator::Run ();
+  // Keep the report out of the test output.
+  std::ostringstream report;
+  std::streambuf *clog = std::clog.rdbuf (report.rdbuf ());
+  Simulator::Destroy ();
+  std::clog.rdbuf (clog);
+  GlobalValue::Bind ("EventProfiler", BooleanValue (false));
+  GlobalValue::Bind ("EventProfilerFile", StringValue ("event-profile.json"));
+
+  std::ifstream is (file.c_str ());
+  NS_TEST_EXPECT_MSG_NE (report.str ().find ("Event profile: 40 events"), std::string::npos,
+                         "Wrong report: " << report.str ());
+  NS_TEST_ASSERT_MSG_EQ (is.is_open (), true, "Profile file not written");
+  std::vector<std::string> events;
+  std::string line;
+  while (std::getline (is, line))
+    {
+      if (line.find ("\"type\"") != std::string::npos)
+        {
+          events.push_back (line);
+        }
+    }
+  // The slow events run in context 7, the fast ones without context.
+  NS_TEST_ASSERT_MSG_EQ (events.size (), 2, "Wrong number of profile entries");
+#ifdef HAVE_DLFCN_H
+  NS_TEST_EXPECT_MSG_NE (events[0].find ("SimulatorProfilerTestCase::Slow(unsigned int)"), std::string::npos,
+                         "Slowest event is not named after its function: " << events[0]);
+#else
+  NS_TEST_EXPECT_MSG_NE (events[0].find ("SimulatorProfilerTestCase::*)(unsigned int)"), std::string::npos,
+                         "Slowest event is not named after its function: " << events[0]);
+#endif
+  NS_TEST_EXPECT_MSG_NE (events[0].find ("\"context\" : 7, \"count\" : 10,"), std::string::npos,
+                         "Wrong context or count: " << events[0]);
+#ifdef HAVE_DLFCN_H
+  NS_TEST_EXPECT_MSG_NE (events[1].find ("SimulatorProfilerTestCase::Fast()"), std::string::npos,
+                         "Fastest event is not named after its function: " << events[1]);
+#else
+  NS_TEST_EXPECT_MSG_NE (events[1].find ("SimulatorProfilerTestCase::*)()"), std::string::npos,
+                         "Fastest event is not named after its function: " << events[1]);
+#endif
+  NS_TEST_EXPECT_MSG_NE (events[1].find ("\"count\" : 30,"), std::string::npos,
+                         "Wrong count: " << events[1]);
+}
+
+class SchedulerOrderTestCase : public TestCase
+{
+public:
+  SchedulerOrderTestCase (ObjectFactory schedulerFactory);
+  virtual void DoRun (void);
+  ObjectFactory m_schedulerFactory;
+};
+
+SchedulerOrderTestCase::SchedulerOrderTestCase (ObjectFactory schedulerFactory)
+  : TestCase ("Check that " + schedulerFactory.GetTypeId ().GetName ()
+              + " dequeues in the same order as ns3::MapScheduler"),
+    m_schedulerFactory (schedulerFactory)
+{
+}
+
+void
+SchedulerOrderTestCase::DoRun (void)
+{
+  // Drive the scheduler directly with spread out events, bursts at a single
+  // timestamp and removals, and compare it with the reference scheduler.
+  Ptr<Scheduler> scheduler = m_schedulerFactory.Create<Scheduler> ();
+  Ptr<Scheduler> reference = CreateObject<MapScheduler> ();
+  Ptr<UniformRandomVariable> rng = CreateObject<UniformRandomVariable> ();
+  rng->SetStream (1);
+  std::vector<Scheduler::Event> pending;
+  uint32_t uid = 0;
+  uint64_t now = 0;
+  // Start with a skewed population so that the first buckets get split
+  // over several levels.
+  for (uint32_t i = 0; i < 20000; ++i)
+    {
+      double u = rng->GetValue ();
+      Scheduler::Event ev;
+      ev.impl = 0;
+      ev.key.m_ts = static_cast<uint64_t> (u * u * u * u * 1e9);
+      ev.key.m_uid = uid++;
+      ev.key.m_context = 0;
+      scheduler->Insert (ev);
+      reference->Insert (ev);
+      pending.push_back (ev);
+    }
+  for (uint32_t step = 0; step < 50000; ++step)
+    {
+      uint32_t action = rng->GetInteger (0, 999);
+      if (action < 400)
+        {
+          // A burst at one timestamp, or a single event close to or far
+          // from now.
+          uint32_t n = action < 2 ? rng->GetInteger (50, 500) : 1;
+          uint64_t ts = now;
+          if (action >= 200)
+            {
+              ts += rng->GetInteger (0, 100);
+            }
+          else if (action >= 2)
+            {
+              ts += rng->GetInteger (0, 1000000);
+            }
+          for (uint32_t i = 0; i < n; ++i)
+            {
+              Scheduler::Event ev;
+              ev.impl = 0;
+              ev.key.m_ts = ts;
+              ev.key.m_uid = uid++;
+              ev.key.m_context = 0;
+              scheduler->Insert (ev);
+              reference->Insert (ev);
+              pending.push_back (ev);
+            }
+        }
+      else if (action < 450)
+        {
+          if (pending.empty ())
+            {
+              continue;
+            }
+          uint32_t i = rng->GetInteger (0, pending.size () - 1);
+          Scheduler::Event ev = pending[i];
+          pending[i] = pending.back ();
+          pending.pop_back ();
+          // Dequeued events sort before everything still queued.
+          if (!reference->IsEmpty () && !(ev < reference->PeekNext ()))
+            {
+              scheduler->Remove (ev);
+              reference->Remove (ev);
+            }
+        }
+      else if (!reference->IsEmpty ())
+        {
+          NS_TEST_ASSERT_MSG_EQ (scheduler->IsEmpty (), false, "Scheduler lost events");
+          Scheduler::Event next = reference->RemoveNext ();
+          NS_TEST_ASSERT_MSG_EQ (scheduler->PeekNext ().key.m_uid, next.key.m_uid,
+                                 "Wrong event at the head of the queue");
+          NS_TEST_ASSERT_MSG_EQ (scheduler->RemoveNext ().key.m_uid, next.key.m_uid,
+                                 "Wrong event dequeued");
+          now = next.key.m_ts;
+        }
+    }
+  while (!reference->IsEmpty ())
+    {
+      NS_TEST_ASSERT_MSG_EQ (scheduler->RemoveNext ().key.m_uid,
+                             reference->RemoveNext ().key.m_uid,
+                             "Wrong event dequeued");
+    }
+  NS_TEST_EXPECT_MSG_EQ (scheduler->IsEmpty (), true, "Scheduler has extra events");
+}
+
 class SimulatorTestSuite : public TestSuite
 {
 public:
@@ -475,5 +798,11 @@ public:
     AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
     factory.SetTypeId (CalendarScheduler::GetTypeId ());
     AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (LadderScheduler::GetTypeId ());
+    AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
+    AddTestCase (new SchedulerOrderTestCase (factory), TestCase::QUICK);
+    AddTestCase (new SimulatorEventPoolTestCase (), TestCase::QUICK);
+    AddTestCase (new SimulatorPurgeTestCase (), TestCase::QUICK);
+    AddTestCase (new SimulatorProfilerTestCase (), TestCase::QUICK);
   }
 } g_simulatorTestSuite;
@@ -25,11 +25,18 @@
 #include "ns3/calendar-scheduler.h"
 #include "ns3/config.h"
 #include "ns3/string.h"
+#include "ns3/uinteger.h"
 #include "ns3/system-thread.h"
+#include "ns3/nstime.h"
+#include "ns3/make-event.h"
+#include "ns3/multithreaded-simulator-impl.h"
 
 #include <ctime>
+#include <algorithm>
 #include <list>
+#include <sstream>
 #include <utility>
+#include <vector>
 
 using namespace ns3;
 
@@ -225,6 +232,330 @@ ThreadedSimulatorEventsTestCase::DoRun (void)
   NS_TEST_EXPECT_MSG_EQ (m_a, m_d, "Bad scheduling");
 }
 
+class ThreadedEventOrderTestCase : public TestCase
+{
+public:
+  ThreadedEventOrderTestCase (uint32_t capacity);
+  static std::string Name (uint32_t capacity);
+  void Record (uint32_t threadno, uint32_t seq);
+  void Poll (void);
+  static void SchedulingThread (std::pair<ThreadedEventOrderTestCase *, uint32_t> context);
+  uint32_t m_capacity;
+  std::vector<uint32_t> m_next;
+  uint32_t m_received;
+  uint32_t m_polls;
+  bool m_ordered;
+  std::list<Ptr<SystemThread> > m_threadlist;
+
+  static const uint32_t THREADS = 8;
+  static const uint32_t EVENTS = 5000;
+
+private:
+  virtual void DoSetup (void);
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+};
+
+ThreadedEventOrderTestCase::ThreadedEventOrderTestCase (uint32_t capacity)
+  : TestCase (Name (capacity)),
+    m_capacity (capacity)
+{
+}
+
+std::string
+ThreadedEventOrderTestCase::Name (uint32_t capacity)
+{
+  std::ostringstream oss;
+  oss << "Check that events scheduled from other threads keep their order "
+      << "with a lock free queue of capacity " << capacity;
+  return oss.str ();
+}
+
+void
+ThreadedEventOrderTestCase::SchedulingThread (std::pair<ThreadedEventOrderTestCase *, uint32_t> context)
+{
+  for (uint32_t seq = 0; seq < EVENTS; ++seq)
+    {
+      Simulator::ScheduleWithContext (context.second, Seconds (0),
+                                      &ThreadedEventOrderTestCase::Record,
+                                      context.first, context.second, seq);
+    }
+}
+
+void
+ThreadedEventOrderTestCase::Record (uint32_t threadno, uint32_t seq)
+{
+  if (m_next[threadno] != seq)
+    {
+      m_ordered = false;
+    }
+  m_next[threadno] = seq + 1;
+  m_received++;
+}
+
+void
+ThreadedEventOrderTestCase::Poll (void)
+{
+  m_polls++;
+  if (m_received < THREADS * EVENTS && m_polls < 100000000)
+    {
+      Simulator::Schedule (MicroSeconds (1), &ThreadedEventOrderTestCase::Poll, this);
+    }
+}
+
+void
+ThreadedEventOrderTestCase::DoSetup (void)
+{
+  Config::SetDefault ("ns3::DefaultSimulatorImpl::EventsWithContextCapacity",
+                      UintegerValue (m_capacity));
+  m_next.assign (THREADS, 0);
+  m_received = 0;
+  m_polls = 0;
+  m_ordered = true;
+  for (uint32_t i = 0; i < THREADS; ++i)
+    {
+      m_threadlist.push_back (
+        Create<SystemThread> (MakeBoundCallback (
+                                &ThreadedEventOrderTestCase::SchedulingThread,
+                                std::pair<ThreadedEventOrderTestCase *, uint32_t> (this, i))));
+    }
+}
+
+void
+ThreadedEventOrderTestCase::DoTeardown (void)
+{
+  m_threadlist.clear ();
+  Config::SetDefault ("ns3::DefaultSimulatorImpl::EventsWithContextCapacity",
+                      UintegerValue (1024));
+}
+
+void
+ThreadedEventOrderTestCase::DoRun (void)
+{
+  // Create the simulator, with the capacity set in DoSetup, before the
+  // threads use it.
+  Simulator::Schedule (MicroSeconds (1), &ThreadedEventOrderTestCase::Poll, this);
+  for (std::list<Ptr<SystemThread> >::iterator it = m_threadlist.begin (); it != m_threadlist.end (); ++it)
+    {
+      (*it)->Start ();
+    }
+  Simulator::Run ();
+  for (std::list<Ptr<SystemThread> >::iterator it = m_threadlist.begin (); it != m_threadlist.end (); ++it)
+    {
+      (*it)->Join ();
+    }
+  Simulator::Destroy ();
+
+  NS_TEST_EXPECT_MSG_EQ (m_received, THREADS * EVENTS, "Lost events scheduled from other threads");
+  NS_TEST_EXPECT_MSG_EQ (m_ordered, true, "Events of one thread out of order");
+}
+
+class ThreadedEventPoolTestCase : public TestCase
+{
+public:
+  ThreadedEventPoolTestCase ();
+  static void Nothing (void);
+  void FreeEvents (void);
+  std::vector<EventImpl *> m_events;
+  uint64_t m_remote;
+
+  static const uint32_t EVENTS = 100;
+
+private:
+  virtual void DoRun (void);
+};
+
+ThreadedEventPoolTestCase::ThreadedEventPoolTestCase ()
+  : TestCase ("Check that events freed by another thread return to their pool "
+              "and that the free lists are bounded")
+{
+}
+
+void
+ThreadedEventPoolTestCase::Nothing (void)
+{
+}
+
+void
+ThreadedEventPoolTestCase::FreeEvents (void)
+{
+  EventImpl::PoolStats before = EventImpl::GetPoolStats ();
+  for (std::vector<EventImpl *>::iterator i = m_events.begin (); i != m_events.end (); ++i)
+    {
+      (*i)->Unref ();
+    }
+  m_remote = EventImpl::GetPoolStats ().remote - before.remote;
+}
+
+void
+ThreadedEventPoolTestCase::DoRun (void)
+{
+  // Allocate the events here, free them on another thread.
+  for (uint32_t i = 0; i < EVENTS; ++i)
+    {
+      m_events.push_back (MakeEvent (&ThreadedEventPoolTestCase::Nothing));
+    }
+  Ptr<SystemThread> thread = Create<SystemThread>
+    (MakeCallback (&ThreadedEventPoolTestCase::FreeEvents, this));
+  thread->Start ();
+  thread->Join ();
+  m_events.clear ();
+  NS_TEST_EXPECT_MSG_EQ (m_remote, EVENTS, "Events were not handed back to their pool");
+
+  // The blocks handed back are reused by this thread.
+  EventImpl::PoolStats before = EventImpl::GetPoolStats ();
+  for (uint32_t i = 0; i < EVENTS; ++i)
+    {
+      m_events.push_back (MakeEvent (&ThreadedEventPoolTestCase::Nothing));
+    }
+  EventImpl::PoolStats after = EventImpl::GetPoolStats ();
+  NS_TEST_EXPECT_MSG_EQ (after.hits - before.hits, EVENTS, "Handed back events were not reused");
+  NS_TEST_EXPECT_MSG_EQ (after.refills, before.refills, "Pool grew while events were handed back");
+
+  // A free list keeps at most MAX_FREE_EVENTS blocks.
+  uint32_t events = EventImpl::MAX_FREE_EVENTS + 2 * EVENTS;
+  while (m_events.size () < events)
+    {
+      m_events.push_back (MakeEvent (&ThreadedEventPoolTestCase::Nothing));
+    }
+  before = EventImpl::GetPoolStats ();
+  for (std::vector<EventImpl *>::iterator i = m_events.begin (); i != m_events.end (); ++i)
+    {
+      (*i)->Unref ();
+    }
+  m_events.clear ();
+  after = EventImpl::GetPoolStats ();
+  NS_TEST_EXPECT_MSG_EQ (after.released - before.released, events - EventImpl::MAX_FREE_EVENTS,
+                         "Free list was not bounded");
+}
+
+class MultithreadedSimulatorTestCase : public TestCase
+{
+public:
+  MultithreadedSimulatorTestCase (uint32_t threads);
+  typedef std::vector<std::vector<std::pair<uint64_t, uint32_t> > > Traces;
+  void Hop (uint32_t context, uint32_t value, uint32_t hops);
+  void Local (uint32_t context, uint32_t value);
+  void Snapshot (void);
+  void RunScenario (void);
+  uint32_t m_threads;
+  Traces m_traces;
+  std::vector<uint32_t> m_snapshots;
+  uint64_t m_end;
+
+  static const uint32_t CONTEXTS = 24;
+  static const uint32_t CHAINS = 100;
+  static const uint32_t HOPS = 200;
+
+private:
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+};
+
+MultithreadedSimulatorTestCase::MultithreadedSimulatorTestCase (uint32_t threads)
+  : TestCase ("Check that ns3::MultithreadedSimulatorImpl runs the same events as ns3::DefaultSimulatorImpl"),
+    m_threads (threads)
+{
+}
+
+void
+MultithreadedSimulatorTestCase::Hop (uint32_t context, uint32_t value, uint32_t hops)
+{
+  m_traces[context].push_back (std::make_pair (Simulator::Now ().GetNanoSeconds (), value));
+  value = value * 1103515245 + 12345;
+  // Even delays: the snapshots and the stop time are odd.
+  Simulator::Schedule (NanoSeconds (2 * (value % 50)),
+                       &MultithreadedSimulatorTestCase::Local, this, context, value);
+  if (hops > 0)
+    {
+      uint32_t next = (value >> 8) % CONTEXTS;
+      Simulator::ScheduleWithContext (next, MicroSeconds (1) + NanoSeconds (2 * ((value >> 16) % 1000)),
+                                      &MultithreadedSimulatorTestCase::Hop, this, next, value, hops - 1);
+    }
+}
+
+void
+MultithreadedSimulatorTestCase::Local (uint32_t context, uint32_t value)
+{
+  NS_ASSERT (Simulator::GetContext () == context);
+  m_traces[context].push_back (std::make_pair (Simulator::Now ().GetNanoSeconds (), value));
+}
+
+void
+MultithreadedSimulatorTestCase::Snapshot (void)
+{
+  uint32_t n = 0;
+  for (Traces::const_iterator i = m_traces.begin (); i != m_traces.end (); ++i)
+    {
+      n += i->size ();
+    }
+  m_snapshots.push_back (n);
+}
+
+void
+MultithreadedSimulatorTestCase::RunScenario (void)
+{
+  m_traces.assign (CONTEXTS, std::vector<std::pair<uint64_t, uint32_t> > ());
+  m_snapshots.clear ();
+  for (uint32_t i = 0; i < CHAINS; ++i)
+    {
+      uint32_t context = i % CONTEXTS;
+      Simulator::ScheduleWithContext (context, NanoSeconds (2 * i),
+                                      &MultithreadedSimulatorTestCase::Hop, this, context, i, HOPS);
+    }
+  Ptr<MultithreadedSimulatorImpl> impl = DynamicCast<MultithreadedSimulatorImpl> (Simulator::GetImplementation ());
+  if (impl != 0)
+    {
+      // Move already scheduled events to a new partition.
+      impl->SetPartition (3, 5);
+      impl->SetPartition (7, 5);
+    }
+  for (uint32_t i = 1; i < 10; ++i)
+    {
+      Simulator::Schedule (MicroSeconds (10 * i) + NanoSeconds (1), &MultithreadedSimulatorTestCase::Snapshot, this);
+    }
+  Simulator::Stop (MicroSeconds (150) + NanoSeconds (1));
+  Simulator::Run ();
+  m_end = Simulator::Now ().GetNanoSeconds ();
+  Simulator::Destroy ();
+  for (Traces::iterator i = m_traces.begin (); i != m_traces.end (); ++i)
+    {
+      std::sort (i->begin (), i->end ());
+    }
+}
+
+void
+MultithreadedSimulatorTestCase::DoTeardown (void)
+{
+  Config::SetGlobal ("SimulatorImplementationType", StringValue ("ns3::DefaultSimulatorImpl"));
+  Config::SetDefault ("ns3::MultithreadedSimulatorImpl::Threads", UintegerValue (0));
+  Config::SetDefault ("ns3::MultithreadedSimulatorImpl::Lookahead", TimeValue (Seconds (0)));
+}
+
+void
+MultithreadedSimulatorTestCase::DoRun (void)
+{
+  Config::SetGlobal ("SimulatorImplementationType", StringValue ("ns3::DefaultSimulatorImpl"));
+  RunScenario ();
+  Traces traces = m_traces;
+  std::vector<uint32_t> snapshots = m_snapshots;
+  uint64_t end = m_end;
+
+  Config::SetDefault ("ns3::MultithreadedSimulatorImpl::Threads", UintegerValue (m_threads));
+  Config::SetDefault ("ns3::MultithreadedSimulatorImpl::Lookahead", TimeValue (MicroSeconds (1)));
+  Config::SetGlobal ("SimulatorImplementationType", StringValue ("ns3::MultithreadedSimulatorImpl"));
+  RunScenario ();
+
+  NS_TEST_ASSERT_MSG_GT (snapshots.back (), 0, "No event ran");
+  NS_TEST_EXPECT_MSG_EQ (m_end, end, "Different stop time");
+  NS_TEST_EXPECT_MSG_EQ ((m_snapshots == snapshots), true, "Events without context did not run alone");
+  for (uint32_t i = 0; i < CONTEXTS; ++i)
+    {
+      NS_TEST_EXPECT_MSG_EQ (m_traces[i].size (), traces[i].size (), "Different number of events in context " << i);
+      NS_TEST_EXPECT_MSG_EQ ((m_traces[i] == traces[i]), true, "Different events in context " << i);
+    }
+}
+
 class ThreadedSimulatorTestSuite : public TestSuite
 {
 public:
@@ -262,5 +593,14 @@ public:
               }
           }
       }
+    // A small queue overflows to the list, 0 always uses the list.
+    uint32_t capacities[] = { 1024, 16, 0 };
+    for (unsigned int i=0; i < (sizeof(capacities) / sizeof(capacities[0])); ++i)
+      {
+        AddTestCase (new ThreadedEventOrderTestCase (capacities[i]), TestCase::QUICK);
+      }
+    AddTestCase (new ThreadedEventPoolTestCase (), TestCase::QUICK);
+    AddTestCase (new MultithreadedSimulatorTestCase (1), TestCase::QUICK);
+    AddTestCase (new MultithreadedSimulatorTestCase (4), TestCase::QUICK);
   }
 } g_threadedSimulatorTestSuite;
@@ -21,6 +21,12 @@
 #include "ns3/test.h"
 #include "ns3/simulator.h"
 #include "ns3/nstime.h"
+#include "ns3/timer-wheel.h"
+#include "ns3/config.h"
+#include "ns3/boolean.h"
+#include "ns3/random-variable-stream.h"
+#include <utility>
+#include <vector>
 
 namespace {
 void bari (int)
@@ -208,6 +214,204 @@ TimerTemplateTestCase::DoTeardown (void)
   Simulator::Destroy ();
 }
 
+class TimerWheelTestCase : public TestCase
+{
+public:
+  TimerWheelTestCase ();
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+  /**
+   * Drive the timers with and without the wheel.
+   * \param wheel whether to use the TimerWheel
+   * \returns the expirations and delays left seen, in order
+   */
+  std::vector<std::pair<uint32_t, int64_t> > RunTimers (bool wheel);
+  void Step (uint32_t step);
+  void Expire (uint32_t i);
+  Time Delay (void);
+  std::vector<Timer *> m_timers;
+  std::vector<std::pair<uint32_t, int64_t> > m_record;
+  Ptr<UniformRandomVariable> m_rng;
+  uint32_t m_maxWheelTimers;
+};
+
+TimerWheelTestCase::TimerWheelTestCase ()
+  : TestCase ("Check that the timer wheel expires timers at the same times")
+{
+}
+
+Time
+TimerWheelTestCase::Delay (void)
+{
+  switch (m_rng->GetInteger (0, 3))
+    {
+    case 0:
+      return MicroSeconds (m_rng->GetInteger (0, 100));
+    case 1:
+      return MicroSeconds (m_rng->GetInteger (1, 64 * 64 * 10));
+    case 2:
+      return MilliSeconds (m_rng->GetInteger (1, 1000));
+    default:
+      // past the last level with a resolution of 1 us
+      return Seconds (m_rng->GetInteger (10, 30));
+    }
+}
+
+void
+TimerWheelTestCase::Expire (uint32_t i)
+{
+  m_record.push_back (std::make_pair (i, Simulator::Now ().GetNanoSeconds ()));
+  if (m_rng->GetInteger (0, 1) == 0)
+    {
+      m_timers[i]->Schedule (Delay ());
+    }
+}
+
+void
+TimerWheelTestCase::Step (uint32_t step)
+{
+  for (uint32_t n = 0; n < 20; ++n)
+    {
+      Timer *timer = m_timers[m_rng->GetInteger (0, m_timers.size () - 1)];
+      if (timer->IsRunning ())
+        {
+          m_record.push_back (std::make_pair (0xffffffff, timer->GetDelayLeft ().GetNanoSeconds ()));
+          if (m_rng->GetInteger (0, 3) == 0)
+            {
+              timer->Suspend ();
+              timer->Resume ();
+              continue;
+            }
+          timer->Cancel ();
+        }
+      // Offset by 1 ns, so that expirations never fall on a step.
+      timer->Schedule (Delay () + NanoSeconds (1));
+    }
+  if (TimerWheel::IsEnabled ())
+    {
+      m_maxWheelTimers = std::max (m_maxWheelTimers, TimerWheel::Get ()->GetNTimers ());
+    }
+  if (step < 500)
+    {
+      Simulator::Schedule (MicroSeconds (100), &TimerWheelTestCase::Step, this, step + 1);
+    }
+}
+
+std::vector<std::pair<uint32_t, int64_t> >
+TimerWheelTestCase::RunTimers (bool wheel)
+{
+  Config::SetGlobal ("TimerWheel", BooleanValue (wheel));
+  Config::SetGlobal ("TimerWheelResolution", TimeValue (MicroSeconds (1)));
+  m_rng = CreateObject<UniformRandomVariable> ();
+  m_rng->SetStream (1);
+  m_record.clear ();
+  m_maxWheelTimers = 0;
+  for (uint32_t i = 0; i < 200; ++i)
+    {
+      Timer *timer = new Timer (Timer::CANCEL_ON_DESTROY);
+      timer->SetFunction (&TimerWheelTestCase::Expire, this);
+      timer->SetArguments (i);
+      m_timers.push_back (timer);
+    }
+  Simulator::Schedule (NanoSeconds (1), &TimerWheelTestCase::Step, this, 0);
+  Simulator::Run ();
+  for (std::vector<Timer *>::iterator i = m_timers.begin (); i != m_timers.end (); ++i)
+    {
+      delete *i;
+    }
+  m_timers.clear ();
+  Simulator::Destroy ();
+  return m_record;
+}
+
+void
+TimerWheelTestCase::DoRun (void)
+{
+  std::vector<std::pair<uint32_t, int64_t> > events = RunTimers (false);
+  std::vector<std::pair<uint32_t, int64_t> > wheel = RunTimers (true);
+  NS_TEST_ASSERT_MSG_GT (m_maxWheelTimers, 100, "Timers did not use the wheel");
+  NS_TEST_ASSERT_MSG_EQ (wheel.size (), events.size (), "Different number of expirations");
+  for (uint32_t i = 0; i < events.size (); ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (wheel[i].first, events[i].first, "Timers expired in a different order");
+      NS_TEST_ASSERT_MSG_EQ (wheel[i].second, events[i].second, "Timer expired at a different time");
+    }
+}
+
+void
+TimerWheelTestCase::DoTeardown (void)
+{
+  Config::SetGlobal ("TimerWheel", BooleanValue (false));
+  Config::SetGlobal ("TimerWheelResolution", TimeValue (MilliSeconds (1)));
+}
+
+class TimerWheelCopyTestCase : public TestCase
+{
+public:
+  TimerWheelCopyTestCase ();
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+  void Expire (uint32_t i);
+  std::vector<uint32_t> m_expired;
+};
+
+TimerWheelCopyTestCase::TimerWheelCopyTestCase ()
+  : TestCase ("Check that copies of a timer do not share its timer wheel entry")
+{
+}
+
+void
+TimerWheelCopyTestCase::Expire (uint32_t i)
+{
+  m_expired.push_back (i);
+}
+
+void
+TimerWheelCopyTestCase::DoRun (void)
+{
+  Config::SetGlobal ("TimerWheel", BooleanValue (true));
+  Simulator::Destroy ();
+
+  Timer original (Timer::CANCEL_ON_DESTROY);
+  original.SetFunction (&TimerWheelCopyTestCase::Expire, this);
+  original.SetArguments (static_cast<uint32_t> (0));
+  original.Schedule (Seconds (1));
+  {
+    Timer copy (original);
+    NS_TEST_EXPECT_MSG_EQ (copy.IsRunning (), false, "Copy took over the wheel entry");
+    Timer assigned (Timer::CANCEL_ON_DESTROY);
+    assigned = original;
+    NS_TEST_EXPECT_MSG_EQ (assigned.IsRunning (), false, "Assignment took over the wheel entry");
+    // The copies can be scheduled on their own.
+    copy.SetArguments (static_cast<uint32_t> (1));
+    copy.Schedule (Seconds (2));
+  }
+  NS_TEST_EXPECT_MSG_EQ (original.IsRunning (), true, "Destroying a copy cancelled the original");
+
+  // A stale identifier does not cancel the Timer which reuses its entry.
+  TimerWheel *wheel = TimerWheel::Get ();
+  Timer other (Timer::CANCEL_ON_DESTROY);
+  other.SetFunction (&TimerWheelCopyTestCase::Expire, this);
+  other.SetArguments (static_cast<uint32_t> (2));
+  uint64_t stale = wheel->Arm (&other, Seconds (3));
+  wheel->Cancel (stale);
+  other.Schedule (Seconds (3));
+  wheel->Cancel (stale);
+  NS_TEST_EXPECT_MSG_EQ (other.IsRunning (), true, "Stale identifier cancelled another timer");
+
+  Simulator::Run ();
+  NS_TEST_ASSERT_MSG_EQ (m_expired.size (), 2, "Wrong number of expirations");
+  NS_TEST_EXPECT_MSG_EQ (m_expired[0], 0, "Original did not expire");
+  NS_TEST_EXPECT_MSG_EQ (m_expired[1], 2, "Other timer did not expire");
+  Simulator::Destroy ();
+}
+
+void
+TimerWheelCopyTestCase::DoTeardown (void)
+{
+  Config::SetGlobal ("TimerWheel", BooleanValue (false));
+}
+
 static class TimerTestSuite : public TestSuite
 {
 public:
@@ -216,5 +420,7 @@ public:
   {
     AddTestCase (new TimerStateTestCase (), TestCase::QUICK);
     AddTestCase (new TimerTemplateTestCase (), TestCase::QUICK);
+    AddTestCase (new TimerWheelTestCase (), TestCase::QUICK);
+    AddTestCase (new TimerWheelCopyTestCase (), TestCase::QUICK);
   }
 } g_timerTestSuite;
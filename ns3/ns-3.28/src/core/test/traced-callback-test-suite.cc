@@ -108,6 +108,168 @@ BasicTracedCallbackTestCase::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ (m_two, true, "Callback CbTwo not called");
 }
 
+class ConnectTracedCallbackTestCase : public TestCase
+{
+public:
+  ConnectTracedCallbackTestCase ();
+  virtual ~ConnectTracedCallbackTestCase () {}
+
+private:
+  virtual void DoRun (void);
+
+  void CbOne (uint8_t a, double b);
+  void CbTwo (uint8_t a, double b);
+
+  TracedCallback<uint8_t, double> m_trace;
+  uint32_t m_one;
+  uint32_t m_two;
+};
+
+ConnectTracedCallbackTestCase::ConnectTracedCallbackTestCase ()
+  : TestCase ("Check TracedCallback IsEmpty and connections from a callback")
+{
+}
+
+void
+ConnectTracedCallbackTestCase::CbOne (uint8_t a, double b)
+{
+  m_one++;
+  //
+  // Connect enough callbacks to move the chain while it is being invoked.
+  //
+  if (m_one == 1)
+    {
+      for (uint32_t i = 0; i < 16; i++)
+        {
+          m_trace.ConnectWithoutContext (MakeCallback (&ConnectTracedCallbackTestCase::CbTwo, this));
+        }
+    }
+}
+
+void
+ConnectTracedCallbackTestCase::CbTwo (uint8_t a, double b)
+{
+  m_two++;
+}
+
+void
+ConnectTracedCallbackTestCase::DoRun (void)
+{
+  NS_TEST_ASSERT_MSG_EQ (m_trace.IsEmpty (), true, "New TracedCallback not empty");
+
+  m_trace.ConnectWithoutContext (MakeCallback (&ConnectTracedCallbackTestCase::CbOne, this));
+  NS_TEST_ASSERT_MSG_EQ (m_trace.IsEmpty (), false, "Connected TracedCallback empty");
+
+  //
+  // The callbacks connected by CbOne are called on the same invocation.
+  //
+  m_one = 0;
+  m_two = 0;
+  m_trace (1, 2);
+  NS_TEST_ASSERT_MSG_EQ (m_one, 1, "Callback CbOne not called once");
+  NS_TEST_ASSERT_MSG_EQ (m_two, 16, "Callbacks connected by CbOne not called");
+
+  m_trace (1, 2);
+  NS_TEST_ASSERT_MSG_EQ (m_one, 2, "Callback CbOne not called once");
+  NS_TEST_ASSERT_MSG_EQ (m_two, 32, "Callbacks CbTwo not called");
+
+  //
+  // Disconnecting removes every identical callback.
+  //
+  m_trace.DisconnectWithoutContext (MakeCallback (&ConnectTracedCallbackTestCase::CbTwo, this));
+  m_trace.DisconnectWithoutContext (MakeCallback (&ConnectTracedCallbackTestCase::CbOne, this));
+  NS_TEST_ASSERT_MSG_EQ (m_trace.IsEmpty (), true, "Disconnected TracedCallback not empty");
+  m_trace (1, 2);
+  NS_TEST_ASSERT_MSG_EQ (m_one, 2, "Callback CbOne unexpectedly called");
+  NS_TEST_ASSERT_MSG_EQ (m_two, 32, "Callback CbTwo unexpectedly called");
+}
+
+class DisconnectTracedCallbackTestCase : public TestCase
+{
+public:
+  DisconnectTracedCallbackTestCase ();
+  virtual ~DisconnectTracedCallbackTestCase () {}
+
+private:
+  virtual void DoRun (void);
+
+  void CbOne (uint8_t a, double b);
+  void CbTwo (uint8_t a, double b);
+  void CbThree (uint8_t a, double b);
+
+  TracedCallback<uint8_t, double> m_trace;
+  uint32_t m_one;
+  uint32_t m_two;
+  uint32_t m_three;
+};
+
+DisconnectTracedCallbackTestCase::DisconnectTracedCallbackTestCase ()
+  : TestCase ("Check TracedCallback disconnections from a callback and copies")
+{
+}
+
+void
+DisconnectTracedCallbackTestCase::CbOne (uint8_t a, double b)
+{
+  m_one++;
+  //
+  // Disconnect this callback, while it runs, and the next one.
+  //
+  m_trace.DisconnectWithoutContext (MakeCallback (&DisconnectTracedCallbackTestCase::CbOne, this));
+  m_trace.DisconnectWithoutContext (MakeCallback (&DisconnectTracedCallbackTestCase::CbTwo, this));
+  m_trace.ConnectWithoutContext (MakeCallback (&DisconnectTracedCallbackTestCase::CbTwo, this));
+}
+
+void
+DisconnectTracedCallbackTestCase::CbTwo (uint8_t a, double b)
+{
+  m_two++;
+}
+
+void
+DisconnectTracedCallbackTestCase::CbThree (uint8_t a, double b)
+{
+  m_three++;
+}
+
+void
+DisconnectTracedCallbackTestCase::DoRun (void)
+{
+  m_trace.ConnectWithoutContext (MakeCallback (&DisconnectTracedCallbackTestCase::CbOne, this));
+  m_trace.ConnectWithoutContext (MakeCallback (&DisconnectTracedCallbackTestCase::CbTwo, this));
+  m_trace.ConnectWithoutContext (MakeCallback (&DisconnectTracedCallbackTestCase::CbThree, this));
+
+  //
+  // CbTwo is disconnected before its turn, then connected again at
+  // the end of the chain.
+  //
+  m_one = 0;
+  m_two = 0;
+  m_three = 0;
+  m_trace (1, 2);
+  NS_TEST_ASSERT_MSG_EQ (m_one, 1, "Callback CbOne not called once");
+  NS_TEST_ASSERT_MSG_EQ (m_two, 1, "Callback CbTwo not called once, after CbThree");
+  NS_TEST_ASSERT_MSG_EQ (m_three, 1, "Callback CbThree not called once");
+
+  m_trace (1, 2);
+  NS_TEST_ASSERT_MSG_EQ (m_one, 1, "Disconnected callback CbOne called");
+  NS_TEST_ASSERT_MSG_EQ (m_two, 2, "Callback CbTwo not called");
+  NS_TEST_ASSERT_MSG_EQ (m_three, 2, "Callback CbThree not called");
+
+  //
+  // A copy keeps its own chain.
+  //
+  TracedCallback<uint8_t, double> copy = m_trace;
+  m_trace.DisconnectWithoutContext (MakeCallback (&DisconnectTracedCallbackTestCase::CbTwo, this));
+  m_trace.DisconnectWithoutContext (MakeCallback (&DisconnectTracedCallbackTestCase::CbThree, this));
+  NS_TEST_ASSERT_MSG_EQ (m_trace.IsEmpty (), true, "Disconnected TracedCallback not empty");
+  NS_TEST_ASSERT_MSG_EQ (copy.IsEmpty (), false, "Copy of a TracedCallback empty");
+  copy (1, 2);
+  m_trace (1, 2);
+  NS_TEST_ASSERT_MSG_EQ (m_two, 3, "Callback CbTwo not called once by the copy");
+  NS_TEST_ASSERT_MSG_EQ (m_three, 3, "Callback CbThree not called once by the copy");
+}
+
 class TracedCallbackTestSuite : public TestSuite
 {
 public:
@@ -118,6 +280,8 @@ TracedCallbackTestSuite::TracedCallbackTestSuite ()
   : TestSuite ("traced-callback", UNIT)
 {
   AddTestCase (new BasicTracedCallbackTestCase, TestCase::QUICK);
+  AddTestCase (new ConnectTracedCallbackTestCase, TestCase::QUICK);
+  AddTestCase (new DisconnectTracedCallbackTestCase, TestCase::QUICK);
 }
 
 static TracedCallbackTestSuite tracedCallbackTestSuite;
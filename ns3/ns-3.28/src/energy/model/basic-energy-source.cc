@@ -24,6 +24,7 @@
 #include "ns3/double.h"
 #include "ns3/trace-source-accessor.h"
 #include "ns3/simulator.h"
+#include <algorithm>
 
 namespace ns3 {
 
@@ -148,6 +149,34 @@ BasicEnergySource::GetEnergyFraction (void)
   return m_remainingEnergyJ / m_initialEnergyJ;
 }
 
+void
+BasicEnergySource::DecreaseRemainingEnergy (double energyJ)
+{
+  NS_LOG_FUNCTION (this << energyJ);
+  NS_ASSERT (energyJ >= 0);
+  m_remainingEnergyJ -= std::min (energyJ, m_remainingEnergyJ.Get ());
+
+  if (!m_depleted && m_remainingEnergyJ <= m_lowBatteryTh * m_initialEnergyJ)
+    {
+      m_depleted = true;
+      HandleEnergyDrainedEvent ();
+    }
+}
+
+void
+BasicEnergySource::IncreaseRemainingEnergy (double energyJ)
+{
+  NS_LOG_FUNCTION (this << energyJ);
+  NS_ASSERT (energyJ >= 0);
+  m_remainingEnergyJ += energyJ;
+
+  if (m_depleted && m_remainingEnergyJ > m_highBatteryTh * m_initialEnergyJ)
+    {
+      m_depleted = false;
+      HandleEnergyRechargedEvent ();
+    }
+}
+
 void
 BasicEnergySource::UpdateEnergySource (void)
 {
@@ -69,6 +69,21 @@ public:
    */
   virtual double GetEnergyFraction (void);
 
+  /**
+   * \param energyJ Amount of energy (in Joules) to decrease from energy source.
+   *
+   * Implements DecreaseRemainingEnergy. The energy is removed immediately,
+   * without waiting for the next periodic update.
+   */
+  virtual void DecreaseRemainingEnergy (double energyJ);
+
+  /**
+   * \param energyJ Amount of energy (in Joules) to increase from energy source.
+   *
+   * Implements IncreaseRemainingEnergy.
+   */
+  virtual void IncreaseRemainingEnergy (double energyJ);
+
   /**
    * Implements UpdateEnergySource.
    */
@@ -25,6 +25,7 @@
 
 #include "energy-source.h"
 #include "ns3/log.h"
+#include "ns3/fatal-error.h"
 
 namespace ns3 {
 
@@ -120,6 +120,21 @@ public:
    */
   virtual void UpdateEnergySource (void) = 0;
 
+  /**
+   * \param energyJ Amount of energy (in Joules) to decrease from the source.
+   *
+   * Direct energy update interface, used by DeviceEnergyModels that charge a
+   * fixed amount of energy per operation instead of drawing a current.
+   */
+  virtual void DecreaseRemainingEnergy (double energyJ) = 0;
+
+  /**
+   * \param energyJ Amount of energy (in Joules) to add to the source.
+   *
+   * Direct energy update interface.
+   */
+  virtual void IncreaseRemainingEnergy (double energyJ) = 0;
+
   /**
    * \brief Sets pointer to node containing this EnergySource.
    *
@@ -0,0 +1,225 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "first-order-radio-energy-model.h"
+#include "radio-distance-tag.h"
+#include "ns3/energy-source.h"
+#include "ns3/double.h"
+#include "ns3/trace-source-accessor.h"
+#include "ns3/log.h"
+#include <cmath>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("FirstOrderRadioEnergyModel");
+
+NS_OBJECT_ENSURE_REGISTERED (FirstOrderRadioEnergyModel);
+
+TypeId
+FirstOrderRadioEnergyModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::FirstOrderRadioEnergyModel")
+    .SetParent<DeviceEnergyModel> ()
+    .SetGroupName ("Energy")
+    .AddConstructor<FirstOrderRadioEnergyModel> ()
+    .AddAttribute ("ElectronicsEnergy",
+                   "Energy dissipated per bit by the transmitter or receiver circuitry (E_elec), in J/bit.",
+                   DoubleValue (50e-9),
+                   MakeDoubleAccessor (&FirstOrderRadioEnergyModel::m_elecEnergyJ),
+                   MakeDoubleChecker<double> (0))
+    .AddAttribute ("FreeSpaceAmplifierEnergy",
+                   "Transmit amplifier energy in the free space model (eps_fs), in J/bit/m^2.",
+                   DoubleValue (10e-12),
+                   MakeDoubleAccessor (&FirstOrderRadioEnergyModel::m_freeSpaceAmpEnergyJ),
+                   MakeDoubleChecker<double> (0))
+    .AddAttribute ("MultipathAmplifierEnergy",
+                   "Transmit amplifier energy in the multipath fading model (eps_mp), in J/bit/m^4.",
+                   DoubleValue (0.0013e-12),
+                   MakeDoubleAccessor (&FirstOrderRadioEnergyModel::m_multipathAmpEnergyJ),
+                   MakeDoubleChecker<double> (0))
+    .AddAttribute ("DefaultDistance",
+                   "Transmission distance, in meters, charged for packets without a RadioDistanceTag.",
+                   DoubleValue (0.0),
+                   MakeDoubleAccessor (&FirstOrderRadioEnergyModel::m_defaultDistance),
+                   MakeDoubleChecker<double> (0))
+    .AddTraceSource ("TotalEnergyConsumption",
+                     "Total energy consumption of the radio device.",
+                     MakeTraceSourceAccessor (&FirstOrderRadioEnergyModel::m_totalEnergyConsumption),
+                     "ns3::TracedValueCallback::Double")
+  ;
+  return tid;
+}
+
+FirstOrderRadioEnergyModel::FirstOrderRadioEnergyModel ()
+  : m_source (0),
+    m_depleted (false),
+    m_totalEnergyConsumption (0)
+{
+  NS_LOG_FUNCTION (this);
+  m_energyDepletionCallback.Nullify ();
+  m_energyRechargedCallback.Nullify ();
+}
+
+FirstOrderRadioEnergyModel::~FirstOrderRadioEnergyModel ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+FirstOrderRadioEnergyModel::SetEnergySource (Ptr<EnergySource> source)
+{
+  NS_LOG_FUNCTION (this << source);
+  NS_ASSERT (source != NULL);
+  m_source = source;
+}
+
+double
+FirstOrderRadioEnergyModel::GetTotalEnergyConsumption (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_totalEnergyConsumption;
+}
+
+void
+FirstOrderRadioEnergyModel::ChangeState (int newState)
+{
+  NS_LOG_FUNCTION (this << newState);
+}
+
+void
+FirstOrderRadioEnergyModel::HandleEnergyDepletion (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_LOG_DEBUG ("FirstOrderRadioEnergyModel:Energy is depleted!");
+  m_depleted = true;
+  if (!m_energyDepletionCallback.IsNull ())
+    {
+      m_energyDepletionCallback ();
+    }
+}
+
+void
+FirstOrderRadioEnergyModel::HandleEnergyRecharged (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_LOG_DEBUG ("FirstOrderRadioEnergyModel:Energy is recharged!");
+  m_depleted = false;
+  if (!m_energyRechargedCallback.IsNull ())
+    {
+      m_energyRechargedCallback ();
+    }
+}
+
+void
+FirstOrderRadioEnergyModel::HandleEnergyChanged (void)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+FirstOrderRadioEnergyModel::SetEnergyDepletionCallback (FirstOrderRadioEnergyCallback callback)
+{
+  NS_LOG_FUNCTION (this);
+  m_energyDepletionCallback = callback;
+}
+
+void
+FirstOrderRadioEnergyModel::SetEnergyRechargedCallback (FirstOrderRadioEnergyCallback callback)
+{
+  NS_LOG_FUNCTION (this);
+  m_energyRechargedCallback = callback;
+}
+
+double
+FirstOrderRadioEnergyModel::GetCrossoverDistance (void) const
+{
+  return std::sqrt (m_freeSpaceAmpEnergyJ / m_multipathAmpEnergyJ);
+}
+
+double
+FirstOrderRadioEnergyModel::GetTxEnergy (uint32_t bits, double distance) const
+{
+  double d2 = distance * distance;
+  // d < d0 <=> d^2 < eps_fs / eps_mp, which avoids a square root per packet
+  if (d2 * m_multipathAmpEnergyJ < m_freeSpaceAmpEnergyJ)
+    {
+      return bits * (m_elecEnergyJ + m_freeSpaceAmpEnergyJ * d2);
+    }
+  return bits * (m_elecEnergyJ + m_multipathAmpEnergyJ * d2 * d2);
+}
+
+double
+FirstOrderRadioEnergyModel::GetRxEnergy (uint32_t bits) const
+{
+  return bits * m_elecEnergyJ;
+}
+
+void
+FirstOrderRadioEnergyModel::ChargeTx (uint32_t bits, double distance)
+{
+  NS_LOG_FUNCTION (this << bits << distance);
+  Consume (GetTxEnergy (bits, distance));
+}
+
+void
+FirstOrderRadioEnergyModel::ChargeRx (uint32_t bits)
+{
+  NS_LOG_FUNCTION (this << bits);
+  Consume (GetRxEnergy (bits));
+}
+
+void
+FirstOrderRadioEnergyModel::NotifyTx (Ptr<const Packet> packet)
+{
+  NS_LOG_FUNCTION (this << packet);
+  RadioDistanceTag tag (m_defaultDistance);
+  packet->PeekPacketTag (tag);
+  ChargeTx (packet->GetSize () * 8, tag.GetDistance ());
+}
+
+void
+FirstOrderRadioEnergyModel::NotifyRx (Ptr<const Packet> packet)
+{
+  NS_LOG_FUNCTION (this << packet);
+  ChargeRx (packet->GetSize () * 8);
+}
+
+/*
+ * Private functions start here.
+ */
+
+void
+FirstOrderRadioEnergyModel::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_source = NULL;
+  m_energyDepletionCallback.Nullify ();
+  m_energyRechargedCallback.Nullify ();
+}
+
+void
+FirstOrderRadioEnergyModel::Consume (double energyJ)
+{
+  if (m_depleted || m_source == 0)
+    {
+      return;
+    }
+  NS_LOG_DEBUG ("FirstOrderRadioEnergyModel:Consuming " << energyJ << " J");
+  m_totalEnergyConsumption += energyJ;
+  m_source->DecreaseRemainingEnergy (energyJ);
+}
+
+} // namespace ns3
@@ -0,0 +1,188 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef FIRST_ORDER_RADIO_ENERGY_MODEL_H
+#define FIRST_ORDER_RADIO_ENERGY_MODEL_H
+
+#include "ns3/device-energy-model.h"
+#include "ns3/traced-value.h"
+#include "ns3/callback.h"
+#include "ns3/packet.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup energy
+ *
+ * \brief First order radio energy model (Heinzelman et al.).
+ *
+ * This is the radio model used throughout the LEACH literature. Instead of
+ * tracking the radio state and the current drawn in each state, it charges a
+ * fixed amount of energy per transmitted and received bit:
+ *
+ *    E_tx(k, d) = E_elec * k + eps_fs * k * d^2   if d <  d0
+ *    E_tx(k, d) = E_elec * k + eps_mp * k * d^4   if d >= d0
+ *    E_rx(k)    = E_elec * k
+ *
+ * with d0 = sqrt (eps_fs / eps_mp) the crossover distance between the free
+ * space and the multipath fading channel model.
+ *
+ * The transmission distance is taken from the RadioDistanceTag that the
+ * routing layer attaches to the packet. Untagged packets (MAC control
+ * frames, broadcasts, ...) are charged for the DefaultDistance attribute.
+ *
+ * Every packet costs a constant amount of work and the energy is removed
+ * directly from the EnergySource (see EnergySource::DecreaseRemainingEnergy),
+ * so the model does not schedule any events and does not contribute a current
+ * to the source.
+ */
+class FirstOrderRadioEnergyModel : public DeviceEnergyModel
+{
+public:
+  /**
+   * Callback type for energy depletion / recharged handling.
+   */
+  typedef Callback<void> FirstOrderRadioEnergyCallback;
+
+  static TypeId GetTypeId (void);
+  FirstOrderRadioEnergyModel ();
+  virtual ~FirstOrderRadioEnergyModel ();
+
+  /**
+   * \param source Pointer to EnergySource installed on node.
+   *
+   * Implements DeviceEnergyModel::SetEnergySource.
+   */
+  virtual void SetEnergySource (Ptr<EnergySource> source);
+
+  /**
+   * \returns Total energy consumption of the radio, in Joules.
+   *
+   * Implements DeviceEnergyModel::GetTotalEnergyConsumption.
+   */
+  virtual double GetTotalEnergyConsumption (void) const;
+
+  /**
+   * \param newState New state the device is in.
+   *
+   * The first order model is stateless, this function does nothing.
+   */
+  virtual void ChangeState (int newState);
+
+  /**
+   * \brief Handles energy depletion.
+   *
+   * Stops charging energy and invokes the depletion callback.
+   */
+  virtual void HandleEnergyDepletion (void);
+
+  /**
+   * \brief Handles energy recharged.
+   *
+   * Resumes charging energy and invokes the recharged callback.
+   */
+  virtual void HandleEnergyRecharged (void);
+
+  /**
+   * \brief Handles energy changed.
+   *
+   * Not used by this model.
+   */
+  virtual void HandleEnergyChanged (void);
+
+  /**
+   * \param callback Callback function invoked when the energy is depleted.
+   */
+  void SetEnergyDepletionCallback (FirstOrderRadioEnergyCallback callback);
+
+  /**
+   * \param callback Callback function invoked when the energy is recharged.
+   */
+  void SetEnergyRechargedCallback (FirstOrderRadioEnergyCallback callback);
+
+  /**
+   * \returns the crossover distance d0 = sqrt (eps_fs / eps_mp), in meters.
+   */
+  double GetCrossoverDistance (void) const;
+
+  /**
+   * \param bits number of transmitted bits
+   * \param distance transmission distance, in meters
+   * \returns the energy needed to transmit the bits over the distance, in J.
+   */
+  double GetTxEnergy (uint32_t bits, double distance) const;
+
+  /**
+   * \param bits number of received bits
+   * \returns the energy needed to receive the bits, in Joules.
+   */
+  double GetRxEnergy (uint32_t bits) const;
+
+  /**
+   * \param bits number of transmitted bits
+   * \param distance transmission distance, in meters
+   *
+   * Charges the energy source for a transmission.
+   */
+  void ChargeTx (uint32_t bits, double distance);
+
+  /**
+   * \param bits number of received bits
+   *
+   * Charges the energy source for a reception.
+   */
+  void ChargeRx (uint32_t bits);
+
+  /**
+   * \param packet the packet that starts being transmitted
+   *
+   * Charges the transmission of a packet. The distance is read from the
+   * RadioDistanceTag of the packet. Meant to be connected to the transmit
+   * trace source of the PHY.
+   */
+  void NotifyTx (Ptr<const Packet> packet);
+
+  /**
+   * \param packet the packet that has been received
+   *
+   * Charges the reception of a packet. Meant to be connected to the receive
+   * trace source of the PHY.
+   */
+  void NotifyRx (Ptr<const Packet> packet);
+
+private:
+  void DoDispose (void);
+
+  /**
+   * \param energyJ the energy to remove from the source, in Joules.
+   */
+  void Consume (double energyJ);
+
+  Ptr<EnergySource> m_source;         ///< energy source
+  double m_elecEnergyJ;               ///< E_elec, in J/bit
+  double m_freeSpaceAmpEnergyJ;       ///< eps_fs, in J/bit/m^2
+  double m_multipathAmpEnergyJ;       ///< eps_mp, in J/bit/m^4
+  double m_defaultDistance;           ///< distance used for untagged packets
+  bool m_depleted;                    ///< true while the source is depleted
+  TracedValue<double> m_totalEnergyConsumption; ///< total energy consumption, in J
+
+  FirstOrderRadioEnergyCallback m_energyDepletionCallback; ///< energy depletion callback
+  FirstOrderRadioEnergyCallback m_energyRechargedCallback; ///< energy recharged callback
+};
+
+} // namespace ns3
+
+#endif /* FIRST_ORDER_RADIO_ENERGY_MODEL_H */
@@ -0,0 +1,81 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "radio-distance-tag.h"
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (RadioDistanceTag);
+
+TypeId
+RadioDistanceTag::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::RadioDistanceTag")
+    .SetParent<Tag> ()
+    .SetGroupName ("Energy")
+    .AddConstructor<RadioDistanceTag> ()
+  ;
+  return tid;
+}
+
+TypeId
+RadioDistanceTag::GetInstanceTypeId (void) const
+{
+  return GetTypeId ();
+}
+
+RadioDistanceTag::RadioDistanceTag (double distance)
+  : m_distance (distance)
+{
+}
+
+uint32_t
+RadioDistanceTag::GetSerializedSize (void) const
+{
+  return sizeof (double);
+}
+
+void
+RadioDistanceTag::Serialize (TagBuffer i) const
+{
+  i.WriteDouble (m_distance);
+}
+
+void
+RadioDistanceTag::Deserialize (TagBuffer i)
+{
+  m_distance = i.ReadDouble ();
+}
+
+void
+RadioDistanceTag::Print (std::ostream &os) const
+{
+  os << "Distance=" << m_distance;
+}
+
+void
+RadioDistanceTag::SetDistance (double distance)
+{
+  m_distance = distance;
+}
+
+double
+RadioDistanceTag::GetDistance (void) const
+{
+  return m_distance;
+}
+
+} // namespace ns3
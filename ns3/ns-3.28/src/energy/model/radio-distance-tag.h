@@ -0,0 +1,69 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef RADIO_DISTANCE_TAG_H
+#define RADIO_DISTANCE_TAG_H
+
+#include "ns3/tag.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup energy
+ *
+ * \brief Packet tag carrying the transmission distance of a packet.
+ *
+ * The routing layer knows the next hop of a packet and therefore the distance
+ * the radio has to bridge. It stores this distance in a RadioDistanceTag so
+ * that distance-based energy models (see FirstOrderRadioEnergyModel) can
+ * charge the transmission when the frame reaches the PHY.
+ */
+class RadioDistanceTag : public Tag
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  virtual TypeId GetInstanceTypeId (void) const;
+
+  /**
+   * \param distance the transmission distance, in meters
+   */
+  RadioDistanceTag (double distance = 0);
+
+  virtual uint32_t GetSerializedSize (void) const;
+  virtual void Serialize (TagBuffer i) const;
+  virtual void Deserialize (TagBuffer i);
+  virtual void Print (std::ostream &os) const;
+
+  /**
+   * \param distance the transmission distance, in meters
+   */
+  void SetDistance (double distance);
+  /**
+   * \return the transmission distance, in meters
+   */
+  double GetDistance (void) const;
+
+private:
+  double m_distance; ///< transmission distance, in meters
+};
+
+} // namespace ns3
+
+#endif /* RADIO_DISTANCE_TAG_H */
@@ -25,6 +25,7 @@
 #include "ns3/trace-source-accessor.h"
 #include "ns3/simulator.h"
 #include <cmath>
+#include <algorithm>
 
 namespace ns3 {
 
@@ -100,6 +101,7 @@ RvBatteryModel::RvBatteryModel ()
   m_previousLoad = -1.0;
   m_batteryLevel = 1; // fully charged
   m_lifetime = Seconds (0.0);
+  m_directCharge = 0;
 }
 
 RvBatteryModel::~RvBatteryModel ()
@@ -137,6 +139,24 @@ RvBatteryModel::GetEnergyFraction (void)
   return GetBatteryLevel ();
 }
 
+void
+RvBatteryModel::DecreaseRemainingEnergy (double energyJ)
+{
+  NS_LOG_FUNCTION (this << energyJ);
+  NS_ASSERT (energyJ >= 0);
+  m_directCharge += energyJ / GetSupplyVoltage ();
+  UpdateEnergySource ();
+}
+
+void
+RvBatteryModel::IncreaseRemainingEnergy (double energyJ)
+{
+  NS_LOG_FUNCTION (this << energyJ);
+  NS_ASSERT (energyJ >= 0);
+  m_directCharge -= std::min (energyJ / GetSupplyVoltage (), m_directCharge);
+  UpdateEnergySource ();
+}
+
 void
 RvBatteryModel::UpdateEnergySource (void)
 {
@@ -166,7 +186,7 @@ RvBatteryModel::UpdateEnergySource (void)
                 " time = " << Simulator::Now ().GetSeconds ());
 
   // calculate battery level
-  m_batteryLevel = 1 - (calculatedAlpha / m_alpha);
+  m_batteryLevel = 1 - ((calculatedAlpha + m_directCharge) / m_alpha);
   if (m_batteryLevel < 0)
     {
       m_batteryLevel = 0;
@@ -83,6 +83,22 @@ public:
    */
   virtual double GetEnergyFraction (void);
 
+  /**
+   * \param energyJ Amount of energy (in Joules) to decrease from the battery.
+   *
+   * Implements DecreaseRemainingEnergy. The charge drawn at the supply voltage
+   * is removed immediately and, unlike the load profile, does not recover.
+   */
+  virtual void DecreaseRemainingEnergy (double energyJ);
+
+  /**
+   * \param energyJ Amount of energy (in Joules) to add to the battery.
+   *
+   * Implements IncreaseRemainingEnergy. The charge is given back, up to the
+   * charge removed by DecreaseRemainingEnergy; a dead battery stays dead.
+   */
+  virtual void IncreaseRemainingEnergy (double energyJ);
+
   /**
    * Implements UpdateEnergySource. This function samples the total load (total
    * current) from all devices to discharge the battery.
@@ -228,6 +244,8 @@ private:
 
   int m_numOfTerms; // # of terms for infinite sum in battery level estimation
 
+  double m_directCharge; // charge removed by DecreaseRemainingEnergy, in Coulomb
+
   /**
    * Battery level is defined as: output of Discharge function / alpha value
    *
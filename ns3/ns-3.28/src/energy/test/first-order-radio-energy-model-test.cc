@@ -0,0 +1,124 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "ns3/test.h"
+#include "ns3/node.h"
+#include "ns3/simulator.h"
+#include "ns3/double.h"
+#include "ns3/packet.h"
+#include "ns3/basic-energy-source.h"
+#include "ns3/first-order-radio-energy-model.h"
+#include "ns3/radio-distance-tag.h"
+#include <cmath>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("FirstOrderRadioEnergyModelTestSuite");
+
+/**
+ * Checks the per-bit energy formulas and that the charged energy is removed
+ * from the energy source.
+ */
+class FirstOrderRadioEnergyModelTestCase : public TestCase
+{
+public:
+  FirstOrderRadioEnergyModelTestCase ();
+  ~FirstOrderRadioEnergyModelTestCase ();
+
+  void DoRun (void);
+
+  double m_tolerance; // tolerance for energy estimation
+};
+
+FirstOrderRadioEnergyModelTestCase::FirstOrderRadioEnergyModelTestCase ()
+  : TestCase ("First order radio energy model test case")
+{
+  m_tolerance = 1.0e-15;
+}
+
+FirstOrderRadioEnergyModelTestCase::~FirstOrderRadioEnergyModelTestCase ()
+{
+}
+
+void
+FirstOrderRadioEnergyModelTestCase::DoRun ()
+{
+  double elec = 50e-9;
+  double fs = 10e-12;
+  double mp = 0.0013e-12;
+
+  Ptr<Node> node = CreateObject<Node> ();
+  Ptr<BasicEnergySource> source = CreateObject<BasicEnergySource> ();
+  source->SetInitialEnergy (1.0);
+  source->SetNode (node);
+  node->AggregateObject (source);
+
+  Ptr<FirstOrderRadioEnergyModel> model = CreateObject<FirstOrderRadioEnergyModel> ();
+  model->SetAttribute ("ElectronicsEnergy", DoubleValue (elec));
+  model->SetAttribute ("FreeSpaceAmplifierEnergy", DoubleValue (fs));
+  model->SetAttribute ("MultipathAmplifierEnergy", DoubleValue (mp));
+  source->AppendDeviceEnergyModel (model);
+  model->SetEnergySource (source);
+
+  double d0 = model->GetCrossoverDistance ();
+  NS_TEST_ASSERT_MSG_EQ_TOL (d0, std::sqrt (fs / mp), 1e-9, "Wrong crossover distance");
+
+  // free space below the crossover distance, multipath fading above it
+  uint32_t bits = 4000;
+  double near = 0.5 * d0;
+  double far = 2 * d0;
+  NS_TEST_ASSERT_MSG_EQ_TOL (model->GetTxEnergy (bits, near),
+                             elec * bits + fs * bits * near * near,
+                             m_tolerance, "Wrong free space transmit energy");
+  NS_TEST_ASSERT_MSG_EQ_TOL (model->GetTxEnergy (bits, far),
+                             elec * bits + mp * bits * far * far * far * far,
+                             m_tolerance, "Wrong multipath transmit energy");
+  NS_TEST_ASSERT_MSG_EQ_TOL (model->GetRxEnergy (bits), elec * bits,
+                             m_tolerance, "Wrong receive energy");
+
+  // a tagged packet is charged for its distance, an untagged one for 0 m
+  Ptr<Packet> tagged = Create<Packet> (500);
+  tagged->AddPacketTag (RadioDistanceTag (near));
+  Ptr<Packet> untagged = Create<Packet> (500);
+  model->NotifyTx (tagged);
+  model->NotifyTx (untagged);
+  model->NotifyRx (untagged);
+
+  double expected = model->GetTxEnergy (bits, near) + model->GetTxEnergy (bits, 0)
+    + model->GetRxEnergy (bits);
+  NS_TEST_ASSERT_MSG_EQ_TOL (model->GetTotalEnergyConsumption (), expected,
+                             m_tolerance, "Wrong total energy consumption");
+  NS_TEST_ASSERT_MSG_EQ_TOL (source->GetRemainingEnergy (), 1.0 - expected,
+                             m_tolerance, "Energy not removed from the source");
+
+  Simulator::Destroy ();
+}
+
+class FirstOrderRadioEnergyModelTestSuite : public TestSuite
+{
+public:
+  FirstOrderRadioEnergyModelTestSuite ();
+};
+
+FirstOrderRadioEnergyModelTestSuite::FirstOrderRadioEnergyModelTestSuite ()
+  : TestSuite ("first-order-radio-energy-model", UNIT)
+{
+  AddTestCase (new FirstOrderRadioEnergyModelTestCase, TestCase::QUICK);
+}
+
+// create an instance of the test suite
+static FirstOrderRadioEnergyModelTestSuite g_firstOrderRadioEnergyModelTestSuite;
@@ -29,6 +29,7 @@
 #include "ns3/config.h"
 #include "ns3/simulator.h"
 #include "ns3/string.h"
+#include "ns3/boolean.h"
 #include "ns3/net-device.h"
 #include "ns3/callback.h"
 #include "ns3/node.h"
@@ -107,7 +108,10 @@ InternetStackHelper::InternetStackHelper ()
     m_ipv4Enabled (true),
     m_ipv6Enabled (true),
     m_ipv4ArpJitterEnabled (true),
-    m_ipv6NsRsJitterEnabled (true)
+    m_ipv6NsRsJitterEnabled (true),
+    m_icmpv4Enabled (true),
+    m_tcpEnabled (true),
+    m_staticArpEnabled (false)
 
 {
   Initialize ();
@@ -143,6 +147,9 @@ InternetStackHelper::InternetStackHelper (const InternetStackHelper &o)
   m_tcpFactory = o.m_tcpFactory;
   m_ipv4ArpJitterEnabled = o.m_ipv4ArpJitterEnabled;
   m_ipv6NsRsJitterEnabled = o.m_ipv6NsRsJitterEnabled;
+  m_icmpv4Enabled = o.m_icmpv4Enabled;
+  m_tcpEnabled = o.m_tcpEnabled;
+  m_staticArpEnabled = o.m_staticArpEnabled;
 }
 
 InternetStackHelper &
@@ -168,6 +175,9 @@ InternetStackHelper::Reset (void)
   m_ipv6Enabled = true;
   m_ipv4ArpJitterEnabled = true;
   m_ipv6NsRsJitterEnabled = true;
+  m_icmpv4Enabled = true;
+  m_tcpEnabled = true;
+  m_staticArpEnabled = false;
   Initialize ();
 }
 
@@ -206,6 +216,21 @@ void InternetStackHelper::SetIpv6NsRsJitter (bool enable)
   m_ipv6NsRsJitterEnabled = enable;
 }
 
+void InternetStackHelper::SetIcmpv4Install (bool enable)
+{
+  m_icmpv4Enabled = enable;
+}
+
+void InternetStackHelper::SetTcpInstall (bool enable)
+{
+  m_tcpEnabled = enable;
+}
+
+void InternetStackHelper::SetStaticArp (bool enable)
+{
+  m_staticArpEnabled = enable;
+}
+
 int64_t
 InternetStackHelper::AssignStreams (NodeContainer c, int64_t stream)
 {
@@ -302,13 +327,22 @@ InternetStackHelper::Install (Ptr<Node> node) const
 
       CreateAndAggregateObjectFromTypeId (node, "ns3::ArpL3Protocol");
       CreateAndAggregateObjectFromTypeId (node, "ns3::Ipv4L3Protocol");
-      CreateAndAggregateObjectFromTypeId (node, "ns3::Icmpv4L4Protocol");
+      if (m_icmpv4Enabled)
+        {
+          CreateAndAggregateObjectFromTypeId (node, "ns3::Icmpv4L4Protocol");
+        }
       if (m_ipv4ArpJitterEnabled == false)
         {
           Ptr<ArpL3Protocol> arp = node->GetObject<ArpL3Protocol> ();
           NS_ASSERT (arp);
           arp->SetAttribute ("RequestJitter", StringValue ("ns3::ConstantRandomVariable[Constant=0.0]"));
         }
+      if (m_staticArpEnabled)
+        {
+          Ptr<ArpL3Protocol> arp = node->GetObject<ArpL3Protocol> ();
+          NS_ASSERT (arp);
+          arp->SetAttribute ("StaticResolution", BooleanValue (true));
+        }
       // Set routing
       Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
       Ptr<Ipv4RoutingProtocol> ipv4Routing = m_routing->Create (node);
@@ -347,7 +381,10 @@ InternetStackHelper::Install (Ptr<Node> node) const
     {
       CreateAndAggregateObjectFromTypeId (node, "ns3::TrafficControlLayer");
       CreateAndAggregateObjectFromTypeId (node, "ns3::UdpL4Protocol");
-      node->AggregateObject (m_tcpFactory.Create<Object> ());
+      if (m_tcpEnabled)
+        {
+          node->AggregateObject (m_tcpFactory.Create<Object> ());
+        }
       Ptr<PacketSocketFactory> factory = CreateObject<PacketSocketFactory> ();
       node->AggregateObject (factory);
     }
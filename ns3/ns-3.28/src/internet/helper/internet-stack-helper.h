@@ -82,6 +82,21 @@ class Ipv6RoutingHelper;
  *  - a PacketSocketFactory
  *  - Ipv4 routing (a list routing object, a global routing object, and a static routing object)
  *  - Ipv6 routing (a static routing object)
+ *
+ * For large networks of sensor nodes, a slim stack of IPv4 and UDP only
+ * can be installed, with static ARP and no queue discs:
+ *
+ * \code
+ *   InternetStackHelper stack;
+ *   stack.SetIpv6StackInstall (false);
+ *   stack.SetIcmpv4Install (false);
+ *   stack.SetTcpInstall (false);
+ *   stack.SetStaticArp (true);
+ *   stack.Install (nodes);
+ *   Ipv4AddressHelper address ("10.1.0.0", "255.255.0.0");
+ *   address.SetQueueDiscInstall (false);
+ *   address.Assign (devices);
+ * \endcode
  */
 class InternetStackHelper : public PcapHelperForIpv4, public PcapHelperForIpv6, 
                             public AsciiTraceHelperForIpv4, public AsciiTraceHelperForIpv6
@@ -223,6 +238,33 @@ public:
    */
   void SetIpv6NsRsJitter (bool enable);
 
+  /**
+   * \brief Enable/disable ICMPv4 install.
+   *
+   * Without ICMPv4, no error messages are sent back for the IPv4
+   * packets dropped.
+   *
+   * \param enable enable state
+   */
+  void SetIcmpv4Install (bool enable);
+
+  /**
+   * \brief Enable/disable TCP install.
+   * \param enable enable state
+   */
+  void SetTcpInstall (bool enable);
+
+  /**
+   * \brief Enable/disable static ARP.
+   *
+   * With static ARP, the addresses are resolved from the IPv4 interfaces
+   * of the other devices on the channel instead of ARP requests (see the
+   * ArpL3Protocol::StaticResolution attribute).
+   *
+   * \param enable enable state
+   */
+  void SetStaticArp (bool enable);
+
   /**
   * Assign a fixed random variable stream number to the random variables
   * used by this model.  Return the number of streams (possibly zero) that
@@ -369,6 +411,21 @@ private:
    * \brief IPv6 IPv6 NS and RS Jitter state (enabled/disabled) ?
    */
   bool m_ipv6NsRsJitterEnabled;
+
+  /**
+   * \brief ICMPv4 install state (enabled/disabled) ?
+   */
+  bool m_icmpv4Enabled;
+
+  /**
+   * \brief TCP install state (enabled/disabled) ?
+   */
+  bool m_tcpEnabled;
+
+  /**
+   * \brief Static ARP state (enabled/disabled) ?
+   */
+  bool m_staticArpEnabled;
 };
 
 } // namespace ns3
@@ -34,6 +34,7 @@ namespace ns3 {
 NS_LOG_COMPONENT_DEFINE ("Ipv4AddressHelper");
 
 Ipv4AddressHelper::Ipv4AddressHelper () 
+  : m_queueDiscs (true)
 {
   NS_LOG_FUNCTION_NOARGS ();
 
@@ -54,6 +55,7 @@ Ipv4AddressHelper::Ipv4AddressHelper (
   const Ipv4Address network, 
   const Ipv4Mask    mask,
   const Ipv4Address address)
+  : m_queueDiscs (true)
 {
   NS_LOG_FUNCTION_NOARGS ();
   SetBase (network, mask, address);
@@ -165,7 +167,7 @@ Ipv4AddressHelper::Assign (const NetDeviceContainer &c)
       // control layer has been aggregated, if this is not 
       // a loopback interface, and there is no queue disc installed already
       Ptr<TrafficControlLayer> tc = node->GetObject<TrafficControlLayer> ();
-      if (tc && DynamicCast<LoopbackNetDevice> (device) == 0 && tc->GetRootQueueDiscOnDevice (device) == 0)
+      if (m_queueDiscs && tc && DynamicCast<LoopbackNetDevice> (device) == 0 && tc->GetRootQueueDiscOnDevice (device) == 0)
         {
           NS_LOG_LOGIC ("Installing default traffic control configuration");
           TrafficControlHelper tcHelper = TrafficControlHelper::Default ();
@@ -175,6 +177,13 @@ Ipv4AddressHelper::Assign (const NetDeviceContainer &c)
   return retval;
 }
 
+void
+Ipv4AddressHelper::SetQueueDiscInstall (bool enable)
+{
+  NS_LOG_FUNCTION (this << enable);
+  m_queueDiscs = enable;
+}
+
 const uint32_t N_BITS = 32; //!< number of bits in a IPv4 address
 
 uint32_t
@@ -180,6 +180,18 @@ public:
  */
   Ipv4InterfaceContainer Assign (const NetDeviceContainer &c);
 
+/**
+ * @brief Enable/disable the install of the default queue disc.
+ *
+ * By default, Assign installs the default traffic control configuration
+ * on the net devices which have no queue disc yet.  Without it, the
+ * packets are handed to the net devices directly, which saves the memory
+ * of the queue discs on large networks.
+ *
+ * @param enable enable state
+ */
+  void SetQueueDiscInstall (bool enable);
+
 private:
   /**
    * \brief Returns the number of address bits (hostpart) for a given netmask
@@ -194,6 +206,7 @@ private:
   uint32_t m_base;    //!< base address
   uint32_t m_shift;   //!< shift, equivalent to the number of bits in the hostpart
   uint32_t m_max;     //!< maximum allowed address
+  bool m_queueDiscs;  //!< install the default queue disc
 };
 
 } // namespace ns3
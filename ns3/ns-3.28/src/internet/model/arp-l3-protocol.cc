@@ -17,6 +17,8 @@
  *
  * Author: Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
  */
+#include <map>
+#include <mutex>
 #include "ns3/packet.h"
 #include "ns3/log.h"
 #include "ns3/node.h"
@@ -25,6 +27,9 @@
 #include "ns3/trace-source-accessor.h"
 #include "ns3/pointer.h"
 #include "ns3/string.h"
+#include "ns3/boolean.h"
+#include "ns3/channel.h"
+#include "ns3/simulator.h"
 
 #include "ipv4-l3-protocol.h"
 #include "arp-l3-protocol.h"
@@ -40,6 +45,46 @@ const uint16_t ArpL3Protocol::PROT_NUMBER = 0x0806;
 
 NS_OBJECT_ENSURE_REGISTERED (ArpL3Protocol);
 
+/**
+ * \ingroup arp
+ * The MAC address of each IPv4 address on a channel, for the static
+ * resolution of ArpL3Protocol.
+ */
+struct StaticArpTable
+{
+  StaticArpTable () : valid (false), addressChanges (0), devices (0) {}
+
+  std::map<Ipv4Address, Address> addresses; //!< The MAC address of each IPv4 address
+  bool valid;                               //!< Whether the addresses were collected
+  uint32_t addressChanges;                  //!< Ipv4Interface::GetAddressChanges() when collected
+  uint32_t devices;                         //!< The number of devices on the channel when collected
+};
+
+/**
+ * \ingroup arp
+ * The static ARP tables, by channel, shared by all the ArpL3Protocol
+ * instances and cleared by Simulator::Destroy.
+ */
+static std::map<Ptr<Channel>, StaticArpTable> g_staticArpTables;
+
+/**
+ * \ingroup arp
+ * The mutex of g_staticArpTables, which the threads of
+ * MultithreadedSimulatorImpl share.
+ */
+static std::mutex g_staticArpTablesMutex;
+
+/**
+ * \ingroup arp
+ * Clear the static ARP tables.
+ */
+static void
+ClearStaticArpTables (void)
+{
+  std::lock_guard<std::mutex> lock (g_staticArpTablesMutex);
+  g_staticArpTables.clear ();
+}
+
 TypeId 
 ArpL3Protocol::GetTypeId (void)
 {
@@ -61,6 +106,13 @@ ArpL3Protocol::GetTypeId (void)
                    StringValue ("ns3::UniformRandomVariable[Min=0.0|Max=10.0]"),
                    MakePointerAccessor (&ArpL3Protocol::m_requestJitter),
                    MakePointerChecker<RandomVariableStream> ())
+    .AddAttribute ("StaticResolution",
+                   "Resolve the addresses from the IPv4 interfaces of the "
+                   "other devices on the channel, into permanent entries, "
+                   "instead of sending ARP requests.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&ArpL3Protocol::m_staticResolution),
+                   MakeBooleanChecker ())
     .AddTraceSource ("Drop",
                      "Packet dropped because not enough room "
                      "in pending queue for a specific cache entry.",
@@ -71,6 +123,7 @@ ArpL3Protocol::GetTypeId (void)
 }
 
 ArpL3Protocol::ArpL3Protocol ()
+  : m_staticResolution (false)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -341,6 +394,15 @@ ArpL3Protocol::Lookup (Ptr<Packet> packet, const Ipv4Header & ipHeader, Ipv4Addr
   else
     {
       // This is our first attempt to transmit data to this destination.
+      if (m_staticResolution && ResolveStatically (device, destination, hardwareDestination))
+        {
+          NS_LOG_LOGIC ("node="<<m_node->GetId ()<<
+                        ", no entry for " << destination << " -- resolved statically");
+          entry = cache->Add (destination);
+          entry->SetMacAddress (*hardwareDestination);
+          entry->MarkPermanent ();
+          return true;
+        }
       NS_LOG_LOGIC ("node="<<m_node->GetId ()<<
                     ", no entry for " << destination << " -- send arp request");
       entry = cache->Add (destination);
@@ -350,6 +412,60 @@ ArpL3Protocol::Lookup (Ptr<Packet> packet, const Ipv4Header & ipHeader, Ipv4Addr
   return false;
 }
 
+bool
+ArpL3Protocol::ResolveStatically (Ptr<NetDevice> device, Ipv4Address destination,
+                                  Address *hardwareDestination) const
+{
+  NS_LOG_FUNCTION (this << device << destination);
+  Ptr<Channel> channel = device->GetChannel ();
+  if (channel == 0)
+    {
+      return false;
+    }
+  std::lock_guard<std::mutex> lock (g_staticArpTablesMutex);
+  if (g_staticArpTables.empty ())
+    {
+      Simulator::ScheduleDestroy (&ClearStaticArpTables);
+    }
+  StaticArpTable &table = g_staticArpTables[channel];
+  // Collect the addresses again only when an address was added or
+  // removed, or a device attached to the channel, since the last time:
+  // the unknown addresses stay unknown until then.
+  uint32_t addressChanges = Ipv4Interface::GetAddressChanges ();
+  if (!table.valid || table.addressChanges != addressChanges || table.devices != channel->GetNDevices ())
+    {
+      table.addresses.clear ();
+      table.valid = true;
+      table.addressChanges = addressChanges;
+      table.devices = channel->GetNDevices ();
+      for (uint32_t i = 0; i < channel->GetNDevices (); ++i)
+        {
+          Ptr<NetDevice> peer = channel->GetDevice (i);
+          Ptr<Ipv4L3Protocol> ipv4 = peer->GetNode ()->GetObject<Ipv4L3Protocol> ();
+          if (ipv4 == 0)
+            {
+              continue;
+            }
+          int32_t interface = ipv4->GetInterfaceForDevice (peer);
+          if (interface < 0)
+            {
+              continue;
+            }
+          for (uint32_t j = 0; j < ipv4->GetNAddresses (interface); ++j)
+            {
+              table.addresses[ipv4->GetAddress (interface, j).GetLocal ()] = peer->GetAddress ();
+            }
+        }
+    }
+  std::map<Ipv4Address, Address>::const_iterator it = table.addresses.find (destination);
+  if (it == table.addresses.end ())
+    {
+      return false;
+    }
+  *hardwareDestination = it->second;
+  return true;
+}
+
 void
 ArpL3Protocol::SendArpRequest (Ptr<const ArpCache> cache, Ipv4Address to)
 {
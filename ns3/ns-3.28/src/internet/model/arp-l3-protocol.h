@@ -144,6 +144,17 @@ private:
    */
   Ptr<ArpCache> FindCache (Ptr<NetDevice> device);
 
+  /**
+   * \brief Resolve an address from the IPv4 interfaces of the devices on
+   * the channel, for the StaticResolution attribute
+   * \param device the outgoing device
+   * \param destination the destination IP address
+   * \param hardwareDestination filled with the destination MAC address, if found
+   * \return true if the address was resolved
+   */
+  bool ResolveStatically (Ptr<NetDevice> device, Ipv4Address destination,
+                          Address *hardwareDestination) const;
+
   /**
    * \brief Send an ARP request to an host
    * \param cache the ARP cache to use
@@ -163,6 +174,7 @@ private:
   Ptr<Node> m_node; //!< node the ARP L3 protocol is associated with
   TracedCallback<Ptr<const Packet> > m_dropTrace; //!< trace for packets dropped by ARP
   Ptr<RandomVariableStream> m_requestJitter; //!< jitter to de-sync ARP requests
+  bool m_staticResolution; //!< resolve the addresses without ARP requests
 
 };
 
@@ -30,6 +30,7 @@
 #include "ns3/node.h"
 #include "ns3/pointer.h"
 #include "ns3/traffic-control-layer.h"
+#include <atomic>
 
 
 namespace ns3 {
@@ -38,6 +39,13 @@ NS_LOG_COMPONENT_DEFINE ("Ipv4Interface");
 
 NS_OBJECT_ENSURE_REGISTERED (Ipv4Interface);
 
+/**
+ * \ingroup ipv4
+ * The number of addresses added to or removed from all the interfaces,
+ * which the threads of MultithreadedSimulatorImpl share.
+ */
+static std::atomic<uint32_t> g_addressChanges (0);
+
 TypeId 
 Ipv4Interface::GetTypeId (void)
 {
@@ -310,6 +318,7 @@ Ipv4Interface::AddAddress (Ipv4InterfaceAddress addr)
 {
   NS_LOG_FUNCTION (this << addr);
   m_ifaddrs.push_back (addr);
+  g_addressChanges++;
   return true;
 }
 
@@ -353,6 +362,7 @@ Ipv4Interface::RemoveAddress (uint32_t index)
         {
           Ipv4InterfaceAddress addr = *i;
           m_ifaddrs.erase (i);
+          g_addressChanges++;
           return addr;
         }
       ++tmp;
@@ -380,11 +390,18 @@ Ipv4Interface::RemoveAddress(Ipv4Address address)
         {
           Ipv4InterfaceAddress ifAddr = *it;
           m_ifaddrs.erase(it);
+          g_addressChanges++;
           return ifAddr;
         }
     }
   return Ipv4InterfaceAddress();
 }
 
+uint32_t
+Ipv4Interface::GetAddressChanges (void)
+{
+  return g_addressChanges;
+}
+
 } // namespace ns3
 
@@ -188,6 +188,12 @@ public:
    */
   Ipv4InterfaceAddress RemoveAddress (Ipv4Address address);
 
+  /**
+   * \returns the number of addresses added to or removed from all the
+   * interfaces so far, for the callers caching the addresses
+   */
+  static uint32_t GetAddressChanges (void);
+
 protected:
   virtual void DoDispose (void);
 private:
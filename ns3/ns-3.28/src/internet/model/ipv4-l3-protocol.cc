@@ -562,7 +562,10 @@ Ipv4L3Protocol::Receive ( Ptr<NetDevice> device, Ptr<const Packet> p, uint16_t p
 
   if (ipv4Interface->IsUp ())
     {
-      m_rxTrace (packet, m_node->GetObject<Ipv4> (), interface);
+      if (!m_rxTrace.IsEmpty ())
+        {
+          m_rxTrace (packet, m_node->GetObject<Ipv4> (), interface);
+        }
     }
   else
     {
@@ -709,11 +712,15 @@ Ipv4L3Protocol::SendWithHeader (Ptr<Packet> packet,
 
 void
 Ipv4L3Protocol::CallTxTrace (const Ipv4Header & ipHeader, Ptr<Packet> packet,
-                                    Ptr<Ipv4> ipv4, uint32_t interface)
+                                    uint32_t interface)
 {
+  if (m_txTrace.IsEmpty ())
+    {
+      return;
+    }
   Ptr<Packet> packetCopy = packet->Copy ();
   packetCopy->AddHeader (ipHeader);
-  m_txTrace (packetCopy, ipv4, interface);
+  m_txTrace (packetCopy, m_node->GetObject<Ipv4> (), interface);
 }
 
 void 
@@ -779,7 +786,7 @@ Ipv4L3Protocol::Send (Ptr<Packet> packet,
               NS_ASSERT (packetCopy->GetSize () <= outInterface->GetDevice ()->GetMtu ());
 
               m_sendOutgoingTrace (ipHeader, packetCopy, ifaceIndex);
-              CallTxTrace (ipHeader, packetCopy, m_node->GetObject<Ipv4> (), ifaceIndex);
+              CallTxTrace (ipHeader, packetCopy, ifaceIndex);
               outInterface->Send (packetCopy, ipHeader, destination);
             }
         }
@@ -803,7 +810,7 @@ Ipv4L3Protocol::Send (Ptr<Packet> packet,
               ipHeader = BuildHeader (source, destination, protocol, packet->GetSize (), ttl, tos, mayFragment);
               Ptr<Packet> packetCopy = packet->Copy ();
               m_sendOutgoingTrace (ipHeader, packetCopy, ifaceIndex);
-              CallTxTrace (ipHeader, packetCopy, m_node->GetObject<Ipv4> (), ifaceIndex);
+              CallTxTrace (ipHeader, packetCopy, ifaceIndex);
               outInterface->Send (packetCopy, ipHeader, destination);
               return;
             }
@@ -936,13 +943,13 @@ Ipv4L3Protocol::SendRealOut (Ptr<Ipv4Route> route,
               DoFragmentation (packet, ipHeader, outInterface->GetDevice ()->GetMtu (), listFragments);
               for ( std::list<Ipv4PayloadHeaderPair>::iterator it = listFragments.begin (); it != listFragments.end (); it++ )
                 {
-                  CallTxTrace (it->second, it->first, m_node->GetObject<Ipv4> (), interface);
+                  CallTxTrace (it->second, it->first, interface);
                   outInterface->Send (it->first, it->second, route->GetGateway ());
                 }
             }
           else
             {
-              CallTxTrace (ipHeader, packet, m_node->GetObject<Ipv4> (), interface);
+              CallTxTrace (ipHeader, packet, interface);
               outInterface->Send (packet, ipHeader, route->GetGateway ());
             }
         }
@@ -964,13 +971,13 @@ Ipv4L3Protocol::SendRealOut (Ptr<Ipv4Route> route,
               for ( std::list<Ipv4PayloadHeaderPair>::iterator it = listFragments.begin (); it != listFragments.end (); it++ )
                 {
                   NS_LOG_LOGIC ("Sending fragment " << *(it->first) );
-                  CallTxTrace (it->second, it->first, m_node->GetObject<Ipv4> (), interface);
+                  CallTxTrace (it->second, it->first, interface);
                   outInterface->Send (it->first, it->second, ipHeader.GetDestination ());
                 }
             }
           else
             {
-              CallTxTrace (ipHeader, packet, m_node->GetObject<Ipv4> (), interface);
+              CallTxTrace (ipHeader, packet, interface);
               outInterface->Send (packet, ipHeader, ipHeader.GetDestination ());
             }
         }
@@ -1036,7 +1043,10 @@ Ipv4L3Protocol::IpForward (Ptr<Ipv4Route> rtentry, Ptr<const Packet> p, const Ip
           ipHeader.GetDestination ().IsMulticast () == false)
         {
           Ptr<Icmpv4L4Protocol> icmp = GetIcmp ();
-          icmp->SendTimeExceededTtl (ipHeader, packet, false);
+          if (icmp != 0)
+            {
+              icmp->SendTimeExceededTtl (ipHeader, packet, false);
+            }
         }
       NS_LOG_WARN ("TTL exceeded.  Drop.");
       m_dropTrace (header, packet, DROP_TTL_EXPIRED, m_node->GetObject<Ipv4> (), interface);
@@ -1112,9 +1122,10 @@ Ipv4L3Protocol::LocalDeliver (Ptr<const Packet> packet, Ipv4Header const&ip, uin
                   subnetDirected = true;
                 }
             }
-          if (subnetDirected == false)
+          Ptr<Icmpv4L4Protocol> icmp = GetIcmp ();
+          if (subnetDirected == false && icmp != 0)
             {
-              GetIcmp ()->SendDestUnreachPort (ipHeader, copy);
+              icmp->SendDestUnreachPort (ipHeader, copy);
             }
         }
     }
@@ -1686,9 +1697,9 @@ Ipv4L3Protocol::HandleFragmentsTimeout (std::pair<uint64_t, uint32_t> key, Ipv4H
   Ptr<Packet> packet = it->second->GetPartialPacket ();
 
   // if we have at least 8 bytes, we can send an ICMP.
-  if ( packet->GetSize () > 8 )
+  Ptr<Icmpv4L4Protocol> icmp = GetIcmp ();
+  if ( packet->GetSize () > 8 && icmp != 0)
     {
-      Ptr<Icmpv4L4Protocol> icmp = GetIcmp ();
       icmp->SendTimeExceededTtl (ipHeader, packet, true);
     }
   m_dropTrace (ipHeader, packet, DROP_FRAGMENT_TIMEOUT, m_node->GetObject<Ipv4> (), iif);
@@ -424,15 +424,14 @@ private:
 
   /**
    * \brief Make a copy of the packet, add the header and invoke the TX trace callback
+   *
+   * This does nothing if no callback is connected to the TX trace.
+   *
    * \param ipHeader the IP header that will be added to the packet
    * \param packet the packet
-   * \param ipv4 the Ipv4 protocol
    * \param interface the interface index
-   *
-   * Note: If the TracedCallback API ever is extended, we could consider
-   * to check for connected functions before adding the header
    */
-  void CallTxTrace (const Ipv4Header & ipHeader, Ptr<Packet> packet, Ptr<Ipv4> ipv4, uint32_t interface);
+  void CallTxTrace (const Ipv4Header & ipHeader, Ptr<Packet> packet, uint32_t interface);
 
   /**
    * \brief Container of the IPv4 Interfaces.
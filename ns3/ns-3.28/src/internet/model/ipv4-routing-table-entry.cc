@@ -20,6 +20,7 @@
 
 #include "ipv4-routing-table-entry.h"
 #include "ns3/assert.h"
+#include "ns3/memory-accounting.h"
 #include "ns3/log.h"
 
 namespace ns3 {
@@ -53,6 +54,29 @@ Ipv4RoutingTableEntry::Ipv4RoutingTableEntry (Ipv4RoutingTableEntry const *route
   NS_LOG_FUNCTION (this << route);
 }
 
+/**
+ * \ingroup ipv4Routing
+ * \returns The index of the Ipv4RoutingTableEntry in MemoryAccounting.
+ */
+static uint32_t
+GetIpv4AccountingIndex (void)
+{
+  static uint32_t index = MemoryAccounting::Register ("ns3::Ipv4RoutingTableEntry");
+  return index;
+}
+
+void *
+Ipv4RoutingTableEntry::operator new (std::size_t size)
+{
+  return MemoryAccounting::New (GetIpv4AccountingIndex (), size);
+}
+
+void
+Ipv4RoutingTableEntry::operator delete (void *p, std::size_t size)
+{
+  MemoryAccounting::Delete (p, GetIpv4AccountingIndex (), size);
+}
+
 Ipv4RoutingTableEntry::Ipv4RoutingTableEntry (Ipv4Address dest,
                                               Ipv4Address gateway,
                                               uint32_t interface)
@@ -292,6 +316,29 @@ Ipv4MulticastRoutingTableEntry::Ipv4MulticastRoutingTableEntry (Ipv4MulticastRou
   NS_LOG_FUNCTION (this << route);
 }
 
+/**
+ * \ingroup ipv4Routing
+ * \returns The index of the Ipv4MulticastRoutingTableEntry in MemoryAccounting.
+ */
+static uint32_t
+GetIpv4MulticastAccountingIndex (void)
+{
+  static uint32_t index = MemoryAccounting::Register ("ns3::Ipv4MulticastRoutingTableEntry");
+  return index;
+}
+
+void *
+Ipv4MulticastRoutingTableEntry::operator new (std::size_t size)
+{
+  return MemoryAccounting::New (GetIpv4MulticastAccountingIndex (), size);
+}
+
+void
+Ipv4MulticastRoutingTableEntry::operator delete (void *p, std::size_t size)
+{
+  MemoryAccounting::Delete (p, GetIpv4MulticastAccountingIndex (), size);
+}
+
 Ipv4MulticastRoutingTableEntry::Ipv4MulticastRoutingTableEntry (
   Ipv4Address origin, 
   Ipv4Address group, 
@@ -50,6 +50,21 @@ public:
    * \param route The route to copy
    */
   Ipv4RoutingTableEntry (Ipv4RoutingTableEntry const *route);
+  /**
+   * Allocate an entry, counted as "ns3::Ipv4RoutingTableEntry"
+   * by MemoryAccounting.
+   *
+   * \param [in] size The size of the entry, in bytes.
+   * \returns Storage for the entry.
+   */
+  static void * operator new (std::size_t size);
+  /**
+   * Release the storage of an entry.
+   *
+   * \param [in] p The storage to release.
+   * \param [in] size The size of the entry, in bytes.
+   */
+  static void operator delete (void *p, std::size_t size);
   /**
    * \return True if this route is a host route (mask of all ones); false otherwise
    */
@@ -218,6 +233,21 @@ public:
    * \param route The route to copy
    */
   Ipv4MulticastRoutingTableEntry (Ipv4MulticastRoutingTableEntry const *route);
+  /**
+   * Allocate an entry, counted as "ns3::Ipv4MulticastRoutingTableEntry"
+   * by MemoryAccounting.
+   *
+   * \param [in] size The size of the entry, in bytes.
+   * \returns Storage for the entry.
+   */
+  static void * operator new (std::size_t size);
+  /**
+   * Release the storage of an entry.
+   *
+   * \param [in] p The storage to release.
+   * \param [in] size The size of the entry, in bytes.
+   */
+  static void operator delete (void *p, std::size_t size);
   /**
    * \return The IPv4 address of the source of this route
    */
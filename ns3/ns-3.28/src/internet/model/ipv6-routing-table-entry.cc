@@ -19,6 +19,7 @@
  */
 
 #include "ns3/assert.h"
+#include "ns3/memory-accounting.h"
 
 #include "ipv6-routing-table-entry.h"
 
@@ -47,6 +48,29 @@ Ipv6RoutingTableEntry::Ipv6RoutingTableEntry (Ipv6RoutingTableEntry const* route
 {
 }
 
+/**
+ * \ingroup ipv6Routing
+ * \returns The index of the Ipv6RoutingTableEntry in MemoryAccounting.
+ */
+static uint32_t
+GetIpv6AccountingIndex (void)
+{
+  static uint32_t index = MemoryAccounting::Register ("ns3::Ipv6RoutingTableEntry");
+  return index;
+}
+
+void *
+Ipv6RoutingTableEntry::operator new (std::size_t size)
+{
+  return MemoryAccounting::New (GetIpv6AccountingIndex (), size);
+}
+
+void
+Ipv6RoutingTableEntry::operator delete (void *p, std::size_t size)
+{
+  MemoryAccounting::Delete (p, GetIpv6AccountingIndex (), size);
+}
+
 Ipv6RoutingTableEntry::Ipv6RoutingTableEntry (Ipv6Address dest, Ipv6Address gateway, uint32_t interface)
   : m_dest (dest),
     m_destNetworkPrefix (Ipv6Prefix::GetZero ()),
@@ -267,6 +291,29 @@ Ipv6MulticastRoutingTableEntry::Ipv6MulticastRoutingTableEntry (Ipv6MulticastRou
 {
 }
 
+/**
+ * \ingroup ipv6Routing
+ * \returns The index of the Ipv6MulticastRoutingTableEntry in MemoryAccounting.
+ */
+static uint32_t
+GetIpv6MulticastAccountingIndex (void)
+{
+  static uint32_t index = MemoryAccounting::Register ("ns3::Ipv6MulticastRoutingTableEntry");
+  return index;
+}
+
+void *
+Ipv6MulticastRoutingTableEntry::operator new (std::size_t size)
+{
+  return MemoryAccounting::New (GetIpv6MulticastAccountingIndex (), size);
+}
+
+void
+Ipv6MulticastRoutingTableEntry::operator delete (void *p, std::size_t size)
+{
+  MemoryAccounting::Delete (p, GetIpv6MulticastAccountingIndex (), size);
+}
+
 Ipv6MulticastRoutingTableEntry::Ipv6MulticastRoutingTableEntry (Ipv6Address origin, Ipv6Address group, uint32_t inputInterface, std::vector<uint32_t> outputInterfaces)
   : m_origin (origin),
     m_group (group),
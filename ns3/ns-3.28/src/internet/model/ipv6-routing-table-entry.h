@@ -54,6 +54,21 @@ public:
    * \param route the route to copy
    */
   Ipv6RoutingTableEntry (Ipv6RoutingTableEntry const* route);
+  /**
+   * Allocate an entry, counted as "ns3::Ipv6RoutingTableEntry"
+   * by MemoryAccounting.
+   *
+   * \param [in] size The size of the entry, in bytes.
+   * \returns Storage for the entry.
+   */
+  static void * operator new (std::size_t size);
+  /**
+   * Release the storage of an entry.
+   *
+   * \param [in] p The storage to release.
+   * \param [in] size The size of the entry, in bytes.
+   */
+  static void operator delete (void *p, std::size_t size);
 
   /**
    * \brief Destructor
@@ -294,6 +309,21 @@ public:
    * \param route the route to copy
    */
   Ipv6MulticastRoutingTableEntry (Ipv6MulticastRoutingTableEntry const* route);
+  /**
+   * Allocate an entry, counted as "ns3::Ipv6MulticastRoutingTableEntry"
+   * by MemoryAccounting.
+   *
+   * \param [in] size The size of the entry, in bytes.
+   * \returns Storage for the entry.
+   */
+  static void * operator new (std::size_t size);
+  /**
+   * Release the storage of an entry.
+   *
+   * \param [in] p The storage to release.
+   * \param [in] size The size of the entry, in bytes.
+   */
+  static void operator delete (void *p, std::size_t size);
 
   /**
    * \brief Get the source of this route
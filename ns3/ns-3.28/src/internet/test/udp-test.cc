@@ -52,6 +52,10 @@
 #include "ns3/ipv6-list-routing.h"
 #include "ns3/ipv6-static-routing.h"
 #include "ns3/ipv6-address-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-interface.h"
+#include "ns3/arp-cache.h"
+#include "ns3/traffic-control-layer.h"
 
 #include <string>
 #include <limits>
@@ -708,6 +712,106 @@ Udp6SocketImplTest::DoRun (void)
 }
 
 
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief UDP over the slim IPv4 stack Test: no IPv6, ICMPv4, TCP nor
+ * queue discs, and static ARP.
+ */
+class UdpSocketSlimStackTest : public TestCase
+{
+public:
+  UdpSocketSlimStackTest ();
+  virtual void DoRun (void);
+
+  /**
+   * \brief Receive a packet.
+   * \param socket The receiving socket.
+   */
+  void ReceivePkt (Ptr<Socket> socket);
+
+  /**
+   * \brief Send data.
+   * \param socket The sending socket.
+   * \param to The destination address.
+   * \param port The destination port.
+   */
+  void DoSendDataTo (Ptr<Socket> socket, std::string to, uint16_t port);
+  Ptr<Packet> m_receivedPacket; //!< Received packet
+};
+
+UdpSocketSlimStackTest::UdpSocketSlimStackTest ()
+  : TestCase ("UDP over the slim IPv4 stack")
+{
+}
+
+void UdpSocketSlimStackTest::ReceivePkt (Ptr<Socket> socket)
+{
+  m_receivedPacket = socket->Recv (std::numeric_limits<uint32_t>::max (), 0);
+}
+
+void
+UdpSocketSlimStackTest::DoSendDataTo (Ptr<Socket> socket, std::string to, uint16_t port)
+{
+  Address realTo = InetSocketAddress (Ipv4Address (to.c_str ()), port);
+  NS_TEST_EXPECT_MSG_EQ (socket->SendTo (Create<Packet> (123), 0, realTo),
+                         123, "100");
+}
+
+void
+UdpSocketSlimStackTest::DoRun (void)
+{
+  NodeContainer nodes;
+  nodes.Create (3);
+
+  SimpleNetDeviceHelper helperChannel;
+  NetDeviceContainer devices = helperChannel.Install (nodes);
+
+  InternetStackHelper internet;
+  internet.SetIpv6StackInstall (false);
+  internet.SetIcmpv4Install (false);
+  internet.SetTcpInstall (false);
+  internet.SetStaticArp (true);
+  internet.Install (nodes);
+
+  Ipv4AddressHelper address ("10.0.0.0", "255.255.255.0");
+  address.SetQueueDiscInstall (false);
+  address.Assign (devices);
+
+  Ptr<Node> txNode = nodes.Get (0);
+  NS_TEST_EXPECT_MSG_EQ (txNode->GetObject<Ipv6> (), 0, "IPv6 should not be installed");
+  NS_TEST_EXPECT_MSG_EQ (txNode->GetObject<Icmpv4L4Protocol> (), 0, "ICMPv4 should not be installed");
+  NS_TEST_EXPECT_MSG_EQ (txNode->GetObject<TcpL4Protocol> (), 0, "TCP should not be installed");
+  NS_TEST_EXPECT_MSG_NE (txNode->GetObject<UdpL4Protocol> (), 0, "UDP should be installed");
+  Ptr<TrafficControlLayer> tc = txNode->GetObject<TrafficControlLayer> ();
+  NS_TEST_EXPECT_MSG_EQ (tc->GetRootQueueDiscOnDevice (devices.Get (0)), 0, "no queue disc should be installed");
+
+  Ptr<Socket> rxSocket = nodes.Get (2)->GetObject<UdpSocketFactory> ()->CreateSocket ();
+  NS_TEST_EXPECT_MSG_EQ (rxSocket->Bind (InetSocketAddress (Ipv4Address::GetAny (), 1234)), 0, "trivial");
+  rxSocket->SetRecvCallback (MakeCallback (&UdpSocketSlimStackTest::ReceivePkt, this));
+
+  Ptr<Socket> txSocket = txNode->GetObject<UdpSocketFactory> ()->CreateSocket ();
+  Simulator::ScheduleWithContext (txNode->GetId (), Seconds (0),
+                                  &UdpSocketSlimStackTest::DoSendDataTo, this, txSocket, "10.0.0.3", 1234);
+  // Without ICMPv4, a packet to a closed port is dropped silently
+  Simulator::ScheduleWithContext (txNode->GetId (), Seconds (1),
+                                  &UdpSocketSlimStackTest::DoSendDataTo, this, txSocket, "10.0.0.2", 4321);
+  Simulator::Run ();
+
+  NS_TEST_EXPECT_MSG_NE (m_receivedPacket, 0, "the packet should be received");
+  NS_TEST_EXPECT_MSG_EQ (m_receivedPacket->GetSize (), 123, "trivial");
+
+  // The destinations are resolved without ARP requests
+  Ptr<ArpCache> cache = txNode->GetObject<Ipv4L3Protocol> ()->GetInterface (1)->GetArpCache ();
+  ArpCache::Entry *entry = cache->Lookup (Ipv4Address ("10.0.0.3"));
+  NS_TEST_EXPECT_MSG_NE (entry, 0, "the destination should be in the ARP cache");
+  NS_TEST_EXPECT_MSG_EQ (entry->IsPermanent (), true, "the ARP entry should be permanent");
+  NS_TEST_EXPECT_MSG_EQ (entry->GetMacAddress (), devices.Get (2)->GetAddress (), "wrong MAC address");
+
+  Simulator::Destroy ();
+}
+
 /**
  * \ingroup internet-test
  * \ingroup tests
@@ -723,6 +827,7 @@ public:
     AddTestCase (new UdpSocketLoopbackTest, TestCase::QUICK);
     AddTestCase (new Udp6SocketImplTest, TestCase::QUICK);
     AddTestCase (new Udp6SocketLoopbackTest, TestCase::QUICK);
+    AddTestCase (new UdpSocketSlimStackTest, TestCase::QUICK);
   }
 };
 
@@ -15,6 +15,7 @@
 #include "ns3/names.h"
 #include "ns3/ptr.h"
 #include "ns3/ipv4-list-routing.h"
+#include "ns3/uinteger.h"
 
 namespace ns3
 {
@@ -45,6 +46,13 @@ LeachHelper::Set (std::string name, const AttributeValue &value)
   m_agentFactory.Set (name, value);
 }
 
+void
+LeachHelper::SetBaseStation (Ptr<Node> node, Ipv4Address address)
+{
+  m_agentFactory.Set ("BaseStationNode", UintegerValue (node->GetId ()));
+  m_agentFactory.Set ("BaseStationAddress", Ipv4AddressValue (address));
+}
+
 int64_t
 LeachHelper::AssignStreams (NodeContainer c, int64_t stream)
 {
@@ -17,6 +17,7 @@
 #include "ns3/node.h"
 #include "ns3/node-container.h"
 #include "ns3/ipv4-routing-helper.h"
+#include "ns3/ipv4-address.h"
 
 namespace ns3 {
 /**
@@ -53,6 +54,14 @@ public:
    * This method controls the attributes of ns3::aodv::RoutingProtocol
    */
   void Set (std::string name, const AttributeValue &value);
+  /**
+   * \param node the node of the base station
+   * \param address the address the base station will be assigned
+   *
+   * Set the BaseStationNode and BaseStationAddress attributes of the
+   * protocols created, to which the cluster heads send their data.
+   */
+  void SetBaseStation (Ptr<Node> node, Ipv4Address address);
   /**
    * Assign a fixed random variable stream number to the random variables
    * used by this model.  Return the number of streams (possibly zero) that
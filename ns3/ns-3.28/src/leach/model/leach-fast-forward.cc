@@ -0,0 +1,479 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Round-level analytic model of the LEACH protocol, see leach-fast-forward.h.
+ */
+
+#include "leach-fast-forward.h"
+#include "leach-routing-protocol.h"
+#include "ns3/core-config.h"
+#include "ns3/log.h"
+#include "ns3/double.h"
+#include "ns3/uinteger.h"
+#include "ns3/boolean.h"
+#include "ns3/pointer.h"
+#include "ns3/string.h"
+#include "ns3/trace-source-accessor.h"
+#include "ns3/mobility-model.h"
+#ifdef HAVE_PTHREAD_H
+#include "ns3/system-thread.h"
+#endif
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LeachFastForward");
+
+namespace leach {
+
+NS_OBJECT_ENSURE_REGISTERED (FastForward);
+
+const uint32_t FastForward::NO_HEAD = std::numeric_limits<uint32_t>::max ();
+
+TypeId
+FastForward::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::leach::FastForward")
+    .SetParent<Object> ()
+    .SetGroupName ("Leach")
+    .AddConstructor<FastForward> ()
+    .AddAttribute ("CHPercentage", "Desired fraction of cluster heads per round.",
+                   DoubleValue (0.05),
+                   MakeDoubleAccessor (&FastForward::m_CHPercentage),
+                   MakeDoubleChecker<double> (0, 1))
+    .AddAttribute ("PacketSize", "Size of a data packet in bytes.",
+                   UintegerValue (1024),
+                   MakeUintegerAccessor (&FastForward::m_packetSize),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("PacketsPerRound", "Number of data packets every sensor sends per round.",
+                   UintegerValue (3),
+                   MakeUintegerAccessor (&FastForward::m_packetsPerRound),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("DataAggregation",
+                   "If true, a cluster head fuses the packets of its members into its own "
+                   "instead of forwarding every packet.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&FastForward::m_aggregate),
+                   MakeBooleanChecker ())
+    .AddAttribute ("AggregationEnergy", "Energy to fuse one bit of one signal, in J/bit.",
+                   DoubleValue (5e-9),
+                   MakeDoubleAccessor (&FastForward::m_aggregationEnergyJ),
+                   MakeDoubleChecker<double> (0))
+    .AddAttribute ("LowBatteryThreshold",
+                   "Fraction of the initial energy at which a sensor is depleted, as in BasicEnergySource.",
+                   DoubleValue (0.10),
+                   MakeDoubleAccessor (&FastForward::m_lowBatteryTh),
+                   MakeDoubleChecker<double> (0, 1))
+    .AddAttribute ("Threads", "Number of threads the sensors are split over.",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&FastForward::m_threads),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("RadioEnergyModel", "The radio model which gives the energy per bit.",
+                   PointerValue (),
+                   MakePointerAccessor (&FastForward::m_radio),
+                   MakePointerChecker<FirstOrderRadioEnergyModel> ())
+    .AddAttribute ("UniformRv",
+                   "Access to the underlying UniformRandomVariable",
+                   StringValue ("ns3::UniformRandomVariable"),
+                   MakePointerAccessor (&FastForward::m_uniformRandomVariable),
+                   MakePointerChecker<UniformRandomVariable> ())
+    .AddTraceSource ("RoundEnd", "A round has been computed.",
+                     MakeTraceSourceAccessor (&FastForward::m_roundTrace),
+                     "ns3::leach::FastForward::RoundTracedCallback")
+  ;
+  return tid;
+}
+
+FastForward::FastForward ()
+  : m_bsX (0),
+    m_bsY (0),
+    m_minX (std::numeric_limits<u_int32_t>::max ()),
+    m_minY (std::numeric_limits<u_int32_t>::max ()),
+    m_maxX (0),
+    m_maxY (0),
+    m_cellSize (1),
+    m_gridWidth (0),
+    m_gridHeight (0),
+    m_curRound (0),
+    m_nAlive (0)
+{
+  NS_LOG_FUNCTION (this);
+  m_radio = CreateObject<FirstOrderRadioEnergyModel> ();
+}
+
+FastForward::~FastForward ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+FastForward::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_radio = 0;
+  m_uniformRandomVariable = 0;
+  Object::DoDispose ();
+}
+
+void
+FastForward::SetBaseStation (double x, double y)
+{
+  NS_LOG_FUNCTION (this << x << y);
+  /* Positions are truncated the same way as in RoutingProtocol. */
+  m_bsX = x;
+  m_bsY = y;
+  for (uint32_t i = 0; i < m_x.size (); ++i)
+    {
+      m_bsDist[i] = RoutingProtocol::Distance (m_x[i], m_y[i], m_bsX, m_bsY);
+    }
+}
+
+uint32_t
+FastForward::AddNode (double x, double y, double energyJ)
+{
+  NS_LOG_FUNCTION (this << x << y << energyJ);
+  m_x.push_back (x);
+  m_y.push_back (y);
+  m_bsDist.push_back (RoutingProtocol::Distance (m_x.back (), m_y.back (), m_bsX, m_bsY));
+  m_initialEnergy.push_back (energyJ);
+  m_energy.push_back (energyJ);
+  m_alive.push_back (energyJ > m_lowBatteryTh * energyJ);
+  m_isCH.push_back (false);
+  m_wasCH.push_back (false);
+  m_head.push_back (NO_HEAD);
+  m_headDist.push_back (0);
+  m_members.push_back (0);
+  m_nAlive += m_alive.back ();
+  m_minX = std::min (m_minX, m_x.back ());
+  m_minY = std::min (m_minY, m_y.back ());
+  m_maxX = std::max (m_maxX, m_x.back ());
+  m_maxY = std::max (m_maxY, m_y.back ());
+  return m_x.size () - 1;
+}
+
+void
+FastForward::AddNodes (NodeContainer nodes, double energyJ)
+{
+  NS_LOG_FUNCTION (this << energyJ);
+  for (NodeContainer::Iterator i = nodes.Begin (); i != nodes.End (); ++i)
+    {
+      Ptr<MobilityModel> mobility = (*i)->GetObject<MobilityModel> ();
+      NS_ASSERT_MSG (mobility != 0, "Node " << (*i)->GetId () << " has no MobilityModel");
+      Vector pos = mobility->GetPosition ();
+      AddNode (pos.x, pos.y, energyJ);
+    }
+}
+
+uint32_t
+FastForward::GetNNodes (void) const
+{
+  return m_x.size ();
+}
+
+uint32_t
+FastForward::GetNAliveNodes (void) const
+{
+  return m_nAlive;
+}
+
+bool
+FastForward::IsAlive (uint32_t i) const
+{
+  return m_alive[i];
+}
+
+double
+FastForward::GetRemainingEnergy (uint32_t i) const
+{
+  return m_energy[i];
+}
+
+double
+FastForward::GetTotalEnergyConsumption (uint32_t i) const
+{
+  return m_initialEnergy[i] - m_energy[i];
+}
+
+uint32_t
+FastForward::GetRound (void) const
+{
+  return m_curRound;
+}
+
+uint32_t
+FastForward::GetNClusterHeads (void) const
+{
+  return m_heads.size ();
+}
+
+int64_t
+FastForward::AssignStreams (int64_t stream)
+{
+  NS_LOG_FUNCTION (this << stream);
+  m_uniformRandomVariable->SetStream (stream);
+  return 1;
+}
+
+uint32_t
+FastForward::Run (uint32_t maxRounds)
+{
+  NS_LOG_FUNCTION (this << maxRounds);
+  uint32_t rounds = 0;
+  while (rounds < maxRounds && m_nAlive > 0)
+    {
+      RunRound ();
+      rounds++;
+    }
+  return rounds;
+}
+
+uint32_t
+FastForward::RunRound (void)
+{
+  NS_LOG_FUNCTION (this);
+  uint32_t n = m_x.size ();
+  m_curRound += 1;
+
+  /* Election, in node order so the random numbers do not depend on the
+   * number of threads. Mirrors RoutingProtocol::newRound, with the numbers
+   * of all the sensors alive drawn at once. */
+  bool epochEnded = RoutingProtocol::EpochEnded (m_CHPercentage, m_curRound);
+  m_heads.clear ();
+  m_draws.resize (m_nAlive);
+  if (m_nAlive > 0)
+    {
+      m_uniformRandomVariable->GetValues (0.0, 1.0, &m_draws[0], m_nAlive);
+    }
+  uint32_t draw = 0;
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      if (!m_alive[i])
+        {
+          continue;
+        }
+      if (m_isCH[i])
+        {
+          m_isCH[i] = false;
+          m_wasCH[i] = true;
+        }
+      if (epochEnded)
+        {
+          m_wasCH[i] = false;
+        }
+      double randNum = m_draws[draw++];
+      if (randNum < RoutingProtocol::ElectionProbability (m_CHPercentage, m_curRound, m_wasCH[i]))
+        {
+          m_isCH[i] = true;
+          m_heads.push_back (i);
+        }
+      m_members[i] = 0;
+    }
+
+  BuildGrid ();
+  ParallelFor (MakeCallback (&FastForward::AssignClusters, this));
+
+  /* Cluster sizes. */
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      if (m_alive[i] && m_head[i] != NO_HEAD)
+        {
+          m_members[m_head[i]]++;
+        }
+    }
+
+  ParallelFor (MakeCallback (&FastForward::ChargeRound, this));
+
+  m_nAlive = std::count (m_alive.begin (), m_alive.end (), 1);
+  NS_LOG_INFO ("Round " << m_curRound << ": " << m_heads.size () << " cluster heads, "
+                        << m_nAlive << " sensors alive");
+  m_roundTrace (m_curRound, m_nAlive, m_heads.size ());
+  return m_nAlive;
+}
+
+void
+FastForward::BuildGrid (void)
+{
+  if (m_heads.empty ())
+    {
+      return;
+    }
+  /* About one cluster head per cell. */
+  double width = m_maxX - m_minX + 1;
+  double height = m_maxY - m_minY + 1;
+  m_cellSize = std::max (1.0, std::sqrt (width * height / m_heads.size ()));
+  m_gridWidth = std::ceil (width / m_cellSize);
+  m_gridHeight = std::ceil (height / m_cellSize);
+
+  /* Counting sort of the heads on their cell, which keeps the node order
+   * inside a cell. */
+  m_cellStart.assign (m_gridWidth * m_gridHeight + 1, 0);
+  m_cellHeads.resize (m_heads.size ());
+  for (std::vector<uint32_t>::const_iterator h = m_heads.begin (); h != m_heads.end (); ++h)
+    {
+      uint32_t cx = (m_x[*h] - m_minX) / m_cellSize;
+      uint32_t cy = (m_y[*h] - m_minY) / m_cellSize;
+      m_cellStart[cy * m_gridWidth + cx + 1]++;
+    }
+  for (uint32_t c = 0; c < m_gridWidth * m_gridHeight; ++c)
+    {
+      m_cellStart[c + 1] += m_cellStart[c];
+    }
+  std::vector<uint32_t> fill (m_cellStart.begin (), m_cellStart.end () - 1);
+  for (std::vector<uint32_t>::const_iterator h = m_heads.begin (); h != m_heads.end (); ++h)
+    {
+      uint32_t cx = (m_x[*h] - m_minX) / m_cellSize;
+      uint32_t cy = (m_y[*h] - m_minY) / m_cellSize;
+      m_cellHeads[fill[cy * m_gridWidth + cx]++] = *h;
+    }
+}
+
+void
+FastForward::AssignClusters (uint32_t begin, uint32_t end)
+{
+  int32_t width = m_gridWidth;
+  int32_t height = m_gridHeight;
+  int32_t maxRing = std::max (width, height);
+  for (uint32_t i = begin; i < end; ++i)
+    {
+      m_head[i] = NO_HEAD;
+      if (!m_alive[i] || m_isCH[i] || m_heads.empty ())
+        {
+          continue;
+        }
+      /* Same rule as RoutingProtocol::RecvAdvertisement: the closest cluster
+       * head wins and on a tie the first one, i.e. the lowest node index.
+       * Search the grid ring by ring around the sensor; the heads in ring
+       * r + 1 are at least r cells away, so stop once the best distance is
+       * below that. */
+      int32_t cx = (m_x[i] - m_minX) / m_cellSize;
+      int32_t cy = (m_y[i] - m_minY) / m_cellSize;
+      double best = std::numeric_limits<double>::max ();
+      for (int32_t r = 0; r <= maxRing; ++r)
+        {
+          for (int32_t y = std::max (cy - r, 0); y <= std::min (cy + r, height - 1); ++y)
+            {
+              /* Only the border of the ring. */
+              int32_t step = (y == cy - r || y == cy + r) ? 1 : 2 * r;
+              for (int32_t x = cx - r; x <= cx + r; x += std::max (step, 1))
+                {
+                  if (x < 0 || x >= width)
+                    {
+                      continue;
+                    }
+                  uint32_t c = y * width + x;
+                  for (uint32_t k = m_cellStart[c]; k < m_cellStart[c + 1]; ++k)
+                    {
+                      uint32_t h = m_cellHeads[k];
+                      double d = RoutingProtocol::Distance (m_x[i], m_y[i], m_x[h], m_y[h]);
+                      if (d < best || (d == best && h < m_head[i]))
+                        {
+                          best = d;
+                          m_head[i] = h;
+                        }
+                    }
+                }
+            }
+          if (best < r * m_cellSize)
+            {
+              break;
+            }
+        }
+      m_headDist[i] = best;
+    }
+}
+
+void
+FastForward::ChargeRound (uint32_t begin, uint32_t end)
+{
+  uint32_t bits = m_packetSize * 8;
+  double k = m_packetsPerRound;
+  for (uint32_t i = begin; i < end; ++i)
+    {
+      if (!m_alive[i])
+        {
+          continue;
+        }
+      double energyJ;
+      if (m_isCH[i])
+        {
+          double members = m_members[i];
+          double forwarded = m_aggregate ? 0 : members;
+          energyJ = k * members * m_radio->GetRxEnergy (bits)
+            + k * (1 + forwarded) * m_radio->GetTxEnergy (bits, m_bsDist[i]);
+          if (m_aggregate)
+            {
+              energyJ += k * (1 + members) * bits * m_aggregationEnergyJ;
+            }
+        }
+      else if (m_head[i] != NO_HEAD)
+        {
+          energyJ = k * m_radio->GetTxEnergy (bits, m_headDist[i]);
+        }
+      else
+        {
+          energyJ = k * m_radio->GetTxEnergy (bits, m_bsDist[i]);
+        }
+
+      m_energy[i] -= std::min (energyJ, m_energy[i]);
+      if (m_energy[i] <= m_lowBatteryTh * m_initialEnergy[i])
+        {
+          m_alive[i] = false;
+        }
+    }
+}
+
+#ifdef HAVE_PTHREAD_H
+/**
+ * One slice of a FastForward::ParallelFor.
+ */
+struct FastForwardRange
+{
+  Callback<void, uint32_t, uint32_t> fn; ///< function to call
+  uint32_t begin;                        ///< first sensor
+  uint32_t end;                          ///< one past the last sensor
+
+  /** Run the slice. */
+  void Run (void)
+  {
+    fn (begin, end);
+  }
+};
+#endif
+
+void
+FastForward::ParallelFor (Callback<void, uint32_t, uint32_t> fn)
+{
+  uint32_t n = m_x.size ();
+#ifdef HAVE_PTHREAD_H
+  uint32_t threads = std::min (m_threads, n);
+  if (threads > 1)
+    {
+      std::vector<FastForwardRange> ranges (threads);
+      std::vector<Ptr<SystemThread> > workers;
+      uint32_t chunk = (n + threads - 1) / threads;
+      for (uint32_t t = 0; t < threads; ++t)
+        {
+          ranges[t].fn = fn;
+          ranges[t].begin = std::min (t * chunk, n);
+          ranges[t].end = std::min (ranges[t].begin + chunk, n);
+        }
+      /* The calling thread takes the first slice itself. */
+      for (uint32_t t = 1; t < threads; ++t)
+        {
+          workers.push_back (Create<SystemThread> (MakeCallback (&FastForwardRange::Run, &ranges[t])));
+          workers.back ()->Start ();
+        }
+      ranges[0].Run ();
+      for (uint32_t t = 0; t < workers.size (); ++t)
+        {
+          workers[t]->Join ();
+        }
+      return;
+    }
+#endif
+  fn (0, n);
+}
+
+} /* namespace leach */
+} /* namespace ns3 */
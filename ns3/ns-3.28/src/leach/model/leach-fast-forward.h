@@ -0,0 +1,240 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Round-level analytic model of the LEACH protocol.
+ *
+ * Instead of simulating every packet, each round is computed directly over
+ * arrays of node state: the cluster head election and the cluster assignment
+ * are the ones of leach::RoutingProtocol and the radio is charged with the
+ * per-bit cost of the FirstOrderRadioEnergyModel. This makes lifetime curves
+ * of very large fields over thousands of rounds cheap to compute.
+ */
+
+#ifndef LEACH_FAST_FORWARD_H
+#define LEACH_FAST_FORWARD_H
+
+#include "ns3/object.h"
+#include "ns3/node-container.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/traced-callback.h"
+#include "ns3/first-order-radio-energy-model.h"
+#include <vector>
+
+namespace ns3 {
+namespace leach {
+
+/**
+ * \ingroup leach
+ * \brief Analytic, round by round LEACH lifetime model.
+ *
+ * Every round each alive sensor runs the LEACH election, every sensor that
+ * is not a cluster head joins the nearest cluster head (or sends directly to
+ * the base station if there is none) and sends PacketsPerRound packets of
+ * PacketSize bytes. A cluster head receives the packets of its members and
+ * forwards them, together with its own, to the base station.
+ *
+ * The model only covers the data plane: advertisements, replies, MAC
+ * overhead and radio range are ignored. The packet-level simulation with
+ * the FirstOrderRadioEnergyModel installed can be used to check how much
+ * this matters for a given topology.
+ *
+ * The nearest cluster head is searched in a uniform grid of the cluster
+ * heads of the round, so a round costs about O(n) instead of O(n * heads).
+ * The cluster assignment and the energy update are independent per node,
+ * so with Threads > 1 they are split over that many threads. The random
+ * numbers of the election are always drawn in node order, so the results
+ * do not depend on the number of threads.
+ */
+class FastForward : public Object
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  FastForward ();
+  virtual ~FastForward ();
+
+  /**
+   * \param x x coordinate of the base station
+   * \param y y coordinate of the base station
+   */
+  void SetBaseStation (double x, double y);
+
+  /**
+   * \param x x coordinate of the sensor
+   * \param y y coordinate of the sensor
+   * \param energyJ initial energy of the sensor, in Joules
+   * \returns the index of the sensor
+   */
+  uint32_t AddNode (double x, double y, double energyJ);
+
+  /**
+   * \param nodes sensor nodes with a MobilityModel aggregated
+   * \param energyJ initial energy of every sensor, in Joules
+   *
+   * Adds every node of the container at the position of its MobilityModel.
+   */
+  void AddNodes (NodeContainer nodes, double energyJ);
+
+  /**
+   * \returns the number of sensors
+   */
+  uint32_t GetNNodes (void) const;
+
+  /**
+   * \returns the number of sensors which still have energy
+   */
+  uint32_t GetNAliveNodes (void) const;
+
+  /**
+   * \param i index of the sensor
+   * \returns true if the sensor still has energy
+   */
+  bool IsAlive (uint32_t i) const;
+
+  /**
+   * \param i index of the sensor
+   * \returns the remaining energy of the sensor, in Joules
+   */
+  double GetRemainingEnergy (uint32_t i) const;
+
+  /**
+   * \param i index of the sensor
+   * \returns the energy the sensor consumed so far, in Joules
+   */
+  double GetTotalEnergyConsumption (uint32_t i) const;
+
+  /**
+   * \returns the number of rounds computed so far
+   */
+  uint32_t GetRound (void) const;
+
+  /**
+   * \returns the number of cluster heads of the last round
+   */
+  uint32_t GetNClusterHeads (void) const;
+
+  /**
+   * Compute a single round.
+   *
+   * \returns the number of sensors alive after the round
+   */
+  uint32_t RunRound (void);
+
+  /**
+   * Compute rounds until every sensor is depleted or maxRounds rounds are
+   * computed.
+   *
+   * \param maxRounds maximum number of rounds
+   * \returns the number of rounds computed
+   */
+  uint32_t Run (uint32_t maxRounds);
+
+  /**
+   * Assign a fixed random variable stream number to the random variables
+   * used by this model.
+   *
+   * \param stream first stream index to use
+   * \return the number of stream indices assigned by this model
+   */
+  int64_t AssignStreams (int64_t stream);
+
+  /**
+   * TracedCallback signature for the end of a round.
+   *
+   * \param [in] round the round that ended
+   * \param [in] alive number of sensors still alive
+   * \param [in] clusterHeads number of cluster heads in the round
+   */
+  typedef void (* RoundTracedCallback)(uint32_t round, uint32_t alive, uint32_t clusterHeads);
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /**
+   * Call fn over all sensors, split over m_threads threads.
+   * \param fn the function to call with the range [begin, end) of sensors
+   */
+  void ParallelFor (Callback<void, uint32_t, uint32_t> fn);
+
+  /**
+   * Bucket the cluster heads of the round in a uniform grid over the field,
+   * so the nearest one can be found without looking at all of them.
+   */
+  void BuildGrid (void);
+
+  /**
+   * Join every sensor in [begin, end) that is not a cluster head to the
+   * nearest cluster head.
+   * \param begin first sensor
+   * \param end one past the last sensor
+   */
+  void AssignClusters (uint32_t begin, uint32_t end);
+
+  /**
+   * Charge the radio energy of the round to the sensors in [begin, end).
+   * \param begin first sensor
+   * \param end one past the last sensor
+   */
+  void ChargeRound (uint32_t begin, uint32_t end);
+
+  static const uint32_t NO_HEAD; ///< Sensor sends directly to the base station
+
+  /* Parameters */
+  double m_CHPercentage;
+  uint32_t m_packetSize;
+  uint32_t m_packetsPerRound;
+  bool m_aggregate;
+  double m_aggregationEnergyJ;
+  double m_lowBatteryTh;
+  uint32_t m_threads;
+  Ptr<FirstOrderRadioEnergyModel> m_radio;
+  Ptr<UniformRandomVariable> m_uniformRandomVariable;
+
+  /* Base station */
+  u_int32_t m_bsX;
+  u_int32_t m_bsY;
+
+  /* Sensor state, one entry per sensor */
+  std::vector<u_int32_t> m_x;
+  std::vector<u_int32_t> m_y;
+  std::vector<double> m_bsDist;
+  std::vector<double> m_initialEnergy;
+  std::vector<double> m_energy;
+  std::vector<uint8_t> m_alive;
+  std::vector<uint8_t> m_isCH;
+  std::vector<uint8_t> m_wasCH;
+  std::vector<uint32_t> m_head;
+  std::vector<double> m_headDist;
+
+  /* Cluster heads of the current round */
+  std::vector<uint32_t> m_heads;
+  std::vector<uint32_t> m_members;
+  /* Election draws of the current round, one per sensor alive */
+  std::vector<double> m_draws;
+
+  /* Grid of cluster heads, m_cellHeads[m_cellStart[c]..m_cellStart[c+1]) are
+   * the heads in cell c, in node order. The grid covers every sensor. */
+  u_int32_t m_minX;
+  u_int32_t m_minY;
+  u_int32_t m_maxX;
+  u_int32_t m_maxY;
+  double m_cellSize;
+  uint32_t m_gridWidth;
+  uint32_t m_gridHeight;
+  std::vector<uint32_t> m_cellStart;
+  std::vector<uint32_t> m_cellHeads;
+
+  u_int32_t m_curRound;
+  uint32_t m_nAlive;
+
+  TracedCallback<uint32_t, uint32_t, uint32_t> m_roundTrace;
+};
+
+} /* namespace leach */
+} /* namespace ns3 */
+
+#endif /* LEACH_FAST_FORWARD_H */
@@ -28,6 +28,9 @@
 #include "ns3/adhoc-wifi-mac.h"
 #include "ns3/string.h"
 #include "ns3/pointer.h"
+#include "ns3/node-list.h"
+#include "ns3/mobility-model.h"
+#include "ns3/radio-distance-tag.h"
 #include <algorithm>
 #include <limits>
 #include "math.h"
@@ -145,6 +148,7 @@ RoutingProtocol::RoutingProtocol ()
     m_wasCH(false),
     m_nearestCH_addr(Ipv4Address()),
     m_nearestCH_dist(100000), /* Large enough so a new connection is always the CH.  */
+    m_bsDist(0),
     m_sleepNode(Timer::CANCEL_ON_DESTROY),
     m_roundDuration(Seconds(3)),
     m_roundTimer(Timer::CANCEL_ON_DESTROY),
@@ -162,7 +166,9 @@ RoutingProtocol::RoutingProtocol ()
     m_x(0),
     m_y(0),
     m_myAddr(Ipv4Address()),
-    m_isBS(false)
+    m_isBS(false),
+    m_bsAddr(Ipv4Address("10.1.1.1")),
+    m_bsNode(0)
 {
 }
 
@@ -204,6 +210,14 @@ RoutingProtocol::GetTypeId (void)
                    StringValue ("ns3::UniformRandomVariable"),
                    MakePointerAccessor (&RoutingProtocol::m_uniformRandomVariable),
                    MakePointerChecker<UniformRandomVariable> ())
+    .AddAttribute ("BaseStationAddress", "The address of the base station, to which the data is sent.",
+                   Ipv4AddressValue ("10.1.1.1"),
+                   MakeIpv4AddressAccessor (&RoutingProtocol::m_bsAddr),
+                   MakeIpv4AddressChecker ())
+    .AddAttribute ("BaseStationNode", "The id of the node of the base station.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&RoutingProtocol::m_bsNode),
+                   MakeUintegerChecker<uint32_t> ())
   ;
   return tid;
 }
@@ -296,6 +310,7 @@ RoutingProtocol::RouteOutputClusterNode (Ptr<Packet> p, const Ipv4Header &header
         route->SetGateway(header.GetDestination());
         route->SetSource(m_myAddr);
         route->SetOutputDevice(m_ipv4->GetNetDevice(m_ipv4->GetInterfaceForAddress(m_myAddr)));
+        TagRadioDistance(p, route->GetGateway());
 
         NS_LOG_INFO("Route reply to CH: " << route->GetDestination() << " from: " << route->GetSource()
                     << " through: " << route->GetGateway() << " on interface: " <<
@@ -315,6 +330,7 @@ RoutingProtocol::RouteOutputClusterNode (Ptr<Packet> p, const Ipv4Header &header
         route->SetGateway(header.GetDestination());
         route->SetSource(m_myAddr);
         route->SetOutputDevice(m_ipv4->GetNetDevice(m_ipv4->GetInterfaceForAddress(m_myAddr)));
+        TagRadioDistance(p, route->GetGateway());
 
         NS_LOG_INFO("1.Route to: " << route->GetDestination() << " from: " << route->GetSource()
                     << " through: " << route->GetGateway() << " on interface: " <<
@@ -331,6 +347,7 @@ RoutingProtocol::RouteOutputClusterNode (Ptr<Packet> p, const Ipv4Header &header
         route->SetGateway(m_nearestCH_addr);
         route->SetSource(m_myAddr);
         route->SetOutputDevice(m_ipv4->GetNetDevice(m_ipv4->GetInterfaceForAddress(m_myAddr)));
+        TagRadioDistance(p, route->GetGateway());
 
         NS_LOG_INFO("2.Route to: " << route->GetDestination() << " from: " << route->GetSource()
                     << " through: " << route->GetGateway() << " on interface: " <<
@@ -362,6 +379,7 @@ RoutingProtocol::RouteOutputClusterHead (Ptr<Packet> p, const Ipv4Header &header
     route->SetGateway(header.GetDestination());
     route->SetSource(m_myAddr);
     route->SetOutputDevice(m_ipv4->GetNetDevice(m_ipv4->GetInterfaceForAddress(m_myAddr)));
+    TagRadioDistance(p, route->GetGateway());
 
     NS_LOG_INFO("Route from CH to: " << route->GetDestination() << " from: " << route->GetSource()
                 << " through: " << route->GetGateway() << " on interface: " <<
@@ -451,6 +469,8 @@ RoutingProtocol::Forwarding (Ptr<const Packet> p, const Ipv4Header & header,
                   << " through: " << route->GetGateway() << " on interface: " <<
                   route->GetOutputDevice());
 
+      /* The packet is copied by Ipv4L3Protocol::IpForward, only tag it. */
+      TagRadioDistance(ConstCast<Packet> (p), route->GetGateway());
       ucb(route, p, header);
 
       return true;
@@ -814,11 +834,33 @@ RoutingProtocol::RecvLeach (Ptr<Socket> socket)
 }
 
 
+void RoutingProtocol::TagRadioDistance(Ptr<Packet> p, Ipv4Address gateway)
+{
+    if(p == 0)
+        return;
+
+    double dist;
+    if(gateway != Ipv4Address() && gateway == m_nearestCH_addr)
+        dist = m_nearestCH_dist;
+    else if(gateway == m_bsAddr)
+        dist = m_bsDist;
+    else
+        return;
+
+    RadioDistanceTag tag(dist);
+    p->ReplacePacketTag(tag);
+}
+
 double RoutingProtocol::DistTo(u_int32_t a_x, u_int32_t a_y)
+{
+    return Distance(a_x, a_y, m_x, m_y);
+}
+
+double RoutingProtocol::Distance(u_int32_t a_x, u_int32_t a_y, u_int32_t b_x, u_int32_t b_y)
 {
     /* Simple pythagoras to calculate the distance between two points. */
-    int dx = a_x - m_x;
-    int dy = a_y - m_y;
+    int dx = a_x - b_x;
+    int dy = a_y - b_y;
     double x_square = pow(dx, 2);
     double y_square = pow(dy, 2);
     double dist = sqrt(x_square + y_square);
@@ -960,6 +1002,7 @@ RoutingProtocol::SendPacketFromQueue (Ipv4Address dst, Ptr<Ipv4Route> route)
       Ipv4Header header = queueEntry.GetIpv4Header ();
       header.SetSource (route->GetSource ());
       header.SetTtl (header.GetTtl () + 1); // compensate extra TTL decrement by fake loopback routing
+      TagRadioDistance (p, route->GetGateway ());
       ucb (route, p, header);
     }
 }
@@ -1042,7 +1085,7 @@ RoutingProtocol::SendFromQueue()
     /* Wake the node up. */
     resume();
 
-    Ipv4Address dst = Ipv4Address("10.1.1.1");
+    Ipv4Address dst = m_bsAddr;
 
     QueueEntry queueEntry;
     while (m_queue.Dequeue (dst, queueEntry))
@@ -1069,6 +1112,7 @@ RoutingProtocol::SendFromQueue()
         Ipv4Header header = queueEntry.GetIpv4Header ();
         header.SetSource (route->GetSource ());
         header.SetTtl (header.GetTtl () + 1); // compensate extra TTL decrement by fake loopback routing
+        TagRadioDistance(p, route->GetGateway());
         ucb (route, p, header);
     }
 }
@@ -1126,13 +1170,18 @@ RoutingProtocol::DoInitialize (void)
   m_roundTimer.Schedule();
 
   /* Check if this node is the base station. */
-  if(m_ipv4->GetObject<Node>()->GetId() == 0)
+  if(m_ipv4->GetObject<Node>()->GetId() == m_bsNode)
       m_isBS = true;
 
   /* Get the position of the node. */
   m_x = m_ipv4->GetObject<Node>()->GetObject<MobilityModel>()->GetPosition().x;
   m_y = m_ipv4->GetObject<Node>()->GetObject<MobilityModel>()->GetPosition().y;
 
+  /* Get the distance to the base station. */
+  Ptr<MobilityModel> bsMobility = NodeList::GetNode(m_bsNode)->GetObject<MobilityModel>();
+  if(bsMobility != 0)
+      m_bsDist = DistTo(bsMobility->GetPosition().x, bsMobility->GetPosition().y);
+
   Ipv4RoutingProtocol::DoInitialize();
 }
 
@@ -1212,13 +1261,23 @@ float RoutingProtocol::electionProbability()
 {
     NS_LOG_FUNCTION(this);
 
+    return ElectionProbability(m_CHPercentage, m_curRound, m_wasCH);
+}
+
+float RoutingProtocol::ElectionProbability(double chPercentage, u_int32_t round, bool wasCH)
+{
     /* Return a probability of 0.0 if the node was a CH in (1 / m_CHPercentage)
      * number of rounds. */
-    if(m_wasCH)
+    if(wasCH)
         return 0.0;
 
     /* Return the probability that this node becomes a CH. */
-    return m_CHPercentage / (float) (1 - m_CHPercentage * fmod(m_curRound, (1 / m_CHPercentage)));
+    return chPercentage / (float) (1 - chPercentage * fmod(round, (1 / chPercentage)));
+}
+
+bool RoutingProtocol::EpochEnded(double chPercentage, u_int32_t round)
+{
+    return fmod(round, 1 / chPercentage) < round;
 }
 
 /**
@@ -1265,7 +1324,7 @@ void RoutingProtocol::newRound()
     }
 
     /* Everyone has been a CH, so reset everybody. */
-    if(fmod(m_curRound, 1 / m_CHPercentage) < m_curRound)
+    if(EpochEnded(m_CHPercentage, m_curRound))
         m_wasCH = false;
 
     m_nearestCH_addr = Ipv4Address();
@@ -73,6 +73,14 @@ public:
      */
     int64_t AssignStreams (int64_t stream);
 
+    /* Election threshold T(n) of a node in the given round. A node that was
+     * a CH in the current epoch is never elected again. */
+    static float ElectionProbability(double chPercentage, u_int32_t round, bool wasCH);
+    /* True if every node has been a CH, so the wasCH flags are reset. */
+    static bool EpochEnded(double chPercentage, u_int32_t round);
+    /* Distance between two points, as used for the nearest CH selection. */
+    static double Distance(u_int32_t a_x, u_int32_t a_y, u_int32_t b_x, u_int32_t b_y);
+
 protected:
     virtual void DoInitialize (void);
 
@@ -238,6 +246,7 @@ private:
     bool        m_wasCH;
     Ipv4Address m_nearestCH_addr;
     double      m_nearestCH_dist;
+    double      m_bsDist;
     std::list<Ipv4Address> m_clusterNodes;
 
     /* Cluster node information */
@@ -266,6 +275,8 @@ private:
     u_int32_t   m_y;
     Ipv4Address m_myAddr;
     bool        m_isBS;
+    Ipv4Address m_bsAddr;       /* Address of the base station. */
+    uint32_t    m_bsNode;       /* Node id of the base station. */
     Ptr<WifiNetDevice> m_wifiDev;
 
     /* Calculates the threshold and returns this threshold which is a float
@@ -277,6 +288,11 @@ private:
     void setupTimerExpires();
     double DistTo(u_int32_t a_x, u_int32_t a_y);
 
+    /* Tag the packet with the distance to the next hop, so the radio energy
+     * model can charge the amplifier for it. Packets to a next hop with an
+     * unknown position are left untagged. */
+    void TagRadioDistance(Ptr<Packet> p, Ipv4Address gateway);
+
     /* Functions that are called when a timer expires. */
     void advertisePhaseExpired();
     void replyPhaseExpired();
@@ -1,7 +1,10 @@
 /* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
 
 // Include a header file from your module to test.
-#include "ns3/leach.h"
+#include "ns3/leach-routing-protocol.h"
+#include "ns3/leach-fast-forward.h"
+#include "ns3/double.h"
+#include "ns3/uinteger.h"
 
 // An essential include is test.h
 #include "ns3/test.h"
@@ -46,6 +49,77 @@ LeachTestCase1::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ_TOL (0.01, 0.01, 0.001, "Numbers are not equal within tolerance");
 }
 
+// Check the analytic fast-forward engine against hand computed energy and
+// check that the number of threads does not change the outcome.
+class LeachFastForwardTestCase : public TestCase
+{
+public:
+  LeachFastForwardTestCase ();
+  virtual ~LeachFastForwardTestCase ();
+
+private:
+  virtual void DoRun (void);
+  Ptr<leach::FastForward> CreateField (uint32_t threads);
+};
+
+LeachFastForwardTestCase::LeachFastForwardTestCase ()
+  : TestCase ("Leach fast-forward engine")
+{
+}
+
+LeachFastForwardTestCase::~LeachFastForwardTestCase ()
+{
+}
+
+Ptr<leach::FastForward>
+LeachFastForwardTestCase::CreateField (uint32_t threads)
+{
+  Ptr<leach::FastForward> ff = CreateObject<leach::FastForward> ();
+  ff->SetAttribute ("Threads", UintegerValue (threads));
+  ff->SetBaseStation (50, 175);
+  for (uint32_t i = 0; i < 200; i++)
+    {
+      ff->AddNode ((i * 37) % 100, (i * 61) % 100, 0.5);
+    }
+  ff->AssignStreams (1);
+  return ff;
+}
+
+void
+LeachFastForwardTestCase::DoRun (void)
+{
+  // With a CH percentage of 1 every node is a cluster head in every round
+  // and sends straight to the base station.
+  Ptr<leach::FastForward> ff = CreateObject<leach::FastForward> ();
+  ff->SetAttribute ("CHPercentage", DoubleValue (1.0));
+  ff->SetAttribute ("PacketSize", UintegerValue (500));
+  ff->SetAttribute ("PacketsPerRound", UintegerValue (2));
+  ff->AddNode (30, 40, 1.0);
+  ff->AddNode (0, 10, 1.0);
+  ff->SetBaseStation (0, 0);
+  ff->Run (5);
+
+  Ptr<FirstOrderRadioEnergyModel> radio = CreateObject<FirstOrderRadioEnergyModel> ();
+  NS_TEST_ASSERT_MSG_EQ (ff->GetRound (), 5, "Wrong number of rounds");
+  NS_TEST_ASSERT_MSG_EQ (ff->GetNClusterHeads (), 2, "Every node should be a cluster head");
+  NS_TEST_ASSERT_MSG_EQ_TOL (ff->GetTotalEnergyConsumption (0), 5 * 2 * radio->GetTxEnergy (4000, 50),
+                             1e-12, "Wrong energy for a cluster head");
+  NS_TEST_ASSERT_MSG_EQ_TOL (ff->GetTotalEnergyConsumption (1), 5 * 2 * radio->GetTxEnergy (4000, 10),
+                             1e-12, "Wrong energy for a cluster head");
+
+  // Splitting the field over threads gives the same result.
+  Ptr<leach::FastForward> serial = CreateField (1);
+  Ptr<leach::FastForward> parallel = CreateField (4);
+  uint32_t rounds = serial->Run (10000);
+  NS_TEST_ASSERT_MSG_EQ (parallel->Run (10000), rounds, "Lifetime depends on the number of threads");
+  NS_TEST_ASSERT_MSG_EQ (serial->GetNAliveNodes (), 0, "Field did not die");
+  for (uint32_t i = 0; i < serial->GetNNodes (); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (serial->GetRemainingEnergy (i), parallel->GetRemainingEnergy (i),
+                             "Energy depends on the number of threads");
+    }
+}
+
 // The TestSuite class names the TestSuite, identifies what type of TestSuite,
 // and enables the TestCases to be run.  Typically, only the constructor for
 // this class must be defined
@@ -61,6 +135,7 @@ LeachTestSuite::LeachTestSuite ()
 {
   // TestDuration for TestCase can be QUICK, EXTENSIVE or TAKES_FOREVER
   AddTestCase (new LeachTestCase1, TestCase::QUICK);
+  AddTestCase (new LeachFastForwardTestCase, TestCase::QUICK);
 }
 
 // Do not forget to allocate an instance of this TestSuite
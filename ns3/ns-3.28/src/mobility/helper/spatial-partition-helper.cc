@@ -0,0 +1,151 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "spatial-partition-helper.h"
+#include "ns3/mobility-model.h"
+#include "ns3/simulator.h"
+#include "ns3/core-config.h"
+#include "ns3/assert.h"
+#include "ns3/log.h"
+#ifdef HAVE_PTHREAD_H
+#include "ns3/multithreaded-simulator-impl.h"
+#endif
+#include <algorithm>
+#include <limits>
+#include <set>
+#include <utility>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("SpatialPartitionHelper");
+
+SpatialPartitionHelper::SpatialPartitionHelper ()
+  : m_columns (1),
+    m_rows (1),
+    m_speed (299792458.0)
+{
+}
+
+void
+SpatialPartitionHelper::SetGrid (uint32_t columns, uint32_t rows)
+{
+  NS_ASSERT (columns > 0 && rows > 0);
+  m_columns = columns;
+  m_rows = rows;
+}
+
+void
+SpatialPartitionHelper::SetPropagationSpeed (double speed)
+{
+  m_speed = speed;
+}
+
+std::vector<uint32_t>
+SpatialPartitionHelper::GetRegions (NodeContainer c) const
+{
+  std::vector<Vector> positions;
+  double minX = std::numeric_limits<double>::max ();
+  double minY = std::numeric_limits<double>::max ();
+  double maxX = -std::numeric_limits<double>::max ();
+  double maxY = -std::numeric_limits<double>::max ();
+  for (NodeContainer::Iterator i = c.Begin (); i != c.End (); ++i)
+    {
+      Ptr<MobilityModel> mobility = (*i)->GetObject<MobilityModel> ();
+      NS_ASSERT_MSG (mobility != 0, "Node " << (*i)->GetId () << " has no MobilityModel");
+      Vector position = mobility->GetPosition ();
+      positions.push_back (position);
+      minX = std::min (minX, position.x);
+      minY = std::min (minY, position.y);
+      maxX = std::max (maxX, position.x);
+      maxY = std::max (maxY, position.y);
+    }
+  double width = (maxX - minX) / m_columns;
+  double height = (maxY - minY) / m_rows;
+  std::vector<uint32_t> regions;
+  for (std::vector<Vector>::const_iterator i = positions.begin (); i != positions.end (); ++i)
+    {
+      uint32_t column = width > 0 ? std::min<uint32_t> ((i->x - minX) / width, m_columns - 1) : 0;
+      uint32_t row = height > 0 ? std::min<uint32_t> ((i->y - minY) / height, m_rows - 1) : 0;
+      regions.push_back (row * m_columns + column);
+    }
+  return regions;
+}
+
+Time
+SpatialPartitionHelper::Install (NodeContainer c) const
+{
+  std::vector<uint32_t> regions = GetRegions (c);
+  std::vector<Vector> positions;
+  std::vector<std::pair<double, uint32_t> > byX;
+  for (uint32_t i = 0; i < c.GetN (); ++i)
+    {
+      positions.push_back (c.Get (i)->GetObject<MobilityModel> ()->GetPosition ());
+      byX.push_back (std::make_pair (positions[i].x, i));
+    }
+  std::sort (byX.begin (), byX.end ());
+
+  // Closest pair of nodes of different regions, by a sweep along x: the
+  // nodes less than the best distance behind the sweep line are kept by
+  // y, and each node is only compared to those within that distance in y.
+  double distance = std::numeric_limits<double>::max ();
+  std::set<std::pair<double, uint32_t> > window;
+  uint32_t oldest = 0;
+  for (uint32_t k = 0; k < byX.size (); ++k)
+    {
+      uint32_t i = byX[k].second;
+      const Vector &a = positions[i];
+      while (oldest < k && a.x - byX[oldest].first > distance)
+        {
+          uint32_t j = byX[oldest].second;
+          window.erase (std::make_pair (positions[j].y, j));
+          oldest++;
+        }
+      std::set<std::pair<double, uint32_t> >::const_iterator j =
+        window.lower_bound (std::make_pair (a.y - distance, 0U));
+      for (; j != window.end () && j->first <= a.y + distance; ++j)
+        {
+          if (regions[j->second] != regions[i])
+            {
+              distance = std::min (distance, CalculateDistance (a, positions[j->second]));
+            }
+        }
+      window.insert (std::make_pair (a.y, i));
+    }
+  // Same conversion as ConstantSpeedPropagationDelayModel, so that the
+  // lookahead is never larger than the delay between the closest nodes.
+  Time lookahead = distance == std::numeric_limits<double>::max () ?
+    Simulator::GetMaximumSimulationTime () : Seconds (distance / m_speed);
+  NS_LOG_INFO ("closest nodes of different regions are " << distance << " m apart: "
+               << "lookahead " << lookahead);
+
+#ifdef HAVE_PTHREAD_H
+  Ptr<MultithreadedSimulatorImpl> impl =
+    DynamicCast<MultithreadedSimulatorImpl> (Simulator::GetImplementation ());
+  if (impl != 0)
+    {
+      for (uint32_t i = 0; i < c.GetN (); ++i)
+        {
+          impl->SetPartition (c.Get (i)->GetId (), regions[i]);
+        }
+      impl->SetAttribute ("Lookahead", TimeValue (lookahead));
+      return lookahead;
+    }
+#endif
+  NS_LOG_WARN ("The simulator does not run partitions in parallel");
+  return lookahead;
+}
+
+} // namespace ns3
@@ -0,0 +1,83 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SPATIAL_PARTITION_HELPER_H
+#define SPATIAL_PARTITION_HELPER_H
+
+#include "ns3/nstime.h"
+#include "ns3/node-container.h"
+#include <stdint.h>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup mobility
+ * \brief Split nodes into partitions of ns3::MultithreadedSimulatorImpl
+ * by their position.
+ *
+ * The bounding box of the nodes is cut into a grid of regions, and each
+ * region becomes one partition.  The lookahead is the time a signal
+ * takes to travel between the two closest nodes of different regions,
+ * which is the smallest delay of an event scheduled across partitions
+ * by a channel which delays receptions with
+ * ns3::ConstantSpeedPropagationDelayModel at the same speed.  Nodes
+ * must not move closer to another region afterwards.
+ *
+ * The partitions only run in parallel when no channel connects two of
+ * them (see ns3::MultithreadedSimulatorImpl): with one channel across
+ * the regions, the simulator must use one thread.
+ */
+class SpatialPartitionHelper
+{
+public:
+  /** Construct a helper with a 1x1 grid and the speed of light. */
+  SpatialPartitionHelper ();
+
+  /**
+   * \param [in] columns The number of regions along the x axis.
+   * \param [in] rows The number of regions along the y axis.
+   */
+  void SetGrid (uint32_t columns, uint32_t rows);
+  /**
+   * \param [in] speed The propagation speed, in m/s.
+   */
+  void SetPropagationSpeed (double speed);
+
+  /**
+   * Assign each node to the partition of its region, and set the
+   * lookahead of the simulator.  This does nothing but compute the
+   * lookahead if the simulator is not a MultithreadedSimulatorImpl.
+   *
+   * \param [in] c The nodes, which must have a MobilityModel.
+   * \returns The lookahead.
+   */
+  Time Install (NodeContainer c) const;
+  /**
+   * \param [in] c The nodes, which must have a MobilityModel.
+   * \returns The region of each node of c, in the same order.
+   */
+  std::vector<uint32_t> GetRegions (NodeContainer c) const;
+
+private:
+  uint32_t m_columns; //!< Number of regions along x.
+  uint32_t m_rows;    //!< Number of regions along y.
+  double m_speed;     //!< Propagation speed, in m/s.
+};
+
+} // namespace ns3
+
+#endif /* SPATIAL_PARTITION_HELPER_H */
@@ -0,0 +1,123 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/config.h"
+#include "ns3/string.h"
+#include "ns3/core-config.h"
+#include "ns3/node-container.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/double.h"
+#include "ns3/uinteger.h"
+#include "ns3/spatial-partition-helper.h"
+#ifdef HAVE_PTHREAD_H
+#include "ns3/multithreaded-simulator-impl.h"
+#endif
+
+using namespace ns3;
+
+/**
+ * \ingroup mobility-test
+ * \ingroup tests
+ *
+ * \brief Check the regions and lookahead of the SpatialPartitionHelper.
+ */
+class SpatialPartitionHelperTestCase : public TestCase
+{
+public:
+  SpatialPartitionHelperTestCase ();
+
+private:
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+};
+
+SpatialPartitionHelperTestCase::SpatialPartitionHelperTestCase ()
+  : TestCase ("Check the regions and lookahead of SpatialPartitionHelper")
+{
+}
+
+void
+SpatialPartitionHelperTestCase::DoTeardown (void)
+{
+  Config::SetGlobal ("SimulatorImplementationType", StringValue ("ns3::DefaultSimulatorImpl"));
+}
+
+void
+SpatialPartitionHelperTestCase::DoRun (void)
+{
+#ifdef HAVE_PTHREAD_H
+  Config::SetGlobal ("SimulatorImplementationType", StringValue ("ns3::MultithreadedSimulatorImpl"));
+#endif
+  // Two rows of five nodes, 10 m apart along x and 100 m along y.
+  NodeContainer nodes;
+  nodes.Create (10);
+  MobilityHelper mobility;
+  mobility.SetPositionAllocator ("ns3::GridPositionAllocator",
+                                 "DeltaX", DoubleValue (10),
+                                 "DeltaY", DoubleValue (100),
+                                 "GridWidth", UintegerValue (5));
+  mobility.Install (nodes);
+
+  SpatialPartitionHelper partition;
+  partition.SetGrid (2, 2);
+  std::vector<uint32_t> regions = partition.GetRegions (nodes);
+  uint32_t expected[] = { 0, 0, 1, 1, 1, 2, 2, 3, 3, 3 };
+  for (uint32_t i = 0; i < nodes.GetN (); ++i)
+    {
+      NS_TEST_EXPECT_MSG_EQ (regions[i], expected[i], "Wrong region for node " << i);
+    }
+
+  // Nodes 1 and 2 are the closest nodes of different regions.
+  Time lookahead = partition.Install (nodes);
+  NS_TEST_EXPECT_MSG_EQ (lookahead, Seconds (10 / 299792458.0), "Wrong lookahead");
+
+#ifdef HAVE_PTHREAD_H
+  Ptr<MultithreadedSimulatorImpl> impl =
+    DynamicCast<MultithreadedSimulatorImpl> (Simulator::GetImplementation ());
+  NS_TEST_ASSERT_MSG_NE (impl, 0, "Not a MultithreadedSimulatorImpl");
+  for (uint32_t i = 0; i < nodes.GetN (); ++i)
+    {
+      NS_TEST_EXPECT_MSG_EQ (impl->GetPartition (nodes.Get (i)->GetId ()), expected[i],
+                             "Wrong partition for node " << i);
+    }
+  TimeValue value;
+  impl->GetAttribute ("Lookahead", value);
+  NS_TEST_EXPECT_MSG_EQ (value.Get (), lookahead, "Lookahead not set");
+#endif
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup mobility-test
+ * \ingroup tests
+ *
+ * \brief Spatial Partition Helper Test Suite
+ */
+class SpatialPartitionHelperTestSuite : public TestSuite
+{
+public:
+  SpatialPartitionHelperTestSuite ();
+};
+
+SpatialPartitionHelperTestSuite::SpatialPartitionHelperTestSuite ()
+  : TestSuite ("spatial-partition-helper", UNIT)
+{
+  AddTestCase (new SpatialPartitionHelperTestCase, TestCase::QUICK);
+}
+
+static SpatialPartitionHelperTestSuite g_spatialPartitionHelperTestSuite; //!< the test suite
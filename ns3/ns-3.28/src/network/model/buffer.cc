@@ -20,6 +20,7 @@
 #include "buffer.h"
 #include "ns3/assert.h"
 #include "ns3/log.h"
+#include "ns3/memory-accounting.h"
 
 #define LOG_INTERNAL_STATE(y)                                                                    \
   NS_LOG_LOGIC (y << "start="<<m_start<<", end="<<m_end<<", zero start="<<m_zeroAreaStart<<              \
@@ -49,8 +50,18 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("Buffer");
 
+/**
+ * \ingroup packet
+ * \returns The index of the buffer data in MemoryAccounting.
+ */
+static uint32_t
+GetAccountingIndex (void)
+{
+  static uint32_t index = MemoryAccounting::Register ("ns3::Buffer::Data");
+  return index;
+}
 
-uint32_t Buffer::g_recommendedStart = 0;
+thread_local uint32_t Buffer::g_recommendedStart = 0;
 #ifdef BUFFER_FREE_LIST
 /* The following macros are pretty evil but they are needed to allow us to
  * keep track of 3 possible states for the g_freeList variable:
@@ -68,6 +79,8 @@ uint32_t Buffer::g_recommendedStart = 0;
  * which the compiler assigns to zero-memory which is initialized to _zero_
  * before the constructors run so this ensures perfect handling of crazy 
  * constructor orderings.
+ * The free list is per thread: it is destroyed when its thread exits,
+ * and a thread which never created a buffer has none.
  */
 #define MAGIC_DESTROYED (~(long) 0)
 #define IS_UNINITIALIZED(x) (x == (Buffer::FreeList*)0)
@@ -75,9 +88,9 @@ uint32_t Buffer::g_recommendedStart = 0;
 #define IS_INITIALIZED(x) (!IS_UNINITIALIZED (x) && !IS_DESTROYED (x))
 #define DESTROYED ((Buffer::FreeList*)MAGIC_DESTROYED)
 #define UNINITIALIZED ((Buffer::FreeList*)0)
-uint32_t Buffer::g_maxSize = 0;
-Buffer::FreeList *Buffer::g_freeList = 0;
-struct Buffer::LocalStaticDestructor Buffer::g_localStaticDestructor;
+thread_local uint32_t Buffer::g_maxSize = 0;
+thread_local Buffer::FreeList *Buffer::g_freeList = 0;
+thread_local struct Buffer::LocalStaticDestructor Buffer::g_localStaticDestructor;
 
 Buffer::LocalStaticDestructor::~LocalStaticDestructor(void)
 {
@@ -99,11 +112,10 @@ Buffer::Recycle (struct Buffer::Data *data)
 {
   NS_LOG_FUNCTION (data);
   NS_ASSERT (data->m_count == 0);
-  NS_ASSERT (!IS_UNINITIALIZED (g_freeList));
   g_maxSize = std::max (g_maxSize, data->m_size);
   /* feed into free list */
   if (data->m_size < g_maxSize ||
-      IS_DESTROYED (g_freeList) ||
+      !IS_INITIALIZED (g_freeList) ||
       g_freeList->size () > 1000)
     {
       Buffer::Deallocate (data);
@@ -123,6 +135,9 @@ Buffer::Create (uint32_t dataSize)
   if (IS_UNINITIALIZED (g_freeList))
     {
       g_freeList = new Buffer::FreeList ();
+      // The first use of a thread_local constructs it, and registers
+      // its destructor at the exit of the thread.
+      (void) &g_localStaticDestructor;
     }
   else if (IS_INITIALIZED (g_freeList))
     {
@@ -173,6 +188,11 @@ Buffer::Allocate (uint32_t reqSize)
   struct Buffer::Data *data = reinterpret_cast<struct Buffer::Data*>(b);
   data->m_size = reqSize;
   data->m_count = 1;
+  data->m_accounted = MemoryAccounting::IsEnabled ();
+  if (data->m_accounted)
+    {
+      MemoryAccounting::Allocate (GetAccountingIndex (), size);
+    }
   return data;
 }
 
@@ -181,6 +201,11 @@ Buffer::Deallocate (struct Buffer::Data *data)
 {
   NS_LOG_FUNCTION (data);
   NS_ASSERT (data->m_count == 0);
+  if (data->m_accounted)
+    {
+      MemoryAccounting::Deallocate (GetAccountingIndex (),
+                                    data->m_size - 1 + sizeof (struct Buffer::Data));
+    }
   uint8_t *buf = reinterpret_cast<uint8_t *> (data);
   delete [] buf;
 }
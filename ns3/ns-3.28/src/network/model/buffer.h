@@ -678,6 +678,10 @@ private:
      * end of the area in which user bytes were written.
      */
     uint32_t m_dirtyEnd;
+    /**
+     * Whether this instance is counted in MemoryAccounting.
+     */
+    bool m_accounted;
     /**
      * The real data buffer holds _at least_ one byte.
      * Its real size is stored in the m_size field.
@@ -765,9 +769,9 @@ private:
   /**
    * location in a newly-allocated buffer where you should start
    * writing data. i.e., m_start should be initialized to this 
-   * value.
+   * value.  Per thread, as the heuristic data below.
    */
-  static uint32_t g_recommendedStart;
+  static thread_local uint32_t g_recommendedStart;
 
   /**
    * offset to the start of the virtual zero area from the start
@@ -798,9 +802,11 @@ private:
   {
     ~LocalStaticDestructor ();
   };
-  static uint32_t g_maxSize; //!< Max observed data size
-  static FreeList *g_freeList; //!< Buffer data container
-  static struct LocalStaticDestructor g_localStaticDestructor; //!< Local static destructor
+  // Per thread, so that the threads of MultithreadedSimulatorImpl
+  // create and recycle buffers without locking.
+  static thread_local uint32_t g_maxSize; //!< Max observed data size
+  static thread_local FreeList *g_freeList; //!< Buffer data container
+  static thread_local struct LocalStaticDestructor g_localStaticDestructor; //!< Local static destructor
 #endif
 };
 
@@ -21,8 +21,14 @@
 #include "ns3/config.h"
 #include "ns3/log.h"
 #include "ns3/assert.h"
+#include "ns3/core-config.h"
 #include "channel-list.h"
 #include "channel.h"
+#include "net-device.h"
+#include "node.h"
+#ifdef HAVE_PTHREAD_H
+#include "ns3/multithreaded-simulator-impl.h"
+#endif
 
 namespace ns3 {
 
@@ -245,4 +251,60 @@ ChannelList::GetNChannels (void)
   return ChannelListPriv::Get ()->GetNChannels ();
 }
 
+#ifdef HAVE_PTHREAD_H
+/**
+ * \ingroup network
+ *
+ * Abort if a channel connects nodes of different partitions of a
+ * MultithreadedSimulatorImpl, as the channel and the packets it
+ * delivers would be shared by the threads running them.
+ *
+ * \param [in] impl The simulator.
+ */
+static void
+CheckChannelPartitions (Ptr<const MultithreadedSimulatorImpl> impl)
+{
+  NS_LOG_FUNCTION (impl);
+  for (ChannelList::Iterator i = ChannelList::Begin (); i != ChannelList::End (); ++i)
+    {
+      Ptr<Channel> channel = *i;
+      Ptr<Node> first = 0;
+      for (std::size_t j = 0; j < channel->GetNDevices (); ++j)
+        {
+          Ptr<Node> node = channel->GetDevice (j)->GetNode ();
+          if (node == 0)
+            {
+              continue;
+            }
+          if (first == 0)
+            {
+              first = node;
+            }
+          else if (impl->GetPartition (node->GetId ()) != impl->GetPartition (first->GetId ()))
+            {
+              NS_FATAL_ERROR ("Channel " << channel->GetId () << " connects node " <<
+                              first->GetId () << " of partition " <<
+                              impl->GetPartition (first->GetId ()) << " and node " <<
+                              node->GetId () << " of partition " <<
+                              impl->GetPartition (node->GetId ()) <<
+                              ", which cannot run in parallel: use one thread");
+            }
+        }
+    }
+}
+
+/**
+ * \ingroup network
+ * Add CheckChannelPartitions() to the checks of MultithreadedSimulatorImpl.
+ */
+static class ChannelPartitionCheck
+{
+public:
+  ChannelPartitionCheck ()
+  {
+    MultithreadedSimulatorImpl::AddParallelCheck (MakeCallback (&CheckChannelPartitions));
+  }
+} g_channelPartitionCheck; //!< Registers the check at load time.
+#endif
+
 } // namespace ns3
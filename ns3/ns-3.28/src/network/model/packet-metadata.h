@@ -23,6 +23,7 @@
 #include <stdint.h>
 #include <vector>
 #include <limits>
+#include <atomic>
 #include "ns3/callback.h"
 #include "ns3/assert.h"
 #include "ns3/type-id.h"
@@ -661,7 +662,10 @@ public:
    */
   static void Deallocate (struct PacketMetadata::Data *data);
 
-  static DataFreeList m_freeList; //!< the metadata data storage
+  // The free list is per thread, so that the threads of
+  // MultithreadedSimulatorImpl create and recycle metadata without locking.
+  static thread_local DataFreeList m_freeList; //!< the metadata data storage
+  static thread_local bool m_freeListDestroyed; //!< Set when m_freeList is destroyed
   static bool m_enable; //!< Enable the packet metadata
   static bool m_enableChecking; //!< Enable the packet metadata checking
 
@@ -670,10 +674,10 @@ public:
    * m_enable is false; used to detect enabling of metadata in the
    * middle of a simulation, which isn't allowed.
    */
-  static bool m_metadataSkipped;
+  static std::atomic<bool> m_metadataSkipped;
 
-  static uint32_t m_maxSize; //!< maximum metadata size
-  static uint16_t m_chunkUid; //!< Chunk Uid
+  static thread_local uint32_t m_maxSize; //!< maximum metadata size
+  static std::atomic<uint16_t> m_chunkUid; //!< Chunk Uid
 
   struct Data *m_data; //!< Metadata storage
   /*
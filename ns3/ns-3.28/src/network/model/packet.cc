@@ -21,6 +21,7 @@
 #include "ns3/assert.h"
 #include "ns3/log.h"
 #include "ns3/simulator.h"
+#include "ns3/memory-accounting.h"
 #include <string>
 #include <cstdarg>
 
@@ -28,7 +29,45 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("Packet");
 
-uint32_t Packet::m_globalUid = 0;
+std::atomic<uint32_t> Packet::m_globalUid (0);
+
+/**
+ * \ingroup packet
+ * \returns The index of the packets in MemoryAccounting.
+ */
+static uint32_t
+GetAccountingIndex (void)
+{
+  static uint32_t index = MemoryAccounting::Register ("ns3::Packet");
+  return index;
+}
+
+/**
+ * \ingroup packet
+ * Count a new Packet in MemoryAccounting, if enabled.
+ *
+ * \returns \c true if the Packet was counted.
+ */
+static bool
+AllocatePacket (void)
+{
+  if (MemoryAccounting::IsEnabled ())
+    {
+      MemoryAccounting::Allocate (GetAccountingIndex (), sizeof (Packet));
+      return true;
+    }
+  return false;
+}
+
+/**
+ * \ingroup packet
+ * Release a counted Packet in MemoryAccounting.
+ */
+static void
+DeallocatePacket (void)
+{
+  MemoryAccounting::Deallocate (GetAccountingIndex (), sizeof (Packet));
+}
 
 TypeId 
 ByteTagIterator::Item::GetTypeId (void) const
@@ -136,10 +175,10 @@ Packet::Packet ()
      * zero.  The lower 32 bits are for the 
      * global UID
      */
-    m_metadata (static_cast<uint64_t> (Simulator::GetSystemId ()) << 32 | m_globalUid, 0),
+    m_metadata (static_cast<uint64_t> (Simulator::GetSystemId ()) << 32 | m_globalUid++, 0),
     m_nixVector (0)
 {
-  m_globalUid++;
+  m_accounted = AllocatePacket ();
 }
 
 Packet::Packet (const Packet &o)
@@ -148,10 +187,19 @@ Packet::Packet (const Packet &o)
     m_packetTagList (o.m_packetTagList),
     m_metadata (o.m_metadata)
 {
+  m_accounted = AllocatePacket ();
   o.m_nixVector ? m_nixVector = o.m_nixVector->Copy ()
     : m_nixVector = 0;
 }
 
+Packet::~Packet ()
+{
+  if (m_accounted)
+    {
+      DeallocatePacket ();
+    }
+}
+
 Packet &
 Packet::operator = (const Packet &o)
 {
@@ -178,10 +226,10 @@ Packet::Packet (uint32_t size)
      * zero.  The lower 32 bits are for the 
      * global UID
      */
-    m_metadata (static_cast<uint64_t> (Simulator::GetSystemId ()) << 32 | m_globalUid, size),
+    m_metadata (static_cast<uint64_t> (Simulator::GetSystemId ()) << 32 | m_globalUid++, size),
     m_nixVector (0)
 {
-  m_globalUid++;
+  m_accounted = AllocatePacket ();
 }
 Packet::Packet (uint8_t const *buffer, uint32_t size, bool magic)
   : m_buffer (0, false),
@@ -190,6 +238,7 @@ Packet::Packet (uint8_t const *buffer, uint32_t size, bool magic)
     m_metadata (0,0),
     m_nixVector (0)
 {
+  m_accounted = AllocatePacket ();
   NS_ASSERT (magic);
   Deserialize (buffer, size);
 }
@@ -204,10 +253,10 @@ Packet::Packet (uint8_t const*buffer, uint32_t size)
      * zero.  The lower 32 bits are for the 
      * global UID
      */
-    m_metadata (static_cast<uint64_t> (Simulator::GetSystemId ()) << 32 | m_globalUid, size),
+    m_metadata (static_cast<uint64_t> (Simulator::GetSystemId ()) << 32 | m_globalUid++, size),
     m_nixVector (0)
 {
-  m_globalUid++;
+  m_accounted = AllocatePacket ();
   m_buffer.AddAtStart (size);
   Buffer::Iterator i = m_buffer.Begin ();
   i.Write (buffer, size);
@@ -221,6 +270,7 @@ Packet::Packet (const Buffer &buffer,  const ByteTagList &byteTagList,
     m_metadata (metadata),
     m_nixVector (0)
 {
+  m_accounted = AllocatePacket ();
 }
 
 Ptr<Packet>
@@ -21,6 +21,7 @@
 #define PACKET_H
 
 #include <stdint.h>
+#include <atomic>
 #include "buffer.h"
 #include "header.h"
 #include "trailer.h"
@@ -248,6 +249,10 @@ public:
    * \return the copied object
    */
   Packet &operator = (const Packet &o);
+  /**
+   * \brief Destructor
+   */
+  ~Packet ();
   /**
    * \brief Create a packet with a zero-filled payload.
    *
@@ -756,7 +761,9 @@ private:
   /* Please see comments above about nix-vector */
   Ptr<NixVector> m_nixVector; //!< the packet's Nix vector
 
-  static uint32_t m_globalUid; //!< Global counter of packets Uid
+  bool m_accounted; //!< whether the packet is counted in MemoryAccounting
+
+  static std::atomic<uint32_t> m_globalUid; //!< Global counter of packets Uid, shared by the threads of MultithreadedSimulatorImpl
 };
 
 /**
@@ -29,6 +29,7 @@
 #include "ns3/string.h"
 #include "ns3/pointer.h"
 #include <cmath>
+#include <limits>
 
 namespace ns3 {
 
@@ -49,7 +50,8 @@ PropagationLossModel::GetTypeId (void)
 }
 
 PropagationLossModel::PropagationLossModel ()
-  : m_next (0)
+  : m_next (0),
+    m_changes (0)
 {
 }
 
@@ -61,6 +63,24 @@ void
 PropagationLossModel::SetNext (Ptr<PropagationLossModel> next)
 {
   m_next = next;
+  NotifyChange ();
+}
+
+uint32_t
+PropagationLossModel::GetChanges (void) const
+{
+  uint32_t changes = 0;
+  for (const PropagationLossModel *model = this; model != 0; model = PeekPointer (model->m_next))
+    {
+      changes += model->m_changes;
+    }
+  return changes;
+}
+
+void
+PropagationLossModel::NotifyChange (void)
+{
+  m_changes++;
 }
 
 Ptr<PropagationLossModel>
@@ -82,6 +102,145 @@ PropagationLossModel::CalcRxPower (double txPowerDbm,
   return self;
 }
 
+double
+PropagationLossModel::CalcRxPowerBound (double txPowerDbm, double distance) const
+{
+  double self = DoCalcRxPowerBound (txPowerDbm, distance);
+  if (m_next != 0)
+    {
+      self = m_next->CalcRxPowerBound (self, distance);
+    }
+  return self;
+}
+
+double
+PropagationLossModel::DoCalcRxPowerBound (double txPowerDbm, double distance) const
+{
+  return std::numeric_limits<double>::infinity ();
+}
+
+bool
+PropagationLossModel::IsDeterministic (void) const
+{
+  return DoIsDeterministic ();
+}
+
+bool
+PropagationLossModel::DoIsDeterministic (void) const
+{
+  return false;
+}
+
+double
+PropagationLossModel::CalcRxPowerUntil (double txPowerDbm,
+                                        Ptr<MobilityModel> a,
+                                        Ptr<MobilityModel> b,
+                                        Ptr<const PropagationLossModel> last) const
+{
+  if (this == PeekPointer (last))
+    {
+      return txPowerDbm;
+    }
+  double self = DoCalcRxPower (txPowerDbm, a, b);
+  if (m_next != 0)
+    {
+      self = m_next->CalcRxPowerUntil (self, a, b, last);
+    }
+  return self;
+}
+
+bool
+PropagationLossModel::IsBatchSupported (void) const
+{
+  for (const PropagationLossModel *model = this; model != 0; model = PeekPointer (model->m_next))
+    {
+      if (!model->DoIsBatchSupported ())
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+bool
+PropagationLossModel::DoIsBatchSupported (void) const
+{
+  return false;
+}
+
+void
+PropagationLossModel::CalcRxPowers (double txPowerDbm, const Vector &a, const Vector *b,
+                                    double *rxPowerDbm, uint32_t n) const
+{
+  NS_LOG_FUNCTION (this << txPowerDbm << a << n);
+  NS_ASSERT (IsBatchSupported ());
+  // Per thread rather than per model, as a model may be shared by the
+  // channels of partitions run in parallel.
+  static thread_local std::vector<double> g_distances;
+  g_distances.resize (n);
+  double *distances = n > 0 ? &g_distances[0] : 0;
+  // As MobilityModel::GetDistanceFrom(), kept free of calls to vectorize
+  for (uint32_t i = 0; i < n; i++)
+    {
+      double x = b[i].x - a.x;
+      double y = b[i].y - a.y;
+      double z = b[i].z - a.z;
+      distances[i] = std::sqrt (x * x + y * y + z * z);
+    }
+  for (uint32_t i = 0; i < n; i++)
+    {
+      rxPowerDbm[i] = txPowerDbm;
+    }
+  for (const PropagationLossModel *model = this; model != 0; model = PeekPointer (model->m_next))
+    {
+      model->DoCalcRxPowers (a, b, distances, rxPowerDbm, n);
+    }
+}
+
+void
+PropagationLossModel::DoCalcRxPowers (const Vector &a, const Vector *b, const double *distances,
+                                      double *rxPowerDbm, uint32_t n) const
+{
+  NS_FATAL_ERROR ("The batch Rx Powers are not supported by " << GetInstanceTypeId ().GetName ());
+}
+
+double
+PropagationLossModel::GetMaxRange (double txPowerDbm, double rxPowerDbm) const
+{
+  NS_LOG_FUNCTION (this << txPowerDbm << rxPowerDbm);
+  if (CalcRxPowerBound (txPowerDbm, 0) < rxPowerDbm)
+    {
+      return 0;
+    }
+  /* The bound does not increase with the distance: find a distance
+   * where it is below the threshold, then bisect. */
+  double near = 0;
+  double far = 1;
+  while (CalcRxPowerBound (txPowerDbm, far) >= rxPowerDbm)
+    {
+      near = far;
+      far *= 2;
+      if (far > 1e9)
+        {
+          return std::numeric_limits<double>::infinity ();
+        }
+    }
+  while (far - near > 1e-3)
+    {
+      double middle = (near + far) / 2;
+      if (CalcRxPowerBound (txPowerDbm, middle) < rxPowerDbm)
+        {
+          far = middle;
+        }
+      else
+        {
+          near = middle;
+        }
+    }
+  NS_LOG_DEBUG ("range=" << far << "m");
+  return far;
+}
+
 int64_t
 PropagationLossModel::AssignStreams (int64_t stream)
 {
@@ -131,6 +290,30 @@ RandomPropagationLossModel::DoCalcRxPower (double txPowerDbm,
   return txPowerDbm + rxc;
 }
 
+bool
+RandomPropagationLossModel::DoIsBatchSupported (void) const
+{
+  return true;
+}
+
+void
+RandomPropagationLossModel::DoCalcRxPowers (const Vector &a, const Vector *b, const double *distances,
+                                            double *rxPowerDbm, uint32_t n) const
+{
+  // The same draws as n calls to DoCalcRxPower(), in one call to the stream
+  static thread_local std::vector<double> g_losses;
+  g_losses.resize (n);
+  if (n == 0)
+    {
+      return;
+    }
+  m_variable->GetValues (&g_losses[0], n);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      rxPowerDbm[i] = rxPowerDbm[i] - g_losses[i];
+    }
+}
+
 int64_t
 RandomPropagationLossModel::DoAssignStreams (int64_t stream)
 {
@@ -271,6 +454,51 @@ FriisPropagationLossModel::DoCalcRxPower (double txPowerDbm,
   return txPowerDbm - std::max (lossDb, m_minLoss);
 }
 
+double
+FriisPropagationLossModel::DoCalcRxPowerBound (double txPowerDbm, double distance) const
+{
+  if (distance <= 0)
+    {
+      return txPowerDbm - m_minLoss;
+    }
+  double numerator = m_lambda * m_lambda;
+  double denominator = 16 * M_PI * M_PI * distance * distance * m_systemLoss;
+  double lossDb = -10 * log10 (numerator / denominator);
+  return txPowerDbm - std::max (lossDb, m_minLoss);
+}
+
+bool
+FriisPropagationLossModel::DoIsDeterministic (void) const
+{
+  return true;
+}
+
+bool
+FriisPropagationLossModel::DoIsBatchSupported (void) const
+{
+  return true;
+}
+
+void
+FriisPropagationLossModel::DoCalcRxPowers (const Vector &a, const Vector *b, const double *distances,
+                                           double *rxPowerDbm, uint32_t n) const
+{
+  // Same operations as DoCalcRxPower(), for the same results
+  double numerator = m_lambda * m_lambda;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      double distance = distances[i];
+      if (distance <= 0)
+        {
+          rxPowerDbm[i] = rxPowerDbm[i] - m_minLoss;
+          continue;
+        }
+      double denominator = 16 * M_PI * M_PI * distance * distance * m_systemLoss;
+      double lossDb = -10 * log10 (numerator / denominator);
+      rxPowerDbm[i] = rxPowerDbm[i] - std::max (lossDb, m_minLoss);
+    }
+}
+
 int64_t
 FriisPropagationLossModel::DoAssignStreams (int64_t stream)
 {
@@ -445,6 +673,52 @@ TwoRayGroundPropagationLossModel::DoCalcRxPower (double txPowerDbm,
     }
 }
 
+bool
+TwoRayGroundPropagationLossModel::DoIsDeterministic (void) const
+{
+  return true;
+}
+
+bool
+TwoRayGroundPropagationLossModel::DoIsBatchSupported (void) const
+{
+  return true;
+}
+
+void
+TwoRayGroundPropagationLossModel::DoCalcRxPowers (const Vector &a, const Vector *b, const double *distances,
+                                                  double *rxPowerDbm, uint32_t n) const
+{
+  // Same operations as DoCalcRxPower(), for the same results
+  double txAntHeight = a.z + m_heightAboveZ;
+  double numerator = m_lambda * m_lambda;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      double distance = distances[i];
+      if (distance <= m_minDistance)
+        {
+          continue;
+        }
+      double rxAntHeight = b[i].z + m_heightAboveZ;
+      double dCross = (4 * M_PI * txAntHeight * rxAntHeight) / m_lambda;
+      double tmp;
+      if (distance <= dCross)
+        {
+          tmp = M_PI * distance;
+          double denominator = 16 * tmp * tmp * m_systemLoss;
+          rxPowerDbm[i] = rxPowerDbm[i] + 10 * std::log10 (numerator / denominator);
+        }
+      else
+        {
+          tmp = txAntHeight * rxAntHeight;
+          double rayNumerator = tmp * tmp;
+          tmp = distance * distance;
+          double rayDenominator = tmp * tmp * m_systemLoss;
+          rxPowerDbm[i] = rxPowerDbm[i] + 10 * std::log10 (rayNumerator / rayDenominator);
+        }
+    }
+}
+
 int64_t
 TwoRayGroundPropagationLossModel::DoAssignStreams (int64_t stream)
 {
@@ -534,6 +808,51 @@ LogDistancePropagationLossModel::DoCalcRxPower (double txPowerDbm,
   return txPowerDbm + rxc;
 }
 
+double
+LogDistancePropagationLossModel::DoCalcRxPowerBound (double txPowerDbm, double distance) const
+{
+  if (m_exponent < 0)
+    {
+      return std::numeric_limits<double>::infinity ();
+    }
+  if (distance <= m_referenceDistance)
+    {
+      return txPowerDbm - m_referenceLoss;
+    }
+  double pathLossDb = 10 * m_exponent * std::log10 (distance / m_referenceDistance);
+  return txPowerDbm - m_referenceLoss - pathLossDb;
+}
+
+bool
+LogDistancePropagationLossModel::DoIsDeterministic (void) const
+{
+  return true;
+}
+
+bool
+LogDistancePropagationLossModel::DoIsBatchSupported (void) const
+{
+  return true;
+}
+
+void
+LogDistancePropagationLossModel::DoCalcRxPowers (const Vector &a, const Vector *b, const double *distances,
+                                                 double *rxPowerDbm, uint32_t n) const
+{
+  // Same operations as DoCalcRxPower(), for the same results
+  for (uint32_t i = 0; i < n; i++)
+    {
+      if (distances[i] <= m_referenceDistance)
+        {
+          rxPowerDbm[i] = rxPowerDbm[i] - m_referenceLoss;
+          continue;
+        }
+      double pathLossDb = 10 * m_exponent * std::log10 (distances[i] / m_referenceDistance);
+      double rxc = -m_referenceLoss - pathLossDb;
+      rxPowerDbm[i] = rxPowerDbm[i] + rxc;
+    }
+}
+
 int64_t
 LogDistancePropagationLossModel::DoAssignStreams (int64_t stream)
 {
@@ -636,6 +955,84 @@ ThreeLogDistancePropagationLossModel::DoCalcRxPower (double txPowerDbm,
   return txPowerDbm - pathLossDb;
 }
 
+double
+ThreeLogDistancePropagationLossModel::DoCalcRxPowerBound (double txPowerDbm, double distance) const
+{
+  if (m_exponent0 < 0 || m_exponent1 < 0 || m_exponent2 < 0)
+    {
+      return std::numeric_limits<double>::infinity ();
+    }
+  if (distance < m_distance0)
+    {
+      // No loss up to d0, then the reference loss.
+      return txPowerDbm - std::min (0.0, m_referenceLoss);
+    }
+  double pathLossDb = m_referenceLoss;
+  if (distance < m_distance1)
+    {
+      pathLossDb += 10 * m_exponent0 * std::log10 (distance / m_distance0);
+    }
+  else if (distance < m_distance2)
+    {
+      pathLossDb += 10 * m_exponent0 * std::log10 (m_distance1 / m_distance0)
+        + 10 * m_exponent1 * std::log10 (distance / m_distance1);
+    }
+  else
+    {
+      pathLossDb += 10 * m_exponent0 * std::log10 (m_distance1 / m_distance0)
+        + 10 * m_exponent1 * std::log10 (m_distance2 / m_distance1)
+        + 10 * m_exponent2 * std::log10 (distance / m_distance2);
+    }
+  return txPowerDbm - pathLossDb;
+}
+
+bool
+ThreeLogDistancePropagationLossModel::DoIsDeterministic (void) const
+{
+  return true;
+}
+
+bool
+ThreeLogDistancePropagationLossModel::DoIsBatchSupported (void) const
+{
+  return true;
+}
+
+void
+ThreeLogDistancePropagationLossModel::DoCalcRxPowers (const Vector &a, const Vector *b, const double *distances,
+                                                      double *rxPowerDbm, uint32_t n) const
+{
+  // Same operations as DoCalcRxPower(), for the same results
+  for (uint32_t i = 0; i < n; i++)
+    {
+      double distance = distances[i];
+      double pathLossDb;
+      if (distance < m_distance0)
+        {
+          pathLossDb = 0;
+        }
+      else if (distance < m_distance1)
+        {
+          pathLossDb = m_referenceLoss
+            + 10 * m_exponent0 * std::log10 (distance / m_distance0);
+        }
+      else if (distance < m_distance2)
+        {
+          pathLossDb = m_referenceLoss
+            + 10 * m_exponent0 * std::log10 (m_distance1 / m_distance0)
+            + 10 * m_exponent1 * std::log10 (distance / m_distance1);
+        }
+      else
+        {
+          pathLossDb = m_referenceLoss
+            + 10 * m_exponent0 * std::log10 (m_distance1 / m_distance0)
+            + 10 * m_exponent1 * std::log10 (m_distance2 / m_distance1)
+            + 10 * m_exponent2 * std::log10 (distance / m_distance2);
+        }
+      rxPowerDbm[i] = rxPowerDbm[i] - pathLossDb;
+    }
+}
+
 int64_t
 ThreeLogDistancePropagationLossModel::DoAssignStreams (int64_t stream)
 {
@@ -798,6 +1195,18 @@ FixedRssLossModel::DoCalcRxPower (double txPowerDbm,
   return m_rss;
 }
 
+double
+FixedRssLossModel::DoCalcRxPowerBound (double txPowerDbm, double distance) const
+{
+  return m_rss;
+}
+
+bool
+FixedRssLossModel::DoIsDeterministic (void) const
+{
+  return true;
+}
+
 int64_t
 FixedRssLossModel::DoAssignStreams (int64_t stream)
 {
@@ -817,7 +1226,8 @@ MatrixPropagationLossModel::GetTypeId (void)
     .AddConstructor<MatrixPropagationLossModel> ()
     .AddAttribute ("DefaultLoss", "The default value for propagation loss, dB.",
                    DoubleValue (std::numeric_limits<double>::max ()),
-                   MakeDoubleAccessor (&MatrixPropagationLossModel::m_default),
+                   MakeDoubleAccessor (&MatrixPropagationLossModel::SetDefaultLoss,
+                                       &MatrixPropagationLossModel::GetDefaultLoss),
                    MakeDoubleChecker<double> ())
   ;
   return tid;
@@ -836,6 +1246,13 @@ void
 MatrixPropagationLossModel::SetDefaultLoss (double loss)
 {
   m_default = loss;
+  NotifyChange ();
+}
+
+double
+MatrixPropagationLossModel::GetDefaultLoss (void) const
+{
+  return m_default;
 }
 
 void
@@ -854,6 +1271,7 @@ MatrixPropagationLossModel::SetLoss (Ptr<MobilityModel> ma, Ptr<MobilityModel> m
     {
       i->second = loss;
     }
+  NotifyChange ();
 
   if (symmetric)
     {
@@ -878,6 +1296,12 @@ MatrixPropagationLossModel::DoCalcRxPower (double txPowerDbm,
     }
 }
 
+bool
+MatrixPropagationLossModel::DoIsDeterministic (void) const
+{
+  return true;
+}
+
 int64_t
 MatrixPropagationLossModel::DoAssignStreams (int64_t stream)
 {
@@ -924,6 +1348,41 @@ RangePropagationLossModel::DoCalcRxPower (double txPowerDbm,
     }
 }
 
+double
+RangePropagationLossModel::DoCalcRxPowerBound (double txPowerDbm, double distance) const
+{
+  if (distance <= m_range)
+    {
+      return txPowerDbm;
+    }
+  else
+    {
+      return -1000;
+    }
+}
+
+bool
+RangePropagationLossModel::DoIsDeterministic (void) const
+{
+  return true;
+}
+
+bool
+RangePropagationLossModel::DoIsBatchSupported (void) const
+{
+  return true;
+}
+
+void
+RangePropagationLossModel::DoCalcRxPowers (const Vector &a, const Vector *b, const double *distances,
+                                           double *rxPowerDbm, uint32_t n) const
+{
+  for (uint32_t i = 0; i < n; i++)
+    {
+      rxPowerDbm[i] = distances[i] <= m_range ? rxPowerDbm[i] : -1000;
+    }
+}
+
 int64_t
 RangePropagationLossModel::DoAssignStreams (int64_t stream)
 {
@@ -27,7 +27,9 @@
 
 #include "ns3/object.h"
 #include "ns3/random-variable-stream.h"
+#include "ns3/vector.h"
 #include <map>
+#include <vector>
 
 namespace ns3 {
 
@@ -93,6 +95,72 @@ public:
                       Ptr<MobilityModel> a,
                       Ptr<MobilityModel> b) const;
 
+  /**
+   * Returns a distance beyond which the Rx Power, taking into account
+   * all the PropagationLossModel(s) chained to the current one, is
+   * always below a threshold.
+   *
+   * The range is infinite as soon as one model of the chain does not
+   * bound its Rx Power by a function of the distance, e.g. because it
+   * is random or depends on the antenna heights.
+   *
+   * \param txPowerDbm the transmission power (in dBm)
+   * \param rxPowerDbm the threshold (in dBm)
+   * \returns the range (in m), within a millimeter
+   */
+  double GetMaxRange (double txPowerDbm, double rxPowerDbm) const;
+
+  /**
+   * \returns true if the Rx Power of this particular model is a function
+   * of the transmission power and of the positions only, that callers
+   * may cache for static nodes
+   */
+  bool IsDeterministic (void) const;
+
+  /**
+   * Returns the Rx Power taking into account the PropagationLossModel(s)
+   * chained to the current one, up to a given model of the chain.
+   *
+   * \param txPowerDbm current transmission power (in dBm)
+   * \param a the mobility model of the source
+   * \param b the mobility model of the destination
+   * \param last the first model of the chain not taken into account,
+   *        or 0 to take them all into account
+   * \returns the reception power after adding/multiplying propagation loss (in dBm)
+   */
+  double CalcRxPowerUntil (double txPowerDbm,
+                           Ptr<MobilityModel> a,
+                           Ptr<MobilityModel> b,
+                           Ptr<const PropagationLossModel> last) const;
+
+  /**
+   * \returns true if all the PropagationLossModel(s) chained to the
+   * current one can compute the Rx Powers of several receivers at once,
+   * from the positions only, with CalcRxPowers()
+   */
+  bool IsBatchSupported (void) const;
+
+  /**
+   * Returns the Rx Powers of a transmission to several receivers, taking
+   * into account all the PropagationLossModel(s) chained to the current
+   * one.  The distances are computed once for the whole chain, and each
+   * model processes all the receivers in turn.  The powers are those of
+   * CalcRxPower() for mobility models at the same positions.  Only valid
+   * if IsBatchSupported() is true.
+   *
+   * The random models draw the losses of the destinations in order, as
+   * many CalcRxPower() calls would: to get the same values, pass only the
+   * destinations CalcRxPower() would be called for, in the same order.
+   *
+   * \param txPowerDbm current transmission power (in dBm)
+   * \param a the position of the source
+   * \param b the positions of the destinations
+   * \param rxPowerDbm the reception powers of the destinations (in dBm)
+   * \param n the number of destinations
+   */
+  void CalcRxPowers (double txPowerDbm, const Vector &a, const Vector *b,
+                     double *rxPowerDbm, uint32_t n) const;
+
   /**
    * If this loss model uses objects of type RandomVariableStream,
    * set the stream numbers to the integers starting with the offset
@@ -106,6 +174,21 @@ public:
    */
   int64_t AssignStreams (int64_t stream);
 
+  /**
+   * \returns the number of changes of the models chained to the current
+   * one, which invalidate the Rx Powers computed before, e.g. by the
+   * callers caching the deterministic models
+   */
+  uint32_t GetChanges (void) const;
+
+protected:
+  /**
+   * Notify that the Rx Powers of this model changed, for a given
+   * transmission power and positions.  The models changing after their
+   * first use must call it.
+   */
+  void NotifyChange (void);
+
 private:
   /**
    * \brief Copy constructor
@@ -134,6 +217,53 @@ private:
                                 Ptr<MobilityModel> a,
                                 Ptr<MobilityModel> b) const = 0;
 
+  /**
+   * Returns an upper bound of the Rx Power taking into account all
+   * the PropagationLossModel(s) chained to the current one.
+   *
+   * \param txPowerDbm current transmission power (in dBm)
+   * \param distance the distance between the source and the destination (in m)
+   * \returns the bound of the reception power (in dBm)
+   */
+  double CalcRxPowerBound (double txPowerDbm, double distance) const;
+
+  /**
+   * Returns an upper bound of the Rx Power of this particular model,
+   * over all the distances beyond the given one.  The default bound is
+   * infinite, which disables the range computation of GetMaxRange().
+   *
+   * \param txPowerDbm current transmission power (in dBm)
+   * \param distance the distance between the source and the destination (in m)
+   * \returns the bound of the reception power (in dBm)
+   */
+  virtual double DoCalcRxPowerBound (double txPowerDbm, double distance) const;
+
+  /**
+   * \returns true if the Rx Power of this particular model is a function
+   * of the transmission power and of the positions only.  The default
+   * is false.
+   */
+  virtual bool DoIsDeterministic (void) const;
+
+  /**
+   * \returns true if this particular model implements DoCalcRxPowers().
+   * The default is false.
+   */
+  virtual bool DoIsBatchSupported (void) const;
+
+  /**
+   * Updates the Rx Powers of several receivers with the loss of this
+   * particular model only.  Called only if DoIsBatchSupported() is true.
+   *
+   * \param a the position of the source
+   * \param b the positions of the destinations
+   * \param distances the distances between the source and the destinations (in m)
+   * \param rxPowerDbm the powers before (in) and after (out) the loss of this model (in dBm)
+   * \param n the number of destinations
+   */
+  virtual void DoCalcRxPowers (const Vector &a, const Vector *b, const double *distances,
+                               double *rxPowerDbm, uint32_t n) const;
+
   /**
    * Subclasses must implement this; those not using random variables
    * can return zero
@@ -141,6 +271,7 @@ private:
   virtual int64_t DoAssignStreams (int64_t stream) = 0;
 
   Ptr<PropagationLossModel> m_next; //!< Next propagation loss model in the list
+  uint32_t m_changes;               //!< The number of changes of this model
 };
 
 /**
@@ -177,6 +308,9 @@ private:
   virtual double DoCalcRxPower (double txPowerDbm,
                                 Ptr<MobilityModel> a,
                                 Ptr<MobilityModel> b) const;
+  virtual bool DoIsBatchSupported (void) const;
+  virtual void DoCalcRxPowers (const Vector &a, const Vector *b, const double *distances,
+                               double *rxPowerDbm, uint32_t n) const;
   virtual int64_t DoAssignStreams (int64_t stream);
   Ptr<RandomVariableStream> m_variable; //!< random generator
 };
@@ -321,6 +455,11 @@ private:
   virtual double DoCalcRxPower (double txPowerDbm,
                                 Ptr<MobilityModel> a,
                                 Ptr<MobilityModel> b) const;
+  virtual double DoCalcRxPowerBound (double txPowerDbm, double distance) const;
+  virtual bool DoIsDeterministic (void) const;
+  virtual bool DoIsBatchSupported (void) const;
+  virtual void DoCalcRxPowers (const Vector &a, const Vector *b, const double *distances,
+                               double *rxPowerDbm, uint32_t n) const;
   virtual int64_t DoAssignStreams (int64_t stream);
 
   /**
@@ -441,6 +580,10 @@ private:
   virtual double DoCalcRxPower (double txPowerDbm,
                                 Ptr<MobilityModel> a,
                                 Ptr<MobilityModel> b) const;
+  virtual bool DoIsDeterministic (void) const;
+  virtual bool DoIsBatchSupported (void) const;
+  virtual void DoCalcRxPowers (const Vector &a, const Vector *b, const double *distances,
+                               double *rxPowerDbm, uint32_t n) const;
   virtual int64_t DoAssignStreams (int64_t stream);
 
   /**
@@ -529,6 +672,11 @@ private:
   virtual double DoCalcRxPower (double txPowerDbm,
                                 Ptr<MobilityModel> a,
                                 Ptr<MobilityModel> b) const;
+  virtual double DoCalcRxPowerBound (double txPowerDbm, double distance) const;
+  virtual bool DoIsDeterministic (void) const;
+  virtual bool DoIsBatchSupported (void) const;
+  virtual void DoCalcRxPowers (const Vector &a, const Vector *b, const double *distances,
+                               double *rxPowerDbm, uint32_t n) const;
   virtual int64_t DoAssignStreams (int64_t stream);
 
   /**
@@ -612,6 +760,11 @@ private:
   virtual double DoCalcRxPower (double txPowerDbm,
                                 Ptr<MobilityModel> a,
                                 Ptr<MobilityModel> b) const;
+  virtual double DoCalcRxPowerBound (double txPowerDbm, double distance) const;
+  virtual bool DoIsDeterministic (void) const;
+  virtual bool DoIsBatchSupported (void) const;
+  virtual void DoCalcRxPowers (const Vector &a, const Vector *b, const double *distances,
+                               double *rxPowerDbm, uint32_t n) const;
   virtual int64_t DoAssignStreams (int64_t stream);
 
   double m_distance0; //!< Beginning of the first (near) distance field
@@ -745,6 +898,8 @@ private:
   virtual double DoCalcRxPower (double txPowerDbm,
                                 Ptr<MobilityModel> a,
                                 Ptr<MobilityModel> b) const;
+  virtual double DoCalcRxPowerBound (double txPowerDbm, double distance) const;
+  virtual bool DoIsDeterministic (void) const;
 
   virtual int64_t DoAssignStreams (int64_t stream);
   double m_rss; //!< the received signal strength
@@ -786,6 +941,11 @@ public:
    */
   void SetDefaultLoss (double defaultLoss);
 
+  /**
+   * \returns the default propagation loss (in dB, positive)
+   */
+  double GetDefaultLoss (void) const;
+
 private:
   /**
    * \brief Copy constructor
@@ -804,6 +964,7 @@ private:
   virtual double DoCalcRxPower (double txPowerDbm,
                                 Ptr<MobilityModel> a,
                                 Ptr<MobilityModel> b) const;
+  virtual bool DoIsDeterministic (void) const;
 
   virtual int64_t DoAssignStreams (int64_t stream);
 private:
@@ -851,6 +1012,11 @@ private:
   virtual double DoCalcRxPower (double txPowerDbm,
                                 Ptr<MobilityModel> a,
                                 Ptr<MobilityModel> b) const;
+  virtual double DoCalcRxPowerBound (double txPowerDbm, double distance) const;
+  virtual bool DoIsDeterministic (void) const;
+  virtual bool DoIsBatchSupported (void) const;
+  virtual void DoCalcRxPowers (const Vector &a, const Vector *b, const double *distances,
+                               double *rxPowerDbm, uint32_t n) const;
   virtual int64_t DoAssignStreams (int64_t stream);
 private:
   double m_range; //!< Maximum Transmission Range (meters)
@@ -25,6 +25,10 @@
 #include "ns3/constant-position-mobility-model.h"
 #include "ns3/simulator.h"
 
+#include <cmath>
+#include <limits>
+#include <vector>
+
 using namespace ns3;
 
 NS_LOG_COMPONENT_DEFINE ("PropagationLossModelsTest");
@@ -436,6 +440,167 @@ RangePropagationLossModelTestCase::DoRun (void)
   Simulator::Destroy ();
 }
 
+class MaxRangePropagationLossModelTestCase : public TestCase
+{
+public:
+  MaxRangePropagationLossModelTestCase ();
+  virtual ~MaxRangePropagationLossModelTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+MaxRangePropagationLossModelTestCase::MaxRangePropagationLossModelTestCase ()
+  : TestCase ("Test PropagationLossModel::GetMaxRange")
+{
+}
+
+MaxRangePropagationLossModelTestCase::~MaxRangePropagationLossModelTestCase ()
+{
+}
+
+void
+MaxRangePropagationLossModelTestCase::DoRun (void)
+{
+  Ptr<MobilityModel> a = CreateObject<ConstantPositionMobilityModel> ();
+  a->SetPosition (Vector (0,0,0));
+  Ptr<MobilityModel> b = CreateObject<ConstantPositionMobilityModel> ();
+
+  double txPwrdBm = 16.0206;
+  double thresholddBm = -116.0;
+  double tolerance = 2e-3;
+
+  // rx = tx - L0 - 10 n log10 (d / d0)
+  Ptr<LogDistancePropagationLossModel> logDistance = CreateObject<LogDistancePropagationLossModel> ();
+  logDistance->SetPathLossExponent (3.0);
+  logDistance->SetReference (1.0, 46.6777);
+  double expected = std::pow (10.0, (txPwrdBm - 46.6777 - thresholddBm) / 30.0);
+  double range = logDistance->GetMaxRange (txPwrdBm, thresholddBm);
+  NS_TEST_EXPECT_MSG_EQ_TOL (range, expected, tolerance, "Got unexpected range");
+  b->SetPosition (Vector (range, 0, 0));
+  NS_TEST_EXPECT_MSG_LT (logDistance->CalcRxPower (txPwrdBm, a, b), thresholddBm, "Rx power above the threshold at the range");
+  NS_TEST_EXPECT_MSG_EQ (logDistance->GetMaxRange (txPwrdBm, txPwrdBm), 0, "Got unexpected range");
+
+  // The range of a chain is the shortest range
+  Config::SetDefault ("ns3::RangePropagationLossModel::MaxRange", DoubleValue (127.2));
+  Ptr<RangePropagationLossModel> rangeModel = CreateObject<RangePropagationLossModel> ();
+  NS_TEST_EXPECT_MSG_EQ_TOL (rangeModel->GetMaxRange (txPwrdBm, thresholddBm), 127.2, tolerance, "Got unexpected range");
+  logDistance->SetNext (rangeModel);
+  NS_TEST_EXPECT_MSG_EQ_TOL (logDistance->GetMaxRange (txPwrdBm, thresholddBm), 127.2, tolerance, "Got unexpected range");
+  NS_TEST_EXPECT_MSG_EQ_TOL (logDistance->GetMaxRange (txPwrdBm, -60.0), std::pow (10.0, (txPwrdBm - 46.6777 + 60.0) / 30.0),
+                             tolerance, "Got unexpected range");
+
+  // Random models do not bound the rx power
+  Ptr<NakagamiPropagationLossModel> nakagami = CreateObject<NakagamiPropagationLossModel> ();
+  rangeModel->SetNext (nakagami);
+  NS_TEST_EXPECT_MSG_EQ (logDistance->GetMaxRange (txPwrdBm, thresholddBm), std::numeric_limits<double>::infinity (),
+                         "Got unexpected range");
+  Simulator::Destroy ();
+}
+
+class BatchPropagationLossModelTestCase : public TestCase
+{
+public:
+  BatchPropagationLossModelTestCase ();
+  virtual ~BatchPropagationLossModelTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Check that the batch Rx Powers of a chain are those of CalcRxPower()
+   * \param model the first model of the chain
+   */
+  void CheckChain (Ptr<PropagationLossModel> model);
+};
+
+BatchPropagationLossModelTestCase::BatchPropagationLossModelTestCase ()
+  : TestCase ("Test PropagationLossModel::CalcRxPowers")
+{
+}
+
+BatchPropagationLossModelTestCase::~BatchPropagationLossModelTestCase ()
+{
+}
+
+void
+BatchPropagationLossModelTestCase::CheckChain (Ptr<PropagationLossModel> model)
+{
+  NS_TEST_ASSERT_MSG_EQ (model->IsBatchSupported (), true, "Batch not supported");
+  Ptr<MobilityModel> a = CreateObject<ConstantPositionMobilityModel> ();
+  a->SetPosition (Vector (3, -2, 1.5));
+  Ptr<MobilityModel> b = CreateObject<ConstantPositionMobilityModel> ();
+  const uint32_t n = 200;
+  std::vector<Vector> positions;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      // From the same position to beyond 2 km, with various heights
+      positions.push_back (Vector (3 + i * i * 0.05, -2 + i * 0.5, (i % 4) * 2.0));
+    }
+  double txPwrdBm = 16.0206;
+  double rxPowers[n];
+  model->CalcRxPowers (txPwrdBm, a->GetPosition (), &positions[0], rxPowers, n);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      b->SetPosition (positions[i]);
+      NS_TEST_EXPECT_MSG_EQ (rxPowers[i], model->CalcRxPower (txPwrdBm, a, b),
+                             "Got unexpected batch rcv power at " << positions[i]);
+    }
+}
+
+void
+BatchPropagationLossModelTestCase::DoRun (void)
+{
+  CheckChain (CreateObject<FriisPropagationLossModel> ());
+  Ptr<TwoRayGroundPropagationLossModel> twoRay = CreateObject<TwoRayGroundPropagationLossModel> ();
+  twoRay->SetHeightAboveZ (1.0);
+  CheckChain (twoRay);
+  CheckChain (CreateObject<LogDistancePropagationLossModel> ());
+  CheckChain (CreateObject<ThreeLogDistancePropagationLossModel> ());
+  CheckChain (CreateObject<RangePropagationLossModel> ());
+
+  Ptr<LogDistancePropagationLossModel> chain = CreateObject<LogDistancePropagationLossModel> ();
+  Ptr<RangePropagationLossModel> range = CreateObject<RangePropagationLossModel> ();
+  range->SetAttribute ("MaxRange", DoubleValue (500.0));
+  chain->SetNext (range);
+  range->SetNext (CreateObject<FriisPropagationLossModel> ());
+  CheckChain (chain);
+
+  // The random model draws the losses as in one CalcRxPower() per destination
+  Ptr<PropagationLossModel> batch = CreateObject<LogDistancePropagationLossModel> ();
+  batch->SetNext (CreateObject<RandomPropagationLossModel> ());
+  batch->AssignStreams (1);
+  Ptr<PropagationLossModel> scalar = CreateObject<LogDistancePropagationLossModel> ();
+  scalar->SetNext (CreateObject<RandomPropagationLossModel> ());
+  scalar->AssignStreams (1);
+  NS_TEST_EXPECT_MSG_EQ (batch->IsBatchSupported (), true, "Batch not supported by the random model");
+  Ptr<MobilityModel> a = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<MobilityModel> b = CreateObject<ConstantPositionMobilityModel> ();
+  const uint32_t n = 50;
+  std::vector<Vector> positions;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      positions.push_back (Vector (1 + i * 10.0, 0, 0));
+    }
+  double rxPowers[n];
+  for (uint32_t round = 0; round < 2; round++)
+    {
+      batch->CalcRxPowers (10.0, a->GetPosition (), &positions[0], rxPowers, n);
+      for (uint32_t i = 0; i < n; i++)
+        {
+          b->SetPosition (positions[i]);
+          NS_TEST_EXPECT_MSG_EQ (rxPowers[i], scalar->CalcRxPower (10.0, a, b),
+                                 "Got unexpected random batch rcv power at " << positions[i]);
+        }
+    }
+
+  // The Nakagami model is not supported
+  range->SetNext (CreateObject<NakagamiPropagationLossModel> ());
+  NS_TEST_EXPECT_MSG_EQ (chain->IsBatchSupported (), false, "Batch supported by a random chain");
+  NS_TEST_EXPECT_MSG_EQ (CreateObject<MatrixPropagationLossModel> ()->IsBatchSupported (), false,
+                         "Batch supported by the matrix model");
+  Simulator::Destroy ();
+}
+
 class PropagationLossModelsTestSuite : public TestSuite
 {
 public:
@@ -450,6 +615,8 @@ PropagationLossModelsTestSuite::PropagationLossModelsTestSuite ()
   AddTestCase (new LogDistancePropagationLossModelTestCase, TestCase::QUICK);
   AddTestCase (new MatrixPropagationLossModelTestCase, TestCase::QUICK);
   AddTestCase (new RangePropagationLossModelTestCase, TestCase::QUICK);
+  AddTestCase (new MaxRangePropagationLossModelTestCase, TestCase::QUICK);
+  AddTestCase (new BatchPropagationLossModelTestCase, TestCase::QUICK);
 }
 
 static PropagationLossModelsTestSuite propagationLossModelsTestSuite;
@@ -308,6 +308,33 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
         }
 
 
+      // compute the propagation gains of all the receivers at once, if the model supports it,
+      // in the order and for the receivers of CalcRxPower() below, so that the random models
+      // draw the same values
+      const std::set<Ptr<SpectrumPhy> > &rxPhySet = rxInfoIterator->second.m_rxPhySet;
+      const double *propagationGains = 0;
+      uint32_t propagationGainIndex = 0;
+      if (txMobility && m_propagationLoss && m_propagationLoss->IsBatchSupported ())
+        {
+          m_rxPositions.clear ();
+          for (std::set<Ptr<SpectrumPhy> >::const_iterator rxPhyIterator = rxPhySet.begin ();
+               rxPhyIterator != rxPhySet.end ();
+               ++rxPhyIterator)
+            {
+              Ptr<MobilityModel> receiverMobility = (*rxPhyIterator)->GetMobility ();
+              if ((*rxPhyIterator) != txParams->txPhy && receiverMobility)
+                {
+                  m_rxPositions.push_back (receiverMobility->GetPosition ());
+                }
+            }
+          if (!m_rxPositions.empty ())
+            {
+              m_propagationGains.resize (m_rxPositions.size ());
+              m_propagationLoss->CalcRxPowers (0, txMobility->GetPosition (), &m_rxPositions[0], &m_propagationGains[0], m_rxPositions.size ());
+              propagationGains = &m_propagationGains[0];
+            }
+        }
+
       for (std::set<Ptr<SpectrumPhy> >::const_iterator rxPhyIterator = rxInfoIterator->second.m_rxPhySet.begin ();
            rxPhyIterator != rxInfoIterator->second.m_rxPhySet.end ();
            ++rxPhyIterator)
@@ -344,7 +371,9 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
                     }
                   if (m_propagationLoss)
                     {
-                      double propagationGainDb = m_propagationLoss->CalcRxPower (0, txMobility, receiverMobility);
+                      double propagationGainDb = propagationGains
+                        ? propagationGains[propagationGainIndex++]
+                        : m_propagationLoss->CalcRxPower (0, txMobility, receiverMobility);
                       NS_LOG_LOGIC ("propagationGainDb = " << propagationGainDb << " dB");
                       pathLossDb -= propagationGainDb;
                     }                    
@@ -27,8 +27,10 @@
 #include <ns3/spectrum-channel.h>
 #include <ns3/spectrum-propagation-loss-model.h>
 #include <ns3/propagation-delay-model.h>
+#include <ns3/vector.h>
 #include <map>
 #include <set>
+#include <vector>
 
 namespace ns3 {
 
@@ -207,6 +209,14 @@ private:
    */
   double m_maxLossDb;
 
+  /**
+   * The positions of the receivers, and their propagation gains [dB],
+   * computed at once by StartTx() when the propagation loss model
+   * supports it.
+   */
+  std::vector<Vector> m_rxPositions;
+  std::vector<double> m_propagationGains; //!< The propagation gains of m_rxPositions
+
   /**
    * \deprecated The non-const \c Ptr<SpectrumPhy> argument
    * is deprecated and will be changed to \c Ptr<const SpectrumPhy>
@@ -134,6 +134,32 @@ SingleModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
 
   Ptr<MobilityModel> senderMobility = txParams->txPhy->GetMobility ();
 
+  // compute the propagation gains of all the receivers at once, if the model supports it,
+  // in the order and for the receivers of CalcRxPower() below, so that the random models
+  // draw the same values
+  const double *propagationGains = 0;
+  uint32_t propagationGainIndex = 0;
+  if (senderMobility && m_propagationLoss && m_propagationLoss->IsBatchSupported ())
+    {
+      m_rxPositions.clear ();
+      for (PhyList::const_iterator rxPhyIterator = m_phyList.begin ();
+           rxPhyIterator != m_phyList.end ();
+           ++rxPhyIterator)
+        {
+          Ptr<MobilityModel> receiverMobility = (*rxPhyIterator)->GetMobility ();
+          if ((*rxPhyIterator) != txParams->txPhy && receiverMobility)
+            {
+              m_rxPositions.push_back (receiverMobility->GetPosition ());
+            }
+        }
+      if (!m_rxPositions.empty ())
+        {
+          m_propagationGains.resize (m_rxPositions.size ());
+          m_propagationLoss->CalcRxPowers (0, senderMobility->GetPosition (), &m_rxPositions[0], &m_propagationGains[0], m_rxPositions.size ());
+          propagationGains = &m_propagationGains[0];
+        }
+    }
+
   for (PhyList::const_iterator rxPhyIterator = m_phyList.begin ();
        rxPhyIterator != m_phyList.end ();
        ++rxPhyIterator)
@@ -166,7 +192,9 @@ SingleModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
                 }
               if (m_propagationLoss)
                 {
-                  double propagationGainDb = m_propagationLoss->CalcRxPower (0, senderMobility, receiverMobility);
+                  double propagationGainDb = propagationGains
+                    ? propagationGains[propagationGainIndex++]
+                    : m_propagationLoss->CalcRxPower (0, senderMobility, receiverMobility);
                   NS_LOG_LOGIC ("propagationGainDb = " << propagationGainDb << " dB");
                   pathLossDb -= propagationGainDb;
                 }                    
@@ -0,0 +1,102 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "first-order-radio-energy-model-helper.h"
+#include "ns3/wifi-net-device.h"
+#include "ns3/wifi-phy.h"
+
+namespace ns3 {
+
+FirstOrderRadioEnergyModelHelper::FirstOrderRadioEnergyModelHelper ()
+{
+  m_radioEnergy.SetTypeId ("ns3::FirstOrderRadioEnergyModel");
+  m_depletionCallback.Nullify ();
+  m_rechargedCallback.Nullify ();
+}
+
+FirstOrderRadioEnergyModelHelper::~FirstOrderRadioEnergyModelHelper ()
+{
+}
+
+void
+FirstOrderRadioEnergyModelHelper::Set (std::string name, const AttributeValue &v)
+{
+  m_radioEnergy.Set (name, v);
+}
+
+void
+FirstOrderRadioEnergyModelHelper::SetDepletionCallback (
+  FirstOrderRadioEnergyModel::FirstOrderRadioEnergyCallback callback)
+{
+  m_depletionCallback = callback;
+}
+
+void
+FirstOrderRadioEnergyModelHelper::SetRechargedCallback (
+  FirstOrderRadioEnergyModel::FirstOrderRadioEnergyCallback callback)
+{
+  m_rechargedCallback = callback;
+}
+
+Ptr<DeviceEnergyModel>
+FirstOrderRadioEnergyModelHelper::DoInstall (Ptr<NetDevice> device,
+                                             Ptr<EnergySource> source) const
+{
+  NS_ASSERT (device != NULL);
+  NS_ASSERT (source != NULL);
+  // check if device is WifiNetDevice
+  Ptr<WifiNetDevice> wifiDevice = DynamicCast<WifiNetDevice> (device);
+  if (wifiDevice == 0)
+    {
+      NS_FATAL_ERROR ("NetDevice type is not WifiNetDevice!");
+    }
+  Ptr<FirstOrderRadioEnergyModel> model = m_radioEnergy.Create ()->GetObject<FirstOrderRadioEnergyModel> ();
+  NS_ASSERT (model != NULL);
+
+  // set energy depletion callback
+  // if none is specified, make a callback to WifiPhy::SetOffMode
+  Ptr<WifiPhy> wifiPhy = wifiDevice->GetPhy ();
+  if (m_depletionCallback.IsNull ())
+    {
+      model->SetEnergyDepletionCallback (MakeCallback (&WifiPhy::SetOffMode, wifiPhy));
+    }
+  else
+    {
+      model->SetEnergyDepletionCallback (m_depletionCallback);
+    }
+  // set energy recharged callback
+  // if none is specified, make a callback to WifiPhy::ResumeFromOff
+  if (m_rechargedCallback.IsNull ())
+    {
+      model->SetEnergyRechargedCallback (MakeCallback (&WifiPhy::ResumeFromOff, wifiPhy));
+    }
+  else
+    {
+      model->SetEnergyRechargedCallback (m_rechargedCallback);
+    }
+  // add model to device model list in energy source
+  source->AppendDeviceEnergyModel (model);
+  // set energy source pointer
+  model->SetEnergySource (source);
+  // charge every frame sent or received by the PHY
+  wifiPhy->TraceConnectWithoutContext ("PhyTxBegin",
+                                       MakeCallback (&FirstOrderRadioEnergyModel::NotifyTx, model));
+  wifiPhy->TraceConnectWithoutContext ("PhyRxEnd",
+                                       MakeCallback (&FirstOrderRadioEnergyModel::NotifyRx, model));
+  return model;
+}
+
+} // namespace ns3
@@ -0,0 +1,91 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef FIRST_ORDER_RADIO_ENERGY_MODEL_HELPER_H
+#define FIRST_ORDER_RADIO_ENERGY_MODEL_HELPER_H
+
+#include "ns3/energy-model-helper.h"
+#include "ns3/first-order-radio-energy-model.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup energy
+ * \brief Assign FirstOrderRadioEnergyModel to wifi devices.
+ *
+ * The model is connected to the PhyTxBegin and PhyRxEnd trace sources of the
+ * WifiPhy, so every frame put on or taken from the air is charged once.
+ * This installer installs FirstOrderRadioEnergyModel for only WifiNetDevice
+ * objects.
+ */
+class FirstOrderRadioEnergyModelHelper : public DeviceEnergyModelHelper
+{
+public:
+  /**
+   * Construct a helper which is used to add a first order radio energy model
+   * to a node
+   */
+  FirstOrderRadioEnergyModelHelper ();
+
+  /**
+   * Destroy a FirstOrderRadioEnergyModelHelper
+   */
+  ~FirstOrderRadioEnergyModelHelper ();
+
+  /**
+   * \param name the name of the attribute to set
+   * \param v the value of the attribute
+   *
+   * Sets an attribute of the underlying energy model.
+   */
+  void Set (std::string name, const AttributeValue &v);
+
+  /**
+   * \param callback Callback function for energy depletion handling.
+   *
+   * Sets the callback to be invoked when energy is depleted.
+   */
+  void SetDepletionCallback (
+    FirstOrderRadioEnergyModel::FirstOrderRadioEnergyCallback callback);
+
+  /**
+   * \param callback Callback function for energy recharged handling.
+   *
+   * Sets the callback to be invoked when energy is recharged.
+   */
+  void SetRechargedCallback (
+    FirstOrderRadioEnergyModel::FirstOrderRadioEnergyCallback callback);
+
+private:
+  /**
+   * \param device Pointer to the NetDevice to install DeviceEnergyModel.
+   * \param source Pointer to EnergySource to install.
+   * \returns Ptr<DeviceEnergyModel>
+   *
+   * Implements DeviceEnergyModel::Install.
+   */
+  virtual Ptr<DeviceEnergyModel> DoInstall (Ptr<NetDevice> device,
+                                            Ptr<EnergySource> source) const;
+
+private:
+  ObjectFactory m_radioEnergy; ///< radio energy
+  FirstOrderRadioEnergyModel::FirstOrderRadioEnergyCallback m_depletionCallback; ///< radio energy depletion callback
+  FirstOrderRadioEnergyModel::FirstOrderRadioEnergyCallback m_rechargedCallback; ///< radio energy recharged callback
+};
+
+} // namespace ns3
+
+#endif /* FIRST_ORDER_RADIO_ENERGY_MODEL_HELPER_H */
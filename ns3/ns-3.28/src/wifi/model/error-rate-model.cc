@@ -19,20 +19,187 @@
  */
 
 #include "error-rate-model.h"
+#include "ns3/boolean.h"
+#include "ns3/double.h"
+#include "ns3/log.h"
+#include <cmath>
+#include <mutex>
+#include <sstream>
 
 namespace ns3 {
 
+NS_LOG_COMPONENT_DEFINE ("ErrorRateModel");
+
 NS_OBJECT_ENSURE_REGISTERED (ErrorRateModel);
 
+/**
+ * \ingroup wifi
+ * The success rate tables of the ErrorRateModels, by model key (see
+ * ErrorRateModel::GetModelKey) and by mode key, shared by all the
+ * models.  The tables are never moved once built.
+ */
+static std::map<std::string, std::map<uint64_t, std::vector<double> > > g_errorRateTables;
+
+/**
+ * \ingroup wifi
+ * The mutex of g_errorRateTables, which the threads of
+ * MultithreadedSimulatorImpl share.
+ */
+static std::mutex g_errorRateTablesMutex;
+
 TypeId ErrorRateModel::GetTypeId (void)
 {
   static TypeId tid = TypeId ("ns3::ErrorRateModel")
     .SetParent<Object> ()
     .SetGroupName ("Wifi")
+    .AddAttribute ("UseTable",
+                   "Interpolate the chunk success rates from a table of each mode.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&ErrorRateModel::m_useTable),
+                   MakeBooleanChecker ())
+    .AddAttribute ("TableMinSnr",
+                   "The lowest SNR of the tables (dB).",
+                   DoubleValue (-10.0),
+                   MakeDoubleAccessor (&ErrorRateModel::m_tableMinSnr),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("TableMaxSnr",
+                   "The highest SNR of the tables (dB).",
+                   DoubleValue (60.0),
+                   MakeDoubleAccessor (&ErrorRateModel::m_tableMaxSnr),
+                   MakeDoubleChecker<double> ())
+    .AddAttribute ("TableStep",
+                   "The SNR step of the tables (dB).",
+                   DoubleValue (0.05),
+                   MakeDoubleAccessor (&ErrorRateModel::m_tableStep),
+                   MakeDoubleChecker<double> (1e-6))
   ;
   return tid;
 }
 
+ErrorRateModel::ErrorRateModel ()
+  : m_lastKey (0),
+    m_lastTable (0)
+{
+}
+
+double
+ErrorRateModel::GetChunkSuccessRate (WifiMode mode, WifiTxVector txVector, double snr, uint64_t nbits) const
+{
+  double csr;
+  if (m_useTable && Interpolate (GetTable (mode, txVector), snr, nbits, &csr))
+    {
+      return csr;
+    }
+  return DoGetChunkSuccessRate (mode, txVector, snr, nbits);
+}
+
+void
+ErrorRateModel::GetChunkSuccessRates (WifiMode mode, WifiTxVector txVector, const double *snr, const uint64_t *nbits,
+                                      double *csr, uint32_t n) const
+{
+  if (!m_useTable)
+    {
+      for (uint32_t i = 0; i < n; i++)
+        {
+          csr[i] = DoGetChunkSuccessRate (mode, txVector, snr[i], nbits[i]);
+        }
+      return;
+    }
+  const std::vector<double> &table = GetTable (mode, txVector);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      if (!Interpolate (table, snr[i], nbits[i], &csr[i]))
+        {
+          csr[i] = DoGetChunkSuccessRate (mode, txVector, snr[i], nbits[i]);
+        }
+    }
+}
+
+const std::vector<double> &
+ErrorRateModel::GetTable (WifiMode mode, WifiTxVector txVector) const
+{
+  uint64_t key = (static_cast<uint64_t> (mode.GetUid ()) << 32)
+    | (static_cast<uint64_t> (txVector.GetChannelWidth ()) << 24)
+    | (static_cast<uint64_t> (txVector.GetNss ()) << 16)
+    | txVector.GetGuardInterval ();
+  if (m_lastTable != 0 && key == m_lastKey)
+    {
+      return *m_lastTable;
+    }
+  const std::vector<double> *&shared = m_tables[key];
+  if (shared == 0)
+    {
+      std::string modelKey = GetModelKey ();
+      std::lock_guard<std::mutex> lock (g_errorRateTablesMutex);
+      std::vector<double> &table = g_errorRateTables[modelKey][key];
+      if (table.empty ())
+        {
+          NS_LOG_DEBUG ("building the table of " << mode << ", " << +txVector.GetChannelWidth () << "MHz");
+          uint32_t size = std::floor ((m_tableMaxSnr - m_tableMinSnr) / m_tableStep) + 1;
+          table.resize (size);
+          for (uint32_t i = 0; i < size; i++)
+            {
+              double snr = std::pow (10.0, (m_tableMinSnr + i * m_tableStep) / 10.0);
+              double rate = DoGetChunkSuccessRate (mode, txVector, snr, 1);
+              // Keep the logarithm finite when the rate of one bit is 0 or 1.
+              double errors = std::max (1e-300, std::min (-std::log (rate), 1e300));
+              table[i] = std::log (errors);
+            }
+        }
+      shared = &table;
+    }
+  m_lastKey = key;
+  m_lastTable = shared;
+  return *shared;
+}
+
+std::string
+ErrorRateModel::GetModelKey (void) const
+{
+  // The attributes of the subclasses may change the rates too.
+  std::ostringstream oss;
+  TypeId tid = GetInstanceTypeId ();
+  oss << tid.GetName ();
+  while (true)
+    {
+      for (uint32_t i = 0; i < tid.GetAttributeN (); i++)
+        {
+          struct TypeId::AttributeInformation info = tid.GetAttribute (i);
+          if (info.flags & TypeId::ATTR_GET)
+            {
+              Ptr<AttributeValue> value = info.checker->Create ();
+              GetAttribute (info.name, *value);
+              oss << " " << info.name << "=" << value->SerializeToString (info.checker);
+            }
+        }
+      if (!tid.HasParent ())
+        {
+          break;
+        }
+      tid = tid.GetParent ();
+    }
+  return oss.str ();
+}
+
+bool
+ErrorRateModel::Interpolate (const std::vector<double> &table, double snr, uint64_t nbits, double *csr) const
+{
+  if (!(snr > 0))
+    {
+      return false;
+    }
+  double x = (10.0 * std::log10 (snr) - m_tableMinSnr) / m_tableStep;
+  if (!(x >= 0 && x < table.size () - 1))
+    {
+      return false;
+    }
+  uint32_t i = static_cast<uint32_t> (x);
+  double f = x - i;
+  double errors = std::exp (table[i] + f * (table[i + 1] - table[i]));
+  *csr = std::exp (-static_cast<double> (nbits) * errors);
+  return true;
+}
+
 double
 ErrorRateModel::CalculateSnr (WifiTxVector txVector, double ber) const
 {
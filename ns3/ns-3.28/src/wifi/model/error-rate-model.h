@@ -23,12 +23,26 @@
 
 #include "wifi-tx-vector.h"
 #include "ns3/object.h"
+#include <map>
+#include <string>
+#include <vector>
 
 namespace ns3 {
 /**
  * \ingroup wifi
  * \brief the interface for Wifi's error models
  *
+ * With the UseTable attribute, the chunk success rates are interpolated
+ * from a table of the success rate of one bit, computed on first use for
+ * each mode (and each channel width, guard interval and number of spatial
+ * streams, which the PHY rate depends on).  The tables are shared by all
+ * the models of the same type and attribute values.  The table
+ * holds log (-log (rate)) on a grid of SNRs in dB, so that the rate of a
+ * chunk of n bits is exp (-n * exp (interpolated value)).  This assumes
+ * that the success rate of n bits is the rate of one bit to the power n,
+ * as in all the models of this module.  The SNRs out of the table are
+ * computed by the model.  The table attributes must be set before the
+ * first use.
  */
 class ErrorRateModel : public Object
 {
@@ -39,6 +53,8 @@ public:
    */
   static TypeId GetTypeId (void);
 
+  ErrorRateModel ();
+
   /**
    * \param txVector a specific transmission vector including WifiMode
    * \param ber a target ber
@@ -48,7 +64,6 @@ public:
   double CalculateSnr (WifiTxVector txVector, double ber) const;
 
   /**
-   * A pure virtual method that must be implemented in the subclass.
    * This method returns the probability that the given 'chunk' of the
    * packet will be successfully received by the PHY.
    *
@@ -70,7 +85,66 @@ public:
    *
    * \return probability of successfully receiving the chunk
    */
-  virtual double GetChunkSuccessRate (WifiMode mode, WifiTxVector txVector, double snr, uint64_t nbits) const = 0;
+  double GetChunkSuccessRate (WifiMode mode, WifiTxVector txVector, double snr, uint64_t nbits) const;
+
+  /**
+   * Return the probabilities of successfully receiving several chunks
+   * of the same mode.  With the UseTable attribute, the table is looked
+   * up once for all the chunks.
+   *
+   * \param mode the Wi-Fi mode applicable to the chunks
+   * \param txVector TXVECTOR of the overall transmission
+   * \param snr the SNRs of the chunks
+   * \param nbits the numbers of bits in the chunks
+   * \param csr the probabilities of successfully receiving the chunks
+   * \param n the number of chunks
+   */
+  void GetChunkSuccessRates (WifiMode mode, WifiTxVector txVector, const double *snr, const uint64_t *nbits,
+                             double *csr, uint32_t n) const;
+
+
+private:
+  /**
+   * A pure virtual method that must be implemented in the subclass.
+   * This method returns the probability that the given 'chunk' of the
+   * packet will be successfully received by the PHY.
+   *
+   * \param mode the Wi-Fi mode applicable to this chunk
+   * \param txVector TXVECTOR of the overall transmission
+   * \param snr the SNR of the chunk
+   * \param nbits the number of bits in this chunk
+   *
+   * \return probability of successfully receiving the chunk
+   */
+  virtual double DoGetChunkSuccessRate (WifiMode mode, WifiTxVector txVector, double snr, uint64_t nbits) const = 0;
+
+  /**
+   * \param mode the Wi-Fi mode
+   * \param txVector TXVECTOR of the overall transmission
+   * \return the table of the mode, built if needed
+   */
+  const std::vector<double> & GetTable (WifiMode mode, WifiTxVector txVector) const;
+  /**
+   * \return the name of the type of this model and its attribute values,
+   *         which identify the tables it shares with the other models
+   */
+  std::string GetModelKey (void) const;
+  /**
+   * \param table the table of the mode
+   * \param snr the SNR of the chunk
+   * \param nbits the number of bits in this chunk
+   * \param [out] csr the probability of successfully receiving the chunk
+   * \return false if the SNR is out of the table
+   */
+  bool Interpolate (const std::vector<double> &table, double snr, uint64_t nbits, double *csr) const;
+
+  bool m_useTable;       //!< Whether to interpolate the success rates
+  double m_tableMinSnr;  //!< The lowest SNR of the tables (dB)
+  double m_tableMaxSnr;  //!< The highest SNR of the tables (dB)
+  double m_tableStep;    //!< The SNR step of the tables (dB)
+  mutable std::map<uint64_t, const std::vector<double> *> m_tables; //!< The shared tables used, by mode and PHY rate parameters
+  mutable uint64_t m_lastKey;                                        //!< The key of the last table used
+  mutable const std::vector<double> *m_lastTable;                    //!< The last table used
 };
 
 } //namespace ns3
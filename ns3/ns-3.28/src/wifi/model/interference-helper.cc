@@ -88,12 +88,19 @@ InterferenceHelper::Event::GetPayloadMode (void) const
  *       short period of time.
  ****************************************************************/
 
-InterferenceHelper::NiChange::NiChange (double power, Ptr<InterferenceHelper::Event> event)
-  : m_power (power),
+InterferenceHelper::NiChange::NiChange (Time time, double power, Ptr<InterferenceHelper::Event> event)
+  : m_time (time),
+    m_power (power),
     m_event (event)
 {
 }
 
+Time
+InterferenceHelper::NiChange::GetTime (void) const
+{
+  return m_time;
+}
+
 double
 InterferenceHelper::NiChange::GetPower (void) const
 {
@@ -112,6 +119,12 @@ InterferenceHelper::NiChange::GetEvent (void) const
   return m_event;
 }
 
+bool
+InterferenceHelper::NiChange::operator < (const InterferenceHelper::NiChange &o) const
+{
+  return m_time < o.m_time;
+}
+
 
 /****************************************************************
  *       The actual InterferenceHelper
@@ -124,7 +137,7 @@ InterferenceHelper::InterferenceHelper ()
     m_rxing (false)
 {
   // Always have a zero power noise event in the list
-  AddNiChangeEvent (Time (0), NiChange (0.0, 0));
+  AddNiChangeEvent (NiChange (Time (0), 0.0, 0));
 }
 
 InterferenceHelper::~InterferenceHelper ()
@@ -186,11 +199,11 @@ InterferenceHelper::GetEnergyDuration (double energyW) const
 {
   Time now = Simulator::Now ();
   auto i = GetPreviousPosition (now);
-  Time end = i->first;
+  Time end = i->GetTime ();
   for (; i != m_niChanges.end (); ++i)
     {
-      double noiseInterferenceW = i->second.GetPower ();
-      end = i->first;
+      double noiseInterferenceW = i->GetPower ();
+      end = i->GetTime ();
       if (noiseInterferenceW < energyW)
         {
           break;
@@ -205,21 +218,21 @@ InterferenceHelper::AppendEvent (Ptr<InterferenceHelper::Event> event)
   NS_LOG_FUNCTION (this);
   double previousPowerStart = 0;
   double previousPowerEnd = 0;
-  previousPowerStart = GetPreviousPosition (event->GetStartTime ())->second.GetPower ();
-  previousPowerEnd = GetPreviousPosition (event->GetEndTime ())->second.GetPower ();
+  previousPowerStart = GetPreviousPosition (event->GetStartTime ())->GetPower ();
+  previousPowerEnd = GetPreviousPosition (event->GetEndTime ())->GetPower ();
 
   if (!m_rxing)
     {
       m_firstPower = previousPowerStart;
       // Always leave the first zero power noise event in the list
-      m_niChanges.erase (++(m_niChanges.begin ()),
+      m_niChanges.erase (m_niChanges.begin () + 1,
                          GetNextPosition (event->GetStartTime ()));
     }
-  auto first = AddNiChangeEvent (event->GetStartTime (), NiChange (previousPowerStart, event));
-  auto last = AddNiChangeEvent (event->GetEndTime (), NiChange (previousPowerEnd, event));
-  for (auto i = first; i != last; ++i)
+  std::size_t first = AddNiChangeEvent (NiChange (event->GetStartTime (), previousPowerStart, event));
+  std::size_t last = AddNiChangeEvent (NiChange (event->GetEndTime (), previousPowerEnd, event));
+  for (std::size_t i = first; i != last; ++i)
     {
-      i->second.AddPower (event->GetRxPowerW ());
+      m_niChanges[i].AddPower (event->GetRxPowerW ());
     }
 }
 
@@ -239,20 +252,22 @@ InterferenceHelper::CalculateSnr (double signal, double noiseInterference, uint8
 }
 
 double
-InterferenceHelper::CalculateNoiseInterferenceW (Ptr<InterferenceHelper::Event> event, NiChanges *ni) const
+InterferenceHelper::CalculateNoiseInterferenceW (Ptr<InterferenceHelper::Event> event, NiChanges::const_iterator *first,
+                                                 NiChanges::const_iterator *last) const
 {
   double noiseInterference = m_firstPower;
-  auto it = m_niChanges.find (event->GetStartTime ());
-  for (; it != m_niChanges.end () && it->second.GetEvent () != event; ++it)
+  auto it = std::lower_bound (m_niChanges.begin (), m_niChanges.end (), NiChange (event->GetStartTime (), 0, 0));
+  for (; it != m_niChanges.end () && it->GetEvent () != event; ++it)
     {
-      noiseInterference = it->second.GetPower ();
+      noiseInterference = it->GetPower ();
     }
-  ni->emplace (event->GetStartTime (), NiChange (0, event));
-  while (++it != m_niChanges.end () && it->second.GetEvent () != event)
+  NS_ASSERT (it != m_niChanges.end ());
+  *first = it;
+  while (++it != m_niChanges.end () && it->GetEvent () != event)
     {
-      ni->insert (*it);
     }
-  ni->emplace (event->GetEndTime (), NiChange (0, event));
+  NS_ASSERT (it != m_niChanges.end ());
+  *last = ++it;
   return noiseInterference;
 }
 
@@ -263,6 +278,14 @@ InterferenceHelper::CalculateChunkSuccessRate (double snir, Time duration, WifiM
     {
       return 1.0;
     }
+  uint64_t nbits = CalculateChunkBits (&snir, duration, mode, txVector);
+  double csr = m_errorRateModel->GetChunkSuccessRate (mode, txVector, snir, nbits);
+  return csr;
+}
+
+uint64_t
+InterferenceHelper::CalculateChunkBits (double *snir, Time duration, WifiMode mode, WifiTxVector txVector) const
+{
   uint64_t rate = mode.GetPhyRate (txVector);
   uint64_t nbits = static_cast<uint64_t> (rate * duration.GetSeconds ());
   if (txVector.GetMode ().GetModulationClass () == WIFI_MOD_CLASS_HT || txVector.GetMode ().GetModulationClass () == WIFI_MOD_CLASS_VHT || txVector.GetMode ().GetModulationClass () == WIFI_MOD_CLASS_HE)
@@ -272,68 +295,84 @@ InterferenceHelper::CalculateChunkSuccessRate (double snir, Time duration, WifiM
       NS_LOG_DEBUG ("TX=" << +txVector.GetNTx () <<
                     ", RX=" << +m_numRxAntennas <<
                     ", SNIR improvement=+" << 10 * std::log10 (gain) << "dB");
-      snir *= gain;
+      *snir *= gain;
     }
-  double csr = m_errorRateModel->GetChunkSuccessRate (mode, txVector, snir, nbits);
-  return csr;
+  return nbits;
 }
 
 double
-InterferenceHelper::CalculatePlcpPayloadPer (Ptr<const InterferenceHelper::Event> event, NiChanges *ni) const
+InterferenceHelper::CalculatePlcpPayloadPer (Ptr<const InterferenceHelper::Event> event, NiChanges::const_iterator first,
+                                             NiChanges::const_iterator last) const
 {
   NS_LOG_FUNCTION (this);
   const WifiTxVector txVector = event->GetTxVector ();
   double psr = 1.0; /* Packet Success Rate */
-  auto j = ni->begin ();
-  Time previous = j->first;
+  auto j = first;
+  Time previous = j->GetTime ();
   WifiMode payloadMode = event->GetPayloadMode ();
   WifiPreamble preamble = txVector.GetPreambleType ();
-  Time plcpHeaderStart = j->first + WifiPhy::GetPlcpPreambleDuration (txVector); //packet start time + preamble
+  Time plcpHeaderStart = j->GetTime () + WifiPhy::GetPlcpPreambleDuration (txVector); //packet start time + preamble
   Time plcpHsigHeaderStart = plcpHeaderStart + WifiPhy::GetPlcpHeaderDuration (txVector); //packet start time + preamble + L-SIG
   Time plcpTrainingSymbolsStart = plcpHsigHeaderStart + WifiPhy::GetPlcpHtSigHeaderDuration (preamble) + WifiPhy::GetPlcpSigA1Duration (preamble) + WifiPhy::GetPlcpSigA2Duration (preamble); //packet start time + preamble + L-SIG + HT-SIG or SIG-A
   Time plcpPayloadStart = plcpTrainingSymbolsStart + WifiPhy::GetPlcpTrainingSymbolDuration (txVector) + WifiPhy::GetPlcpSigBDuration (preamble); //packet start time + preamble + L-SIG + HT-SIG or SIG-A + Training + SIG-B
   double noiseInterferenceW = m_firstPower;
   double powerW = event->GetRxPowerW ();
-  while (++j != ni->end ())
+  // All the payload chunks have the same mode: collect them, and get
+  // their success rates from the error rate model at once.
+  m_chunkSnirs.clear ();
+  m_chunkBits.clear ();
+  while (++j != last)
     {
-      Time current = j->first;
+      Time current = j->GetTime ();
       NS_LOG_DEBUG ("previous= " << previous << ", current=" << current);
       NS_ASSERT (current >= previous);
+      Time duration;
       //Case 1: Both previous and current point to the payload
       if (previous >= plcpPayloadStart)
         {
-          psr *= CalculateChunkSuccessRate (CalculateSnr (powerW,
-                                                          noiseInterferenceW,
-                                                          txVector.GetChannelWidth ()),
-                                            current - previous,
-                                            payloadMode, txVector);
-          NS_LOG_DEBUG ("Both previous and current point to the payload: mode=" << payloadMode << ", psr=" << psr);
+          duration = current - previous;
+          NS_LOG_DEBUG ("Both previous and current point to the payload: mode=" << payloadMode);
         }
       //Case 2: previous is before payload and current is in the payload
       else if (current >= plcpPayloadStart)
         {
-          psr *= CalculateChunkSuccessRate (CalculateSnr (powerW,
-                                                          noiseInterferenceW,
-                                                          txVector.GetChannelWidth ()),
-                                            current - plcpPayloadStart,
-                                            payloadMode, txVector);
-          NS_LOG_DEBUG ("previous is before payload and current is in the payload: mode=" << payloadMode << ", psr=" << psr);
+          duration = current - plcpPayloadStart;
+          NS_LOG_DEBUG ("previous is before payload and current is in the payload: mode=" << payloadMode);
+        }
+      if (!duration.IsZero ())
+        {
+          double snir = CalculateSnr (powerW, noiseInterferenceW, txVector.GetChannelWidth ());
+          m_chunkBits.push_back (CalculateChunkBits (&snir, duration, payloadMode, txVector));
+          m_chunkSnirs.push_back (snir);
+        }
+      noiseInterferenceW = j->GetPower () - powerW;
+      previous = j->GetTime ();
+    }
+  uint32_t n = m_chunkSnirs.size ();
+  if (n > 0)
+    {
+      m_chunkRates.resize (n);
+      m_errorRateModel->GetChunkSuccessRates (payloadMode, txVector, &m_chunkSnirs[0], &m_chunkBits[0],
+                                              &m_chunkRates[0], n);
+      for (uint32_t i = 0; i < n; i++)
+        {
+          psr *= m_chunkRates[i];
         }
-      noiseInterferenceW = j->second.GetPower () - powerW;
-      previous = j->first;
     }
+  NS_LOG_DEBUG ("psr=" << psr);
   double per = 1 - psr;
   return per;
 }
 
 double
-InterferenceHelper::CalculatePlcpHeaderPer (Ptr<const InterferenceHelper::Event> event, NiChanges *ni) const
+InterferenceHelper::CalculatePlcpHeaderPer (Ptr<const InterferenceHelper::Event> event, NiChanges::const_iterator first,
+                                            NiChanges::const_iterator last) const
 {
   NS_LOG_FUNCTION (this);
   const WifiTxVector txVector = event->GetTxVector ();
   double psr = 1.0; /* Packet Success Rate */
-  auto j = ni->begin ();
-  Time previous = j->first;
+  auto j = first;
+  Time previous = j->GetTime ();
   WifiPreamble preamble = txVector.GetPreambleType ();
   WifiMode mcsHeaderMode;
   if (preamble == WIFI_PREAMBLE_HT_MF || preamble == WIFI_PREAMBLE_HT_GF)
@@ -352,15 +391,15 @@ InterferenceHelper::CalculatePlcpHeaderPer (Ptr<const InterferenceHelper::Event>
       mcsHeaderMode = WifiPhy::GetHePlcpHeaderMode ();
     }
   WifiMode headerMode = WifiPhy::GetPlcpHeaderMode (txVector);
-  Time plcpHeaderStart = j->first + WifiPhy::GetPlcpPreambleDuration (txVector); //packet start time + preamble
+  Time plcpHeaderStart = j->GetTime () + WifiPhy::GetPlcpPreambleDuration (txVector); //packet start time + preamble
   Time plcpHsigHeaderStart = plcpHeaderStart + WifiPhy::GetPlcpHeaderDuration (txVector); //packet start time + preamble + L-SIG
   Time plcpTrainingSymbolsStart = plcpHsigHeaderStart + WifiPhy::GetPlcpHtSigHeaderDuration (preamble) + WifiPhy::GetPlcpSigA1Duration (preamble) + WifiPhy::GetPlcpSigA2Duration (preamble); //packet start time + preamble + L-SIG + HT-SIG or SIG-A
   Time plcpPayloadStart = plcpTrainingSymbolsStart + WifiPhy::GetPlcpTrainingSymbolDuration (txVector) + WifiPhy::GetPlcpSigBDuration (preamble); //packet start time + preamble + L-SIG + HT-SIG or SIG-A + Training + SIG-B
   double noiseInterferenceW = m_firstPower;
   double powerW = event->GetRxPowerW ();
-  while (++j != ni->end ())
+  while (++j != last)
     {
-      Time current = j->first;
+      Time current = j->GetTime ();
       NS_LOG_DEBUG ("previous= " << previous << ", current=" << current);
       NS_ASSERT (current >= previous);
       //Case 1: previous and current after playload start: nothing to do
@@ -733,8 +772,8 @@ InterferenceHelper::CalculatePlcpHeaderPer (Ptr<const InterferenceHelper::Event>
             }
         }
 
-      noiseInterferenceW = j->second.GetPower () - powerW;
-      previous = j->first;
+      noiseInterferenceW = j->GetPower () - powerW;
+      previous = j->GetTime ();
     }
 
   double per = 1 - psr;
@@ -744,8 +783,9 @@ InterferenceHelper::CalculatePlcpHeaderPer (Ptr<const InterferenceHelper::Event>
 struct InterferenceHelper::SnrPer
 InterferenceHelper::CalculatePlcpPayloadSnrPer (Ptr<InterferenceHelper::Event> event) const
 {
-  NiChanges ni;
-  double noiseInterferenceW = CalculateNoiseInterferenceW (event, &ni);
+  NiChanges::const_iterator first;
+  NiChanges::const_iterator last;
+  double noiseInterferenceW = CalculateNoiseInterferenceW (event, &first, &last);
   double snr = CalculateSnr (event->GetRxPowerW (),
                              noiseInterferenceW,
                              event->GetTxVector ().GetChannelWidth ());
@@ -753,7 +793,7 @@ InterferenceHelper::CalculatePlcpPayloadSnrPer (Ptr<InterferenceHelper::Event> e
   /* calculate the SNIR at the start of the packet and accumulate
    * all SNIR changes in the snir vector.
    */
-  double per = CalculatePlcpPayloadPer (event, &ni);
+  double per = CalculatePlcpPayloadPer (event, first, last);
 
   struct SnrPer snrPer;
   snrPer.snr = snr;
@@ -764,8 +804,9 @@ InterferenceHelper::CalculatePlcpPayloadSnrPer (Ptr<InterferenceHelper::Event> e
 struct InterferenceHelper::SnrPer
 InterferenceHelper::CalculatePlcpHeaderSnrPer (Ptr<InterferenceHelper::Event> event) const
 {
-  NiChanges ni;
-  double noiseInterferenceW = CalculateNoiseInterferenceW (event, &ni);
+  NiChanges::const_iterator first;
+  NiChanges::const_iterator last;
+  double noiseInterferenceW = CalculateNoiseInterferenceW (event, &first, &last);
   double snr = CalculateSnr (event->GetRxPowerW (),
                              noiseInterferenceW,
                              event->GetTxVector ().GetChannelWidth ());
@@ -773,7 +814,7 @@ InterferenceHelper::CalculatePlcpHeaderSnrPer (Ptr<InterferenceHelper::Event> ev
   /* calculate the SNIR at the start of the plcp header and accumulate
    * all SNIR changes in the snir vector.
    */
-  double per = CalculatePlcpHeaderPer (event, &ni);
+  double per = CalculatePlcpHeaderPer (event, first, last);
 
   struct SnrPer snrPer;
   snrPer.snr = snr;
@@ -786,7 +827,7 @@ InterferenceHelper::EraseEvents (void)
 {
   m_niChanges.clear ();
   // Always have a zero power noise event in the list
-  AddNiChangeEvent (Time (0), NiChange (0.0, 0));
+  AddNiChangeEvent (NiChange (Time (0), 0.0, 0));
   m_rxing = false;
   m_firstPower = 0;
 }
@@ -794,7 +835,7 @@ InterferenceHelper::EraseEvents (void)
 InterferenceHelper::NiChanges::const_iterator
 InterferenceHelper::GetNextPosition (Time moment) const
 {
-  return m_niChanges.upper_bound (moment);
+  return std::upper_bound (m_niChanges.begin (), m_niChanges.end (), NiChange (moment, 0, 0));
 }
 
 InterferenceHelper::NiChanges::const_iterator
@@ -807,10 +848,13 @@ InterferenceHelper::GetPreviousPosition (Time moment) const
   return it;
 }
 
-InterferenceHelper::NiChanges::iterator
-InterferenceHelper::AddNiChangeEvent (Time moment, NiChange change)
+std::size_t
+InterferenceHelper::AddNiChangeEvent (NiChange change)
 {
-  return m_niChanges.insert (GetNextPosition (moment), std::make_pair (moment, change));
+  NiChanges::const_iterator position = GetNextPosition (change.GetTime ());
+  std::size_t index = position - m_niChanges.begin ();
+  m_niChanges.insert (m_niChanges.begin () + index, change);
+  return index;
 }
 
 void
@@ -818,6 +862,13 @@ InterferenceHelper::NotifyRxStart ()
 {
   NS_LOG_FUNCTION (this);
   m_rxing = true;
+  // The changes before the last one preceding the received event are not
+  // needed anymore, and the events received later start later.
+  auto it = std::lower_bound (m_niChanges.begin (), m_niChanges.end (), NiChange (Simulator::Now (), 0, 0));
+  if (it - m_niChanges.begin () > 2)
+    {
+      m_niChanges.erase (m_niChanges.begin () + 1, it - 1);
+    }
 }
 
 void
@@ -826,9 +877,13 @@ InterferenceHelper::NotifyRxEnd ()
   NS_LOG_FUNCTION (this);
   m_rxing = false;
   //Update m_firstPower for frame capture
-  auto it = m_niChanges.find (Simulator::Now ());
+  auto it = std::lower_bound (m_niChanges.begin (), m_niChanges.end (), NiChange (Simulator::Now (), 0, 0));
+  if (it != m_niChanges.end () && it->GetTime () != Simulator::Now ())
+    {
+      it = m_niChanges.end ();
+    }
   it--;
-  m_firstPower = it->second.GetPower ();
+  m_firstPower = it->GetPower ();
 }
 
 } //namespace ns3
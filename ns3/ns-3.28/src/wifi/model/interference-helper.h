@@ -25,7 +25,7 @@
 #include "ns3/packet.h"
 #include "wifi-tx-vector.h"
 #include "error-rate-model.h"
-#include <map>
+#include <vector>
 
 namespace ns3 {
 
@@ -213,10 +213,17 @@ public:
     /**
      * Create a NiChange at the given time and the amount of NI change.
      *
+     * \param time the time of the change
      * \param power the power
      * \param event causes this NI change
      */
-    NiChange (double power, Ptr<InterferenceHelper::Event> event);
+    NiChange (Time time, double power, Ptr<InterferenceHelper::Event> event);
+    /**
+     * Return the time of the change
+     *
+     * \return the time
+     */
+    Time GetTime (void) const;
     /**
      * Return the power
      *
@@ -235,17 +242,26 @@ public:
      * \return the event
      */
     Ptr<InterferenceHelper::Event> GetEvent (void) const;
+    /**
+     * Compare the times of two changes
+     *
+     * \param o the other change
+     * \return true if this change is earlier than the other one
+     */
+    bool operator < (const NiChange &o) const;
 
 
 private:
+    Time m_time; ///< time
     double m_power; ///< power
     Ptr<InterferenceHelper::Event> m_event; ///< event
   };
 
   /**
-   * typedef for a multimap of NiChanges
+   * typedef for a vector of NiChanges, in time order.  The power of each
+   * change is the total power from this change to the next one.
    */
-  typedef std::multimap<Time, NiChange> NiChanges;
+  typedef std::vector<NiChange> NiChanges;
 
   /**
    * Append the given Event.
@@ -257,11 +273,13 @@ private:
    * Calculate noise and interference power in W.
    *
    * \param event
-   * \param ni
+   * \param first set to the change starting the event
+   * \param last set past the change ending the event
    *
    * \return noise and interference power
    */
-  double CalculateNoiseInterferenceW (Ptr<Event> event, NiChanges *ni) const;
+  double CalculateNoiseInterferenceW (Ptr<Event> event, NiChanges::const_iterator *first,
+                                      NiChanges::const_iterator *last) const;
   /**
    * Calculate SNR (linear ratio) from the given signal power and noise+interference power.
    * (Mode is not currently used)
@@ -285,26 +303,42 @@ private:
    * \return the success rate
    */
   double CalculateChunkSuccessRate (double snir, Time duration, WifiMode mode, WifiTxVector txVector) const;
+  /**
+   * Calculate the number of bits of a chunk, and apply the MIMO gain to its SINR,
+   * as CalculateChunkSuccessRate does.
+   *
+   * \param [in,out] snir SINR
+   * \param duration the duration of the chunk
+   * \param mode the Wi-Fi mode of the chunk
+   * \param txVector TXVECTOR of the overall transmission
+   *
+   * \return the number of bits of the chunk
+   */
+  uint64_t CalculateChunkBits (double *snir, Time duration, WifiMode mode, WifiTxVector txVector) const;
   /**
    * Calculate the error rate of the given plcp payload. The plcp payload can be divided into
    * multiple chunks (e.g. due to interference from other transmissions).
    *
    * \param event
-   * \param ni
+   * \param first the change starting the event
+   * \param last past the change ending the event
    *
    * \return the error rate of the packet
    */
-  double CalculatePlcpPayloadPer (Ptr<const Event> event, NiChanges *ni) const;
+  double CalculatePlcpPayloadPer (Ptr<const Event> event, NiChanges::const_iterator first,
+                                  NiChanges::const_iterator last) const;
   /**
    * Calculate the error rate of the plcp header. The plcp header can be divided into
    * multiple chunks (e.g. due to interference from other transmissions).
    *
    * \param event
-   * \param ni
+   * \param first the change starting the event
+   * \param last past the change ending the event
    *
    * \return the error rate of the packet
    */
-  double CalculatePlcpHeaderPer (Ptr<const Event> event, NiChanges *ni) const;
+  double CalculatePlcpHeaderPer (Ptr<const Event> event, NiChanges::const_iterator first,
+                                 NiChanges::const_iterator last) const;
 
   double m_noiseFigure; /**< noise figure (linear) */
   Ptr<ErrorRateModel> m_errorRateModel; ///< error rate model
@@ -313,6 +347,9 @@ private:
   NiChanges m_niChanges;
   double m_firstPower; ///< first power
   bool m_rxing; ///< flag whether it is in receiving state
+  mutable std::vector<double> m_chunkSnirs;     ///< The SINRs of the payload chunks of CalculatePlcpPayloadPer
+  mutable std::vector<uint64_t> m_chunkBits;    ///< The bits of the payload chunks of CalculatePlcpPayloadPer
+  mutable std::vector<double> m_chunkRates;     ///< The success rates of the payload chunks of CalculatePlcpPayloadPer
 
   /**
    * Returns an iterator to the first nichange that is later than moment
@@ -321,13 +358,6 @@ private:
    * \returns an iterator to the list of NiChanges
    */
   NiChanges::const_iterator GetNextPosition (Time moment) const;
-  /**
-   * Returns an iterator to the first nichange that is later than moment
-   *
-   * \param moment time to check from
-   * \returns an iterator to the list of NiChanges
-   */
-  //NiChanges::iterator GetNextPosition (Time moment);
   /**
    * Returns an iterator to the last nichange that is before than moment
    *
@@ -338,13 +368,12 @@ private:
 
   /**
    * Add NiChange to the list at the appropriate position and
-   * return the iterator of the new event.
+   * return the index of the new event.
    *
-   * \param moment
    * \param change
-   * \returns the iterator of the new event
+   * \returns the index of the new event
    */
-  NiChanges::iterator AddNiChangeEvent (Time moment, NiChange change);
+  std::size_t AddNiChangeEvent (NiChange change);
 };
 
 } //namespace ns3
@@ -304,7 +304,7 @@ public:
    * This method is typically invoked by the lower PHY layer to notify
    * the MAC layer that a packet was unsuccessfully received.
    */
-  void ReceiveError (Ptr<Packet> packet, double rxSnr);
+  void ReceiveError (Ptr<const Packet> packet, double rxSnr);
   /**
    * \param duration switching delay duration.
    *
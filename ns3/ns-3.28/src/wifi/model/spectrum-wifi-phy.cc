@@ -256,8 +256,7 @@ SpectrumWifiPhy::StartRx (Ptr<SpectrumSignalParameters> rxParams)
     }
 
   NS_LOG_INFO ("Received Wi-Fi signal");
-  Ptr<Packet> packet = wifiRxParams->packet->Copy ();
-  StartReceivePreambleAndHeader (packet, rxPowerW, rxDuration);
+  StartReceivePreambleAndHeader (wifiRxParams->packet, rxPowerW, rxDuration);
 }
 
 Ptr<WifiSpectrumPhyInterface>
@@ -258,31 +258,46 @@ WifiMac::GetMaxPropagationDelay (void) const
 void
 WifiMac::NotifyTx (Ptr<const Packet> packet)
 {
-  m_macTxTrace (packet);
+  if (!m_macTxTrace.IsEmpty ())
+    {
+      m_macTxTrace (packet);
+    }
 }
 
 void
 WifiMac::NotifyTxDrop (Ptr<const Packet> packet)
 {
-  m_macTxDropTrace (packet);
+  if (!m_macTxDropTrace.IsEmpty ())
+    {
+      m_macTxDropTrace (packet);
+    }
 }
 
 void
 WifiMac::NotifyRx (Ptr<const Packet> packet)
 {
-  m_macRxTrace (packet);
+  if (!m_macRxTrace.IsEmpty ())
+    {
+      m_macRxTrace (packet);
+    }
 }
 
 void
 WifiMac::NotifyPromiscRx (Ptr<const Packet> packet)
 {
-  m_macPromiscRxTrace (packet);
+  if (!m_macPromiscRxTrace.IsEmpty ())
+    {
+      m_macPromiscRxTrace (packet);
+    }
 }
 
 void
 WifiMac::NotifyRxDrop (Ptr<const Packet> packet)
 {
-  m_macRxDropTrace (packet);
+  if (!m_macRxDropTrace.IsEmpty ())
+    {
+      m_macRxDropTrace (packet);
+    }
 }
 
 void
@@ -47,7 +47,9 @@ WifiPhyStateHelper::GetTypeId (void)
                      MakeTraceSourceAccessor (&WifiPhyStateHelper::m_rxOkTrace),
                      "ns3::WifiPhyStateHelper::RxOkTracedCallback")
     .AddTraceSource ("RxError",
-                     "A packet has been received unsuccessfully.",
+                     "A packet has been received unsuccessfully. The packet "
+                     "is the one sent on the channel, shared by all the "
+                     "receivers, and still carries the WifiPhyTag.",
                      MakeTraceSourceAccessor (&WifiPhyStateHelper::m_rxErrorTrace),
                      "ns3::WifiPhyStateHelper::RxEndErrorTracedCallback")
     .AddTraceSource ("Tx", "Packet transmission is starting.",
@@ -349,7 +351,10 @@ WifiPhyStateHelper::SwitchToTx (Time txDuration, Ptr<const Packet> packet, doubl
                                 WifiTxVector txVector)
 {
   NS_LOG_FUNCTION (this << txDuration << packet << txPowerDbm << txVector);
-  m_txTrace (packet, txVector.GetMode (), txVector.GetPreambleType (), txVector.GetTxPowerLevel ());
+  if (!m_txTrace.IsEmpty ())
+    {
+      m_txTrace (packet, txVector.GetMode (), txVector.GetPreambleType (), txVector.GetTxPowerLevel ());
+    }
   Time now = Simulator::Now ();
   switch (GetState ())
     {
@@ -460,7 +465,10 @@ void
 WifiPhyStateHelper::SwitchFromRxEndOk (Ptr<Packet> packet, double snr, WifiTxVector txVector)
 {
   NS_LOG_FUNCTION (this << packet << snr << txVector);
-  m_rxOkTrace (packet, snr, txVector.GetMode (), txVector.GetPreambleType ());
+  if (!m_rxOkTrace.IsEmpty ())
+    {
+      m_rxOkTrace (packet, snr, txVector.GetMode (), txVector.GetPreambleType ());
+    }
   NotifyRxEndOk ();
   DoSwitchFromRx ();
   if (!m_rxOkCallback.IsNull ())
@@ -471,7 +479,7 @@ WifiPhyStateHelper::SwitchFromRxEndOk (Ptr<Packet> packet, double snr, WifiTxVec
 }
 
 void
-WifiPhyStateHelper::SwitchFromRxEndError (Ptr<Packet> packet, double snr)
+WifiPhyStateHelper::SwitchFromRxEndError (Ptr<const Packet> packet, double snr)
 {
   NS_LOG_FUNCTION (this << packet << snr);
   m_rxErrorTrace (packet, snr);
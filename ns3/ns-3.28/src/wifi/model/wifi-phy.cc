@@ -299,6 +299,12 @@ WifiPhy::GetTypeId (void)
                    MakePointerAccessor (&WifiPhy::GetFrameCaptureModel,
                                         &WifiPhy::SetFrameCaptureModel),
                    MakePointerChecker <FrameCaptureModel> ())
+    .AddAttribute ("TxDurationCacheSize",
+                   "The maximum number of transmission durations kept by CalculateTxDuration "
+                   "(0 to disable the cache). The cache is emptied when it is full.",
+                   UintegerValue (64),
+                   MakeUintegerAccessor (&WifiPhy::m_txDurationCacheSize),
+                   MakeUintegerChecker<uint32_t> ())
     .AddTraceSource ("PhyTxBegin",
                      "Trace source indicating a packet "
                      "has begun transmitting over the channel medium",
@@ -320,7 +326,9 @@ WifiPhy::GetTypeId (void)
     .AddTraceSource ("PhyRxBegin",
                      "Trace source indicating a packet "
                      "has begun being received from the channel medium "
-                     "by the device",
+                     "by the device. The packet is the one sent on the "
+                     "channel, shared by all the receivers, and still "
+                     "carries the WifiPhyTag.",
                      MakeTraceSourceAccessor (&WifiPhy::m_phyRxBeginTrace),
                      "ns3::Packet::TracedCallback")
     .AddTraceSource ("PhyRxEnd",
@@ -331,7 +339,9 @@ WifiPhy::GetTypeId (void)
                      "ns3::Packet::TracedCallback")
     .AddTraceSource ("PhyRxDrop",
                      "Trace source indicating a packet "
-                     "has been dropped by the device during reception",
+                     "has been dropped by the device during reception. "
+                     "The packet is the one sent on the channel, shared by "
+                     "all the receivers, and still carries the WifiPhyTag.",
                      MakeTraceSourceAccessor (&WifiPhy::m_phyRxDropTrace),
                      "ns3::Packet::TracedCallback")
     .AddTraceSource ("MonitorSnifferRx",
@@ -353,6 +363,8 @@ WifiPhy::WifiPhy ()
     m_plcpSuccess (false),
     m_txMpduReferenceNumber (0xffffffff),
     m_rxMpduReferenceNumber (0xffffffff),
+    m_rxPackets (0),
+    m_rxPacketCopies (0),
     m_endRxEvent (),
     m_endPlcpRxEvent (),
     m_standard (WIFI_PHY_STANDARD_UNSPECIFIED),
@@ -364,6 +376,8 @@ WifiPhy::WifiPhy ()
     m_initialChannelNumber (0),
     m_totalAmpduSize (0),
     m_totalAmpduNumSymbols (0),
+    m_txDurationCacheHits (0),
+    m_txDurationCacheMisses (0),
     m_currentEvent (0),
     m_wifiRadioEnergyModel (0)
 {
@@ -2292,8 +2306,34 @@ WifiPhy::CalculatePlcpPreambleAndHeaderDuration (WifiTxVector txVector)
 Time
 WifiPhy::CalculateTxDuration (uint32_t size, WifiTxVector txVector, uint16_t frequency, MpduType mpdutype, uint8_t incFlag)
 {
+  //The MPDUs of an A-MPDU depend on the previous MPDUs, and update them
+  if (mpdutype != NORMAL_MPDU || m_txDurationCacheSize == 0)
+    {
+      return CalculatePlcpPreambleAndHeaderDuration (txVector)
+             + GetPayloadDuration (size, txVector, frequency, mpdutype, incFlag);
+    }
+  TxDurationKey key ((static_cast<uint64_t> (size) << 32) | txVector.GetMode ().GetUid (),
+                     (static_cast<uint64_t> (frequency) << 48)
+                     | (static_cast<uint64_t> (txVector.GetGuardInterval ()) << 33)
+                     | (static_cast<uint64_t> (txVector.GetPreambleType ()) << 25)
+                     | (static_cast<uint64_t> (txVector.GetChannelWidth ()) << 17)
+                     | (static_cast<uint64_t> (txVector.GetNss ()) << 9)
+                     | (static_cast<uint64_t> (txVector.GetNess ()) << 1)
+                     | txVector.IsStbc ());
+  std::map<TxDurationKey, Time>::const_iterator it = m_txDurations.find (key);
+  if (it != m_txDurations.end ())
+    {
+      m_txDurationCacheHits++;
+      return it->second;
+    }
+  m_txDurationCacheMisses++;
   Time duration = CalculatePlcpPreambleAndHeaderDuration (txVector)
     + GetPayloadDuration (size, txVector, frequency, mpdutype, incFlag);
+  if (m_txDurations.size () >= m_txDurationCacheSize)
+    {
+      m_txDurations.clear ();
+    }
+  m_txDurations.insert (std::make_pair (key, duration));
   return duration;
 }
 
@@ -2394,10 +2434,13 @@ WifiPhy::SendPacket (Ptr<const Packet> packet, WifiTxVector txVector, MpduType m
       //send the first MPDU in an MPDU
       m_txMpduReferenceNumber++;
     }
-  MpduInfo aMpdu;
-  aMpdu.type = mpdutype;
-  aMpdu.mpduRefNumber = m_txMpduReferenceNumber;
-  NotifyMonitorSniffTx (packet, GetFrequency (), txVector, aMpdu);
+  if (!m_phyMonitorSniffTxTrace.IsEmpty ())
+    {
+      MpduInfo aMpdu;
+      aMpdu.type = mpdutype;
+      aMpdu.mpduRefNumber = m_txMpduReferenceNumber;
+      NotifyMonitorSniffTx (packet, GetFrequency (), txVector, aMpdu);
+    }
   m_state->SwitchToTx (txDuration, packet, GetPowerDbm (txVector.GetTxPowerLevel ()), txVector);
 
   Ptr<Packet> newPacket = packet->Copy (); // obtain non-const Packet
@@ -2420,10 +2463,11 @@ WifiPhy::SendPacket (Ptr<const Packet> packet, WifiTxVector txVector, MpduType m
 }
 
 void
-WifiPhy::StartReceivePreambleAndHeader (Ptr<Packet> packet, double rxPowerW, Time rxDuration)
+WifiPhy::StartReceivePreambleAndHeader (Ptr<const Packet> packet, double rxPowerW, Time rxDuration)
 {
+  m_rxPackets++;
   WifiPhyTag tag;
-  bool found = packet->RemovePacketTag (tag);
+  bool found = packet->PeekPacketTag (tag);
   if (!found)
     {
       NS_FATAL_ERROR ("Received Wi-Fi Signal with no WifiPhyTag");
@@ -2565,7 +2609,7 @@ WifiPhy::MaybeCcaBusyDuration ()
 }
 
 void
-WifiPhy::StartReceivePacket (Ptr<Packet> packet,
+WifiPhy::StartReceivePacket (Ptr<const Packet> packet,
                              WifiTxVector txVector,
                              MpduType mpdutype,
                              Ptr<InterferenceHelper::Event> event)
@@ -2603,7 +2647,7 @@ WifiPhy::StartReceivePacket (Ptr<Packet> packet,
 }
 
 void
-WifiPhy::EndReceive (Ptr<Packet> packet, WifiPreamble preamble, MpduType mpdutype, Ptr<InterferenceHelper::Event> event)
+WifiPhy::EndReceive (Ptr<const Packet> packet, WifiPreamble preamble, MpduType mpdutype, Ptr<InterferenceHelper::Event> event)
 {
   NS_LOG_FUNCTION (this << packet << event);
   NS_ASSERT (IsStateRx ());
@@ -2621,15 +2665,23 @@ WifiPhy::EndReceive (Ptr<Packet> packet, WifiPreamble preamble, MpduType mpdutyp
 
       if (m_random->GetValue () > snrPer.per)
         {
-          NotifyRxEnd (packet);
-          SignalNoiseDbm signalNoise;
-          signalNoise.signal = RatioToDb (event->GetRxPowerW ()) + 30;
-          signalNoise.noise = RatioToDb (event->GetRxPowerW () / snrPer.snr) + 30;
-          MpduInfo aMpdu;
-          aMpdu.type = mpdutype;
-          aMpdu.mpduRefNumber = m_rxMpduReferenceNumber;
-          NotifyMonitorSniffRx (packet, GetFrequency (), event->GetTxVector (), aMpdu, signalNoise);
-          m_state->SwitchFromRxEndOk (packet, snrPer.snr, event->GetTxVector ());
+          //the packet may be shared with the other receivers: copy it for the MAC
+          Ptr<Packet> copy = packet->Copy ();
+          WifiPhyTag tag;
+          copy->RemovePacketTag (tag);
+          m_rxPacketCopies++;
+          NotifyRxEnd (copy);
+          if (!m_phyMonitorSniffRxTrace.IsEmpty ())
+            {
+              SignalNoiseDbm signalNoise;
+              signalNoise.signal = RatioToDb (event->GetRxPowerW ()) + 30;
+              signalNoise.noise = RatioToDb (event->GetRxPowerW () / snrPer.snr) + 30;
+              MpduInfo aMpdu;
+              aMpdu.type = mpdutype;
+              aMpdu.mpduRefNumber = m_rxMpduReferenceNumber;
+              NotifyMonitorSniffRx (copy, GetFrequency (), event->GetTxVector (), aMpdu, signalNoise);
+            }
+          m_state->SwitchFromRxEndOk (copy, snrPer.snr, event->GetTxVector ());
         }
       else
         {
@@ -3644,6 +3696,30 @@ WifiPhy::GetLastRxStartTime (void) const
   return m_state->GetLastRxStartTime ();
 }
 
+uint64_t
+WifiPhy::GetRxPacketCopies (void) const
+{
+  return m_rxPacketCopies;
+}
+
+uint64_t
+WifiPhy::GetRxPacketCopiesAvoided (void) const
+{
+  return m_rxPackets - m_rxPacketCopies;
+}
+
+uint64_t
+WifiPhy::GetTxDurationCacheHits (void) const
+{
+  return m_txDurationCacheHits;
+}
+
+uint64_t
+WifiPhy::GetTxDurationCacheMisses (void) const
+{
+  return m_txDurationCacheMisses;
+}
+
 void
 WifiPhy::SwitchMaybeToCcaBusy (void)
 {
@@ -3680,7 +3756,7 @@ WifiPhy::AbortCurrentReception ()
 }
 
 void
-WifiPhy::StartRx (Ptr<Packet> packet, WifiTxVector txVector, MpduType mpdutype, double rxPowerW, Time rxDuration, Ptr<InterferenceHelper::Event> event)
+WifiPhy::StartRx (Ptr<const Packet> packet, WifiTxVector txVector, MpduType mpdutype, double rxPowerW, Time rxDuration, Ptr<InterferenceHelper::Event> event)
 {
   NS_LOG_FUNCTION (this << packet << txVector << +mpdutype << rxPowerW << rxDuration);
   if (rxPowerW > GetEdThresholdW ()) //checked here, no need to check in the payload reception (current implementation assumes constant rx power over the packet duration)
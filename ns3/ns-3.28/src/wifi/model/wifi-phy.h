@@ -106,7 +106,8 @@ public:
   void SetReceiveOkCallback (RxOkCallback callback);
   /**
    * \param callback the callback to invoke
-   *        upon erroneous packet reception.
+   *        upon erroneous packet reception, with the packet shared by
+   *        all the receivers of the channel, still carrying the WifiPhyTag.
    */
   void SetReceiveErrorCallback (RxErrorCallback callback);
 
@@ -133,11 +134,14 @@ public:
   /**
    * Starting receiving the plcp of a packet (i.e. the first bit of the preamble has arrived).
    *
+   * The packet may be shared with the other receivers of the transmission:
+   * it is copied only when it is successfully received and handed to the MAC.
+   *
    * \param packet the arriving packet
    * \param rxPowerW the receive power in W
    * \param rxDuration the duration needed for the reception of the packet
    */
-  void StartReceivePreambleAndHeader (Ptr<Packet> packet,
+  void StartReceivePreambleAndHeader (Ptr<const Packet> packet,
                                       double rxPowerW,
                                       Time rxDuration);
 
@@ -149,7 +153,7 @@ public:
    * \param mpdutype the type of the MPDU as defined in WifiPhy::MpduType.
    * \param event the corresponding event of the first time the packet arrives
    */
-  void StartReceivePacket (Ptr<Packet> packet,
+  void StartReceivePacket (Ptr<const Packet> packet,
                            WifiTxVector txVector,
                            MpduType mpdutype,
                            Ptr<InterferenceHelper::Event> event);
@@ -162,7 +166,7 @@ public:
    * \param mpdutype the type of the MPDU as defined in WifiPhy::MpduType.
    * \param event the corresponding event of the first time the packet arrives
    */
-  void EndReceive (Ptr<Packet> packet, WifiPreamble preamble, MpduType mpdutype, Ptr<InterferenceHelper::Event> event);
+  void EndReceive (Ptr<const Packet> packet, WifiPreamble preamble, MpduType mpdutype, Ptr<InterferenceHelper::Event> event);
 
   /**
    * \param packet the packet to send
@@ -243,6 +247,28 @@ public:
    */
   Time GetLastRxStartTime (void) const;
 
+  /**
+   * \return the number of packets copied for the MAC, out of those
+   *         received successfully
+   */
+  uint64_t GetRxPacketCopies (void) const;
+  /**
+   * \return the number of packets received from the channel and not
+   *         copied, since they were dropped or received with errors
+   */
+  uint64_t GetRxPacketCopiesAvoided (void) const;
+
+  /**
+   * \return the number of durations of CalculateTxDuration() found in
+   *         the cache of the recent transmission durations
+   */
+  uint64_t GetTxDurationCacheHits (void) const;
+  /**
+   * \return the number of durations of CalculateTxDuration() computed
+   *         and added to the cache of the recent transmission durations
+   */
+  uint64_t GetTxDurationCacheMisses (void) const;
+
   /**
    * \param size the number of bytes in the packet to send
    * \param txVector the TXVECTOR used for the transmission of this packet
@@ -258,6 +284,10 @@ public:
    * \param mpdutype the type of the MPDU as defined in WifiPhy::MpduType.
    * \param incFlag this flag is used to indicate that the static variables need to be update or not. This function is called a couple of times for the same packet so static variables should not be increased each time.
    *
+   * The durations of the MPDUs which are not in an A-MPDU are kept in a
+   * cache of TxDurationCacheSize entries, keyed by the size, frequency and
+   * the TXVECTOR fields they depend on.
+   *
    * \return the total amount of time this PHY will stay busy for the transmission of these bytes.
    */
   Time CalculateTxDuration (uint32_t size, WifiTxVector txVector, uint16_t frequency, MpduType mpdutype, uint8_t incFlag);
@@ -1569,6 +1599,8 @@ protected:
   bool m_plcpSuccess;                  //!< Flag if the PLCP of the packet or the first MPDU in an A-MPDU has been received
   uint32_t m_txMpduReferenceNumber;    //!< A-MPDU reference number to identify all transmitted subframes belonging to the same received A-MPDU
   uint32_t m_rxMpduReferenceNumber;    //!< A-MPDU reference number to identify all received subframes belonging to the same received A-MPDU
+  uint64_t m_rxPackets;                //!< The number of packets received from the channel
+  uint64_t m_rxPacketCopies;           //!< The number of packets copied for the MAC
 
   EventId m_endRxEvent;                //!< the end reeive event
   EventId m_endPlcpRxEvent;            //!< the end PLCP receive event
@@ -1689,7 +1721,7 @@ private:
    * \param rxDuration the duration needed for the reception of the packet
    * \param event the corresponding event of the first time the packet arrives
    */
-  void StartRx (Ptr<Packet> packet,
+  void StartRx (Ptr<const Packet> packet,
                 WifiTxVector txVector,
                 MpduType mpdutype,
                 double rxPowerW,
@@ -1722,7 +1754,8 @@ private:
 
   /**
    * The trace source fired when a packet begins the reception process from
-   * the medium.
+   * the medium.  The packet is shared by all the receivers of the channel,
+   * and still carries the WifiPhyTag.
    *
    * \see class CallBackTraceSource
    */
@@ -1738,6 +1771,8 @@ private:
 
   /**
    * The trace source fired when the phy layer drops a packet it has received.
+   * The packet is shared by all the receivers of the channel, and still
+   * carries the WifiPhyTag.
    *
    * \see class CallBackTraceSource
    */
@@ -1850,6 +1885,13 @@ private:
   uint32_t m_totalAmpduSize;     //!< Total size of the previously transmitted MPDUs in an A-MPDU, used for the computation of the number of symbols needed for the last MPDU in the A-MPDU
   double m_totalAmpduNumSymbols; //!< Number of symbols previously transmitted for the MPDUs in an A-MPDU, used for the computation of the number of symbols needed for the last MPDU in the A-MPDU
 
+  /// The key of a transmission duration: size and mode, then the other TXVECTOR fields and the frequency
+  typedef std::pair<uint64_t, uint64_t> TxDurationKey;
+  std::map<TxDurationKey, Time> m_txDurations; //!< The cache of the recent transmission durations
+  uint32_t m_txDurationCacheSize;              //!< The maximum number of durations in the cache
+  uint64_t m_txDurationCacheHits;              //!< The number of durations found in the cache
+  uint64_t m_txDurationCacheMisses;            //!< The number of durations computed for the cache
+
   Ptr<NetDevice>     m_device;   //!< Pointer to the device
   Ptr<MobilityModel> m_mobility; //!< Pointer to the mobility model
 
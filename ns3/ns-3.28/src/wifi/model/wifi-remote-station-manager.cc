@@ -23,6 +23,7 @@
 #include "ns3/log.h"
 #include "ns3/boolean.h"
 #include "ns3/enum.h"
+#include "ns3/memory-accounting.h"
 #include "wifi-mac.h"
 #include "wifi-utils.h"
 #include "wifi-mac-header.h"
@@ -1648,17 +1649,33 @@ WifiRemoteStationManager::GetInfo (Mac48Address address)
   return state->m_info;
 }
 
+/**
+ * \param address a MAC address
+ * \return the 48 bits of the address, as a key of the station indexes
+ */
+static uint64_t
+GetAddressKey (Mac48Address address)
+{
+  uint8_t buffer[6];
+  address.CopyTo (buffer);
+  uint64_t key = 0;
+  for (uint8_t i = 0; i < 6; i++)
+    {
+      key = (key << 8) | buffer[i];
+    }
+  return key;
+}
+
 WifiRemoteStationState *
 WifiRemoteStationManager::LookupState (Mac48Address address) const
 {
   NS_LOG_FUNCTION (this << address);
-  for (StationStates::const_iterator i = m_states.begin (); i != m_states.end (); i++)
+  uint64_t key = GetAddressKey (address);
+  StationStateIndex::const_iterator i = m_stateIndex.find (key);
+  if (i != m_stateIndex.end ())
     {
-      if ((*i)->m_address == address)
-        {
-          NS_LOG_DEBUG ("WifiRemoteStationManager::LookupState returning existing state");
-          return (*i);
-        }
+      NS_LOG_DEBUG ("WifiRemoteStationManager::LookupState returning existing state");
+      return i->second;
     }
   WifiRemoteStationState *state = new WifiRemoteStationState ();
   state->m_state = WifiRemoteStationState::BRAND_NEW;
@@ -1679,6 +1696,7 @@ WifiRemoteStationManager::LookupState (Mac48Address address) const
   state->m_vhtSupported = false;
   state->m_heSupported = false;
   const_cast<WifiRemoteStationManager *> (this)->m_states.push_back (state);
+  const_cast<WifiRemoteStationManager *> (this)->m_stateIndex[key] = state;
   NS_LOG_DEBUG ("WifiRemoteStationManager::LookupState returning new state");
   return state;
 }
@@ -1702,13 +1720,11 @@ WifiRemoteStation *
 WifiRemoteStationManager::Lookup (Mac48Address address, uint8_t tid) const
 {
   NS_LOG_FUNCTION (this << address << +tid);
-  for (Stations::const_iterator i = m_stations.begin (); i != m_stations.end (); i++)
+  uint64_t key = (GetAddressKey (address) << 8) | tid;
+  StationIndex::const_iterator i = m_stationIndex.find (key);
+  if (i != m_stationIndex.end ())
     {
-      if ((*i)->m_tid == tid
-          && (*i)->m_state->m_address == address)
-        {
-          return (*i);
-        }
+      return i->second;
     }
   WifiRemoteStationState *state = LookupState (address);
 
@@ -1718,6 +1734,7 @@ WifiRemoteStationManager::Lookup (Mac48Address address, uint8_t tid) const
   station->m_ssrc = 0;
   station->m_slrc = 0;
   const_cast<WifiRemoteStationManager *> (this)->m_stations.push_back (station);
+  const_cast<WifiRemoteStationManager *> (this)->m_stationIndex[key] = station;
   return station;
 }
 
@@ -1870,11 +1887,13 @@ WifiRemoteStationManager::Reset (void)
       delete (*i);
     }
   m_states.clear ();
+  m_stateIndex.clear ();
   for (Stations::const_iterator i = m_stations.begin (); i != m_stations.end (); i++)
     {
       delete (*i);
     }
   m_stations.clear ();
+  m_stationIndex.clear ();
   m_bssBasicRateSet.clear ();
   m_bssBasicMcsSet.clear ();
 }
@@ -2277,6 +2296,52 @@ WifiRemoteStation::~WifiRemoteStation ()
   NS_LOG_FUNCTION (this);
 }
 
+/**
+ * \ingroup wifi
+ * \returns The index of the stations in MemoryAccounting.
+ */
+static uint32_t
+GetStationAccountingIndex (void)
+{
+  static uint32_t index = MemoryAccounting::Register ("ns3::WifiRemoteStation");
+  return index;
+}
+
+void *
+WifiRemoteStation::operator new (std::size_t size)
+{
+  return MemoryAccounting::New (GetStationAccountingIndex (), size);
+}
+
+void
+WifiRemoteStation::operator delete (void *p, std::size_t size)
+{
+  MemoryAccounting::Delete (p, GetStationAccountingIndex (), size);
+}
+
+/**
+ * \ingroup wifi
+ * \returns The index of the station states in MemoryAccounting.
+ */
+static uint32_t
+GetStateAccountingIndex (void)
+{
+  static uint32_t index = MemoryAccounting::Register ("ns3::WifiRemoteStationState");
+  return index;
+}
+
+void *
+WifiRemoteStationState::operator new (std::size_t size)
+{
+  return MemoryAccounting::New (GetStateAccountingIndex (), size);
+}
+
+void
+WifiRemoteStationState::operator delete (void *p, std::size_t size)
+{
+  MemoryAccounting::Delete (p, GetStateAccountingIndex (), size);
+}
+
 WifiRemoteStationInfo::WifiRemoteStationInfo ()
   : m_memoryTime (Seconds (1.0)),
     m_lastUpdate (Seconds (0.0)),
@@ -21,6 +21,7 @@
 #ifndef WIFI_REMOTE_STATION_MANAGER_H
 #define WIFI_REMOTE_STATION_MANAGER_H
 
+#include <unordered_map>
 #include "ns3/traced-callback.h"
 #include "ns3/packet.h"
 #include "ns3/object.h"
@@ -1448,6 +1449,14 @@ private:
    * A vector of WifiRemoteStationStates
    */
   typedef std::vector <WifiRemoteStationState *> StationStates;
+  /**
+   * The WifiRemoteStationStates by address
+   */
+  typedef std::unordered_map <uint64_t, WifiRemoteStationState *> StationStateIndex;
+  /**
+   * The WifiRemoteStations by address and TID
+   */
+  typedef std::unordered_map <uint64_t, WifiRemoteStation *> StationIndex;
 
   /**
    * This is a pointer to the WifiPhy associated with this
@@ -1480,6 +1489,8 @@ private:
 
   StationStates m_states;  //!< States of known stations
   Stations m_stations;     //!< Information for each known stations
+  StationStateIndex m_stateIndex; //!< States of known stations, by address
+  StationIndex m_stationIndex;    //!< Information for each known stations, by address and TID
 
   WifiMode m_defaultTxMode; //!< The default transmission mode
   WifiMode m_defaultTxMcs;   //!< The default transmission modulation-coding scheme (MCS)
@@ -1569,6 +1580,22 @@ struct WifiRemoteStationState
   bool m_htSupported;         //!< Flag if HT is supported by the station
   bool m_vhtSupported;        //!< Flag if VHT is supported by the station
   bool m_heSupported;         //!< Flag if HE is supported by the station
+
+  /**
+   * Allocate a state, counted as "ns3::WifiRemoteStationState" by
+   * MemoryAccounting.
+   *
+   * \param [in] size The size of the state, in bytes.
+   * \returns Storage for the state.
+   */
+  static void * operator new (std::size_t size);
+  /**
+   * Release the storage of a state.
+   *
+   * \param [in] p The storage to release.
+   * \param [in] size The size of the state, in bytes.
+   */
+  static void operator delete (void *p, std::size_t size);
 };
 
 /**
@@ -1585,6 +1612,22 @@ struct WifiRemoteStationState
 struct WifiRemoteStation
 {
   virtual ~WifiRemoteStation ();
+  /**
+   * Allocate a station, counted as "ns3::WifiRemoteStation" by
+   * MemoryAccounting with the size of its rate control subclass.
+   *
+   * \param [in] size The size of the station, in bytes.
+   * \returns Storage for the station.
+   */
+  static void * operator new (std::size_t size);
+  /**
+   * Release the storage of a station.
+   *
+   * \param [in] p The storage to release.
+   * \param [in] size The size of the station, in bytes.
+   */
+  static void operator delete (void *p, std::size_t size);
+
   WifiRemoteStationState *m_state;  //!< Remote station state
   uint32_t m_ssrc;                  //!< STA short retry count
   uint32_t m_slrc;                  //!< STA long retry count
@@ -21,10 +21,16 @@
 #include "ns3/simulator.h"
 #include "ns3/log.h"
 #include "ns3/pointer.h"
+#include "ns3/boolean.h"
+#include "ns3/double.h"
+#include "ns3/mobility-model.h"
 #include "yans-wifi-channel.h"
 #include "ns3/propagation-loss-model.h"
 #include "ns3/propagation-delay-model.h"
 #include "wifi-utils.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
 
 namespace ns3 {
 
@@ -47,6 +53,31 @@ YansWifiChannel::GetTypeId (void)
                    PointerValue (),
                    MakePointerAccessor (&YansWifiChannel::m_delay),
                    MakePointerChecker<PropagationDelayModel> ())
+    .AddAttribute ("SpatialIndex",
+                   "Keep the receivers positions in a grid, and deliver the packets "
+                   "to the receivers within the range of the transmission only.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&YansWifiChannel::m_spatialIndex),
+                   MakeBooleanChecker ())
+    .AddAttribute ("CullingMargin",
+                   "With SpatialIndex, the signals received this many dB below the lowest "
+                   "EnergyDetectionThreshold of the receivers are not delivered.",
+                   DoubleValue (20.0),
+                   MakeDoubleAccessor (&YansWifiChannel::m_cullingMargin),
+                   MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("CheckCulling",
+                   "With SpatialIndex, compute the power received by the receivers out of "
+                   "range too, and abort if one receives it, after its RxGain, less than "
+                   "CullingMargin dB below its EnergyDetectionThreshold.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&YansWifiChannel::m_checkCulling),
+                   MakeBooleanChecker ())
+    .AddAttribute ("LinkCache",
+                   "Keep the power received through the deterministic propagation loss "
+                   "models, and the deterministic delay, of the links between static PHYs.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&YansWifiChannel::m_linkCache),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
@@ -54,6 +85,8 @@ YansWifiChannel::GetTypeId (void)
 YansWifiChannel::YansWifiChannel ()
 {
   NS_LOG_FUNCTION (this);
+  m_index.valid = false;
+  m_links.valid = false;
 }
 
 YansWifiChannel::~YansWifiChannel ()
@@ -62,11 +95,33 @@ YansWifiChannel::~YansWifiChannel ()
   m_phyList.clear ();
 }
 
+void
+YansWifiChannel::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (std::vector<Ptr<MobilityModel> >::const_iterator i = m_mobility.begin ();
+       i != m_mobility.end (); ++i)
+    {
+      (*i)->TraceDisconnectWithoutContext ("CourseChange", MakeCallback (&YansWifiChannel::CourseChanged, this));
+    }
+  m_mobility.clear ();
+  m_mobilityIndex.clear ();
+  m_moves.clear ();
+  m_moving.clear ();
+  m_index = SpatialIndex ();
+  m_index.valid = false;
+  m_links = LinkCache ();
+  m_links.valid = false;
+  Channel::DoDispose ();
+}
+
 void
 YansWifiChannel::SetPropagationLossModel (const Ptr<PropagationLossModel> loss)
 {
   NS_LOG_FUNCTION (this << loss);
   m_loss = loss;
+  m_index.valid = false;
+  m_links.valid = false;
 }
 
 void
@@ -74,6 +129,7 @@ YansWifiChannel::SetPropagationDelayModel (const Ptr<PropagationDelayModel> dela
 {
   NS_LOG_FUNCTION (this << delay);
   m_delay = delay;
+  m_links.valid = false;
 }
 
 void
@@ -82,42 +138,380 @@ YansWifiChannel::Send (Ptr<YansWifiPhy> sender, Ptr<const Packet> packet, double
   NS_LOG_FUNCTION (this << sender << packet << txPowerDbm << duration.GetSeconds ());
   Ptr<MobilityModel> senderMobility = sender->GetMobility ();
   NS_ASSERT (senderMobility != 0);
-  for (PhyList::const_iterator i = m_phyList.begin (); i != m_phyList.end (); i++)
+  LinkRow *links = m_linkCache ? GetLinks (sender, txPowerDbm) : 0;
+  if (m_spatialIndex && FindReceivers (senderMobility, txPowerDbm))
     {
-      if (sender != (*i))
+      const double *rxPowers = links == 0 ? CalcRxPowers (sender, senderMobility, txPowerDbm, &m_index.candidates) : 0;
+      for (uint32_t k = 0; k < m_index.candidates.size (); k++)
         {
-          //For now don't account for inter channel interference nor channel bonding
-          if ((*i)->GetChannelNumber () != sender->GetChannelNumber ())
-            {
-              continue;
-            }
+          SendTo (sender, senderMobility, m_index.candidates[k], packet, txPowerDbm, duration, links,
+                  rxPowers != 0 ? &rxPowers[k] : 0);
+        }
+      if (m_checkCulling)
+        {
+          CheckReceivers (sender, senderMobility, txPowerDbm);
+        }
+      return;
+    }
+  const double *rxPowers = links == 0 ? CalcRxPowers (sender, senderMobility, txPowerDbm, 0) : 0;
+  for (uint32_t j = 0; j < m_phyList.size (); j++)
+    {
+      SendTo (sender, senderMobility, j, packet, txPowerDbm, duration, links,
+              rxPowers != 0 ? &rxPowers[j] : 0);
+    }
+}
 
-          Ptr<MobilityModel> receiverMobility = (*i)->GetMobility ()->GetObject<MobilityModel> ();
-          Time delay = m_delay->GetDelay (senderMobility, receiverMobility);
-          double rxPowerDbm = m_loss->CalcRxPower (txPowerDbm, senderMobility, receiverMobility);
-          NS_LOG_DEBUG ("propagation: txPower=" << txPowerDbm << "dbm, rxPower=" << rxPowerDbm << "dbm, " <<
-                        "distance=" << senderMobility->GetDistanceFrom (receiverMobility) << "m, delay=" << delay);
-          Ptr<Packet> copy = packet->Copy ();
-          Ptr<NetDevice> dstNetDevice = (*i)->GetDevice ();
-          uint32_t dstNode;
-          if (dstNetDevice == 0)
-            {
-              dstNode = 0xffffffff;
-            }
-          else
+const double *
+YansWifiChannel::CalcRxPowers (Ptr<YansWifiPhy> sender, Ptr<MobilityModel> senderMobility, double txPowerDbm,
+                               const std::vector<uint32_t> *receivers) const
+{
+  uint32_t n = receivers != 0 ? receivers->size () : m_phyList.size ();
+  if (n == 0 || m_loss == 0 || !m_loss->IsBatchSupported ())
+    {
+      return 0;
+    }
+  TrackMobility ();
+  m_rxPositions.clear ();
+  m_rxReceivers.clear ();
+  for (uint32_t k = 0; k < n; k++)
+    {
+      uint32_t j = receivers != 0 ? (*receivers)[k] : k;
+      // Skip the receivers SendTo() skips, as CalcRxPower() is not called for them.
+      if (m_phyList[j] == sender || m_phyList[j]->GetChannelNumber () != sender->GetChannelNumber ())
+        {
+          continue;
+        }
+      m_rxPositions.push_back (m_mobility[j]->GetPosition ());
+      m_rxReceivers.push_back (k);
+    }
+  uint32_t m = m_rxReceivers.size ();
+  m_rxPowers.resize (n);
+  if (m > 0)
+    {
+      m_loss->CalcRxPowers (txPowerDbm, senderMobility->GetPosition (), &m_rxPositions[0], &m_rxPowers[0], m);
+    }
+  // Move each power to the position of its receiver, from the last one
+  // as the positions are never below the indices.
+  for (uint32_t i = m; i-- > 0; )
+    {
+      m_rxPowers[m_rxReceivers[i]] = m_rxPowers[i];
+    }
+  return &m_rxPowers[0];
+}
+
+void
+YansWifiChannel::SendTo (Ptr<YansWifiPhy> sender, Ptr<MobilityModel> senderMobility, uint32_t j,
+                         Ptr<const Packet> packet, double txPowerDbm, Time duration, LinkRow *links,
+                         const double *batchRxPowerDbm) const
+{
+  Ptr<YansWifiPhy> receiver = m_phyList[j];
+  if (sender == receiver)
+    {
+      return;
+    }
+  //For now don't account for inter channel interference nor channel bonding
+  if (receiver->GetChannelNumber () != sender->GetChannelNumber ())
+    {
+      return;
+    }
+
+  Ptr<MobilityModel> receiverMobility;
+  Time delay;
+  double rxPowerDbm;
+  if (links != 0 && !m_moving[j])
+    {
+      receiverMobility = m_mobility[j];
+      LinkRow::iterator link = links->find (j);
+      if (link == links->end () || link->second.moves != m_moves[j])
+        {
+          LinkBudget &budget = (*links)[j];
+          budget.moves = m_moves[j];
+          budget.rxPowerDbm = m_loss->CalcRxPowerUntil (txPowerDbm, senderMobility, receiverMobility, m_links.random);
+          budget.delay = m_delay->GetDelay (senderMobility, receiverMobility);
+          link = links->find (j);
+        }
+      rxPowerDbm = link->second.rxPowerDbm;
+      if (m_links.random != 0)
+        {
+          rxPowerDbm = m_links.random->CalcRxPower (rxPowerDbm, senderMobility, receiverMobility);
+        }
+      delay = m_links.deterministicDelay ? link->second.delay : m_delay->GetDelay (senderMobility, receiverMobility);
+    }
+  else if (batchRxPowerDbm != 0)
+    {
+      receiverMobility = m_mobility[j];
+      delay = m_delay->GetDelay (senderMobility, receiverMobility);
+      rxPowerDbm = *batchRxPowerDbm;
+    }
+  else
+    {
+      receiverMobility = receiver->GetMobility ()->GetObject<MobilityModel> ();
+      delay = m_delay->GetDelay (senderMobility, receiverMobility);
+      rxPowerDbm = m_loss->CalcRxPower (txPowerDbm, senderMobility, receiverMobility);
+    }
+  NS_LOG_DEBUG ("propagation: txPower=" << txPowerDbm << "dbm, rxPower=" << rxPowerDbm << "dbm, " <<
+                "distance=" << senderMobility->GetDistanceFrom (receiverMobility) << "m, delay=" << delay);
+  Ptr<NetDevice> dstNetDevice = receiver->GetDevice ();
+  uint32_t dstNode;
+  if (dstNetDevice == 0)
+    {
+      dstNode = 0xffffffff;
+    }
+  else
+    {
+      dstNode = dstNetDevice->GetNode ()->GetId ();
+    }
+
+  Simulator::ScheduleWithContext (dstNode,
+                                  delay, &YansWifiChannel::Receive,
+                                  receiver, packet, rxPowerDbm, duration);
+}
+
+bool
+YansWifiChannel::FindReceivers (Ptr<MobilityModel> senderMobility, double txPowerDbm) const
+{
+  if (!m_index.valid)
+    {
+      BuildIndex ();
+    }
+  double range = GetRange (txPowerDbm);
+  if (range == std::numeric_limits<double>::infinity ())
+    {
+      return false;
+    }
+
+  m_index.candidates.clear ();
+  Vector position = senderMobility->GetPosition ();
+  double maxX = m_index.width - 1;
+  double maxY = m_index.height - 1;
+  uint32_t x0 = std::max (0.0, std::min (maxX, std::floor ((position.x - range - m_index.minX) / m_index.cellSize)));
+  uint32_t x1 = std::max (0.0, std::min (maxX, std::floor ((position.x + range - m_index.minX) / m_index.cellSize)));
+  uint32_t y0 = std::max (0.0, std::min (maxY, std::floor ((position.y - range - m_index.minY) / m_index.cellSize)));
+  uint32_t y1 = std::max (0.0, std::min (maxY, std::floor ((position.y + range - m_index.minY) / m_index.cellSize)));
+  // The distance in the plane never exceeds the distance in space.
+  double range2 = range * range;
+  for (uint32_t cy = y0; cy <= y1; ++cy)
+    {
+      for (uint32_t cx = x0; cx <= x1; ++cx)
+        {
+          uint32_t cell = cy * m_index.width + cx;
+          for (uint32_t k = m_index.cellStart[cell]; k < m_index.cellStart[cell + 1]; ++k)
             {
-              dstNode = dstNetDevice->GetNode ()->GetId ();
+              uint32_t j = m_index.cells[k];
+              double dx = m_index.x[j] - position.x;
+              double dy = m_index.y[j] - position.y;
+              if (dx * dx + dy * dy <= range2)
+                {
+                  m_index.candidates.push_back (j);
+                }
             }
+        }
+    }
+  m_index.candidates.insert (m_index.candidates.end (), m_index.moving.begin (), m_index.moving.end ());
+  // Schedule the receptions in the order of the PHY list, as without the index.
+  std::sort (m_index.candidates.begin (), m_index.candidates.end ());
+  NS_LOG_DEBUG ("range=" << range << "m, " << m_index.candidates.size () << " of " <<
+                m_phyList.size () << " receivers");
+  return true;
+}
+
+void
+YansWifiChannel::CheckReceivers (Ptr<YansWifiPhy> sender, Ptr<MobilityModel> senderMobility, double txPowerDbm) const
+{
+  std::vector<bool> visited (m_phyList.size (), false);
+  for (std::vector<uint32_t>::const_iterator i = m_index.candidates.begin ();
+       i != m_index.candidates.end (); i++)
+    {
+      visited[*i] = true;
+    }
+  for (uint32_t j = 0; j < m_phyList.size (); ++j)
+    {
+      Ptr<YansWifiPhy> receiver = m_phyList[j];
+      if (visited[j] || receiver == sender || receiver->GetChannelNumber () != sender->GetChannelNumber ())
+        {
+          continue;
+        }
+      Ptr<MobilityModel> receiverMobility = receiver->GetMobility ()->GetObject<MobilityModel> ();
+      double rxPowerDbm = m_loss->CalcRxPower (txPowerDbm, senderMobility, receiverMobility);
+      // The power the PHY sees, against its own threshold less the margin
+      double thresholdDbm = receiver->GetEdThreshold () - m_cullingMargin;
+      if (rxPowerDbm + receiver->GetRxGain () >= thresholdDbm)
+        {
+          NS_FATAL_ERROR ("Receiver " << j << " left out at " << senderMobility->GetDistanceFrom (receiverMobility) <<
+                          "m with rxPower=" << rxPowerDbm + receiver->GetRxGain () << "dbm, above its culling threshold " <<
+                          thresholdDbm << "dbm");
+        }
+    }
+}
+
+void
+YansWifiChannel::BuildIndex (void) const
+{
+  NS_LOG_FUNCTION (this);
+  uint32_t n = m_phyList.size ();
+  TrackMobility ();
+  m_index.ranges.clear ();
+  m_index.moving.clear ();
+  m_index.x.assign (n, 0);
+  m_index.y.assign (n, 0);
+  m_index.minRxPowerDbm = std::numeric_limits<double>::infinity ();
+  m_index.minX = std::numeric_limits<double>::infinity ();
+  m_index.minY = std::numeric_limits<double>::infinity ();
+  double maxX = -std::numeric_limits<double>::infinity ();
+  double maxY = -std::numeric_limits<double>::infinity ();
+  double maxTxPowerDbm = -std::numeric_limits<double>::infinity ();
+  for (uint32_t j = 0; j < n; ++j)
+    {
+      Ptr<YansWifiPhy> phy = m_phyList[j];
+      m_index.minRxPowerDbm = std::min (m_index.minRxPowerDbm, phy->GetEdThreshold () - phy->GetRxGain ());
+      maxTxPowerDbm = std::max (maxTxPowerDbm, phy->GetTxPowerEnd () + phy->GetTxGain ());
+      if (m_moving[j])
+        {
+          m_index.moving.push_back (j);
+          continue;
+        }
+      Vector position = m_mobility[j]->GetPosition ();
+      m_index.x[j] = position.x;
+      m_index.y[j] = position.y;
+      m_index.minX = std::min (m_index.minX, position.x);
+      m_index.minY = std::min (m_index.minY, position.y);
+      maxX = std::max (maxX, position.x);
+      maxY = std::max (maxY, position.y);
+    }
+  m_index.minRxPowerDbm -= m_cullingMargin;
+  m_index.valid = true;
+
+  uint32_t nStatic = n - m_index.moving.size ();
+  if (nStatic == 0)
+    {
+      m_index.minX = 0;
+      m_index.minY = 0;
+      maxX = 0;
+      maxY = 0;
+    }
+  /* Cells about the range of the strongest transmission, so that most
+   * lookups visit 3x3 cells, but not many more cells than receivers. */
+  double width = maxX - m_index.minX;
+  double height = maxY - m_index.minY;
+  double range = n > 0 ? GetRange (maxTxPowerDbm) : 0;
+  m_index.cellSize = std::max (1.0, std::sqrt (width * height / (4.0 * std::max (nStatic, 1u))));
+  if (range != std::numeric_limits<double>::infinity ())
+    {
+      m_index.cellSize = std::max (m_index.cellSize, range);
+    }
+  m_index.width = std::floor (width / m_index.cellSize) + 1;
+  m_index.height = std::floor (height / m_index.cellSize) + 1;
 
-          Simulator::ScheduleWithContext (dstNode,
-                                          delay, &YansWifiChannel::Receive,
-                                          (*i), copy, rxPowerDbm, duration);
+  /* Counting sort of the static receivers by cell, in PHY list order. */
+  uint32_t nCells = m_index.width * m_index.height;
+  std::vector<uint32_t> cellOf (n);
+  m_index.cellStart.assign (nCells + 1, 0);
+  for (uint32_t j = 0; j < n; ++j)
+    {
+      if (m_moving[j])
+        {
+          continue;
+        }
+      uint32_t cx = std::min<uint32_t> (m_index.width - 1, (m_index.x[j] - m_index.minX) / m_index.cellSize);
+      uint32_t cy = std::min<uint32_t> (m_index.height - 1, (m_index.y[j] - m_index.minY) / m_index.cellSize);
+      cellOf[j] = cy * m_index.width + cx;
+      m_index.cellStart[cellOf[j] + 1]++;
+    }
+  for (uint32_t c = 0; c < nCells; ++c)
+    {
+      m_index.cellStart[c + 1] += m_index.cellStart[c];
+    }
+  m_index.cells.resize (nStatic);
+  std::vector<uint32_t> next (m_index.cellStart.begin (), m_index.cellStart.end () - 1);
+  for (uint32_t j = 0; j < n; ++j)
+    {
+      if (!m_moving[j])
+        {
+          m_index.cells[next[cellOf[j]]++] = j;
+        }
+    }
+  NS_LOG_DEBUG ("grid of " << m_index.width << "x" << m_index.height << " cells of " <<
+                m_index.cellSize << "m, " << m_index.moving.size () << " moving receivers, " <<
+                "culling threshold " << m_index.minRxPowerDbm << "dbm");
+}
+
+double
+YansWifiChannel::GetRange (double txPowerDbm) const
+{
+  std::map<double, double>::const_iterator i = m_index.ranges.find (txPowerDbm);
+  if (i != m_index.ranges.end ())
+    {
+      return i->second;
+    }
+  double range = m_loss->GetMaxRange (txPowerDbm, m_index.minRxPowerDbm);
+  m_index.ranges[txPowerDbm] = range;
+  return range;
+}
+
+YansWifiChannel::LinkRow *
+YansWifiChannel::GetLinks (Ptr<YansWifiPhy> sender, double txPowerDbm) const
+{
+  TrackMobility ();
+  if (!m_links.valid || m_links.lossChanges != m_loss->GetChanges ())
+    {
+      m_links.lossChanges = m_loss->GetChanges ();
+      m_links.random = m_loss;
+      while (m_links.random != 0 && m_links.random->IsDeterministic ())
+        {
+          m_links.random = ConstCast<PropagationLossModel> (m_links.random)->GetNext ();
+        }
+      m_links.deterministicDelay = m_delay->GetInstanceTypeId () == ConstantSpeedPropagationDelayModel::GetTypeId ();
+      m_links.rows.assign (m_phyList.size (), std::map<double, LinkRow> ());
+      m_links.valid = true;
+      NS_LOG_DEBUG ("caching links up to " << m_links.random << ", deterministic delay " << m_links.deterministicDelay);
+    }
+  m_links.rows.resize (m_phyList.size ());
+  std::map<const YansWifiPhy *, uint32_t>::const_iterator i = m_phyIndex.find (PeekPointer (sender));
+  NS_ASSERT (i != m_phyIndex.end ());
+  if (m_moving[i->second])
+    {
+      return 0;
+    }
+  return &m_links.rows[i->second][txPowerDbm];
+}
+
+void
+YansWifiChannel::TrackMobility (void) const
+{
+  for (uint32_t j = m_mobility.size (); j < m_phyList.size (); ++j)
+    {
+      Ptr<MobilityModel> mobility = m_phyList[j]->GetMobility ()->GetObject<MobilityModel> ();
+      mobility->TraceConnectWithoutContext ("CourseChange", MakeCallback (&YansWifiChannel::CourseChanged, this));
+      m_mobility.push_back (mobility);
+      m_mobilityIndex.insert (std::make_pair (PeekPointer (mobility), j));
+      Vector velocity = mobility->GetVelocity ();
+      m_moves.push_back (0);
+      m_moving.push_back (velocity.x != 0 || velocity.y != 0 || velocity.z != 0);
+    }
+}
+
+void
+YansWifiChannel::CourseChanged (Ptr<const MobilityModel> mobility) const
+{
+  m_index.valid = false;
+  Vector velocity = mobility->GetVelocity ();
+  bool moving = velocity.x != 0 || velocity.y != 0 || velocity.z != 0;
+  typedef std::multimap<const MobilityModel *, uint32_t>::const_iterator Iterator;
+  std::pair<Iterator, Iterator> phys = m_mobilityIndex.equal_range (PeekPointer (mobility));
+  for (Iterator i = phys.first; i != phys.second; ++i)
+    {
+      uint32_t j = i->second;
+      m_moves[j]++;
+      m_moving[j] = moving;
+      if (j < m_links.rows.size ())
+        {
+          m_links.rows[j].clear ();
         }
     }
 }
 
 void
-YansWifiChannel::Receive (Ptr<YansWifiPhy> phy, Ptr<Packet> packet, double rxPowerDbm, Time duration)
+YansWifiChannel::Receive (Ptr<YansWifiPhy> phy, Ptr<const Packet> packet, double rxPowerDbm, Time duration)
 {
   NS_LOG_FUNCTION (phy << packet << rxPowerDbm << duration.GetSeconds ());
   phy->StartReceivePreambleAndHeader (packet, DbmToW (rxPowerDbm + phy->GetRxGain ()), duration);
@@ -139,7 +533,9 @@ void
 YansWifiChannel::Add (Ptr<YansWifiPhy> phy)
 {
   NS_LOG_FUNCTION (this << phy);
+  m_phyIndex[PeekPointer (phy)] = m_phyList.size ();
   m_phyList.push_back (phy);
+  m_index.valid = false;
 }
 
 int64_t
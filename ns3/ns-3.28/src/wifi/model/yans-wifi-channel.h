@@ -23,12 +23,16 @@
 
 #include "ns3/channel.h"
 #include "yans-wifi-phy.h"
+#include <map>
+#include <unordered_map>
+#include <vector>
 
 namespace ns3 {
 
 class NetDevice;
 class PropagationLossModel;
 class PropagationDelayModel;
+class MobilityModel;
 
 /**
  * \brief a channel to interconnect ns3::YansWifiPhy objects.
@@ -38,6 +42,26 @@ class PropagationDelayModel;
  * class and supports an ns3::PropagationLossModel and an 
  * ns3::PropagationDelayModel.  By default, no propagation models are set; 
  * it is the caller's responsibility to set them before using the channel.
+ *
+ * With the SpatialIndex attribute, the channel keeps the positions of the
+ * receivers in a grid, and only delivers a packet to the receivers within
+ * the range of the transmission.  The range is where the power received
+ * drops CullingMargin dB below the lowest energy detection threshold of
+ * the receivers, which the propagation loss model must bound (see
+ * PropagationLossModel::GetMaxRange); the PHYs would count the weaker
+ * signals as interference only.  The grid is rebuilt after a course
+ * change of any receiver, and moving receivers are always visited.
+ *
+ * With the LinkCache attribute, the channel keeps the power received and
+ * the delay of each link between two static PHYs, by transmission power,
+ * once computed.  Only the deterministic models at the head of the loss
+ * chain are cached (see PropagationLossModel::IsDeterministic): the
+ * other models are applied on top of the cached power for each packet,
+ * and so is a random delay model.  The links of a PHY are forgotten when
+ * it changes course, and all the links when the loss models notify a
+ * change (see PropagationLossModel::GetChanges), as MatrixPropagationLossModel
+ * does.  The parameters of the other propagation models must not be
+ * changed once links are cached.
  */
 class YansWifiChannel : public Channel
 {
@@ -108,15 +132,168 @@ private:
    * bit of the packet has arrived.
    *
    * \param receiver the device to which the packet is destined
-   * \param packet the packet being sent
+   * \param packet the packet being sent, shared by all the receivers
    * \param txPowerDbm the tx power associated to the packet being sent (dBm)
    * \param duration the transmission duration associated with the packet being sent
    */
-  static void Receive (Ptr<YansWifiPhy> receiver, Ptr<Packet> packet, double txPowerDbm, Time duration);
+  static void Receive (Ptr<YansWifiPhy> receiver, Ptr<const Packet> packet, double txPowerDbm, Time duration);
+
+  virtual void DoDispose (void);
+
+  /**
+   * The budget of a link between two static PHYs.
+   */
+  struct LinkBudget
+  {
+    uint32_t moves;     //!< The course changes of the receiver when the link was computed
+    double rxPowerDbm;  //!< The power received through the deterministic loss models (dBm)
+    Time delay;         //!< The propagation delay, if deterministic
+  };
+
+  /**
+   * The links from one PHY at one tx power, by receiver index.
+   */
+  typedef std::unordered_map<uint32_t, LinkBudget> LinkRow;
+
+  /**
+   * Schedule the reception of a packet by one YansWifiPhy, unless it is
+   * the sender or on another channel.
+   *
+   * \param sender the phy object from which the packet is originating
+   * \param senderMobility the mobility model of the sender
+   * \param receiver the index of the phy object to deliver the packet to
+   * \param packet the packet to send
+   * \param txPowerDbm the tx power associated to the packet, in dBm
+   * \param duration the transmission duration associated with the packet
+   * \param links the cached links from the sender at this tx power, or 0
+   * \param batchRxPowerDbm the rx power computed by CalcRxPowers(), or 0
+   */
+  void SendTo (Ptr<YansWifiPhy> sender, Ptr<MobilityModel> senderMobility, uint32_t receiver,
+               Ptr<const Packet> packet, double txPowerDbm, Time duration, LinkRow *links,
+               const double *batchRxPowerDbm) const;
+
+  /**
+   * Compute the rx powers of a transmission at once, if all the loss
+   * models support it.  Only the receivers SendTo() delivers to are
+   * computed, in the same order, so that the random loss models draw
+   * the same values as with one CalcRxPower() per receiver.
+   *
+   * \param sender the phy object from which the packet is originating
+   * \param senderMobility the mobility model of the sender
+   * \param txPowerDbm the tx power of the transmission, in dBm
+   * \param receivers the indices of the receivers, or 0 for all the PHYs
+   * \return the rx powers, in the order of the receivers, or 0
+   */
+  const double *CalcRxPowers (Ptr<YansWifiPhy> sender, Ptr<MobilityModel> senderMobility, double txPowerDbm,
+                              const std::vector<uint32_t> *receivers) const;
+
+  /**
+   * Find the receivers within the range of a transmission, in the order
+   * of the PHY list, into m_index.candidates.
+   *
+   * \param senderMobility the mobility model of the sender
+   * \param txPowerDbm the tx power of the transmission, in dBm
+   * \return false if the range is not bounded, and all the PHYs must be visited
+   */
+  bool FindReceivers (Ptr<MobilityModel> senderMobility, double txPowerDbm) const;
+
+  /**
+   * Check that the receivers left out by FindReceivers() would have
+   * received the transmission, after their rx gain, at least
+   * CullingMargin dB below their energy detection threshold.
+   *
+   * \param sender the phy object from which the packet is originating
+   * \param senderMobility the mobility model of the sender
+   * \param txPowerDbm the tx power of the transmission, in dBm
+   */
+  void CheckReceivers (Ptr<YansWifiPhy> sender, Ptr<MobilityModel> senderMobility, double txPowerDbm) const;
+
+  /**
+   * Rebuild the grid of the receivers positions.
+   */
+  void BuildIndex (void) const;
+
+  /**
+   * \param txPowerDbm the tx power of a transmission, in dBm
+   * \return the range of the transmission, in m, possibly infinite
+   */
+  double GetRange (double txPowerDbm) const;
+
+  /**
+   * \param sender the phy object from which a packet is originating
+   * \param txPowerDbm the tx power of the transmission, in dBm
+   * \return the cached links from the sender at this tx power, or 0 if
+   *         the sender is moving
+   */
+  LinkRow *GetLinks (Ptr<YansWifiPhy> sender, double txPowerDbm) const;
+
+  /**
+   * Connect CourseChanged() to the mobility models of the PHYs added
+   * since the last call.
+   */
+  void TrackMobility (void) const;
+
+  /**
+   * Invalidate the grid and the links of a PHY after it changed course.
+   *
+   * \param mobility the mobility model of the PHY
+   */
+  void CourseChanged (Ptr<const MobilityModel> mobility) const;
+
+  /**
+   * The grid of the receivers positions used by the SpatialIndex.
+   *
+   * The static receivers in cell c are cells[cellStart[c]..cellStart[c+1]),
+   * in the order of the PHY list.
+   */
+  struct SpatialIndex
+  {
+    bool valid;                               //!< Whether the grid matches the receivers
+    double minRxPowerDbm;                     //!< The culling threshold, before the receivers gain (dBm)
+    double minX;                              //!< The grid origin (m)
+    double minY;                              //!< The grid origin (m)
+    double cellSize;                          //!< The side of the cells (m)
+    uint32_t width;                           //!< The number of cells along x
+    uint32_t height;                          //!< The number of cells along y
+    std::vector<double> x;                    //!< The receivers positions, by PHY index (m)
+    std::vector<double> y;                    //!< The receivers positions, by PHY index (m)
+    std::vector<uint32_t> cellStart;          //!< The start of each cell in cells
+    std::vector<uint32_t> cells;              //!< The PHY indices of the static receivers, by cell
+    std::vector<uint32_t> moving;             //!< The PHY indices of the moving receivers
+    std::vector<uint32_t> candidates;         //!< The receivers found by FindReceivers()
+    std::map<double, double> ranges;          //!< The range of each tx power (m)
+  };
+
+  /**
+   * The links between static PHYs used by the LinkCache.
+   */
+  struct LinkCache
+  {
+    bool valid;                                   //!< Whether the models below are known
+    uint32_t lossChanges;                         //!< The changes of the loss models when cached
+    Ptr<const PropagationLossModel> random;       //!< The first loss model not cached, or 0
+    bool deterministicDelay;                      //!< Whether the delays are cached
+    std::vector<std::map<double, LinkRow> > rows; //!< The links from each PHY, by tx power
+  };
 
   PhyList m_phyList;                   //!< List of YansWifiPhys connected to this YansWifiChannel
   Ptr<PropagationLossModel> m_loss;    //!< Propagation loss model
   Ptr<PropagationDelayModel> m_delay;  //!< Propagation delay model
+  bool m_spatialIndex;                 //!< Whether to visit the receivers within range only
+  double m_cullingMargin;              //!< The margin below the energy detection thresholds (dB)
+  bool m_checkCulling;                 //!< Whether to check the receivers left out
+  bool m_linkCache;                    //!< Whether to cache the links between static PHYs
+  mutable SpatialIndex m_index;        //!< The grid of the receivers positions
+  mutable LinkCache m_links;           //!< The links between static PHYs
+
+  std::map<const YansWifiPhy *, uint32_t> m_phyIndex;  //!< The index of each PHY in m_phyList
+  mutable std::vector<Ptr<MobilityModel> > m_mobility; //!< The mobility models connected to CourseChanged(), by PHY index
+  mutable std::multimap<const MobilityModel *, uint32_t> m_mobilityIndex; //!< The PHY indices of each mobility model
+  mutable std::vector<uint32_t> m_moves;               //!< The number of course changes of each PHY
+  mutable std::vector<uint8_t> m_moving;               //!< Whether each PHY has a velocity
+  mutable std::vector<Vector> m_rxPositions;           //!< The receivers positions of CalcRxPowers()
+  mutable std::vector<double> m_rxPowers;              //!< The rx powers of CalcRxPowers() (dBm)
+  mutable std::vector<uint32_t> m_rxReceivers;         //!< The positions in m_rxPowers of the receivers computed
 };
 
 } //namespace ns3
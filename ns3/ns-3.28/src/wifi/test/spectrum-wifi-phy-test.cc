@@ -79,7 +79,7 @@ protected:
    * \param p the packet
    * \param snr the SNR
    */
-  void SpectrumWifiPhyRxFailure (Ptr<Packet> p, double snr);
+  void SpectrumWifiPhyRxFailure (Ptr<const Packet> p, double snr);
   uint32_t m_count; ///< count
 private:
   virtual void DoRun (void);
@@ -142,7 +142,7 @@ SpectrumWifiPhyBasicTest::SpectrumWifiPhyRxSuccess (Ptr<Packet> p, double snr, W
 }
 
 void
-SpectrumWifiPhyBasicTest::SpectrumWifiPhyRxFailure (Ptr<Packet> p, double snr)
+SpectrumWifiPhyBasicTest::SpectrumWifiPhyRxFailure (Ptr<const Packet> p, double snr)
 {
   NS_LOG_FUNCTION (this << p << snr);
   m_count++;
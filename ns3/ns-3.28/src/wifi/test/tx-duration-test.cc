@@ -22,6 +22,7 @@
 #include <ns3/log.h>
 #include <ns3/test.h>
 #include "ns3/yans-wifi-phy.h"
+#include "ns3/uinteger.h"
 
 using namespace ns3;
 
@@ -426,6 +427,75 @@ TxDurationTest::DoRun (void)
   NS_TEST_EXPECT_MSG_EQ (retval, true, "an 802.11ax duration failed");
 }
 
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Tx Duration Cache Test
+ *
+ * Check that the durations found in the cache of a PHY are those
+ * computed without the cache, including when the cache is full.
+ */
+class TxDurationCacheTest : public TestCase
+{
+public:
+  TxDurationCacheTest ();
+  virtual ~TxDurationCacheTest ();
+  virtual void DoRun (void);
+};
+
+TxDurationCacheTest::TxDurationCacheTest ()
+  : TestCase ("Wifi TX Duration cache")
+{
+}
+
+TxDurationCacheTest::~TxDurationCacheTest ()
+{
+}
+
+void
+TxDurationCacheTest::DoRun (void)
+{
+  const uint32_t sizes[] = {14, 76, 1536};
+  WifiTxVector txVectors[5];
+  txVectors[0] = WifiTxVector (WifiPhy::GetDsssRate1Mbps (), 0, WIFI_PREAMBLE_LONG, 800, 1, 1, 0, 22, false, false);
+  txVectors[1] = WifiTxVector (WifiPhy::GetOfdmRate6Mbps (), 0, WIFI_PREAMBLE_LONG, 800, 1, 1, 0, 20, false, false);
+  txVectors[2] = WifiTxVector (WifiPhy::GetOfdmRate6Mbps (), 0, WIFI_PREAMBLE_LONG, 800, 1, 1, 0, 10, false, false);
+  txVectors[3] = WifiTxVector (WifiPhy::GetHtMcs7 (), 0, WIFI_PREAMBLE_HT_MF, 800, 1, 1, 0, 20, false, false);
+  txVectors[4] = WifiTxVector (WifiPhy::GetHtMcs7 (), 0, WIFI_PREAMBLE_HT_MF, 400, 1, 1, 0, 40, false, false);
+  const uint16_t frequencies[] = {CHANNEL_1_MHZ, CHANNEL_36_MHZ};
+  uint32_t durations = 3 * 5 * 2;
+
+  Ptr<YansWifiPhy> reference = CreateObject<YansWifiPhy> ();
+  reference->SetAttribute ("TxDurationCacheSize", UintegerValue (0));
+  Ptr<YansWifiPhy> phy = CreateObject<YansWifiPhy> ();
+  Ptr<YansWifiPhy> small = CreateObject<YansWifiPhy> ();
+  small->SetAttribute ("TxDurationCacheSize", UintegerValue (7));
+
+  for (uint32_t pass = 0; pass < 2; pass++)
+    {
+      for (uint32_t i = 0; i < 3; i++)
+        {
+          for (uint32_t j = 0; j < 5; j++)
+            {
+              for (uint32_t k = 0; k < 2; k++)
+                {
+                  Time expected = reference->CalculateTxDuration (sizes[i], txVectors[j], frequencies[k]);
+                  NS_TEST_ASSERT_MSG_EQ (phy->CalculateTxDuration (sizes[i], txVectors[j], frequencies[k]), expected,
+                                         "Cached duration differs for " << sizes[i] << " bytes, " << txVectors[j]);
+                  NS_TEST_ASSERT_MSG_EQ (small->CalculateTxDuration (sizes[i], txVectors[j], frequencies[k]), expected,
+                                         "Duration differs with a full cache for " << sizes[i] << " bytes, " << txVectors[j]);
+                }
+            }
+        }
+    }
+  NS_TEST_ASSERT_MSG_EQ (reference->GetTxDurationCacheHits () + reference->GetTxDurationCacheMisses (), 0,
+                         "The disabled cache is used");
+  NS_TEST_ASSERT_MSG_EQ (phy->GetTxDurationCacheMisses (), durations, "Each duration is computed once");
+  NS_TEST_ASSERT_MSG_EQ (phy->GetTxDurationCacheHits (), durations, "The second pass is found in the cache");
+  NS_TEST_ASSERT_MSG_EQ (small->GetTxDurationCacheMisses (), 2 * durations, "The full cache is emptied");
+}
+
 /**
  * \ingroup wifi-test
  * \ingroup tests
@@ -442,6 +512,7 @@ TxDurationTestSuite::TxDurationTestSuite ()
   : TestSuite ("devices-wifi-tx-duration", UNIT)
 {
   AddTestCase (new TxDurationTest, TestCase::QUICK);
+  AddTestCase (new TxDurationCacheTest, TestCase::QUICK);
 }
 
 static TxDurationTestSuite g_txDurationTestSuite; ///< the test suite
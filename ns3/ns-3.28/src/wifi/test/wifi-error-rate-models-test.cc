@@ -21,6 +21,9 @@
 #include <cmath>
 #include "ns3/test.h"
 #include "ns3/nist-error-rate-model.h"
+#include "ns3/yans-error-rate-model.h"
+#include "ns3/boolean.h"
+#include "ns3/double.h"
 
 using namespace ns3;
 
@@ -289,6 +292,99 @@ WifiErrorRateModelsTestCaseNist::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ_TOL (ps, 0.999, 0.001, "Not equal within tolerance");
 }
 
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Wifi Error Rate Models Test Case Table
+ *
+ * Check that the chunk success rates interpolated from the tables stay
+ * close to the rates computed by the models, between the grid points of
+ * the tables, and that the batch evaluation gives the same rates.
+ */
+class WifiErrorRateModelsTestCaseTable : public TestCase
+{
+public:
+  WifiErrorRateModelsTestCaseTable ();
+  virtual ~WifiErrorRateModelsTestCaseTable ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Compare the interpolated rates of a model with its computed rates
+   * \param model the model computing the rates
+   * \param table the same model, interpolating the rates
+   */
+  void CheckModel (Ptr<ErrorRateModel> model, Ptr<ErrorRateModel> table);
+};
+
+WifiErrorRateModelsTestCaseTable::WifiErrorRateModelsTestCaseTable ()
+  : TestCase ("WifiErrorRateModel test case table")
+{
+}
+
+WifiErrorRateModelsTestCaseTable::~WifiErrorRateModelsTestCaseTable ()
+{
+}
+
+void
+WifiErrorRateModelsTestCaseTable::CheckModel (Ptr<ErrorRateModel> model, Ptr<ErrorRateModel> table)
+{
+  const char *modes[] = {"DsssRate1Mbps", "DsssRate2Mbps", "ErpOfdmRate24Mbps", "OfdmRate6Mbps",
+                         "OfdmRate54Mbps", "HtMcs0", "HtMcs7"};
+  const uint64_t sizes[] = {8, 800, 12000};
+  const uint32_t count = 400;
+  double snrs[count];
+  uint64_t nbits[count];
+  double rates[count];
+
+  WifiTxVector txVector;
+  txVector.SetChannelWidth (20);
+  txVector.SetNss (1);
+  for (uint32_t m = 0; m < sizeof (modes) / sizeof (modes[0]); m++)
+    {
+      WifiMode mode (modes[m]);
+      txVector.SetMode (mode);
+      for (uint32_t i = 0; i < count; i++)
+        {
+          // Off the 0.05 dB grid of the tables, from -5 dB to 35 dB
+          double snr = -5.0 + i * 0.1 + 0.013;
+          snrs[i] = std::pow (10.0, snr / 10.0);
+          nbits[i] = sizes[i % 3];
+        }
+      table->GetChunkSuccessRates (mode, txVector, snrs, nbits, rates, count);
+      for (uint32_t i = 0; i < count; i++)
+        {
+          double expected = model->GetChunkSuccessRate (mode, txVector, snrs[i], nbits[i]);
+          double interpolated = table->GetChunkSuccessRate (mode, txVector, snrs[i], nbits[i]);
+          NS_TEST_ASSERT_MSG_EQ_TOL (interpolated, expected, 1e-3, "Table of " << mode << " too far at " << snrs[i]);
+          NS_TEST_ASSERT_MSG_EQ (rates[i], interpolated, "Batch evaluation differs for " << mode);
+        }
+    }
+}
+
+void
+WifiErrorRateModelsTestCaseTable::DoRun (void)
+{
+  Ptr<ErrorRateModel> table = CreateObject<NistErrorRateModel> ();
+  table->SetAttribute ("UseTable", BooleanValue (true));
+  CheckModel (CreateObject<NistErrorRateModel> (), table);
+
+  // The models of the same type and attributes share the tables
+  Ptr<ErrorRateModel> shared = CreateObject<NistErrorRateModel> ();
+  shared->SetAttribute ("UseTable", BooleanValue (true));
+  CheckModel (table, shared);
+  // But not those of other attribute values
+  Ptr<ErrorRateModel> fine = CreateObject<NistErrorRateModel> ();
+  fine->SetAttribute ("UseTable", BooleanValue (true));
+  fine->SetAttribute ("TableStep", DoubleValue (0.02));
+  CheckModel (CreateObject<NistErrorRateModel> (), fine);
+
+  table = CreateObject<YansErrorRateModel> ();
+  table->SetAttribute ("UseTable", BooleanValue (true));
+  CheckModel (CreateObject<YansErrorRateModel> (), table);
+}
+
 /**
  * \ingroup wifi-test
  * \ingroup tests
@@ -306,6 +402,7 @@ WifiErrorRateModelsTestSuite::WifiErrorRateModelsTestSuite ()
 {
   AddTestCase (new WifiErrorRateModelsTestCaseDsss, TestCase::QUICK);
   AddTestCase (new WifiErrorRateModelsTestCaseNist, TestCase::QUICK);
+  AddTestCase (new WifiErrorRateModelsTestCaseTable, TestCase::QUICK);
 }
 
 static WifiErrorRateModelsTestSuite wifiErrorRateModelsTestSuite; ///< the test suite
@@ -42,6 +42,9 @@
 #include "ns3/multi-model-spectrum-channel.h"
 #include "ns3/wifi-spectrum-signal-parameters.h"
 #include "ns3/wifi-phy-tag.h"
+#include "ns3/wifi-mac-helper.h"
+#include "ns3/boolean.h"
+#include <cstdlib>
 #include <tuple>
 #include <vector>
 
@@ -1514,6 +1517,458 @@ Bug2831TestCase::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ (m_countOperationalChannelWidth40, 20, "Incorrect operational channel width after channel change");
 }
 
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Propagation delay model counting the receivers visited by the channel
+ */
+class CountingDelayModel : public ConstantSpeedPropagationDelayModel
+{
+public:
+  CountingDelayModel () : m_count (0) {}
+
+  virtual Time GetDelay (Ptr<MobilityModel> a, Ptr<MobilityModel> b) const
+  {
+    m_count++;
+    return ConstantSpeedPropagationDelayModel::GetDelay (a, b);
+  }
+
+  mutable uint32_t m_count; ///< number of delays computed
+};
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Base class of the YansWifiChannel tests of static nodes on a line
+ *
+ * The nodes are 60 m apart on a line, with ad hoc devices on the channel
+ * of the test, and the frames received by each node are counted.
+ */
+class YansWifiChannelLineTest : public TestCase
+{
+public:
+  /**
+   * Constructor
+   * \param name the name of the test case
+   */
+  YansWifiChannelLineTest (std::string name);
+
+protected:
+  /**
+   * Install the devices and the mobility models of the nodes
+   * \param nodes the nodes
+   * \param channel the channel of the devices
+   * \return the devices
+   */
+  NetDeviceContainer Install (NodeContainer nodes, Ptr<YansWifiChannel> channel);
+  /**
+   * Send one packet function
+   * \param dev the device
+   */
+  void SendOnePacket (Ptr<NetDevice> dev);
+  /**
+   * Notify Phy receive end
+   * \param context the context
+   * \param p the packet
+   */
+  void NotifyPhyRxEnd (std::string context, Ptr<const Packet> p);
+
+  std::vector<uint32_t> m_received; ///< number of frames received by each node
+};
+
+YansWifiChannelLineTest::YansWifiChannelLineTest (std::string name)
+  : TestCase (name)
+{
+}
+
+NetDeviceContainer
+YansWifiChannelLineTest::Install (NodeContainer nodes, Ptr<YansWifiChannel> channel)
+{
+  YansWifiPhyHelper phy = YansWifiPhyHelper::Default ();
+  phy.SetChannel (channel);
+  WifiHelper wifi;
+  wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager",
+                                "DataMode", StringValue ("OfdmRate6Mbps"),
+                                "ControlMode", StringValue ("OfdmRate6Mbps"));
+  WifiMacHelper mac;
+  mac.SetType ("ns3::AdhocWifiMac");
+  NetDeviceContainer devices = wifi.Install (phy, mac, nodes);
+  wifi.AssignStreams (devices, 1);
+
+  MobilityHelper mobility;
+  mobility.SetPositionAllocator ("ns3::GridPositionAllocator",
+                                 "DeltaX", DoubleValue (60.0),
+                                 "GridWidth", UintegerValue (nodes.GetN ()));
+  mobility.Install (nodes);
+
+  m_received.assign (nodes.GetN (), 0);
+  Config::Connect ("/NodeList/*/DeviceList/*/$ns3::WifiNetDevice/Phy/PhyRxEnd",
+                   MakeCallback (&YansWifiChannelLineTest::NotifyPhyRxEnd, this));
+  return devices;
+}
+
+void
+YansWifiChannelLineTest::SendOnePacket (Ptr<NetDevice> dev)
+{
+  Ptr<Packet> p = Create<Packet> (100);
+  dev->Send (p, dev->GetBroadcast (), 1);
+}
+
+void
+YansWifiChannelLineTest::NotifyPhyRxEnd (std::string context, Ptr<const Packet> p)
+{
+  // context is /NodeList/<id>/DeviceList/...
+  uint32_t node = std::atoi (context.c_str () + std::string ("/NodeList/").size ());
+  m_received[node]++;
+}
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief YansWifiChannel spatial index test
+ *
+ * Twenty static nodes, 60 m apart on a line, broadcast one frame each.
+ * Node 19 is then moved next to node 0, which broadcasts again.  The
+ * frames received must not change with the SpatialIndex of the channel,
+ * which delivers them to fewer receivers.
+ */
+class YansWifiChannelSpatialIndexTest : public YansWifiChannelLineTest
+{
+public:
+  YansWifiChannelSpatialIndexTest ();
+
+  virtual void DoRun (void);
+
+private:
+  /**
+   * Run the scenario
+   * \param spatialIndex whether the channel uses a spatial index
+   * \return the number of receivers visited by the channel
+   */
+  uint32_t RunOne (bool spatialIndex);
+};
+
+YansWifiChannelSpatialIndexTest::YansWifiChannelSpatialIndexTest ()
+  : YansWifiChannelLineTest ("Test case for the spatial index of YansWifiChannel")
+{
+}
+
+uint32_t
+YansWifiChannelSpatialIndexTest::RunOne (bool spatialIndex)
+{
+  uint32_t nNodes = 20;
+  NodeContainer nodes;
+  nodes.Create (nNodes);
+
+  Ptr<CountingDelayModel> delay = CreateObject<CountingDelayModel> ();
+  Ptr<YansWifiChannel> channel = CreateObject<YansWifiChannel> ();
+  channel->SetPropagationDelayModel (delay);
+  channel->SetPropagationLossModel (CreateObject<LogDistancePropagationLossModel> ());
+  channel->SetAttribute ("SpatialIndex", BooleanValue (spatialIndex));
+  channel->SetAttribute ("CullingMargin", DoubleValue (10.0));
+  channel->SetAttribute ("CheckCulling", BooleanValue (spatialIndex));
+  NetDeviceContainer devices = Install (nodes, channel);
+
+  for (uint32_t i = 0; i < nNodes; i++)
+    {
+      Simulator::Schedule (MilliSeconds (10 * (i + 1)), &YansWifiChannelSpatialIndexTest::SendOnePacket, this, devices.Get (i));
+    }
+  Ptr<MobilityModel> moved = nodes.Get (nNodes - 1)->GetObject<MobilityModel> ();
+  Simulator::Schedule (Seconds (1.0), &MobilityModel::SetPosition, moved, Vector (50.0, 0.0, 0.0));
+  Simulator::Schedule (Seconds (1.1), &YansWifiChannelSpatialIndexTest::SendOnePacket, this, devices.Get (0));
+
+  Simulator::Stop (Seconds (2.0));
+  Simulator::Run ();
+  Simulator::Destroy ();
+  return delay->m_count;
+}
+
+void
+YansWifiChannelSpatialIndexTest::DoRun (void)
+{
+  uint32_t visited = RunOne (false);
+  std::vector<uint32_t> received = m_received;
+  NS_TEST_ASSERT_MSG_EQ (visited, 21 * 19, "Not all receivers visited without the spatial index");
+  NS_TEST_ASSERT_MSG_EQ (received[1], 3, "Node 1 received its neighbours, then node 0 again");
+  NS_TEST_ASSERT_MSG_EQ (received[19], 2, "Node 19 received node 18, then node 0 after moving");
+
+  uint32_t visitedIndexed = RunOne (true);
+  NS_TEST_ASSERT_MSG_LT (visitedIndexed, visited / 2, "The spatial index did not leave receivers out");
+  for (uint32_t i = 0; i < received.size (); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_received[i], received[i], "Node " << i << " received other frames with the spatial index");
+    }
+}
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Deterministic propagation loss model counting the links computed
+ */
+class CountingLossModel : public PropagationLossModel
+{
+public:
+  CountingLossModel () : m_count (0) {}
+
+  mutable uint32_t m_count; ///< number of losses computed
+
+private:
+  virtual double DoCalcRxPower (double txPowerDbm, Ptr<MobilityModel> a, Ptr<MobilityModel> b) const
+  {
+    m_count++;
+    return txPowerDbm;
+  }
+  virtual bool DoIsDeterministic (void) const
+  {
+    return true;
+  }
+  virtual int64_t DoAssignStreams (int64_t stream)
+  {
+    return 0;
+  }
+};
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief YansWifiChannel link cache test
+ *
+ * Ten static nodes, 60 m apart on a line, broadcast one frame each,
+ * twice.  Node 9 is then moved next to node 0, which broadcasts again.
+ * With the LinkCache of the channel, the deterministic losses of the
+ * second round and of the links not involving node 9 are not computed
+ * again, while the fading on top of them is drawn as without the cache.
+ *
+ * Then two nodes with a MatrixPropagationLossModel exchange a frame
+ * before and after the loss between them is raised: the cached link
+ * must follow the change.
+ */
+class YansWifiChannelLinkCacheTest : public YansWifiChannelLineTest
+{
+public:
+  YansWifiChannelLinkCacheTest ();
+
+  virtual void DoRun (void);
+
+private:
+  /**
+   * Run the scenario
+   * \param linkCache whether the channel caches the links
+   * \return the number of deterministic losses computed
+   */
+  uint32_t RunOne (bool linkCache);
+  /**
+   * Run the scenario of the matrix loss model
+   * \param linkCache whether the channel caches the links
+   */
+  void RunMatrix (bool linkCache);
+};
+
+YansWifiChannelLinkCacheTest::YansWifiChannelLinkCacheTest ()
+  : YansWifiChannelLineTest ("Test case for the link cache of YansWifiChannel")
+{
+}
+
+uint32_t
+YansWifiChannelLinkCacheTest::RunOne (bool linkCache)
+{
+  uint32_t nNodes = 10;
+  NodeContainer nodes;
+  nodes.Create (nNodes);
+
+  Ptr<CountingLossModel> counting = CreateObject<CountingLossModel> ();
+  Ptr<LogDistancePropagationLossModel> logDistance = CreateObject<LogDistancePropagationLossModel> ();
+  counting->SetNext (logDistance);
+  logDistance->SetNext (CreateObject<NakagamiPropagationLossModel> ());
+  Ptr<YansWifiChannel> channel = CreateObject<YansWifiChannel> ();
+  channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+  channel->SetPropagationLossModel (counting);
+  channel->SetAttribute ("LinkCache", BooleanValue (linkCache));
+  channel->AssignStreams (100);
+  NetDeviceContainer devices = Install (nodes, channel);
+
+  for (uint32_t i = 0; i < nNodes; i++)
+    {
+      Simulator::Schedule (MilliSeconds (10 * (i + 1)), &YansWifiChannelLinkCacheTest::SendOnePacket, this, devices.Get (i));
+      Simulator::Schedule (MilliSeconds (500 + 10 * (i + 1)), &YansWifiChannelLinkCacheTest::SendOnePacket, this, devices.Get (i));
+    }
+  Ptr<MobilityModel> moved = nodes.Get (nNodes - 1)->GetObject<MobilityModel> ();
+  Simulator::Schedule (Seconds (1.0), &MobilityModel::SetPosition, moved, Vector (30.0, 0.0, 0.0));
+  Simulator::Schedule (Seconds (1.1), &YansWifiChannelLinkCacheTest::SendOnePacket, this, devices.Get (0));
+
+  Simulator::Stop (Seconds (2.0));
+  Simulator::Run ();
+  Simulator::Destroy ();
+  return counting->m_count;
+}
+
+void
+YansWifiChannelLinkCacheTest::RunMatrix (bool linkCache)
+{
+  NodeContainer nodes;
+  nodes.Create (2);
+
+  Ptr<MatrixPropagationLossModel> matrix = CreateObject<MatrixPropagationLossModel> ();
+  Ptr<YansWifiChannel> channel = CreateObject<YansWifiChannel> ();
+  channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+  channel->SetPropagationLossModel (matrix);
+  channel->SetAttribute ("LinkCache", BooleanValue (linkCache));
+  NetDeviceContainer devices = Install (nodes, channel);
+
+  Ptr<MobilityModel> a = nodes.Get (0)->GetObject<MobilityModel> ();
+  Ptr<MobilityModel> b = nodes.Get (1)->GetObject<MobilityModel> ();
+  matrix->SetLoss (a, b, 50.0);
+  Simulator::Schedule (Seconds (0.1), &YansWifiChannelLinkCacheTest::SendOnePacket, this, devices.Get (0));
+  Simulator::Schedule (Seconds (0.5), &MatrixPropagationLossModel::SetLoss, matrix, a, b, 200.0, true);
+  Simulator::Schedule (Seconds (0.6), &YansWifiChannelLinkCacheTest::SendOnePacket, this, devices.Get (0));
+
+  Simulator::Stop (Seconds (1.0));
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+void
+YansWifiChannelLinkCacheTest::DoRun (void)
+{
+  uint32_t computed = RunOne (false);
+  std::vector<uint32_t> received = m_received;
+  NS_TEST_ASSERT_MSG_EQ (computed, 21 * 9, "Not all losses computed without the link cache");
+
+  uint32_t computedCached = RunOne (true);
+  NS_TEST_ASSERT_MSG_EQ (computedCached, 10 * 9 + 1, "Wrong number of losses computed with the link cache");
+  for (uint32_t i = 0; i < received.size (); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_received[i], received[i], "Node " << i << " received other frames with the link cache");
+    }
+
+  RunMatrix (false);
+  NS_TEST_ASSERT_MSG_EQ (m_received[1], 1, "Node 1 received the frame sent after the loss was raised");
+  RunMatrix (true);
+  NS_TEST_ASSERT_MSG_EQ (m_received[1], 1, "Node 1 received the frame sent after the loss was raised, with the link cache");
+}
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Shared packet delivery test
+ *
+ * Node 0 broadcasts one frame to four nodes in range and one node out of
+ * range.  The channel delivers the same packet to the five PHYs, which
+ * copy it only for the MAC of the four nodes receiving it.
+ */
+class YansWifiChannelSharedPacketTest : public TestCase
+{
+public:
+  YansWifiChannelSharedPacketTest ();
+
+  virtual void DoRun (void);
+
+private:
+  /**
+   * Send one packet function
+   * \param dev the device
+   */
+  void SendOnePacket (Ptr<NetDevice> dev);
+  /**
+   * Receive function
+   * \param device the device
+   * \param packet the packet
+   * \param protocol the protocol
+   * \param from the sender address
+   * \return true
+   */
+  bool Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol, const Address &from);
+
+  std::vector<Ptr<const Packet> > m_received; ///< packets received by the MACs
+};
+
+YansWifiChannelSharedPacketTest::YansWifiChannelSharedPacketTest ()
+  : TestCase ("Test case for the delivery of shared packets by YansWifiChannel")
+{
+}
+
+void
+YansWifiChannelSharedPacketTest::SendOnePacket (Ptr<NetDevice> dev)
+{
+  Ptr<Packet> p = Create<Packet> (100);
+  dev->Send (p, dev->GetBroadcast (), 1);
+}
+
+bool
+YansWifiChannelSharedPacketTest::Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol, const Address &from)
+{
+  m_received.push_back (packet);
+  return true;
+}
+
+void
+YansWifiChannelSharedPacketTest::DoRun (void)
+{
+  NodeContainer nodes;
+  nodes.Create (6);
+
+  Ptr<YansWifiChannel> channel = CreateObject<YansWifiChannel> ();
+  channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+  channel->SetPropagationLossModel (CreateObject<LogDistancePropagationLossModel> ());
+
+  YansWifiPhyHelper phy = YansWifiPhyHelper::Default ();
+  phy.SetChannel (channel);
+  WifiHelper wifi;
+  wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager",
+                                "DataMode", StringValue ("OfdmRate6Mbps"),
+                                "ControlMode", StringValue ("OfdmRate6Mbps"));
+  WifiMacHelper mac;
+  mac.SetType ("ns3::AdhocWifiMac");
+  NetDeviceContainer devices = wifi.Install (phy, mac, nodes);
+  wifi.AssignStreams (devices, 1);
+
+  MobilityHelper mobility;
+  Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator> ();
+  for (uint32_t i = 0; i < 5; i++)
+    {
+      positionAlloc->Add (Vector (10.0 * i, 0.0, 0.0));
+    }
+  positionAlloc->Add (Vector (5000.0, 0.0, 0.0));
+  mobility.SetPositionAllocator (positionAlloc);
+  mobility.Install (nodes);
+
+  for (uint32_t i = 1; i < devices.GetN (); i++)
+    {
+      devices.Get (i)->SetReceiveCallback (MakeCallback (&YansWifiChannelSharedPacketTest::Receive, this));
+    }
+  Simulator::Schedule (Seconds (1.0), &YansWifiChannelSharedPacketTest::SendOnePacket, this, devices.Get (0));
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_received.size (), 4, "The nodes in range did not receive the frame");
+  for (uint32_t i = 0; i < m_received.size (); i++)
+    {
+      WifiPhyTag tag;
+      NS_TEST_ASSERT_MSG_EQ (m_received[i]->PeekPacketTag (tag), false, "The WifiPhyTag was handed to the MAC");
+      NS_TEST_ASSERT_MSG_EQ (m_received[i]->GetUid (), m_received[0]->GetUid (), "The MACs received distinct frames");
+      for (uint32_t j = 0; j < i; j++)
+        {
+          NS_TEST_ASSERT_MSG_NE (m_received[i], m_received[j], "Two MACs received the same copy");
+        }
+    }
+  uint64_t copies = 0;
+  uint64_t avoided = 0;
+  for (uint32_t i = 0; i < devices.GetN (); i++)
+    {
+      Ptr<WifiPhy> wifiPhy = DynamicCast<WifiNetDevice> (devices.Get (i))->GetPhy ();
+      copies += wifiPhy->GetRxPacketCopies ();
+      avoided += wifiPhy->GetRxPacketCopiesAvoided ();
+    }
+  NS_TEST_ASSERT_MSG_EQ (copies, 4, "Wrong number of packets copied for the MACs");
+  NS_TEST_ASSERT_MSG_EQ (avoided, 1, "Wrong number of copies avoided");
+  Simulator::Destroy ();
+}
+
 /**
  * \ingroup wifi-test
  * \ingroup tests
@@ -1538,6 +1993,9 @@ WifiTestSuite::WifiTestSuite ()
   AddTestCase (new Bug2222TestCase, TestCase::QUICK); //Bug 2222
   AddTestCase (new Bug2483TestCase, TestCase::QUICK); //Bug 2483
   AddTestCase (new Bug2831TestCase, TestCase::QUICK); //Bug 2831
+  AddTestCase (new YansWifiChannelSpatialIndexTest, TestCase::QUICK);
+  AddTestCase (new YansWifiChannelLinkCacheTest, TestCase::QUICK);
+  AddTestCase (new YansWifiChannelSharedPacketTest, TestCase::QUICK);
 }
 
 static WifiTestSuite g_wifiTestSuite; ///< the test suite
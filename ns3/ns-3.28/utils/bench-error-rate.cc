@@ -0,0 +1,139 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "ns3/core-module.h"
+#include "ns3/nist-error-rate-model.h"
+#include "ns3/yans-error-rate-model.h"
+
+using namespace ns3;
+
+#define LOG(x)   std::cout << x << std::endl
+
+// Output field width
+int g_fwidth = 16;
+
+/**
+ * Time the chunk success rates of a mode, one by one and in a batch
+ * \param model the error rate model
+ * \param modeName the mode of the chunks
+ * \param snrs the SNRs of the chunks
+ * \param nbits the numbers of bits in the chunks
+ * \param rounds the number of passes over the chunks
+ * \param name the row label
+ *
+ * The Received column is the sum of the rates of a pass, averaged over
+ * all the passes.
+ */
+void
+TimeModel (Ptr<ErrorRateModel> model, std::string modeName, const std::vector<double> &snrs,
+           const std::vector<uint64_t> &nbits, uint32_t rounds, std::string name)
+{
+  WifiMode mode (modeName);
+  WifiTxVector txVector;
+  txVector.SetMode (mode);
+  txVector.SetChannelWidth (20);
+  txVector.SetNss (1);
+  uint32_t n = snrs.size ();
+  std::vector<double> rates (n);
+
+  // Build the tables outside of the timings
+  model->GetChunkSuccessRate (mode, txVector, snrs[0], nbits[0]);
+
+  double sum = 0;
+  SystemWallClockMs time;
+  time.Start ();
+  for (uint32_t r = 0; r < rounds; ++r)
+    {
+      for (uint32_t i = 0; i < n; ++i)
+        {
+          sum += model->GetChunkSuccessRate (mode, txVector, snrs[i], nbits[i]);
+        }
+    }
+  double single = time.End () * 1e6 / (rounds * n);
+
+  time.Start ();
+  for (uint32_t r = 0; r < rounds; ++r)
+    {
+      model->GetChunkSuccessRates (mode, txVector, &snrs[0], &nbits[0], &rates[0], n);
+      sum += rates[r % n];
+    }
+  double batch = time.End () * 1e6 / (rounds * n);
+
+  LOG (std::left << std::setw (g_fwidth) << name <<
+       std::setw (g_fwidth) << modeName <<
+       std::setw (g_fwidth) << sum / (2 * rounds) <<
+       std::setw (g_fwidth) << single <<
+       std::setw (g_fwidth) << batch);
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t chunks = 1000;
+  uint32_t rounds = 1000;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark ErrorRateModel::GetChunkSuccessRate().\n"
+             "\n"
+             "Each row times the success rates of chunks of one mode with\n"
+             "SNRs spread over -5 dB to 35 dB, computed by the model or\n"
+             "interpolated from its tables (UseTable), one by one and in\n"
+             "a batch.");
+  cmd.AddValue ("chunks", "number of chunks per pass (default 1000)", chunks);
+  cmd.AddValue ("rounds", "number of passes per row (default 1000)", rounds);
+  cmd.Parse (argc, argv);
+
+  std::string me = cmd.GetName () + ": ";
+  LOG (me << "chunks: " << chunks << ", rounds: " << rounds);
+
+  std::vector<double> snrs (chunks);
+  std::vector<uint64_t> nbits (chunks);
+  for (uint32_t i = 0; i < chunks; ++i)
+    {
+      snrs[i] = std::pow (10.0, (-5.0 + 40.0 * i / chunks) / 10.0);
+      nbits[i] = 8 + (i * 997) % 12000;
+    }
+
+  Ptr<ErrorRateModel> nist = CreateObject<NistErrorRateModel> ();
+  Ptr<ErrorRateModel> nistTable = CreateObject<NistErrorRateModel> ();
+  nistTable->SetAttribute ("UseTable", BooleanValue (true));
+  Ptr<ErrorRateModel> yans = CreateObject<YansErrorRateModel> ();
+  Ptr<ErrorRateModel> yansTable = CreateObject<YansErrorRateModel> ();
+  yansTable->SetAttribute ("UseTable", BooleanValue (true));
+
+  LOG ("");
+  LOG (std::left << std::setw (g_fwidth) << "Model" <<
+       std::setw (g_fwidth) << "Mode" <<
+       std::setw (g_fwidth) << "Received" <<
+       std::setw (g_fwidth) << "Single (ns)" <<
+       std::setw (g_fwidth) << "Batch (ns)");
+  LOG (std::setfill ('-') << std::setw (5 * g_fwidth) << "" << std::setfill (' '));
+
+  const char *modes[] = {"DsssRate1Mbps", "OfdmRate6Mbps", "OfdmRate54Mbps", "HtMcs7"};
+  for (uint32_t m = 0; m < sizeof (modes) / sizeof (modes[0]); ++m)
+    {
+      TimeModel (nist, modes[m], snrs, nbits, rounds, "Nist");
+      TimeModel (nistTable, modes[m], snrs, nbits, rounds, "Nist (table)");
+      TimeModel (yans, modes[m], snrs, nbits, rounds, "Yans");
+      TimeModel (yansTable, modes[m], snrs, nbits, rounds, "Yans (table)");
+    }
+
+  return 0;
+}
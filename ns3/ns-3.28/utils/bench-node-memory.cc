@@ -0,0 +1,174 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <string>
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+
+using namespace ns3;
+
+#define LOG(x)   std::cout << x << std::endl
+
+// Output field width
+int g_fwidth = 20;
+
+/// The bytes allocated by operator new and not deleted yet
+static uint64_t g_liveBytes = 0;
+
+/// The room kept before each allocation for its size
+static const size_t g_header = 16;
+
+void *
+operator new (size_t size)
+{
+  char *p = static_cast<char *> (std::malloc (size + g_header));
+  if (p == 0)
+    {
+      throw std::bad_alloc ();
+    }
+  *reinterpret_cast<size_t *> (p) = size;
+  g_liveBytes += size;
+  return p + g_header;
+}
+
+void *
+operator new[] (size_t size)
+{
+  return operator new (size);
+}
+
+void
+operator delete (void *ptr) noexcept
+{
+  if (ptr == 0)
+    {
+      return;
+    }
+  char *p = static_cast<char *> (ptr) - g_header;
+  g_liveBytes -= *reinterpret_cast<size_t *> (p);
+  std::free (p);
+}
+
+void
+operator delete[] (void *ptr) noexcept
+{
+  operator delete (ptr);
+}
+
+/// The options of InternetStackHelper and Ipv4AddressHelper of a profile
+struct Profile
+{
+  std::string name; //!< The name of the profile
+  bool ipv6;        //!< Whether to install the IPv6 stack
+  bool icmpv4;      //!< Whether to install ICMPv4
+  bool tcp;         //!< Whether to install TCP
+  bool staticArp;   //!< Whether to resolve the addresses statically
+  bool queueDiscs;  //!< Whether to install the queue discs on the interfaces
+};
+
+/**
+ * Install the internet stack with InternetStackHelper, then assign the
+ * addresses
+ * \param n the number of nodes
+ * \param profile the options of the helpers
+ * \return the bytes per node of the stack
+ */
+double
+Measure (uint32_t n, const Profile &profile)
+{
+  NodeContainer nodes;
+  nodes.Create (n);
+  SimpleNetDeviceHelper simple;
+  NetDeviceContainer devices = simple.Install (nodes);
+  uint64_t before = g_liveBytes;
+
+  InternetStackHelper stack;
+  stack.SetIpv6StackInstall (profile.ipv6);
+  stack.SetIcmpv4Install (profile.icmpv4);
+  stack.SetTcpInstall (profile.tcp);
+  stack.SetStaticArp (profile.staticArp);
+  Ipv4AddressHelper address ("10.0.0.0", "255.0.0.0");
+  address.SetQueueDiscInstall (profile.queueDiscs);
+  stack.Install (nodes);
+  address.Assign (devices);
+  double bytes = (static_cast<double> (g_liveBytes) - before) / n;
+
+  Simulator::Destroy ();
+  return bytes;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t n = 1000;
+
+  CommandLine cmd;
+  cmd.Usage ("Report the heap bytes per node of the internet stack.\n"
+             "\n"
+             "Each row installs the stack with InternetStackHelper on every\n"
+             "node with one SimpleNetDevice, and assigns the addresses.  The\n"
+             "first row is the slim profile (IPv4 and UDP only, with static\n"
+             "ARP and no queue discs), each next row enables one more option,\n"
+             "and the last row is the default of the helpers.  The delta is\n"
+             "the memory of the component enabled by the row.");
+  cmd.AddValue ("nodes", "number of nodes (default 1000)", n);
+  cmd.Parse (argc, argv);
+
+  std::string me = cmd.GetName () + ": ";
+  LOG (me << "nodes: " << n);
+
+  const Profile profiles[] = {
+    {"Slim", false, false, false, true, false},
+    {"+ ICMPv4", false, true, false, true, false},
+    {"+ TCP", false, true, true, true, false},
+    {"+ Queue discs", false, true, true, true, true},
+    {"+ IPv6", true, true, true, true, true},
+    {"- Static ARP", true, true, true, false, true},
+  };
+
+  LOG ("");
+  LOG (std::left << std::setw (g_fwidth) << "Profile" <<
+       std::setw (g_fwidth) << "Total (B/node)" <<
+       std::setw (g_fwidth) << "Delta (B/node)");
+  LOG (std::setfill ('-') << std::setw (3 * g_fwidth) << "" << std::setfill (' '));
+
+  double last = 0;
+  for (uint32_t i = 0; i < sizeof (profiles) / sizeof (profiles[0]); ++i)
+    {
+      double bytes = Measure (n, profiles[i]);
+      std::ostringstream delta;
+      if (i > 0)
+        {
+          delta << bytes - last;
+        }
+      else
+        {
+          delta << "-";
+        }
+      LOG (std::left << std::setw (g_fwidth) << profiles[i].name <<
+           std::setw (g_fwidth) << bytes <<
+           std::setw (g_fwidth) << delta.str ());
+      last = bytes;
+    }
+
+  return 0;
+}
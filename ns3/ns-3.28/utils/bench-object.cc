@@ -0,0 +1,189 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#include "ns3/core-module.h"
+
+using namespace ns3;
+
+#define LOG(x)   std::cout << x << std::endl
+
+// Output field width
+int g_fwidth = 14;
+
+/// Base of the aggregated objects, two levels below ns3::Object
+class Base : public Object
+{
+public:
+  /**
+   * Register this type.
+   * \return The TypeId.
+   */
+  static TypeId GetTypeId (void)
+  {
+    static TypeId tid = TypeId ("BenchObject::Base")
+      .SetParent<Object> ()
+      .HideFromDocumentation ()
+    ;
+    return tid;
+  }
+};
+
+/// Aggregated objects, of distinct types as in a Node
+template <uint32_t N>
+class Part : public Base
+{
+public:
+  /**
+   * Register this type.
+   * \return The TypeId.
+   */
+  static TypeId GetTypeId (void)
+  {
+    static TypeId tid = TypeId (GetName ().c_str ())
+      .SetParent<Base> ()
+      .HideFromDocumentation ()
+      .template AddConstructor<Part<N> > ()
+    ;
+    return tid;
+  }
+private:
+  /**
+   * Name this type.
+   * \return The name of the TypeId.
+   */
+  static std::string GetName (void)
+  {
+    std::ostringstream oss;
+    oss << "BenchObject::Part<" << N << ">";
+    return oss.str ();
+  }
+};
+
+/**
+ * Time lookups of the same type in an aggregate
+ * \tparam T the type looked up
+ * \param object the aggregate
+ * \param lookups the number of lookups
+ * \param name the row label
+ */
+template <typename T>
+void
+TimeLookups (Ptr<Object> object, uint32_t lookups, std::string name)
+{
+  uint32_t found = 0;
+  SystemWallClockMs time;
+  time.Start ();
+  for (uint32_t i = 0; i < lookups; ++i)
+    {
+      if (object->GetObject<T> () != 0)
+        {
+          ++found;
+        }
+    }
+  double ns = time.End () * 1e6 / lookups;
+
+  LOG (std::left << std::setw (2 * g_fwidth) << name <<
+       std::setw (g_fwidth) << found <<
+       std::setw (g_fwidth) << ns);
+}
+
+/**
+ * Time lookups by TypeId of all the aggregated types
+ * \param object the aggregate
+ * \param tids the types looked up in turn
+ * \param lookups the number of lookups
+ */
+void
+TimeAll (Ptr<Object> object, const std::vector<TypeId> &tids, uint32_t lookups)
+{
+  uint32_t found = 0;
+  SystemWallClockMs time;
+  time.Start ();
+  for (uint32_t i = 0; i < lookups; ++i)
+    {
+      if (object->GetObject<Object> (tids[i % tids.size ()]) != 0)
+        {
+          ++found;
+        }
+    }
+  double ns = time.End () * 1e6 / lookups;
+
+  LOG (std::left << std::setw (2 * g_fwidth) << "GetObject (tid)" <<
+       std::setw (g_fwidth) << found <<
+       std::setw (g_fwidth) << ns);
+}
+
+
+int main (int argc, char *argv[])
+{
+  uint32_t lookups = 10000000;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark Object::GetObject() on an aggregate.\n"
+             "\n"
+             "The aggregate holds 12 objects of distinct types, about as\n"
+             "many as a Node with an InternetStack, mobility and energy\n"
+             "models.  Each row times the lookup of one type.");
+  cmd.AddValue ("lookups", "number of lookups per row (default 1E7)", lookups);
+  cmd.Parse (argc, argv);
+
+  std::string me = cmd.GetName () + ": ";
+  LOG (me << "lookups: " << lookups);
+
+  std::vector<Ptr<Object> > parts;
+  parts.push_back (CreateObject<Part<0> > ());
+  parts.push_back (CreateObject<Part<1> > ());
+  parts.push_back (CreateObject<Part<2> > ());
+  parts.push_back (CreateObject<Part<3> > ());
+  parts.push_back (CreateObject<Part<4> > ());
+  parts.push_back (CreateObject<Part<5> > ());
+  parts.push_back (CreateObject<Part<6> > ());
+  parts.push_back (CreateObject<Part<7> > ());
+  parts.push_back (CreateObject<Part<8> > ());
+  parts.push_back (CreateObject<Part<9> > ());
+  parts.push_back (CreateObject<Part<10> > ());
+  parts.push_back (CreateObject<Part<11> > ());
+  std::vector<TypeId> tids;
+  for (uint32_t i = 0; i < parts.size (); ++i)
+    {
+      tids.push_back (parts[i]->GetInstanceTypeId ());
+      if (i > 0)
+        {
+          parts[0]->AggregateObject (parts[i]);
+        }
+    }
+  Ptr<Object> object = parts[0];
+
+  LOG ("");
+  LOG (std::left << std::setw (2 * g_fwidth) << "Lookup" <<
+       std::setw (g_fwidth) << "Found" <<
+       std::setw (g_fwidth) << "Per (ns)");
+  LOG (std::setfill ('-') << std::setw (4 * g_fwidth) << "" << std::setfill (' '));
+
+  TimeLookups<Part<0> > (object, lookups, "GetObject<first> ()");
+  TimeLookups<Part<6> > (object, lookups, "GetObject<middle> ()");
+  TimeLookups<Part<11> > (object, lookups, "GetObject<last> ()");
+  TimeLookups<Part<12> > (object, lookups, "GetObject<missing> ()");
+  TimeAll (object, tids, lookups);
+
+  object->Dispose ();
+  return 0;
+}
@@ -25,6 +25,7 @@
 #include <string.h>
 
 #include "ns3/core-module.h"
+#include "ns3/event-impl.h"
 
 using namespace ns3;
 
@@ -39,6 +40,9 @@ std::string g_me;
 // Output field width
 int g_fwidth = 6;
 
+// Round event times up to a multiple of this many ns, 0 to disable
+uint64_t g_quantum = 0;
+
 /// Bench class
 class Bench
 {
@@ -87,6 +91,11 @@ public:
 private:
   /// callback function
   void Cb (void);
+  /**
+   * Draw the delay of the next event
+   * \return the delay, rounded up to a multiple of g_quantum
+   */
+  Time NextDelay (void);
 
   Ptr<RandomVariableStream> m_rand; ///< random variable
   uint32_t m_population; ///< population
@@ -107,7 +116,7 @@ Bench::RunBench (void)
   time.Start ();
   for (uint32_t i = 0; i < m_population; ++i)
     {
-      Time at = NanoSeconds (m_rand->GetValue ());
+      Time at = NextDelay ();
       Simulator::Schedule (at, &Bench::Cb, this);
     }
   init = time.End ();
@@ -139,11 +148,22 @@ Bench::Cb (void)
     }
   DEB ("event at " << Simulator::Now ().GetSeconds () << "s");
 
-  Time after = NanoSeconds (m_rand->GetValue ());
+  Time after = NextDelay ();
   Simulator::Schedule (after, &Bench::Cb, this);
   ++m_count;
 }
 
+Time
+Bench::NextDelay (void)
+{
+  if (g_quantum == 0)
+    {
+      return NanoSeconds (m_rand->GetValue ());
+    }
+  uint64_t ns = (uint64_t) m_rand->GetValue ();
+  return NanoSeconds ((ns / g_quantum + 1) * g_quantum);
+}
+
 
 Ptr<RandomVariableStream>
 GetRandomStream (std::string filename)
@@ -205,6 +225,7 @@ int main (int argc, char *argv[])
 
   bool schedCal  = false;
   bool schedHeap = false;
+  bool schedLadder = false;
   bool schedList = false;
   bool schedMap  = true;
 
@@ -224,6 +245,7 @@ int main (int argc, char *argv[])
              "to be ascii, giving the relative event times in ns.");
   cmd.AddValue ("cal",   "use CalendarSheduler",          schedCal);
   cmd.AddValue ("heap",  "use HeapScheduler",             schedHeap);
+  cmd.AddValue ("ladder", "use LadderScheduler",          schedLadder);
   cmd.AddValue ("list",  "use ListSheduler",              schedList);
   cmd.AddValue ("map",   "use MapScheduler (default)",    schedMap);
   cmd.AddValue ("debug", "enable debugging output",       g_debug);
@@ -232,6 +254,7 @@ int main (int argc, char *argv[])
   cmd.AddValue ("runs",  "number of runs (default 1)",    runs);
   cmd.AddValue ("file",  "file of relative event times",  filename);
   cmd.AddValue ("prec",  "printed output precision",      g_fwidth);
+  cmd.AddValue ("quantum", "round event times up to a multiple of this many ns", g_quantum);
   cmd.Parse (argc, argv);
   g_me = cmd.GetName () + ": ";
   g_fwidth += 6;  // 5 extra chars in '2.000002e+07 ': . e+0 _
@@ -245,6 +268,10 @@ int main (int argc, char *argv[])
     {
       factory.SetTypeId ("ns3::HeapScheduler");
     }
+  if (schedLadder)
+    {
+      factory.SetTypeId ("ns3::LadderScheduler");
+    }
   if (schedList)
     {
       factory.SetTypeId ("ns3::ListScheduler");
@@ -258,6 +285,10 @@ int main (int argc, char *argv[])
   LOGME ("population: " << pop);
   LOGME ("total events: " << total);
   LOGME ("runs: " << runs);
+  if (g_quantum > 0)
+    {
+      LOGME ("quantum: " << g_quantum << " ns");
+    }
 
   Bench *bench = new Bench (pop, total);
   bench->SetRandomStream (GetRandomStream (filename));
@@ -300,6 +331,11 @@ int main (int argc, char *argv[])
     }
 
   LOG ("");
+  EventImpl::PoolStats pool = EventImpl::GetPoolStats ();
+  LOGME ("event pool: " << pool.allocations << " allocations, " <<
+         pool.hits << " reused (" << (100.0 * pool.hits / pool.allocations) << "%), " <<
+         pool.oversized << " oversized, " << pool.refills << " refills, " <<
+         pool.released << " released");
   Simulator::Destroy ();
   delete bench;
   return 0;
@@ -0,0 +1,126 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "ns3/core-module.h"
+#include "ns3/constant-rate-wifi-manager.h"
+#include "ns3/wifi-mac-header.h"
+#include "ns3/yans-wifi-phy.h"
+
+using namespace ns3;
+
+#define LOG(x)   std::cout << x << std::endl
+
+// Output field width
+int g_fwidth = 16;
+
+/**
+ * Time the lookups of the stations of a manager knowing some neighbours
+ * \param neighbours the number of stations known by the manager
+ * \param lookups the number of lookups per row
+ */
+void
+TimeLookups (uint32_t neighbours, uint32_t lookups)
+{
+  Ptr<YansWifiPhy> phy = CreateObject<YansWifiPhy> ();
+  phy->ConfigureStandard (WIFI_PHY_STANDARD_80211a);
+  Ptr<WifiRemoteStationManager> manager = CreateObject<ConstantRateWifiManager> ();
+  manager->SetupPhy (phy);
+
+  std::vector<Mac48Address> addresses;
+  for (uint32_t i = 0; i < neighbours; ++i)
+    {
+      addresses.push_back (Mac48Address::Allocate ());
+    }
+  WifiMacHeader header;
+  header.SetType (WIFI_MAC_QOSDATA);
+  Ptr<const Packet> packet = Create<Packet> (100);
+  for (uint32_t i = 0; i < neighbours; ++i)
+    {
+      for (uint8_t tid = 0; tid < 8; ++tid)
+        {
+          header.SetQosTid (tid);
+          manager->NeedRtsRetransmission (addresses[i], &header, packet);
+        }
+    }
+  header.SetQosTid (0);
+
+  uint32_t found = 0;
+  SystemWallClockMs time;
+  time.Start ();
+  for (uint32_t i = 0; i < lookups; ++i)
+    {
+      if (manager->IsBrandNew (addresses[i % neighbours]))
+        {
+          ++found;
+        }
+    }
+  double state = time.End () * 1e6 / lookups;
+
+  time.Start ();
+  for (uint32_t i = 0; i < lookups; ++i)
+    {
+      if (manager->NeedRtsRetransmission (addresses[i % neighbours], &header, packet))
+        {
+          ++found;
+        }
+    }
+  double station = time.End () * 1e6 / lookups;
+
+  LOG (std::left << std::setw (g_fwidth) << neighbours <<
+       std::setw (g_fwidth) << found <<
+       std::setw (g_fwidth) << state <<
+       std::setw (g_fwidth) << station);
+
+  manager->Dispose ();
+  phy->Dispose ();
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t lookups = 1000000;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the station lookups of WifiRemoteStationManager.\n"
+             "\n"
+             "Each row times the lookups of the neighbours of a manager\n"
+             "knowing that many neighbours, each with 8 TIDs: the state\n"
+             "of a neighbour (IsBrandNew) and its station for a TID\n"
+             "(NeedRtsRetransmission).");
+  cmd.AddValue ("lookups", "number of lookups per row (default 1E6)", lookups);
+  cmd.Parse (argc, argv);
+
+  std::string me = cmd.GetName () + ": ";
+  LOG (me << "lookups: " << lookups);
+
+  LOG ("");
+  LOG (std::left << std::setw (g_fwidth) << "Neighbours" <<
+       std::setw (g_fwidth) << "Found" <<
+       std::setw (g_fwidth) << "State (ns)" <<
+       std::setw (g_fwidth) << "Station (ns)");
+  LOG (std::setfill ('-') << std::setw (4 * g_fwidth) << "" << std::setfill (' '));
+
+  uint32_t neighbours[] = {1, 10, 30, 100, 300, 1000};
+  for (uint32_t i = 0; i < sizeof (neighbours) / sizeof (neighbours[0]); ++i)
+    {
+      TimeLookups (neighbours[i], lookups);
+    }
+
+  return 0;
+}
@@ -0,0 +1,170 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <iomanip>
+#include <iostream>
+#include <list>
+#include <utility>
+
+#include "ns3/core-module.h"
+
+using namespace ns3;
+
+#define LOG(x)   std::cout << x << std::endl
+
+// Output field width
+int g_fwidth = 14;
+
+/// Bench class: producer threads flood the simulator with events
+class Bench
+{
+public:
+  /**
+   * constructor
+   * \param threads the number of producer threads
+   * \param events the number of events each thread schedules
+   */
+  Bench (uint32_t threads, uint32_t events)
+    : m_threads (threads),
+      m_events (events),
+      m_received (0)
+  {
+  }
+
+  /**
+   * Run function
+   * \param capacity the capacity of the lock free queue
+   */
+  void RunBench (uint32_t capacity);
+private:
+  /**
+   * Producer thread body
+   * \param context the bench and the thread number
+   */
+  static void Produce (std::pair<Bench *, uint32_t> context);
+  /// event scheduled by the producers
+  void Cb (void);
+  /// keep the simulator running until all events are received
+  void Poll (void);
+
+  uint32_t m_threads;  ///< number of producer threads
+  uint32_t m_events;   ///< events per thread
+  uint32_t m_received; ///< events received
+};
+
+void
+Bench::RunBench (uint32_t capacity)
+{
+  Config::SetDefault ("ns3::DefaultSimulatorImpl::EventsWithContextCapacity",
+                      UintegerValue (capacity));
+  m_received = 0;
+  // Create the simulator before the threads use it.
+  Simulator::Schedule (NanoSeconds (1), &Bench::Poll, this);
+
+  std::list<Ptr<SystemThread> > threads;
+  for (uint32_t i = 0; i < m_threads; ++i)
+    {
+      threads.push_back (Create<SystemThread> (MakeBoundCallback (&Bench::Produce,
+                                                                  std::make_pair (this, i))));
+    }
+
+  SystemWallClockMs time;
+  time.Start ();
+  for (std::list<Ptr<SystemThread> >::iterator i = threads.begin (); i != threads.end (); ++i)
+    {
+      (*i)->Start ();
+    }
+  Simulator::Run ();
+  double simu = time.End () / 1000.0;
+  for (std::list<Ptr<SystemThread> >::iterator i = threads.begin (); i != threads.end (); ++i)
+    {
+      (*i)->Join ();
+    }
+  Simulator::Destroy ();
+
+  LOG (std::left << std::setw (g_fwidth) << capacity <<
+       std::setw (g_fwidth) << simu <<
+       std::setw (g_fwidth) << (m_received / simu) <<
+       std::setw (g_fwidth) << (simu / m_received));
+}
+
+void
+Bench::Produce (std::pair<Bench *, uint32_t> context)
+{
+  Bench *bench = context.first;
+  for (uint32_t i = 0; i < bench->m_events; ++i)
+    {
+      Simulator::ScheduleWithContext (context.second, NanoSeconds (1), &Bench::Cb, bench);
+    }
+}
+
+void
+Bench::Cb (void)
+{
+  ++m_received;
+}
+
+void
+Bench::Poll (void)
+{
+  if (m_received < m_threads * m_events)
+    {
+      Simulator::Schedule (NanoSeconds (1), &Bench::Poll, this);
+    }
+}
+
+
+int main (int argc, char *argv[])
+{
+  uint32_t threads = 4;
+  uint32_t events = 1000000;
+  uint32_t capacity = 1024;
+  uint32_t runs = 1;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark events scheduled from other threads.\n"
+             "\n"
+             "Producer threads call Simulator::ScheduleWithContext() in a\n"
+             "loop while the main thread runs the simulation.  Each run\n"
+             "compares the lock free queue of DefaultSimulatorImpl, with\n"
+             "the given capacity, against the mutex protected list alone.");
+  cmd.AddValue ("threads",  "number of producer threads (default 4)",    threads);
+  cmd.AddValue ("events",   "events per thread (default 1E6)",           events);
+  cmd.AddValue ("capacity", "capacity of the lock free queue (default 1024)", capacity);
+  cmd.AddValue ("runs",     "number of runs (default 1)",                runs);
+  cmd.Parse (argc, argv);
+
+  std::string me = cmd.GetName () + ": ";
+  LOG (me << "threads: " << threads);
+  LOG (me << "events per thread: " << events);
+  LOG (me << "runs: " << runs);
+
+  Bench bench (threads, events);
+
+  LOG ("");
+  LOG (std::left << std::setw (g_fwidth) << "Capacity" <<
+       std::setw (g_fwidth) << "Time (s)" <<
+       std::setw (g_fwidth) << "Rate (ev/s)" <<
+       std::setw (g_fwidth) << "Per (s/ev)");
+  LOG (std::setfill ('-') << std::setw (4 * g_fwidth) << "" << std::setfill (' '));
+
+  for (uint32_t i = 0; i < runs; ++i)
+    {
+      bench.RunBench (0);
+      bench.RunBench (capacity);
+    }
+  return 0;
+}
@@ -0,0 +1,195 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <iomanip>
+#include <iostream>
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/wifi-module.h"
+#include "ns3/applications-module.h"
+
+using namespace ns3;
+
+#define LOG(x)   std::cout << x << std::endl
+
+// Output field width
+int g_fwidth = 16;
+
+/// The number of trace sink invocations
+static uint64_t g_traced = 0;
+
+/**
+ * Count a trace of a packet
+ * \param packet the packet
+ */
+void
+TracePacket (Ptr<const Packet> packet)
+{
+  g_traced++;
+}
+
+/**
+ * Count a trace of an IPv4 packet
+ * \param packet the packet
+ * \param ipv4 the IPv4 protocol
+ * \param interface the interface
+ */
+void
+TraceIpv4 (Ptr<const Packet> packet, Ptr<Ipv4> ipv4, uint32_t interface)
+{
+  g_traced++;
+}
+
+/**
+ * Count a monitor trace of a received packet
+ * \param packet the packet
+ * \param channelFreqMhz the channel frequency
+ * \param txVector the TXVECTOR
+ * \param aMpdu the A-MPDU information
+ * \param signalNoise the signal and noise
+ */
+void
+TraceSniffRx (Ptr<const Packet> packet, uint16_t channelFreqMhz, WifiTxVector txVector,
+              MpduInfo aMpdu, SignalNoiseDbm signalNoise)
+{
+  g_traced++;
+}
+
+/**
+ * Run an ad hoc 802.11a network of UDP flows
+ * \param n the number of nodes
+ * \param rate the packets per second sent by each node
+ * \param duration the simulated seconds
+ * \param connect whether to connect sinks to the packet trace sources
+ */
+void
+Run (uint32_t n, double rate, double duration, bool connect)
+{
+  NodeContainer nodes;
+  nodes.Create (n);
+
+  WifiHelper wifi;
+  wifi.SetStandard (WIFI_PHY_STANDARD_80211a);
+  wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager",
+                                "DataMode", StringValue ("OfdmRate24Mbps"));
+  YansWifiChannelHelper channel = YansWifiChannelHelper::Default ();
+  YansWifiPhyHelper phy = YansWifiPhyHelper::Default ();
+  phy.SetChannel (channel.Create ());
+  WifiMacHelper mac;
+  mac.SetType ("ns3::AdhocWifiMac");
+  NetDeviceContainer devices = wifi.Install (phy, mac, nodes);
+
+  MobilityHelper mobility;
+  mobility.SetPositionAllocator ("ns3::GridPositionAllocator",
+                                 "DeltaX", DoubleValue (10.0),
+                                 "DeltaY", DoubleValue (10.0),
+                                 "GridWidth", UintegerValue (5));
+  mobility.Install (nodes);
+
+  InternetStackHelper stack;
+  stack.Install (nodes);
+  Ipv4AddressHelper address ("10.0.0.0", "255.255.255.0");
+  Ipv4InterfaceContainer interfaces = address.Assign (devices);
+
+  UdpServerHelper server (9);
+  ApplicationContainer servers = server.Install (nodes);
+  servers.Start (Seconds (0.0));
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      UdpClientHelper client (interfaces.GetAddress ((i + 1) % n), 9);
+      client.SetAttribute ("MaxPackets", UintegerValue (static_cast<uint32_t> (rate * duration) + 1));
+      client.SetAttribute ("Interval", TimeValue (Seconds (1.0 / rate)));
+      client.SetAttribute ("PacketSize", UintegerValue (512));
+      ApplicationContainer clients = client.Install (nodes.Get (i));
+      clients.Start (Seconds (1.0 + 0.001 * i));
+    }
+
+  if (connect)
+    {
+      Config::ConnectWithoutContext ("/NodeList/*/DeviceList/*/$ns3::WifiNetDevice/Mac/MacTx",
+                                     MakeCallback (&TracePacket));
+      Config::ConnectWithoutContext ("/NodeList/*/DeviceList/*/$ns3::WifiNetDevice/Mac/MacRx",
+                                     MakeCallback (&TracePacket));
+      Config::ConnectWithoutContext ("/NodeList/*/DeviceList/*/$ns3::WifiNetDevice/Phy/PhyTxBegin",
+                                     MakeCallback (&TracePacket));
+      Config::ConnectWithoutContext ("/NodeList/*/DeviceList/*/$ns3::WifiNetDevice/Phy/PhyRxEnd",
+                                     MakeCallback (&TracePacket));
+      Config::ConnectWithoutContext ("/NodeList/*/DeviceList/*/$ns3::WifiNetDevice/Phy/MonitorSnifferRx",
+                                     MakeCallback (&TraceSniffRx));
+      Config::ConnectWithoutContext ("/NodeList/*/$ns3::Ipv4L3Protocol/Tx",
+                                     MakeCallback (&TraceIpv4));
+      Config::ConnectWithoutContext ("/NodeList/*/$ns3::Ipv4L3Protocol/Rx",
+                                     MakeCallback (&TraceIpv4));
+    }
+
+  g_traced = 0;
+  Simulator::Stop (Seconds (1.0 + duration));
+  SystemWallClockMs time;
+  time.Start ();
+  Simulator::Run ();
+  double ms = time.End ();
+
+  uint64_t received = 0;
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      received += DynamicCast<UdpServer> (servers.Get (i))->GetReceived ();
+    }
+  Simulator::Destroy ();
+
+  LOG (std::left << std::setw (g_fwidth) << (connect ? "connected" : "none") <<
+       std::setw (g_fwidth) << received <<
+       std::setw (g_fwidth) << g_traced <<
+       std::setw (g_fwidth) << ms <<
+       std::setw (g_fwidth) << (received > 0 ? ms * 1e3 / received : 0));
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t n = 20;
+  double rate = 100;
+  double duration = 10;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the packet path of an ad hoc 802.11a network.\n"
+             "\n"
+             "Every node sends UDP packets to the next one.  The first row\n"
+             "runs with no trace sink connected, the second with a sink\n"
+             "connected to the MAC, PHY and IPv4 packet trace sources, and\n"
+             "each reports the wall clock time per received packet.");
+  cmd.AddValue ("nodes", "number of nodes (default 20)", n);
+  cmd.AddValue ("rate", "packets per second sent by each node (default 100)", rate);
+  cmd.AddValue ("duration", "simulated seconds of traffic (default 10)", duration);
+  cmd.Parse (argc, argv);
+
+  std::string me = cmd.GetName () + ": ";
+  LOG (me << "nodes: " << n << ", rate: " << rate << "/s, duration: " << duration << " s");
+
+  LOG ("");
+  LOG (std::left << std::setw (g_fwidth) << "Sinks" <<
+       std::setw (g_fwidth) << "Received" <<
+       std::setw (g_fwidth) << "Traced" <<
+       std::setw (g_fwidth) << "Time (ms)" <<
+       std::setw (g_fwidth) << "Per packet (us)");
+  LOG (std::setfill ('-') << std::setw (5 * g_fwidth) << "" << std::setfill (' '));
+
+  Run (n, rate, duration, false);
+  Run (n, rate, duration, true);
+
+  return 0;
+}
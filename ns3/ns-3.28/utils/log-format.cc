@@ -0,0 +1,61 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <fstream>
+#include <iostream>
+#include <limits>
+
+#include "ns3/core-module.h"
+
+using namespace ns3;
+
+int main (int argc, char *argv[])
+{
+  std::string file = "ns3.log";
+  uint32_t firstNode = 0;
+  uint32_t lastNode = std::numeric_limits<uint32_t>::max ();
+  Time start = Time::Min ();
+  Time stop = Time::Max ();
+
+  CommandLine cmd;
+  cmd.Usage ("Print the records written by ns3::LogBuffer as text.\n"
+             "\n"
+             "The output is what the NS_LOG macros would have printed\n"
+             "to std::clog, for the selected nodes and time window.\n"
+             "Messages logged without node are always printed.");
+  cmd.AddValue ("file",      "the file written by LogBuffer (default ns3.log)", file);
+  cmd.AddValue ("firstNode", "the first node printed",                          firstNode);
+  cmd.AddValue ("lastNode",  "the last node printed",                           lastNode);
+  cmd.AddValue ("start",     "the start of the time window",                    start);
+  cmd.AddValue ("stop",      "the end of the time window, excluded",            stop);
+  cmd.Parse (argc, argv);
+
+  std::ifstream is (file.c_str (), std::ios::in | std::ios::binary);
+  if (!is.is_open ())
+    {
+      std::cerr << cmd.GetName () << ": cannot open " << file << std::endl;
+      return 1;
+    }
+  LogBuffer::SetNodeFilter (firstNode, lastNode);
+  LogBuffer::SetTimeFilter (start, stop);
+  if (!LogBuffer::Format (is, std::cout))
+    {
+      std::cerr << cmd.GetName () << ": " << file << " is not a LogBuffer file, "
+                << "or is truncated" << std::endl;
+      return 1;
+    }
+  return 0;
+}